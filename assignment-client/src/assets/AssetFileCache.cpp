@@ -0,0 +1,215 @@
+//
+//  AssetFileCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileCache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "AssetServerLogging.h"
+
+// smaller assets are cheaper to copy than to keep a file descriptor open for
+const qint64 AssetFileCache::MAX_IN_MEMORY_ASSET_SIZE = 64 * 1024;
+
+// well under the usual 1024 descriptor soft limit, which the server also needs for sockets and uploads
+const int AssetFileCache::DEFAULT_MAX_MAPPED_FILES = 256;
+
+AssetFileCache::MappedAsset::~MappedAsset() {
+    if (_file.isOpen()) {
+        // unmapping happens when the file is closed
+        _file.close();
+    }
+}
+
+AssetFileCache::AssetFileCache(const QDir& filesDirectory, qint64 maxCachedBytes, int maxMappedFiles) :
+    _filesDirectory(filesDirectory),
+    _maxCachedBytes(maxCachedBytes),
+    _maxMappedFiles(std::max(maxMappedFiles, 0))
+{
+}
+
+AssetFileCache::MappedAssetPointer AssetFileCache::getAsset(const AssetUtils::AssetHash& hash) {
+    std::shared_ptr<PendingLoad> pendingLoad;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        ++_totalRequests;
+        auto& entry = _entries[hash];
+        ++entry.requests;
+
+        if (entry.asset) {
+            ++entry.hits;
+            ++_totalHits;
+            _lru.splice(_lru.begin(), _lru, entry.lruPosition);
+            return entry.asset;
+        }
+
+        if (entry.pendingLoad) {
+            // another task is already mapping this asset, share its result instead of hitting the disk again
+            ++entry.coalesced;
+            ++_totalCoalesced;
+            auto sharedLoad = entry.pendingLoad;
+            _loadFinished.wait(lock, [&] { return sharedLoad->finished; });
+            return sharedLoad->result;
+        }
+
+        pendingLoad = std::make_shared<PendingLoad>();
+        entry.pendingLoad = pendingLoad;
+    }
+
+    auto asset = loadAsset(hash);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        pendingLoad->result = asset;
+        pendingLoad->finished = true;
+
+        auto it = _entries.find(hash);
+        if (it != _entries.end() && it->pendingLoad == pendingLoad) {
+            it->pendingLoad.reset();
+
+            if (!asset) {
+                // don't keep stats around for hashes we don't have
+                _entries.erase(it);
+            } else if (asset->size() <= _maxCachedBytes) {
+                it->asset = asset;
+                _lru.push_front(hash);
+                it->lruPosition = _lru.begin();
+                _cachedBytes += asset->size();
+                if (asset->isMapped()) {
+                    ++_numMappedFiles;
+                }
+                evictToLimit();
+            }
+        }
+        // otherwise the asset was invalidated while we were loading it, hand it out without caching it
+    }
+    _loadFinished.notify_all();
+
+    return asset;
+}
+
+void AssetFileCache::invalidate(const AssetUtils::AssetHash& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(hash);
+    if (it == _entries.end()) {
+        return;
+    }
+
+    if (it->asset) {
+        _cachedBytes -= it->asset->size();
+        if (it->asset->isMapped()) {
+            --_numMappedFiles;
+        }
+        _lru.erase(it->lruPosition);
+    }
+    _entries.erase(it);
+}
+
+QJsonObject AssetFileCache::getStats(int maxHotAssets) const {
+    static const double BYTES_PER_MEGABYTE = 1000.0 * 1000.0;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto hitRate = [](quint64 hits, quint64 requests) {
+        return requests > 0 ? (double)hits / (double)requests : 0.0;
+    };
+
+    QJsonObject stats;
+    stats["1. Cached Assets"] = (int)_lru.size();
+    stats["2. Cached (MB)"] = (double)_cachedBytes / BYTES_PER_MEGABYTE;
+    stats["3. Limit (MB)"] = (double)_maxCachedBytes / BYTES_PER_MEGABYTE;
+    stats["4. Mapped Files"] = _numMappedFiles;
+    stats["5. Mapped Files Limit"] = _maxMappedFiles;
+    stats["6. Requests"] = (double)_totalRequests;
+    stats["7. Hits"] = (double)_totalHits;
+    stats["8. Coalesced"] = (double)_totalCoalesced;
+    stats["9. Hit Rate"] = hitRate(_totalHits + _totalCoalesced, _totalRequests);
+
+    std::vector<QHash<AssetUtils::AssetHash, Entry>::const_iterator> hotAssets;
+    hotAssets.reserve(_entries.size());
+    for (auto it = _entries.cbegin(); it != _entries.cend(); ++it) {
+        hotAssets.push_back(it);
+    }
+    auto hotCount = std::min((size_t)std::max(maxHotAssets, 0), hotAssets.size());
+    std::partial_sort(hotAssets.begin(), hotAssets.begin() + hotCount, hotAssets.end(), [](const auto& a, const auto& b) {
+        return a->requests > b->requests;
+    });
+
+    QJsonObject hotAssetStats;
+    for (size_t i = 0; i < hotCount; ++i) {
+        const auto& entry = hotAssets[i].value();
+
+        QJsonObject assetStats;
+        assetStats["1. Requests"] = (double)entry.requests;
+        assetStats["2. Hits"] = (double)entry.hits;
+        assetStats["3. Coalesced"] = (double)entry.coalesced;
+        assetStats["4. Hit Rate"] = hitRate(entry.hits + entry.coalesced, entry.requests);
+        assetStats["5. Cached"] = (bool)entry.asset;
+        hotAssetStats[hotAssets[i].key()] = assetStats;
+    }
+    stats["Hot Assets"] = hotAssetStats;
+
+    return stats;
+}
+
+AssetFileCache::MappedAssetPointer AssetFileCache::loadAsset(const AssetUtils::AssetHash& hash) const {
+    auto asset = std::make_shared<MappedAsset>();
+
+    asset->_file.setFileName(_filesDirectory.filePath(hash));
+    if (!asset->_file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    asset->_size = asset->_file.size();
+    if (asset->_size == 0) {
+        // empty files can't be mapped, point at the empty buffer instead
+        asset->_file.close();
+        asset->_data = asset->_buffer.constData();
+        return asset;
+    }
+
+    auto mapping = asset->_size > MAX_IN_MEMORY_ASSET_SIZE ? asset->_file.map(0, asset->_size) : nullptr;
+    if (mapping) {
+        asset->_data = reinterpret_cast<const char*>(mapping);
+    } else {
+        if (asset->_size > MAX_IN_MEMORY_ASSET_SIZE) {
+            qCDebug(asset_server) << "Unable to map asset" << hash << "- reading it into memory instead:"
+                << asset->_file.errorString();
+        }
+        asset->_buffer = asset->_file.readAll();
+        asset->_file.close();
+
+        if (asset->_buffer.size() != asset->_size) {
+            return nullptr;
+        }
+        asset->_data = asset->_buffer.constData();
+    }
+
+    return asset;
+}
+
+void AssetFileCache::evictToLimit() {
+    while ((_cachedBytes > _maxCachedBytes || _numMappedFiles > _maxMappedFiles) && !_lru.empty()) {
+        auto it = _entries.find(_lru.back());
+        _lru.pop_back();
+
+        if (it != _entries.end() && it->asset) {
+            // tasks still sending this asset keep the mapping alive until they release it
+            _cachedBytes -= it->asset->size();
+            if (it->asset->isMapped()) {
+                --_numMappedFiles;
+            }
+            it->asset.reset();
+        }
+    }
+}
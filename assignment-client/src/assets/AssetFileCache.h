@@ -0,0 +1,103 @@
+//
+//  AssetFileCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileCache_h
+#define hifi_AssetFileCache_h
+
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+
+#include "AssetUtils.h"
+
+/// Memory-mapped asset files shared by every SendAssetTask.
+///
+/// Each asset is mapped once and kept in an LRU bounded by bytes and by open files, so concurrent and repeated
+/// requests for the same hash read straight from the page cache instead of re-reading the file into a fresh buffer.
+/// Small assets are copied into memory and their files closed, so only large assets hold a file descriptor.
+/// Requests that arrive while an asset is being mapped wait for that load rather than starting their own.
+class AssetFileCache {
+public:
+    static const qint64 MAX_IN_MEMORY_ASSET_SIZE;
+    static const int DEFAULT_MAX_MAPPED_FILES;
+
+    class MappedAsset {
+    public:
+        ~MappedAsset();
+
+        const char* data() const { return _data; }
+        qint64 size() const { return _size; }
+        bool isMapped() const { return _file.isOpen(); }
+
+    private:
+        friend class AssetFileCache;
+
+        QFile _file;
+        QByteArray _buffer; // holds the contents when the file system can't map the file
+        const char* _data { nullptr };
+        qint64 _size { 0 };
+    };
+    using MappedAssetPointer = std::shared_ptr<const MappedAsset>;
+
+    AssetFileCache(const QDir& filesDirectory, qint64 maxCachedBytes, int maxMappedFiles = DEFAULT_MAX_MAPPED_FILES);
+
+    /// Returns the mapped contents of the asset, or nullptr if it could not be opened.
+    /// Safe to call from any thread; the returned mapping stays valid while it is held, even after eviction.
+    MappedAssetPointer getAsset(const AssetUtils::AssetHash& hash);
+
+    /// Drop the cached mapping for an asset whose file is being removed or rewritten
+    void invalidate(const AssetUtils::AssetHash& hash);
+
+    QJsonObject getStats(int maxHotAssets) const;
+
+private:
+    struct PendingLoad {
+        MappedAssetPointer result;
+        bool finished { false };
+    };
+
+    struct Entry {
+        MappedAssetPointer asset;
+        std::list<AssetUtils::AssetHash>::iterator lruPosition;
+        std::shared_ptr<PendingLoad> pendingLoad;
+
+        quint64 requests { 0 };
+        quint64 hits { 0 };
+        quint64 coalesced { 0 };
+    };
+
+    MappedAssetPointer loadAsset(const AssetUtils::AssetHash& hash) const;
+    void evictToLimit();
+
+    const QDir _filesDirectory;
+    const qint64 _maxCachedBytes;
+    const int _maxMappedFiles;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _loadFinished;
+
+    QHash<AssetUtils::AssetHash, Entry> _entries;
+    std::list<AssetUtils::AssetHash> _lru; // most recently used at the front
+    qint64 _cachedBytes { 0 };
+    int _numMappedFiles { 0 }; // cached assets that keep their file open
+
+    quint64 _totalRequests { 0 };
+    quint64 _totalHits { 0 };
+    quint64 _totalCoalesced { 0 };
+};
+
+#endif // hifi_AssetFileCache_h
@@ -12,8 +12,9 @@
 
 #include "AssetServer.h"
 
-#include <thread>
+#include <algorithm>
 #include <memory>
+#include <thread>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCryptographicHash>
@@ -35,6 +36,7 @@
 #include <PathUtils.h>
 #include <image/Image.h>
 
+#include "AssetFileCache.h"
 #include "AssetServerLogging.h"
 #include "BakeAssetTask.h"
 #include "SendAssetTask.h"
@@ -109,11 +111,15 @@ BakeVersion currentBakeVersionForAssetType(BakedAssetType type) {
 
 const QString ASSET_SERVER_LOGGING_TARGET_NAME = "asset-server";
 
-void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath) {
+void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath,
+                            int priority) {
     qDebug() << "Starting bake for: " << assetPath << assetHash;
     auto it = _pendingBakes.find(assetHash);
     if (it == _pendingBakes.end()) {
-        auto task = std::make_shared<BakeAssetTask>(assetHash, assetPath, filePath);
+        auto mode = _bakeInOvenWorkers ? BakeAssetTask::Mode::OvenWorker : BakeAssetTask::Mode::InProcess;
+        auto task = std::make_shared<BakeAssetTask>(assetHash, assetPath, filePath, mode, [this] {
+            return getNextBakerWorkerThread();
+        });
         task->setAutoDelete(false);
         _pendingBakes[assetHash] = task;
 
@@ -121,9 +127,33 @@ void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetU
         connect(task.get(), &BakeAssetTask::bakeFailed, this, &AssetServer::handleFailedBake);
         connect(task.get(), &BakeAssetTask::bakeAborted, this, &AssetServer::handleAbortedBake);
 
-        _bakingTaskPool.start(task.get());
+        _bakingTaskPool.start(task.get(), priority);
     } else {
         qDebug() << "Already in queue";
+        if (priority > BACKGROUND_BAKE_PRIORITY) {
+            prioritizeBake(assetHash);
+        }
+    }
+}
+
+void AssetServer::prioritizeBake(const AssetUtils::AssetHash& assetHash) {
+    auto it = _pendingBakes.find(assetHash);
+    if (it != _pendingBakes.end() && !(*it)->isBaking() && _bakingTaskPool.tryTake(it->get())) {
+        qDebug() << "Moving bake of" << (*it)->getAssetPath() << "to the front of the queue";
+        _bakingTaskPool.start(it->get(), REQUESTED_BAKE_PRIORITY);
+    }
+}
+
+QThread* AssetServer::getNextBakerWorkerThread() {
+    // same scheme as the oven's worker threads, the threads are all started in completeSetup
+    auto nextIndex = ++_nextBakerWorkerThreadIndex;
+    return _bakerWorkerThreads[nextIndex % _bakerWorkerThreads.size()].get();
+}
+
+void AssetServer::recordBakeTime(const AssetUtils::AssetHash& assetHash) {
+    auto it = _pendingBakes.find(assetHash);
+    if (it != _pendingBakes.end() && (*it)->getBakeStartTime() > 0) {
+        _totalBakeTime += usecTimestampNow() - (*it)->getBakeStartTime();
     }
 }
 
@@ -190,10 +220,10 @@ void AssetServer::bakeAssets() {
     }
 }
 
-void AssetServer::maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash) {
+void AssetServer::maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash, int priority) {
     if (needsToBeBaked(path, hash)) {
         qDebug() << "Queuing bake of: " << path;
-        bakeAsset(hash, path, getPathToAssetHash(hash));
+        bakeAsset(hash, path, getPathToAssetHash(hash), priority);
     }
 }
 
@@ -301,6 +331,9 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     _transferTaskPool.setMaxThreadCount(TASK_POOL_THREAD_COUNT);
     _bakingTaskPool.setMaxThreadCount(1);
 
+    // keep baking threads around, with oven workers each of them owns a running process
+    _bakingTaskPool.setExpiryTimeout(-1);
+
     // Queue all requests until the Asset Server is fully setup
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListenerForTypes({ PacketType::AssetGet, PacketType::AssetGetInfo, PacketType::AssetUpload, PacketType::AssetMappingOperation }, this, "queueRequests");
@@ -343,6 +376,13 @@ void AssetServer::aboutToFinish() {
     while (_pendingBakes.size() > 0) {
         QCoreApplication::processEvents();
     }
+
+    for (auto& thread : _bakerWorkerThreads) {
+        thread->quit();
+    }
+    for (auto& thread : _bakerWorkerThreads) {
+        thread->wait();
+    }
 }
 
 void AssetServer::run() {
@@ -419,6 +459,38 @@ void AssetServer::completeSetup() {
         return;
     }
 
+    // get the budget for asset files kept mapped in memory between requests
+    static const QString ASSETS_CACHE_SIZE_OPTION = "assets_cache_size";
+    static const int DEFAULT_ASSETS_CACHE_SIZE_MB = 512;
+    static const qint64 BYTES_PER_MEGABYTE = 1000 * 1000;
+    auto assetsCacheSize = assetServerObject[ASSETS_CACHE_SIZE_OPTION].toInt(DEFAULT_ASSETS_CACHE_SIZE_MB);
+    _fileCache = std::make_shared<AssetFileCache>(_filesDirectory, std::max(assetsCacheSize, 0) * BYTES_PER_MEGABYTE);
+    qCInfo(asset_server) << "Keeping up to" << assetsCacheSize << "MB of asset files in memory, with at most"
+        << AssetFileCache::DEFAULT_MAX_MAPPED_FILES << "of them mapped.";
+
+    // bakes run in this process by default, the oven workers trade some speed for surviving a crashing baker
+    static const QString BAKE_IN_OVEN_WORKERS_OPTION = "bake_in_oven_workers";
+    static const QString MAX_CONCURRENT_BAKES_OPTION = "max_concurrent_bakes";
+    _bakeInOvenWorkers = assetServerObject[BAKE_IN_OVEN_WORKERS_OPTION].toBool(false);
+
+    auto maxConcurrentBakes = assetServerObject[MAX_CONCURRENT_BAKES_OPTION].toInt(0);
+    if (maxConcurrentBakes <= 0) {
+        maxConcurrentBakes = std::max(1, QThread::idealThreadCount() / 2);
+    }
+    _bakingTaskPool.setMaxThreadCount(maxConcurrentBakes);
+
+    if (!_bakeInOvenWorkers && _bakerWorkerThreads.empty()) {
+        for (int i = 0; i < QThread::idealThreadCount(); ++i) {
+            auto thread = std::unique_ptr<QThread> { new QThread };
+            thread->setObjectName("Asset Baker Worker Thread " + QString::number(i + 1));
+            thread->start();
+            _bakerWorkerThreads.push_back(std::move(thread));
+        }
+    }
+
+    qCInfo(asset_server) << "Running up to" << maxConcurrentBakes << "bakes at a time"
+        << (_bakeInOvenWorkers ? "in oven worker processes." : "in process.");
+
     // load whatever mappings we currently have from the local file
     if (loadMappingsFromFile()) {
         qCInfo(asset_server) << "Serving files from: " << _filesDirectory.path();
@@ -532,6 +604,7 @@ void AssetServer::cleanupUnmappedFiles() {
             if (!matched) {
                 // remove the unmapped file
                 QFile removeableFile { fileInfo.absoluteFilePath() };
+                _fileCache->invalidate(filename);
 
                 if (removeableFile.remove()) {
                     qCDebug(asset_server) << "\tDeleted" << filename << "from asset files directory since it is unmapped.";
@@ -663,6 +736,9 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
                 }
             } else {
                 qDebug() << "Did not find baked version for: " << originalAssetHash << assetPath;
+
+                // someone wants this asset now, if it is waiting to be baked let it go first
+                prioritizeBake(originalAssetHash);
             }
         }
 
@@ -695,7 +771,7 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
 
                     writeMetaFile(originalAssetHash, needsBakingMeta);
                     if (!bakingDisabled) {
-                        maybeBake(assetPath, originalAssetHash);
+                        maybeBake(assetPath, originalAssetHash, REQUESTED_BAKE_PRIORITY);
                     }
 
                 }
@@ -872,7 +948,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _fileCache);
     _transferTaskPool.start(task);
 }
 
@@ -886,7 +962,7 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
     if (canWriteToAssetServer) {
         qCDebug(asset_server) << "Starting an UploadAssetTask for upload from" << message->getSourceID();
 
-        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit);
+        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _fileCache, _filesizeLimit);
         _transferTaskPool.start(task);
     } else {
         // this is a node the domain told us is not allowed to rez entities
@@ -977,6 +1053,33 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
 
+    QJsonObject bakingStats;
+    QJsonObject bakesInProgress;
+    int queuedBakes = 0;
+    auto now = usecTimestampNow();
+    for (const auto& task : _pendingBakes) {
+        if (task->isBaking()) {
+            bakesInProgress[task->getAssetPath()] = (double)(now - task->getBakeStartTime()) / USECS_PER_SECOND;
+        } else {
+            ++queuedBakes;
+        }
+    }
+    auto finishedBakes = _completedBakes + _failedBakes;
+    bakingStats["1. Queued"] = queuedBakes;
+    bakingStats["2. In Progress"] = bakesInProgress.size();
+    bakingStats["3. Completed"] = (double)_completedBakes;
+    bakingStats["4. Failed"] = (double)_failedBakes;
+    bakingStats["5. Aborted"] = (double)_abortedBakes;
+    bakingStats["6. Avg Bake Time (s)"] = finishedBakes > 0 ?
+        (double)_totalBakeTime / finishedBakes / USECS_PER_SECOND : 0.0;
+    bakingStats["7. Baking Now (s)"] = bakesInProgress;
+    serverStats["Baking"] = bakingStats;
+
+    if (_fileCache) {
+        static const int MAX_HOT_ASSET_STATS = 10;
+        serverStats["Asset File Cache"] = _fileCache->getStats(MAX_HOT_ASSET_STATS);
+    }
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -1191,6 +1294,7 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
         for (auto& hash : hashesToCheckForDeletion) {
             // remove the unmapped file
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
+            _fileCache->invalidate(hash);
 
             if (removeableFile.remove()) {
                 qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
@@ -1337,6 +1441,8 @@ void AssetServer::handleFailedBake(QString originalAssetHash, QString assetPath,
 
     writeMetaFile(originalAssetHash, meta);
 
+    ++_failedBakes;
+    recordBakeTime(originalAssetHash);
     _pendingBakes.remove(originalAssetHash);
 }
 
@@ -1437,6 +1543,8 @@ void AssetServer::handleCompletedBake(QString originalAssetHash, QString origina
 
     writeMetaFile(originalAssetHash, meta);
 
+    ++_completedBakes;
+    recordBakeTime(originalAssetHash);
     _pendingBakes.remove(originalAssetHash);
 }
 
@@ -1444,6 +1552,7 @@ void AssetServer::handleAbortedBake(QString originalAssetHash, QString assetPath
     qDebug() << "Aborted bake:" << originalAssetHash;
 
     // for an aborted bake we don't do anything but remove the BakeAssetTask from our pending bakes
+    ++_abortedBakes;
     _pendingBakes.remove(originalAssetHash);
 }
 
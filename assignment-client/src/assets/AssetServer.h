@@ -13,9 +13,14 @@
 #define hifi_AssetServer_h
 
 #include <QtCore/QDir>
+#include <QtCore/QThread>
 #include <QtCore/QThreadPool>
 #include <QRunnable>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <ThreadedAssignment.h>
 
 #include "AssetUtils.h"
@@ -70,6 +75,7 @@ struct AssetMeta {
     QString lastBakeErrors;
 };
 
+class AssetFileCache;
 class BakeAssetTask;
 
 class AssetServer : public ThreadedAssignment {
@@ -132,11 +138,22 @@ private:
     std::pair<AssetUtils::BakingStatus, QString> getAssetStatus(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
 
     void bakeAssets();
-    void maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
+    void maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash,
+                   int priority = BACKGROUND_BAKE_PRIORITY);
     void createEmptyMetaFile(const AssetUtils::AssetHash& hash);
     bool hasMetaFile(const AssetUtils::AssetHash& hash);
     bool needsToBeBaked(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& assetHash);
-    void bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath);
+    void bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath,
+                   int priority);
+
+    /// Move a bake that hasn't started yet ahead of the background bakes, because a client is waiting on it
+    void prioritizeBake(const AssetUtils::AssetHash& assetHash);
+
+    /// Hand out the threads that in-process model bakers run their texture bakes on
+    QThread* getNextBakerWorkerThread();
+
+    /// Account for a finished bake in the baking stats
+    void recordBakeTime(const AssetUtils::AssetHash& assetHash);
 
     /// Move baked content for asset to baked directory and update baked status
     void handleCompletedBake(QString originalAssetHash, QString assetPath, QString bakedTempOutputDir,
@@ -156,12 +173,29 @@ private:
     QDir _resourcesDirectory;
     QDir _filesDirectory;
 
+    /// Mapped asset files shared by the send tasks, created once the files directory is known
+    std::shared_ptr<AssetFileCache> _fileCache;
+
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
     QHash<AssetUtils::AssetHash, std::shared_ptr<BakeAssetTask>> _pendingBakes;
     QThreadPool _bakingTaskPool;
 
+    static const int BACKGROUND_BAKE_PRIORITY = 0;
+    static const int REQUESTED_BAKE_PRIORITY = 1;
+
+    /// Bake in reused `oven --worker` processes instead of in this process, for crash isolation
+    bool _bakeInOvenWorkers { false };
+
+    std::vector<std::unique_ptr<QThread>> _bakerWorkerThreads;
+    std::atomic<uint32_t> _nextBakerWorkerThreadIndex { 0 };
+
+    quint64 _completedBakes { 0 };
+    quint64 _failedBakes { 0 };
+    quint64 _abortedBakes { 0 };
+    quint64 _totalBakeTime { 0 };
+
     QMutex _queuedRequestsMutex;
     bool _isQueueingRequests { true };
     using RequestQueue = QVector<QPair<QSharedPointer<ReceivedMessage>, SharedNodePointer>>;
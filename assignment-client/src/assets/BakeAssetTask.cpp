@@ -11,45 +11,132 @@
 
 #include "BakeAssetTask.h"
 
-#include <mutex>
-
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QProcess>
 #include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
 #include <QCoreApplication>
 
+#include <BakerLibrary.h>
+#include <NumericalConstants.h>
 #include <PathUtils.h>
+#include <SharedUtil.h>
 
 static const int OVEN_STATUS_CODE_SUCCESS { 0 };
 static const int OVEN_STATUS_CODE_FAIL { 1 };
 static const int OVEN_STATUS_CODE_ABORT { 2 };
 
-std::once_flag registerMetaTypesFlag;
+// see tools/oven/src/BakerCLI.h for the other side of the worker protocol
+static const QString OVEN_WORKER_INPUT_KEY = "input";
+static const QString OVEN_WORKER_OUTPUT_KEY = "output";
+static const QString OVEN_WORKER_TYPE_KEY = "type";
+static const QString OVEN_WORKER_RESULT_PREFIX = "OVEN_RESULT ";
 
-BakeAssetTask::BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath) :
-    _assetHash(assetHash),
-    _assetPath(assetPath),
-    _filePath(filePath)
-{
+// How often a bake waiting on its oven worker checks whether it was aborted
+static const int OVEN_WORKER_POLL_INTERVAL_MS = 100;
+
+// A long-lived `oven --worker` process, owned by the baking pool thread that started it
+class OvenWorker {
+public:
+    ~OvenWorker() { stop(); }
+
+    // Sends one bake request and waits for its status code. Kills the worker if `shouldAbort` becomes true.
+    // Returns -1 with `errors` filled if the worker could not be started or died during the bake.
+    int bake(const QString& inputPath, const QString& outputPath, const QString& type,
+             const std::atomic<bool>& shouldAbort, QString& errors);
+
+private:
+    bool ensureStarted();
+    void stop();
+
+    std::unique_ptr<QProcess> _process;
+};
+
+static QThreadStorage<OvenWorker*> ovenWorkers;
 
-    std::call_once(registerMetaTypesFlag, []() {
-        qRegisterMetaType<QProcess::ProcessError>("QProcess::ProcessError");
-        qRegisterMetaType<QProcess::ExitStatus>("QProcess::ExitStatus");
-    });
+bool OvenWorker::ensureStarted() {
+    if (_process && _process->state() == QProcess::Running) {
+        return true;
+    }
+
+    auto base = QFileInfo(QCoreApplication::applicationFilePath()).absoluteDir();
+    QString path = base.absolutePath() + "/oven";
+
+    _process.reset(new QProcess());
+    // we only read stdout for results, let the oven's own logging go straight through
+    _process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    qDebug() << "Starting oven worker on" << QThread::currentThread()->objectName();
+    _process->start(path, { "--worker" });
+    return _process->waitForStarted(-1);
 }
 
-void cleanupTempFiles(QString tempOutputDir, std::vector<QString> files) {
-    for (const auto& filename : files) {
-        QFile f { filename };
-        if (!f.remove()) {
-            qDebug() << "Failed to remove:" << filename;
-        }
+void OvenWorker::stop() {
+    if (!_process || _process->state() == QProcess::NotRunning) {
+        return;
+    }
+
+    // closing its input lets the worker finish up and exit on its own
+    static const int OVEN_WORKER_EXIT_TIMEOUT_MS = 1000;
+    _process->closeWriteChannel();
+    if (!_process->waitForFinished(OVEN_WORKER_EXIT_TIMEOUT_MS)) {
+        _process->kill();
+        _process->waitForFinished();
     }
-    if (!tempOutputDir.isEmpty()) {
-        QDir dir { tempOutputDir };
-        if (!dir.rmdir(".")) {
-            qDebug() << "Failed to remove temporary directory:" << tempOutputDir;
+}
+
+int OvenWorker::bake(const QString& inputPath, const QString& outputPath, const QString& type,
+                     const std::atomic<bool>& shouldAbort, QString& errors) {
+    if (!ensureStarted()) {
+        errors = "Oven process failed to start";
+        return -1;
+    }
+
+    QJsonObject request {
+        { OVEN_WORKER_INPUT_KEY, QUrl::fromLocalFile(inputPath).toString() },
+        { OVEN_WORKER_OUTPUT_KEY, outputPath },
+        { OVEN_WORKER_TYPE_KEY, type }
+    };
+    _process->write(QJsonDocument(request).toJson(QJsonDocument::Compact) + '\n');
+
+    while (true) {
+        if (shouldAbort) {
+            qDebug() << "Terminating oven worker for aborted bake of" << inputPath;
+            _process->kill();
+            _process->waitForFinished();
+            return OVEN_STATUS_CODE_ABORT;
         }
+
+        while (_process->canReadLine()) {
+            auto line = QString::fromUtf8(_process->readLine()).trimmed();
+            if (line.startsWith(OVEN_WORKER_RESULT_PREFIX)) {
+                return line.mid(OVEN_WORKER_RESULT_PREFIX.length()).toInt();
+            }
+        }
+
+        if (_process->state() == QProcess::NotRunning) {
+            qDebug() << "Oven worker exited during bake:" << _process->exitCode() << _process->exitStatus();
+            errors = "Fatal error occurred while baking";
+            return -1;
+        }
+
+        _process->waitForReadyRead(OVEN_WORKER_POLL_INTERVAL_MS);
     }
-};
+}
+
+BakeAssetTask::BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath,
+                             Mode mode, TextureBakerThreadGetter textureThreadGetter) :
+    _assetHash(assetHash),
+    _assetPath(assetPath),
+    _filePath(filePath),
+    _mode(mode),
+    _textureThreadGetter(textureThreadGetter)
+{
+}
 
 void BakeAssetTask::run() {
     if (_isBaking.exchange(true)) {
@@ -57,84 +144,111 @@ void BakeAssetTask::run() {
         return;
     }
 
+    _bakeStartTime = usecTimestampNow();
+
     QString tempOutputDir = PathUtils::generateTemporaryDir();
-    auto base = QFileInfo(QCoreApplication::applicationFilePath()).absoluteDir();
-    QString path = base.absolutePath() + "/oven";
-    QString extension = _assetPath.mid(_assetPath.lastIndexOf('.') + 1);
-    QStringList args {
-        "-i", _filePath,
-        "-o", tempOutputDir,
-        "-t", extension,
-    };
+    QString errors;
 
-    _ovenProcess.reset(new QProcess());
+    qDebug() << "Starting bake for" << _assetPath << (_mode == Mode::InProcess ? "in process" : "in oven worker");
+    int statusCode = _mode == Mode::InProcess ? bakeInProcess(tempOutputDir, errors) : bakeInOvenWorker(tempOutputDir, errors);
 
-    QEventLoop loop;
+    qDebug() << "Baking finished for" << _assetPath << "with status" << statusCode << "in"
+        << (usecTimestampNow() - _bakeStartTime) / USECS_PER_MSEC << "ms";
 
-    connect(_ovenProcess.get(), static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-            this, [&loop, this, tempOutputDir](int exitCode, QProcess::ExitStatus exitStatus) {
-        qDebug() << "Baking process finished: " << exitCode << exitStatus;
+    if (statusCode == OVEN_STATUS_CODE_SUCCESS) {
+        QDir outputDir = tempOutputDir;
+        auto files = outputDir.entryInfoList(QDir::Files);
+        QVector<QString> outputFiles;
+        for (auto& file : files) {
+            outputFiles.push_back(file.absoluteFilePath());
+        }
 
-        if (exitStatus == QProcess::CrashExit) {
-            if (_wasAborted) {
-                emit bakeAborted(_assetHash, _assetPath);
-            } else {
-                QString errors = "Fatal error occurred while baking";
-                emit bakeFailed(_assetHash, _assetPath, errors);
-            }
-        } else if (exitCode == OVEN_STATUS_CODE_SUCCESS) {
-            QDir outputDir = tempOutputDir;
-            auto files = outputDir.entryInfoList(QDir::Files);
-            QVector<QString> outputFiles;
-            for (auto& file : files) {
-                outputFiles.push_back(file.absoluteFilePath());
-            }
+        emit bakeComplete(_assetHash, _assetPath, tempOutputDir, outputFiles);
+    } else {
+        QDir(tempOutputDir).removeRecursively();
 
-            emit bakeComplete(_assetHash, _assetPath, tempOutputDir, outputFiles);
-        } else if (exitStatus == QProcess::NormalExit && exitCode == OVEN_STATUS_CODE_ABORT) {
+        if (statusCode == OVEN_STATUS_CODE_ABORT) {
             _wasAborted.store(true);
             emit bakeAborted(_assetHash, _assetPath);
         } else {
-            QString errors;
-            if (exitCode == OVEN_STATUS_CODE_FAIL) {
-                QDir outputDir = tempOutputDir;
-                auto errorFilePath = outputDir.absoluteFilePath("errors.txt");
-                QFile errorFile { errorFilePath };
-                if (errorFile.open(QIODevice::ReadOnly)) {
-                    errors = errorFile.readAll();
-                    errorFile.close();
-                } else {
-                    errors = "Unknown error occurred while baking";
-                }
-            }
             emit bakeFailed(_assetHash, _assetPath, errors);
         }
+    }
+}
 
-        loop.quit();
-    });
+int BakeAssetTask::bakeInProcess(const QString& tempOutputDir, QString& errors) {
+    QString extension = _assetPath.mid(_assetPath.lastIndexOf('.') + 1);
 
-    qDebug() << "Starting oven for " << _assetPath;
-    _ovenProcess->start(path, args, QIODevice::ReadOnly);
-    if (!_ovenProcess->waitForStarted(-1)) {
-        QString errors = "Oven process failed to start";
-        emit bakeFailed(_assetHash, _assetPath, errors);
-        return;
+    auto baker = createBakerForType(QUrl::fromLocalFile(_filePath), extension, tempOutputDir, _textureThreadGetter, errors);
+    if (!baker) {
+        return OVEN_STATUS_CODE_FAIL;
     }
 
-    _isBaking = true;
+    // the baker lives on this thread, spin an event loop here until it is done
+    QEventLoop loop;
+    connect(baker.get(), &Baker::finished, &loop, &QEventLoop::quit);
+    connect(baker.get(), &Baker::aborted, &loop, &QEventLoop::quit);
 
+    {
+        std::lock_guard<std::mutex> lock(_bakerMutex);
+        if (_wasAborted) {
+            return OVEN_STATUS_CODE_ABORT;
+        }
+        _baker = baker.get();
+    }
+
+    QMetaObject::invokeMethod(baker.get(), "bake", Qt::QueuedConnection);
     loop.exec();
+
+    {
+        std::lock_guard<std::mutex> lock(_bakerMutex);
+        _baker = nullptr;
+    }
+
+    if (baker->wasAborted()) {
+        return OVEN_STATUS_CODE_ABORT;
+    } else if (baker->hasErrors()) {
+        errors = baker->getErrors().join('\n');
+        return OVEN_STATUS_CODE_FAIL;
+    }
+    return OVEN_STATUS_CODE_SUCCESS;
 }
 
-void BakeAssetTask::abort() {
-    if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "abort");
-        return;
+int BakeAssetTask::bakeInOvenWorker(const QString& tempOutputDir, QString& errors) {
+    if (!ovenWorkers.hasLocalData()) {
+        ovenWorkers.setLocalData(new OvenWorker());
     }
+
+    QString extension = _assetPath.mid(_assetPath.lastIndexOf('.') + 1);
+    int statusCode = ovenWorkers.localData()->bake(_filePath, tempOutputDir, extension, _wasAborted, errors);
+
+    if (statusCode < 0) {
+        // the worker died on us, the next bake on this thread will get a fresh one
+        return _wasAborted ? OVEN_STATUS_CODE_ABORT : OVEN_STATUS_CODE_FAIL;
+    }
+
+    if (statusCode == OVEN_STATUS_CODE_FAIL) {
+        QDir outputDir = tempOutputDir;
+        QFile errorFile { outputDir.absoluteFilePath("errors.txt") };
+        if (errorFile.open(QIODevice::ReadOnly)) {
+            errors = errorFile.readAll();
+            errorFile.close();
+        } else {
+            errors = "Unknown error occurred while baking";
+        }
+    }
+
+    return statusCode;
+}
+
+void BakeAssetTask::abort() {
     qDebug() << "Aborting BakeAssetTask for" << _assetHash;
-    if (_ovenProcess->state() != QProcess::NotRunning) {
-        qDebug() << "Teminating oven process for" << _assetHash;
-        _wasAborted = true;
-        _ovenProcess->terminate();
+
+    std::lock_guard<std::mutex> lock(_bakerMutex);
+    _wasAborted = true;
+
+    if (_baker) {
+        // the baker belongs to the baking thread, let it stop its texture bakers from there
+        QMetaObject::invokeMethod(_baker, "abort");
     }
 }
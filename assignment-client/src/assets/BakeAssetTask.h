@@ -12,24 +12,43 @@
 #ifndef hifi_BakeAssetTask_h
 #define hifi_BakeAssetTask_h
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 
 #include <QtCore/QDebug>
 #include <QtCore/QObject>
 #include <QtCore/QRunnable>
 #include <QDir>
-#include <QProcess>
 
 #include <AssetUtils.h>
 
+class Baker;
+class QThread;
+
+using TextureBakerThreadGetter = std::function<QThread*()>;
+
 class BakeAssetTask : public QObject, public QRunnable {
     Q_OBJECT
 public:
-    BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath);
+    // How a bake is run:
+    // InProcess bakes on the baking pool thread itself, without any process startup or temp file round-trip,
+    // OvenWorker hands the bake to a long-lived `oven --worker` process owned by the pool thread, so that a
+    // crashing baker only takes down that worker. The worker is reused for every bake on its thread.
+    enum class Mode {
+        InProcess,
+        OvenWorker
+    };
+
+    BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath,
+                  Mode mode, TextureBakerThreadGetter textureThreadGetter);
 
     // Thread-safe inspection methods
     bool isBaking() { return _isBaking.load(); }
     bool wasAborted() const { return _wasAborted.load(); }
+    quint64 getBakeStartTime() const { return _bakeStartTime.load(); }
+    const AssetUtils::AssetPath& getAssetPath() const { return _assetPath; }
 
     void run() override;
 
@@ -42,12 +61,20 @@ signals:
     void bakeAborted(QString assetHash, QString assetPath);
     
 private:
+    int bakeInProcess(const QString& tempOutputDir, QString& errors);
+    int bakeInOvenWorker(const QString& tempOutputDir, QString& errors);
+
     std::atomic<bool> _isBaking { false };
     AssetUtils::AssetHash _assetHash;
     AssetUtils::AssetPath _assetPath;
     QString _filePath;
-    std::unique_ptr<QProcess> _ovenProcess { nullptr };
+    Mode _mode;
+    TextureBakerThreadGetter _textureThreadGetter;
     std::atomic<bool> _wasAborted { false };
+    std::atomic<quint64> _bakeStartTime { 0 };
+
+    std::mutex _bakerMutex;
+    Baker* _baker { nullptr }; // the in-process baker, while it is running
 };
 
 #endif // hifi_BakeAssetTask_h
@@ -13,8 +13,6 @@
 
 #include <cmath>
 
-#include <QFile>
-
 #include <DependencyManager.h>
 #include <NetworkLogging.h>
 #include <NLPacket.h>
@@ -26,11 +24,12 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode,
+                             std::shared_ptr<AssetFileCache> fileCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _fileCache(fileCache)
 {
     
 }
@@ -63,18 +62,17 @@ void SendAssetTask::run() {
     if (!byteRange.isValid()) {
         replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
     } else {
-        QString filePath = _resourcesDir.filePath(QString(hexHash));
-        
-        QFile file { filePath };
+        // the mapping is shared with every other task serving this asset, and stays valid while we hold it
+        auto asset = _fileCache->getAsset(hexHash);
 
-        if (file.open(QIODevice::ReadOnly)) {
+        if (asset) {
 
             // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+            byteRange.fixupRange(asset->size());
 
             // check if we're being asked to read data that we just don't have
             // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+            if (asset->size() < byteRange.fromInclusive || asset->size() < byteRange.toExclusive) {
                 replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " "
                     << byteRange.fromInclusive << ":" << byteRange.toExclusive;
@@ -84,29 +82,24 @@ void SendAssetTask::run() {
 
                 if (byteRange.fromInclusive >= 0) {
 
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
+                    // this range is positive, meaning we just need to offset into the file and send from there
                     replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
+                    replyPacketList->write(asset->data() + byteRange.fromInclusive, size);
                 } else {
                     // this range is negative, at least the first part of the read will be back into the end of the file
 
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
-
                     replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
 
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
+                    // write everything from where the negative range begins to the end of the file
+                    replyPacketList->write(asset->data() + asset->size() + byteRange.fromInclusive, size);
                 }
 
                 qCDebug(networking) << "Sending asset: " << hexHash;
             }
-            file.close();
         } else {
-            qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
+            qCDebug(networking) << "Asset not found: " << hexHash;
             replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
         }
     }
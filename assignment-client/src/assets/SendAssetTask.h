@@ -17,6 +17,7 @@
 #include <QtCore/QString>
 #include <QtCore/QRunnable>
 
+#include "AssetFileCache.h"
 #include "AssetUtils.h"
 #include "AssetServer.h"
 #include "Node.h"
@@ -25,14 +26,15 @@ class NLPacket;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode,
+                  std::shared_ptr<AssetFileCache> fileCache);
 
     void run() override;
 
 private:
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
-    QDir _resourcesDir;
+    std::shared_ptr<AssetFileCache> _fileCache;
 };
 
 #endif
@@ -13,18 +13,22 @@
 
 #include <QtCore/QBuffer>
 #include <QtCore/QFile>
+#include <QtCore/QSaveFile>
 
 #include <AssetUtils.h>
 #include <NodeList.h>
 #include <NLPacketList.h>
 
+#include "AssetFileCache.h"
 #include "ClientServerUtils.h"
 
 UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode,
-                                 const QDir& resourcesDir, uint64_t filesizeLimit) :
+                                 const QDir& resourcesDir, std::shared_ptr<AssetFileCache> fileCache,
+                                 uint64_t filesizeLimit) :
     _receivedMessage(receivedMessage),
     _senderNode(senderNode),
     _resourcesDir(resourcesDir),
+    _fileCache(fileCache),
     _filesizeLimit(filesizeLimit)
 {
     
@@ -81,13 +85,18 @@ void UploadAssetTask::run() {
             } else {
                 qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << hexHash;
                 file.close();
+
+                // stop serving the bad contents from memory before the file is rewritten
+                _fileCache->invalidate(hexHash);
             }
         }
 
         if (!existingCorrectFile) {
-            if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileSize)) {
+            // written beside the file and renamed over it, so the file is never truncated in place: a SendAssetTask
+            // may still be reading the old contents through a mapping of it
+            QSaveFile saveFile { file.fileName() };
+            if (saveFile.open(QIODevice::WriteOnly) && saveFile.write(fileData) == qint64(fileSize) && saveFile.commit()) {
                 qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
-                file.close();
 
                 replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
                 replyPacket->write(hash);
@@ -95,7 +104,8 @@ void UploadAssetTask::run() {
                 qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
 
                 // upload has failed - remove the file and return an error
-                auto removed = file.remove();
+                // (the partial upload was discarded with saveFile, this only unlinks a file with bad contents)
+                auto removed = !file.exists() || file.remove();
 
                 if (!removed) {
                     qWarning() << "Removal of failed upload file" << hexHash << "failed.";
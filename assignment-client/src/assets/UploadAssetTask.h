@@ -14,6 +14,8 @@
 #ifndef hifi_UploadAssetTask_h
 #define hifi_UploadAssetTask_h
 
+#include <memory>
+
 #include <QtCore/QDir>
 #include <QtCore/QObject>
 #include <QtCore/QRunnable>
@@ -21,13 +23,14 @@
 
 #include "ReceivedMessage.h"
 
+class AssetFileCache;
 class NLPacketList;
 class Node;
 
 class UploadAssetTask : public QRunnable {
 public:
     UploadAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, 
-                    const QDir& resourcesDir, uint64_t filesizeLimit);
+                    const QDir& resourcesDir, std::shared_ptr<AssetFileCache> fileCache, uint64_t filesizeLimit);
 
     void run() override;
 
@@ -35,6 +38,7 @@ private:
     QSharedPointer<ReceivedMessage> _receivedMessage;
     QSharedPointer<Node> _senderNode;
     QDir _resourcesDir;
+    std::shared_ptr<AssetFileCache> _fileCache;
     uint64_t _filesizeLimit;
 };
 
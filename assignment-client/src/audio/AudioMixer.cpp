@@ -41,6 +41,7 @@
 static const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.5f;    // attenuation = -6dB * log2(distance)
 static const int DISABLE_STATIC_JITTER_FRAMES = -1;
 static const float DEFAULT_NOISE_MUTING_THRESHOLD = 1.0f;
+static const float DEFAULT_MAX_AUDIBLE_DISTANCE = 0.0f;
 static const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 static const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 static const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
@@ -49,6 +50,8 @@ static const QString AUDIO_THREADING_GROUP_KEY = "audio_threading";
 int AudioMixer::_numStaticJitterFrames{ DISABLE_STATIC_JITTER_FRAMES };
 float AudioMixer::_noiseMutingThreshold{ DEFAULT_NOISE_MUTING_THRESHOLD };
 float AudioMixer::_attenuationPerDoublingInDistance{ DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE };
+float AudioMixer::_maxAudibleDistance{ DEFAULT_MAX_AUDIBLE_DISTANCE };
+float AudioMixer::_audibilityRadius{ 0.0f };
 std::map<QString, std::shared_ptr<CodecPlugin>> AudioMixer::_availableCodecs{ };
 QStringList AudioMixer::_codecPreferenceOrder{};
 QHash<QString, AABox> AudioMixer::_audioZones;
@@ -279,6 +282,7 @@ void AudioMixer::sendStatsPacket() {
     statsObject["avg_streams_per_frame"] = (float)_stats.sumStreams / (float)_numStatFrames;
     statsObject["avg_listeners_per_frame"] = (float)_stats.sumListeners / (float)_numStatFrames;
     statsObject["avg_listeners_(silent)_per_frame"] = (float)_stats.sumListenersSilent / (float)_numStatFrames;
+    statsObject["avg_listeners_(shared)_per_frame"] = (float)_stats.sumListenersShared / (float)_numStatFrames;
 
     statsObject["silent_packets_per_frame"] = (float)_numSilentPackets / (float)_numStatFrames;
 
@@ -318,6 +322,8 @@ void AudioMixer::sendStatsPacket() {
 
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
+    mixStats["avg_culled_nodes_per_block"] = _stats.culledNodes / _numStatFrames;
+    mixStats["audibility_radius"] = _audibilityRadius;
 
     statsObject["mix_stats"] = mixStats;
 
@@ -384,6 +390,9 @@ void AudioMixer::start() {
     });
     nodeList->linkedDataCreateCallback = [&](Node* node) { getOrCreateClientData(node); };
 
+    // every listener is sent a mix each frame, so send them together
+    nodeList->setDatagramBatchingEnabled(true);
+
     // parse out any AudioMixer settings
     {
         DomainHandler& domainHandler = nodeList->getDomainHandler();
@@ -413,13 +422,22 @@ void AudioMixer::start() {
                 std::for_each(cbegin, cend, [&](const SharedNodePointer& node) {
                     _stats.sumStreams += prepareFrame(node, frame);
                 });
+
+                // index the stream positions, to be shared by the slaves
+                _spatialIndex.build(cbegin, cend, _audibilityRadius);
             }
 
             // mix across slave threads
             {
                 auto mixTimer = _mixTiming.timer();
-                _slavePool.mix(cbegin, cend, frame, _throttlingRatio);
+                nodeList->beginDatagramBatch();
+                _slavePool.mix(cbegin, cend, frame, _throttlingRatio, &_spatialIndex, &_sharedMixes);
+                nodeList->flushDatagramBatch();
             }
+
+            // release the nodes held by the index, and the mixes no longer shared
+            _spatialIndex.clear();
+            _sharedMixes.prune(frame);
         });
 
         // gather stats
@@ -534,6 +552,8 @@ void AudioMixer::clearDomainSettings() {
     _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
     _attenuationPerDoublingInDistance = DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE;
     _noiseMutingThreshold = DEFAULT_NOISE_MUTING_THRESHOLD;
+    _maxAudibleDistance = DEFAULT_MAX_AUDIBLE_DISTANCE;
+    _audibilityRadius = 0.0f;
     _codecPreferenceOrder.clear();
     _audioZones.clear();
     _zoneSettings.clear();
@@ -651,6 +671,16 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             }
         }
 
+        const QString MAX_AUDIBLE_DISTANCE = "max_audible_distance";
+        if (audioEnvGroupObject[MAX_AUDIBLE_DISTANCE].isString()) {
+            bool ok = false;
+            float maxAudibleDistance = audioEnvGroupObject[MAX_AUDIBLE_DISTANCE].toString().toFloat(&ok);
+            if (ok && maxAudibleDistance >= 0.0f) {
+                _maxAudibleDistance = maxAudibleDistance;
+                qCDebug(audio) << "Max audible distance changed to" << _maxAudibleDistance;
+            }
+        }
+
         const QString AUDIO_ZONES = "zones";
         if (audioEnvGroupObject[AUDIO_ZONES].isObject()) {
             const QJsonObject& zones = audioEnvGroupObject[AUDIO_ZONES].toObject();
@@ -757,6 +787,46 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             }
         }
     }
+
+    _audibilityRadius = computeAudibilityRadius();
+    if (_audibilityRadius > 0.0f) {
+        qCDebug(audio) << "Audibility radius:" << _audibilityRadius;
+    } else {
+        qCDebug(audio) << "Audibility radius: unbounded";
+    }
+}
+
+float AudioMixer::computeAudibilityRadius() {
+    // no stream can be farther away than the size of the domain
+    const float MAX_AUDIBILITY_RADIUS = (float)TREE_SCALE;
+
+    if (_maxAudibleDistance > 0.0f) {
+        return std::min(_maxAudibleDistance, MAX_AUDIBILITY_RADIUS);
+    }
+
+    // a stream is inaudible once a full-scale source at unity listener gain falls below the noise floor of a typical
+    // listening environment, about 60dB down (rather than one LSB of the mix, which no listener can hear over the
+    // room); domains whose listeners boost distant sources can set the max audible distance instead
+    const float LOG2_NOISE_FLOOR = -60.0f / 6.02059991f;
+
+    // find the weakest distance attenuation, see computeGain in AudioMixerSlave
+    float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
+    for (const ZoneSettings& settings : _zoneSettings) {
+        attenuationPerDoublingInDistance = std::min(attenuationPerDoublingInDistance, settings.coefficient);
+    }
+    float g = glm::clamp(1.0f - attenuationPerDoublingInDistance, EPSILON, 1.0f);
+
+    // gain = g^log2(distance), so solve log2(distance) * log2(g) = LOG2_NOISE_FLOOR
+    float log2G = log2f(g);
+    if (log2G >= 0.0f) {
+        // no attenuation
+        return 0.0f;
+    }
+    float log2Radius = LOG2_NOISE_FLOOR / log2G;
+    if (log2Radius >= log2f(MAX_AUDIBILITY_RADIUS)) {
+        return MAX_AUDIBILITY_RADIUS;
+    }
+    return exp2f(log2Radius);
 }
 
 AudioMixer::Timer::Timing::Timing(uint64_t& sum) : _sum(sum) {
@@ -21,7 +21,9 @@
 #include <plugins/Forward.h>
 
 #include "AudioMixerStats.h"
+#include "AudioMixerSharedMixes.h"
 #include "AudioMixerSlavePool.h"
+#include "AudioMixerSpatialIndex.h"
 
 class PositionalAudioStream;
 class AvatarAudioStream;
@@ -92,6 +94,9 @@ private:
     void parseSettingsObject(const QJsonObject& settingsObject);
     void clearDomainSettings();
 
+    // the distance beyond which no stream can be heard, or zero if unbounded
+    static float computeAudibilityRadius();
+
     float _trailingMixRatio { 0.0f };
     float _throttlingRatio { 0.0f };
 
@@ -101,6 +106,8 @@ private:
     AudioMixerStats _stats;
 
     AudioMixerSlavePool _slavePool;
+    AudioMixerSpatialIndex _spatialIndex;
+    AudioMixerSharedMixes _sharedMixes;
 
     class Timer {
     public:
@@ -134,6 +141,8 @@ private:
     static int _numStaticJitterFrames; // -1 denotes dynamic jitter buffering
     static float _noiseMutingThreshold;
     static float _attenuationPerDoublingInDistance;
+    static float _maxAudibleDistance; // zero derives the audibility radius from the attenuation
+    static float _audibilityRadius;
     static std::map<QString, CodecPluginPointer> _availableCodecs;
     static QStringList _codecPreferenceOrder;
     static QHash<QString, AABox> _audioZones;
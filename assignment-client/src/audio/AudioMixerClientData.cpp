@@ -236,6 +236,19 @@ void AudioMixerClientData::removeHRTFForStream(const QUuid& nodeID, const QUuid&
     }
 }
 
+void AudioMixerClientData::markNodeMixed(const QUuid& nodeID, unsigned int frame) {
+    auto& lastMixedFrame = _nodeSourcesLastMixedFrame[nodeID];
+    if (lastMixedFrame != 0 && lastMixedFrame + 1 != frame) {
+        auto it = _nodeSourcesHRTFMap.find(nodeID);
+        if (it != _nodeSourcesHRTFMap.end()) {
+            for (auto& hrtfPair : it->second) {
+                hrtfPair.second.reset();
+            }
+        }
+    }
+    lastMixedFrame = frame;
+}
+
 void AudioMixerClientData::removeAgentAvatarAudioStream() {
     QWriteLocker writeLocker { &_streamsLock };
     auto it = _audioStreams.find(QUuid());
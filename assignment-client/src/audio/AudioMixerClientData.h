@@ -56,8 +56,16 @@ public:
     // removes an AudioHRTF object for a given stream
     void removeHRTFForStream(const QUuid& nodeID, const QUuid& streamID = QUuid());
 
+    // marks the node as mixed this frame, resetting the HRTFs of its streams if it was skipped (e.g. culled) last frame,
+    // since they are missing the blocks in between
+    void markNodeMixed(const QUuid& nodeID, unsigned int frame);
+
     // remove all sources and data from this node
-    void removeNode(const QUuid& nodeID) { _nodeSourcesIgnoreMap.unsafe_erase(nodeID); _nodeSourcesHRTFMap.erase(nodeID); }
+    void removeNode(const QUuid& nodeID) {
+        _nodeSourcesIgnoreMap.unsafe_erase(nodeID);
+        _nodeSourcesHRTFMap.erase(nodeID);
+        _nodeSourcesLastMixedFrame.erase(nodeID);
+    }
 
     void removeAgentAvatarAudioStream();
 
@@ -87,6 +95,10 @@ public:
     float getMasterAvatarGain() const { return _masterAvatarGain; }
     void setMasterAvatarGain(float gain) { _masterAvatarGain = gain; }
 
+    // number of streams mixed for this listener in the last frame, used to balance the slave pool
+    int getMixCost() const { return _mixCost; }
+    void setMixCost(int mixCost) { _mixCost = mixCost; }
+
     AudioLimiter audioLimiter;
 
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
@@ -104,6 +116,7 @@ public:
     bool shouldFlushEncoder() { return _shouldFlushEncoder; }
 
     QString getCodecName() { return _selectedCodecName; }
+    CodecPluginPointer getCodec() const { return _codec; }
 
     bool shouldMuteClient() { return _shouldMuteClient; }
     void setShouldMuteClient(bool shouldMuteClient) { _shouldMuteClient = shouldMuteClient; }
@@ -172,6 +185,7 @@ private:
     using HRTFMap = std::unordered_map<QUuid, AudioHRTF>;
     using NodeSourcesHRTFMap = std::unordered_map<QUuid, HRTFMap>;
     NodeSourcesHRTFMap _nodeSourcesHRTFMap;
+    std::unordered_map<QUuid, unsigned int> _nodeSourcesLastMixedFrame;
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
@@ -181,6 +195,8 @@ private:
 
     float _masterAvatarGain { 1.0f };   // per-listener mixing gain, applied only to avatars
 
+    int _mixCost { 0 };
+
     CodecPluginPointer _codec;
     QString _selectedCodecName;
     Encoder* _encoder{ nullptr }; // for outbound mixed stream
@@ -0,0 +1,72 @@
+//
+//  AudioMixerSharedMixes.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerSharedMixes.h"
+
+#include <climits>
+#include <cmath>
+#include <tuple>
+
+// a quarter of a decibel is below what can be heard
+static const float GAIN_STEPS_PER_DB = 4.0f;
+
+bool AudioMixerSharedMixes::Key::operator<(const Key& other) const {
+    return std::tie(codecName, nodeID, streamID, gainStep) <
+        std::tie(other.codecName, other.nodeID, other.streamID, other.gainStep);
+}
+
+int AudioMixerSharedMixes::quantizeGain(float gain) {
+    if (gain <= 0.0f) {
+        return INT_MIN;
+    }
+    return (int)std::round(20.0f * std::log10(gain) * GAIN_STEPS_PER_DB);
+}
+
+float AudioMixerSharedMixes::dequantizeGain(int gainStep) {
+    if (gainStep == INT_MIN) {
+        return 0.0f;
+    }
+    return std::pow(10.0f, gainStep / (20.0f * GAIN_STEPS_PER_DB));
+}
+
+QByteArray AudioMixerSharedMixes::encode(const Key& key, unsigned int frame,
+        const std::function<void(QByteArray& payload)>& encodeMix) {
+    Group* group;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& groupPointer = _groups[key];
+        if (!groupPointer) {
+            groupPointer.reset(new Group(frame));
+        }
+        group = groupPointer.get();
+    }
+
+    // groups are only released between mixes, so the group can be used unlocked from the map
+    std::lock_guard<std::mutex> lock(group->mutex);
+    if (group->frame != frame) {
+        encodeMix(group->payload);
+        group->frame = frame;
+    }
+
+    // implicitly shared, so this does not copy the payload
+    return group->payload;
+}
+
+void AudioMixerSharedMixes::prune(unsigned int frame) {
+    // groups hold no codec or limiter state, so a group that comes back later starts over cleanly
+    auto it = _groups.begin();
+    while (it != _groups.end()) {
+        if (it->second->frame != frame) {
+            it = _groups.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+//
+//  AudioMixerSharedMixes.h
+//  assignment-client/src/audio
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSharedMixes_h
+#define hifi_AudioMixerSharedMixes_h
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <QByteArray>
+#include <QString>
+#include <QUuid>
+
+#include <plugins/CodecPlugin.h>
+
+// Mixes shared across listeners
+//   A listener whose mix is a single audible unspatialized stream (e.g. a stereo injector playing on a stage) hears
+//   exactly what every other listener with the same codec, stream, and gain hears. Those listeners form a group,
+//   and the group's mix is encoded once per frame.
+//   Only codecs that encode each frame on its own can be shared, so every listener keeps its own limiter and
+//   encoder going, and can leave its group at any frame without its decoder noticing.
+class AudioMixerSharedMixes {
+public:
+    struct Key {
+        QString codecName;
+        QUuid nodeID;
+        QUuid streamID;
+        int gainStep; // see quantizeGain
+
+        bool operator<(const Key& other) const;
+    };
+
+    static bool canShare(const CodecPluginPointer& codec) { return !codec || codec->hasStatelessEncoder(); }
+
+    // gains are shared in steps small enough not to be heard, so listeners at slightly different distances
+    // from a stream still share its mix
+    static int quantizeGain(float gain);
+    static float dequantizeGain(int gainStep);
+
+    // returns the encoded mix of the group for this frame
+    // the first listener of the group to ask encodes its limited samples with encodeMix, the others only copy the payload
+    // thread-safe
+    QByteArray encode(const Key& key, unsigned int frame, const std::function<void(QByteArray& payload)>& encodeMix);
+
+    // release the groups that were not mixed this frame
+    // not thread-safe, call between mixes
+    void prune(unsigned int frame);
+
+    int getNumGroups() const { return (int)_groups.size(); }
+
+private:
+    struct Group {
+        Group(unsigned int frame) : frame(frame - 1) {}
+
+        std::mutex mutex;
+        unsigned int frame; // of the current payload
+        QByteArray payload;
+    };
+
+    std::mutex _mutex;
+    std::map<Key, std::unique_ptr<Group>> _groups;
+};
+
+#endif // hifi_AudioMixerSharedMixes_h
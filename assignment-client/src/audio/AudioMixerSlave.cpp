@@ -25,6 +25,7 @@
 #include <plugins/PluginManager.h>
 #include <plugins/CodecPlugin.h>
 #include <udt/PacketHeaders.h>
+#include <udt/Socket.h>
 #include <SharedUtil.h>
 #include <StDev.h>
 #include <UUID.h>
@@ -32,12 +33,15 @@
 #include "AudioRingBuffer.h"
 #include "AudioMixer.h"
 #include "AudioMixerClientData.h"
+#include "AudioMixerSpatialIndex.h"
 #include "AvatarAudioStream.h"
 #include "InjectedAudioStream.h"
 #include "AudioHelpers.h"
 
 using AudioStreamMap = AudioMixerClientData::AudioStreamMap;
 
+static const int HRTF_DATASET_INDEX = 1;
+
 // packet helpers
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec);
 void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer);
@@ -60,11 +64,15 @@ void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     }
 }
 
-void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        const AudioMixerSpatialIndex* spatialIndex, AudioMixerSharedMixes* sharedMixes) {
     _begin = begin;
     _end = end;
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _spatialIndex = (spatialIndex && spatialIndex->isBounded()) ? spatialIndex : nullptr;
+    _sharedMixes = sharedMixes;
+    _numNodes = (int)std::distance(_begin, _end);
 }
 
 void AudioMixerSlave::mix(const SharedNodePointer& node) {
@@ -93,13 +101,24 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
     if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
         ++stats.sumListeners;
 
+        // the packets for this listener go out with the mixer's batch for the frame
+        udt::Socket::DatagramBatchScope batchScope;
+
         // mix the audio
         bool mixHasAudio = prepareMix(node);
 
         // send audio packet
         if (mixHasAudio || data->shouldFlushEncoder()) {
             QByteArray encodedBuffer;
-            if (mixHasAudio) {
+            if (mixHasAudio && _isMixShared) {
+                // encoded once for every listener hearing the same mix
+                encodedBuffer = _sharedMixes->encode(_sharedMixKey, _frame, [&](QByteArray& payload) {
+                    // the encoder is stateless, so it does not matter which listener's encoder makes the payload
+                    QByteArray decodedBuffer(reinterpret_cast<char*>(_bufferSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+                    data->encode(decodedBuffer, payload);
+                });
+                ++stats.sumListenersShared;
+            } else if (mixHasAudio) {
                 // encode the audio
                 QByteArray decodedBuffer(reinterpret_cast<char*>(_bufferSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
                 data->encode(decodedBuffer, encodedBuffer);
@@ -138,6 +157,12 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     // zero out the mix for this listener
     memset(_mixSamples, 0, sizeof(_mixSamples));
 
+    // count the streams mixed for this listener, to estimate its cost next frame
+    int mixesBefore = stats.totalMixes;
+    _numMixedStreams = 0;
+    _hasSharedMixKey = false;
+    _isMixShared = false;
+
     bool isThrottling = _throttlingRatio > 0.0f;
     std::vector<std::pair<float, SharedNodePointer>> throttledNodes;
 
@@ -155,7 +180,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     auto mixStart = p_high_resolution_clock::now();
 #endif
 
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
+    auto mixNode = [&](const SharedNodePointer& node) {
         AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
         if (!nodeData) {
             return;
@@ -170,6 +195,9 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                 }
             }
         } else if (!listenerData->shouldIgnore(listener, node, _frame)) {
+            // streams culled by the spatial index skip their silent HRTF renders, so they are faded in again
+            listenerData->markNodeMixed(node->getUUID(), _frame);
+
             if (!isThrottling) {
                 forAllStreams(node, nodeData, &AudioMixerSlave::mixStream);
             } else {
@@ -197,11 +225,34 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                 std::push_heap(throttledNodes.begin(), throttledNodes.end());
             }
         }
-    });
+    };
+
+    if (_spatialIndex) {
+        // only visit the nodes with a stream within the audibility radius of the listener,
+        // but always visit the listener itself, for its echo
+        mixNode(listener);
+
+        _spatialIndex->queryAudibleNodes(listenerAudioStream->getPosition(), _audibleNodes);
+        int numAudibleOtherNodes = 0;
+        for (int index : _audibleNodes) {
+            const SharedNodePointer& node = _spatialIndex->getNode(index);
+            if (*node != *listener) {
+                mixNode(node);
+                ++numAudibleOtherNodes;
+            }
+        }
+
+        // the listener itself is never culled, whether or not it was found by the query
+        bool isListenerIndexed = AudioMixerSpatialIndex::isIndexed(listenerData->getAudioStreams());
+        int numOtherNodes = _spatialIndex->getNumNodes() - (isListenerIndexed ? 1 : 0);
+        stats.culledNodes += numOtherNodes - numAudibleOtherNodes;
+    } else {
+        std::for_each(_begin, _end, mixNode);
+    }
 
     if (isThrottling) {
         // pop the loudest nodes off the heap and mix their streams
-        int numToRetain = (int)(std::distance(_begin, _end) * (1 - _throttlingRatio));
+        int numToRetain = (int)(_numNodes * (1 - _throttlingRatio));
         for (int i = 0; i < numToRetain; i++) {
             if (throttledNodes.empty()) {
                 break;
@@ -224,6 +275,11 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
     }
 
+    // render all spatialized sources for this listener in one pass
+    _hrtfBatch.render(_mixSamples, HRTF_DATASET_INDEX, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    listenerData->setMixCost(stats.totalMixes - mixesBefore);
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     auto mixEnd = p_high_resolution_clock::now();
     auto mixTime = std::chrono::duration_cast<std::chrono::nanoseconds>(mixEnd - mixStart);
@@ -241,8 +297,14 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     }
 
     // use the per listener AudioLimiter to render the mixed data
+    // (shared mixes go through it too, so it picks up smoothly when the mix stops being shared)
     listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
+    // a mix of a single audible unspatialized stream is identical for every listener with the same stream, gain,
+    // and codec, so it is encoded once for its group instead (see mix)
+    // the HRTF tails of silent and throttled streams are this listener's own, so any of them keeps the mix from being shared
+    _isMixShared = hasAudio && _hasSharedMixKey && _numMixedStreams == 1;
+
     return hasAudio;
 }
 
@@ -278,7 +340,6 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     float distance = glm::max(glm::length(relativePosition), EPSILON);
     float gain = computeGain(listenerNodeData, listeningNodeStream, streamToAdd, relativePosition, distance, isEcho);
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
-    const int HRTF_DATASET_INDEX = 1;
 
     if (!streamToAdd.lastPopSucceeded()) {
         bool forceSilentBlock = true;
@@ -309,6 +370,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
                 static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
                 hrtf.renderSilent(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
                                   AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+                ++_numMixedStreams;
 
                 ++stats.hrtfSilentRenders;
             }
@@ -327,6 +389,19 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
         gain *= hrtf.getGainAdjustment();
 
+        if (streamToAdd.getLastPopOutputLoudness() > 0.0f && gain > 0.0f) {
+            ++_numMixedStreams;
+
+            // remember the stream, in case it is all that this listener hears
+            // its gain is rounded so that listeners at about the same distance hear exactly the same mix
+            if (_sharedMixes && AudioMixerSharedMixes::canShare(listenerNodeData.getCodec())) {
+                int gainStep = AudioMixerSharedMixes::quantizeGain(gain);
+                gain = AudioMixerSharedMixes::dequantizeGain(gainStep);
+                _sharedMixKey = { listenerNodeData.getCodecName(), sourceNodeID, streamToAdd.getStreamIdentifier(), gainStep };
+                _hasSharedMixKey = true;
+            }
+        }
+
         const float scale = 1/32768.0f; // int16_t to float
 
         for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
@@ -340,6 +415,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
 
     // echo sources are not passed through HRTF
     if (isEcho) {
+        ++_numMixedStreams;
 
         const float scale = 1/32768.0f; // int16_t to float
 
@@ -362,6 +438,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         // call renderSilent to reduce artifacts
         hrtf.renderSilent(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        ++_numMixedStreams;
 
         ++stats.hrtfSilentRenders;
         return;
@@ -371,6 +448,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         // call renderSilent with actual frame data and a gain of 0.0f to reduce artifacts
         hrtf.renderSilent(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, 0.0f,
                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        ++_numMixedStreams;
 
         ++stats.hrtfThrottleRenders;
         return;
@@ -381,8 +459,9 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         hrtf.setGainAdjustment(listenerNodeData.hrtfForStream(sourceNodeID, QUuid()).getGainAdjustment());
     }
 
-    hrtf.render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    // rendered with the other sources for this listener, at the end of prepareMix
+    _hrtfBatch.add(hrtf, _bufferSamples, azimuth, distance, gain);
+    ++_numMixedStreams;
 
     ++stats.hrtfRenders;
 }
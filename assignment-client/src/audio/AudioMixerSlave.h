@@ -19,12 +19,14 @@
 #include <UUIDHasher.h>
 #include <NodeList.h>
 
+#include "AudioMixerSharedMixes.h"
 #include "AudioMixerStats.h"
 
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioHRTF;
 class AudioMixerClientData;
+class AudioMixerSpatialIndex;
 
 class AudioMixerSlave {
 public:
@@ -34,7 +36,10 @@ public:
     void processPackets(const SharedNodePointer& node);
 
     // configure a round of mixing
-    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    //   if given, the spatial index limits each listener to the nodes within its audibility radius,
+    //   and the shared mixes encode identical mixes once for all of their listeners
+    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            const AudioMixerSpatialIndex* spatialIndex = nullptr, AudioMixerSharedMixes* sharedMixes = nullptr);
 
     // mix and broadcast non-ignored streams to the node (requires configuration using configureMix, above)
     // returns true if a mixed packet was sent to the node
@@ -57,11 +62,28 @@ private:
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    // audible nodes for the current listener, as indices into the spatial index
+    std::vector<int> _audibleNodes;
+
+    // streams that wrote into the current mix, including the HRTF tails of silent and throttled streams
+    int _numMixedStreams { 0 };
+
+    // the unspatialized stream of the current mix, if the mix can be shared with other listeners
+    AudioMixerSharedMixes::Key _sharedMixKey;
+    bool _hasSharedMixKey { false };
+    bool _isMixShared { false };
+
+    // spatialized sources for the current listener, rendered together at the end of prepareMix
+    AudioHRTFBatch _hrtfBatch;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    const AudioMixerSpatialIndex* _spatialIndex { nullptr };
+    AudioMixerSharedMixes* _sharedMixes { nullptr };
+    int _numNodes { 0 };
 };
 
 #endif // hifi_AudioMixerSlave_h
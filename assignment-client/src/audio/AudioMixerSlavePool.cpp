@@ -13,6 +13,25 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "AudioMixerClientData.h"
+
+// slaves spin for this long before parking, since runs often follow each other closely
+static const auto SLAVE_SPIN_DURATION = std::chrono::microseconds(200);
+
+static inline uint64_t packRange(uint32_t begin, uint32_t end) {
+    return ((uint64_t)begin << 32) | (uint64_t)end;
+}
+
+static inline uint32_t rangeBegin(uint64_t range) {
+    return (uint32_t)(range >> 32);
+}
+
+static inline uint32_t rangeEnd(uint64_t range) {
+    return (uint32_t)(range & 0xffffffff);
+}
 
 void AudioMixerSlaveThread::run() {
     while (true) {
@@ -33,14 +52,23 @@ void AudioMixerSlaveThread::run() {
 }
 
 void AudioMixerSlaveThread::wait() {
-    {
+    // spin, then park
+    auto spinEnd = std::chrono::steady_clock::now() + SLAVE_SPIN_DURATION;
+    while (_pool._generation.load(std::memory_order_acquire) == _generation) {
+        if (std::chrono::steady_clock::now() < spinEnd) {
+            std::this_thread::yield();
+            continue;
+        }
+
         Lock lock(_pool._mutex);
+        ++_pool._numParked;
         _pool._slaveCondition.wait(lock, [&] {
-            assert(_pool._numStarted <= _pool._numThreads);
-            return _pool._numStarted != _pool._numThreads;
+            return _pool._generation.load(std::memory_order_acquire) != _generation;
         });
-        ++_pool._numStarted;
+        --_pool._numParked;
     }
+    ++_generation;
+    assert(_generation == _pool._generation.load());
 
     if (_pool._configure) {
         _pool._configure(*this);
@@ -49,19 +77,34 @@ void AudioMixerSlaveThread::wait() {
 }
 
 void AudioMixerSlaveThread::notify(bool stopping) {
-    {
+    if (stopping) {
         Lock lock(_pool._mutex);
-        assert(_pool._numFinished < _pool._numThreads);
-        ++_pool._numFinished;
-        if (stopping) {
-            ++_pool._numStopped;
-        }
+        ++_pool._numStopped;
+    }
+
+    int numFinished = ++_pool._numFinished;
+    assert(numFinished <= _pool._numThreads);
+    if (numFinished == _pool._numThreads) {
+        // the lock orders this notification after the pool starts waiting
+        Lock lock(_pool._mutex);
+        _pool._poolCondition.notify_one();
     }
-    _pool._poolCondition.notify_one();
 }
 
 bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
+    if (_pool.popFront(_index, node)) {
+        return true;
+    }
+
+    // steal the cheapest remaining work from the other slaves
+    for (int i = 1; i < _pool._numThreads; ++i) {
+        int victim = (_index + i) % _pool._numThreads;
+        if (_pool.popBack(victim, node)) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 #ifdef AUDIO_SINGLE_THREADED
@@ -71,21 +114,24 @@ static AudioMixerSlave slave;
 void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
     _function = &AudioMixerSlave::processPackets;
     _configure = [](AudioMixerSlave& slave) {};
-    run(begin, end);
+    run(begin, end, false);
 }
 
-void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        const AudioMixerSpatialIndex* spatialIndex, AudioMixerSharedMixes* sharedMixes) {
     _function = &AudioMixerSlave::mix;
     _configure = [=](AudioMixerSlave& slave) {
-        slave.configureMix(_begin, _end, _frame, _throttlingRatio);
+        slave.configureMix(_begin, _end, _frame, _throttlingRatio, _spatialIndex, _sharedMixes);
     };
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _spatialIndex = spatialIndex;
+    _sharedMixes = sharedMixes;
 
-    run(begin, end);
+    run(begin, end, true);
 }
 
-void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
+void AudioMixerSlavePool::run(ConstIter begin, ConstIter end, bool useMixCost) {
     _begin = begin;
     _end = end;
 
@@ -95,33 +141,114 @@ void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
         _function(slave, node);
     });
 #else
-    // fill the queue
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-#if defined(__clang__) && defined(Q_OS_LINUX)
-        _queue.push(node);
-#else
-        _queue.emplace(node);
+    partition(_begin, _end, useMixCost);
+    runSlaves();
+
+    _work.clear();
 #endif
+}
+
+void AudioMixerSlavePool::partition(ConstIter begin, ConstIter end, bool useMixCost) {
+    // estimate the cost of each node
+    _sorted.clear();
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        // every node costs something, even if it was not mixed last frame
+        int cost = 1;
+        if (useMixCost) {
+            auto data = static_cast<AudioMixerClientData*>(node->getLinkedData());
+            if (data) {
+                cost += data->getMixCost();
+            }
+        }
+        _sorted.push_back({ cost, node });
     });
 
-    {
-        Lock lock(_mutex);
+    // most expensive first
+    std::sort(_sorted.begin(), _sorted.end(), [](const std::pair<int, SharedNodePointer>& a,
+            const std::pair<int, SharedNodePointer>& b) {
+        return a.first > b.first;
+    });
+
+    // greedily assign each node to the least loaded slave
+    _loads.assign(_numThreads, 0);
+    _counts.assign(_numThreads, 0);
+    _owners.resize(_sorted.size());
+    for (size_t i = 0; i < _sorted.size(); ++i) {
+        int owner = (int)std::distance(_loads.begin(), std::min_element(_loads.begin(), _loads.end()));
+        _loads[owner] += _sorted[i].first;
+        ++_counts[owner];
+        _owners[i] = owner;
+    }
+
+    // lay out the ranges contiguously, keeping each range sorted by cost
+    uint32_t offset = 0;
+    for (int i = 0; i < _numThreads; ++i) {
+        uint32_t count = (uint32_t)_counts[i];
+        _ranges[i].range.store(packRange(offset, offset), std::memory_order_relaxed);
+        _counts[i] = offset;
+        offset += count;
+    }
+
+    _work.resize(_sorted.size());
+    for (size_t i = 0; i < _sorted.size(); ++i) {
+        int owner = _owners[i];
+        _work[_counts[owner]++] = std::move(_sorted[i].second);
+    }
+
+    for (int i = 0; i < _numThreads; ++i) {
+        uint64_t range = _ranges[i].range.load(std::memory_order_relaxed);
+        _ranges[i].range.store(packRange(rangeBegin(range), (uint32_t)_counts[i]), std::memory_order_relaxed);
+    }
+}
+
+void AudioMixerSlavePool::runSlaves() {
+    _numFinished = 0;
 
-        // run
-        _numStarted = _numFinished = 0;
+    // start the run (the increment releases the work ranges to the slaves)
+    _generation.fetch_add(1, std::memory_order_seq_cst);
+    if (_numParked.load(std::memory_order_seq_cst) > 0) {
+        Lock lock(_mutex);
         _slaveCondition.notify_all();
+    }
 
-        // wait
-        _poolCondition.wait(lock, [&] {
-            assert(_numFinished <= _numThreads);
-            return _numFinished == _numThreads;
-        });
+    // wait
+    Lock lock(_mutex);
+    _poolCondition.wait(lock, [&] {
+        assert(_numFinished <= _numThreads);
+        return _numFinished == _numThreads;
+    });
+}
 
-        assert(_numStarted == _numThreads);
+bool AudioMixerSlavePool::popFront(int index, SharedNodePointer& node) {
+    auto& range = _ranges[index].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t begin = rangeBegin(current);
+        uint32_t end = rangeEnd(current);
+        if (begin >= end) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, packRange(begin + 1, end), std::memory_order_acq_rel)) {
+            node = _work[begin];
+            return true;
+        }
     }
+}
 
-    assert(_queue.empty());
-#endif
+bool AudioMixerSlavePool::popBack(int index, SharedNodePointer& node) {
+    auto& range = _ranges[index].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t begin = rangeBegin(current);
+        uint32_t end = rangeEnd(current);
+        if (begin >= end) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, packRange(begin, end - 1), std::memory_order_acq_rel)) {
+            node = _work[end - 1];
+            return true;
+        }
+    }
 }
 
 void AudioMixerSlavePool::each(std::function<void(AudioMixerSlave& slave)> functor) {
@@ -162,16 +289,7 @@ void AudioMixerSlavePool::resize(int numThreads) {
 #else
     qDebug("%s: set %d threads (was %d)", __FUNCTION__, numThreads, _numThreads);
 
-    Lock lock(_mutex);
-
-    if (numThreads > _numThreads) {
-        // start new slaves
-        for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AudioMixerSlaveThread(*this);
-            slave->start();
-            _slaves.emplace_back(slave);
-        }
-    } else if (numThreads < _numThreads) {
+    if (numThreads < _numThreads) {
         auto extraBegin = _slaves.begin() + numThreads;
 
         // mark slaves to stop...
@@ -181,16 +299,18 @@ void AudioMixerSlavePool::resize(int numThreads) {
             ++slave;
         }
 
-        // ...cycle them until they do stop...
-        _numStopped = 0;
-        while (_numStopped != (_numThreads - numThreads)) {
-            _numStarted = _numFinished = _numStopped;
-            _slaveCondition.notify_all();
-            _poolCondition.wait(lock, [&] {
-                assert(_numFinished <= _numThreads);
-                return _numFinished == _numThreads;
-            });
+        // ...cycle them with no work until they do stop...
+        for (int i = 0; i < _numThreads; ++i) {
+            _ranges[i].range.store(packRange(0, 0), std::memory_order_relaxed);
         }
+        {
+            Lock lock(_mutex);
+            _numStopped = 0;
+        }
+        _function = nullptr;
+        _configure = nullptr;
+        runSlaves();
+        assert(_numStopped == _numThreads - numThreads);
 
         // ...wait for threads to finish...
         slave = extraBegin;
@@ -205,7 +325,19 @@ void AudioMixerSlavePool::resize(int numThreads) {
         _slaves.erase(extraBegin, _slaves.end());
     }
 
-    _numThreads = _numStarted = _numFinished = numThreads;
+    // slaves only touch the work ranges during a run, so they can be reallocated here
+    _ranges.reset(numThreads > 0 ? new WorkRange[numThreads] : nullptr);
+
+    if (numThreads > _numThreads) {
+        // start new slaves
+        for (int i = _numThreads; i < numThreads; ++i) {
+            auto slave = new AudioMixerSlaveThread(*this, i, _generation.load());
+            slave->start();
+            _slaves.emplace_back(slave);
+        }
+    }
+
+    _numThreads = numThreads;
     assert(_numThreads == (int)_slaves.size());
 #endif
 }
@@ -12,14 +12,14 @@
 #ifndef hifi_AudioMixerSlavePool_h
 #define hifi_AudioMixerSlavePool_h
 
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 #include <QThread>
 
-#include <TBBHelpers.h>
-
 #include "AudioMixerSlave.h"
 
 class AudioMixerSlavePool;
@@ -31,7 +31,8 @@ class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    AudioMixerSlaveThread(AudioMixerSlavePool& pool) : _pool(pool) {}
+    AudioMixerSlaveThread(AudioMixerSlavePool& pool, int index, unsigned int generation) :
+        _pool(pool), _index(index), _generation(generation) {}
 
     void run() override final;
 
@@ -45,12 +46,17 @@ private:
     AudioMixerSlavePool& _pool;
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
     bool _stop { false };
+    int _index; // of this slave's work range in the pool
+    unsigned int _generation; // of the last run started by this slave
 };
 
 // Slave pool for audio mixers
 //   AudioMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
+//
+//   Each run, nodes are partitioned across slaves by their estimated cost (streams mixed last frame).
+//   Slaves pop from the front of their own range (most expensive first) and, once it is empty,
+//   steal from the back of the other slaves' ranges.
 class AudioMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     using ConditionVariable = std::condition_variable;
@@ -65,7 +71,8 @@ public:
     void processPackets(ConstIter begin, ConstIter end);
 
     // mix on slave threads
-    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            const AudioMixerSpatialIndex* spatialIndex = nullptr, AudioMixerSharedMixes* sharedMixes = nullptr);
 
     // iterate over all slaves
     void each(std::function<void(AudioMixerSlave& slave)> functor);
@@ -74,9 +81,19 @@ public:
     int numThreads() { return _numThreads; }
 
 private:
-    void run(ConstIter begin, ConstIter end);
+    void run(ConstIter begin, ConstIter end, bool useMixCost);
     void resize(int numThreads);
 
+    // partition nodes into per-slave ranges of _work
+    void partition(ConstIter begin, ConstIter end, bool useMixCost);
+
+    // start a run on all slaves, and wait for it to finish
+    void runSlaves();
+
+    // pop work from a slave's range
+    bool popFront(int index, SharedNodePointer& node);
+    bool popBack(int index, SharedNodePointer& node);
+
     std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
 
     friend void AudioMixerSlaveThread::wait();
@@ -90,14 +107,30 @@ private:
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node);
     std::function<void(AudioMixerSlave&)> _configure;
     int _numThreads { 0 };
-    int _numStarted { 0 }; // guarded by _mutex
-    int _numFinished { 0 }; // guarded by _mutex
+    std::atomic<unsigned int> _generation { 0 }; // incremented to start a run
+    std::atomic<int> _numParked { 0 }; // slaves waiting on _slaveCondition
+    std::atomic<int> _numFinished { 0 };
     int _numStopped { 0 }; // guarded by _mutex
 
+    // per-slave work ranges into _work, packed as (begin << 32) | end,
+    // so that the owner (popping the front) and thieves (popping the back) race on a single word
+    struct alignas(64) WorkRange {
+        std::atomic<uint64_t> range { 0 };
+    };
+    std::unique_ptr<WorkRange[]> _ranges;
+    std::vector<SharedNodePointer> _work;
+
+    // partitioning scratch, kept to avoid reallocating every frame
+    std::vector<std::pair<int, SharedNodePointer>> _sorted;
+    std::vector<int> _owners;
+    std::vector<int64_t> _loads;
+    std::vector<int> _counts;
+
     // frame state
-    Queue _queue;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    const AudioMixerSpatialIndex* _spatialIndex { nullptr };
+    AudioMixerSharedMixes* _sharedMixes { nullptr };
     ConstIter _begin;
     ConstIter _end;
 };
@@ -0,0 +1,78 @@
+//
+//  AudioMixerSpatialIndex.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerSpatialIndex.h"
+
+#include <assert.h>
+#include <algorithm>
+
+void AudioMixerSpatialIndex::build(ConstIter begin, ConstIter end, float audibilityRadius) {
+    clear();
+
+    _audibilityRadius = std::max(audibilityRadius, 0.0f);
+    if (!isBounded()) {
+        return;
+    }
+
+    // a cell the size of the radius bounds each query to a few cells
+    _grid.setCellSize(_audibilityRadius);
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        AudioMixerClientData* data = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!data) {
+            return;
+        }
+
+        auto streams = data->getAudioStreams();
+        if (!isIndexed(streams)) {
+            return;
+        }
+
+        int index = (int)_nodes.size();
+        for (auto& streamPair : streams) {
+            auto stream = streamPair.second;
+            if (stream->hasValidPosition()) {
+                _grid.insert(stream->getPosition(), index);
+            }
+        }
+        _nodes.push_back(node);
+    });
+
+    _grid.build();
+}
+
+bool AudioMixerSpatialIndex::isIndexed(const AudioMixerClientData::AudioStreamMap& streams) {
+    // streams without a valid position are never mixed
+    for (auto& streamPair : streams) {
+        if (streamPair.second->hasValidPosition()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AudioMixerSpatialIndex::clear() {
+    _grid.clear();
+    _nodes.clear();
+    _audibilityRadius = 0.0f;
+}
+
+void AudioMixerSpatialIndex::queryAudibleNodes(const glm::vec3& position, std::vector<int>& indices) const {
+    assert(isBounded());
+
+    indices.clear();
+    _grid.queryRadius(position, _audibilityRadius, [&](const int& index, const glm::vec3&) {
+        indices.push_back(index);
+    });
+
+    // a node with several streams (e.g. injectors) may be found more than once
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
@@ -0,0 +1,54 @@
+//
+//  AudioMixerSpatialIndex.h
+//  assignment-client/src/audio
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSpatialIndex_h
+#define hifi_AudioMixerSpatialIndex_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <NodeList.h>
+#include <SpatialHashGrid.h>
+
+#include "AudioMixerClientData.h"
+
+// Spatial index of audio stream positions
+//   AudioMixerSpatialIndex is built once per frame, by the mixer, and then queried read-only by the slaves,
+//   so that each listener only visits the nodes with a stream within the audibility radius.
+class AudioMixerSpatialIndex {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    // index the streams of the nodes in [begin, end)
+    // a radius of zero (or less) leaves the index unbounded, and every node is audible to every listener
+    void build(ConstIter begin, ConstIter end, float audibilityRadius);
+    void clear();
+
+    bool isBounded() const { return _audibilityRadius > 0.0f; }
+    float getAudibilityRadius() const { return _audibilityRadius; }
+
+    // fills indices with the (unique, sorted) indices of nodes with a stream audible at position
+    // requires a bounded index
+    void queryAudibleNodes(const glm::vec3& position, std::vector<int>& indices) const;
+
+    const SharedNodePointer& getNode(int index) const { return _nodes[index]; }
+    int getNumNodes() const { return (int)_nodes.size(); }
+
+    // whether build indexes a node with these streams, i.e. one of them has a valid position
+    static bool isIndexed(const AudioMixerClientData::AudioStreamMap& streams);
+
+private:
+    SpatialHashGrid<int> _grid;
+    std::vector<SharedNodePointer> _nodes;
+    float _audibilityRadius { 0.0f };
+};
+
+#endif // hifi_AudioMixerSpatialIndex_h
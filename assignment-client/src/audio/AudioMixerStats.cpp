@@ -15,7 +15,9 @@ void AudioMixerStats::reset() {
     sumStreams = 0;
     sumListeners = 0;
     sumListenersSilent = 0;
+    sumListenersShared = 0;
     totalMixes = 0;
+    culledNodes = 0;
     hrtfRenders = 0;
     hrtfSilentRenders = 0;
     hrtfThrottleRenders = 0;
@@ -30,7 +32,9 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     sumStreams += otherStats.sumStreams;
     sumListeners += otherStats.sumListeners;
     sumListenersSilent += otherStats.sumListenersSilent;
+    sumListenersShared += otherStats.sumListenersShared;
     totalMixes += otherStats.totalMixes;
+    culledNodes += otherStats.culledNodes;
     hrtfRenders += otherStats.hrtfRenders;
     hrtfSilentRenders += otherStats.hrtfSilentRenders;
     hrtfThrottleRenders += otherStats.hrtfThrottleRenders;
@@ -20,8 +20,10 @@ struct AudioMixerStats {
     int sumStreams { 0 };
     int sumListeners { 0 };
     int sumListenersSilent { 0 };
+    int sumListenersShared { 0 };
 
     int totalMixes { 0 };
+    int culledNodes { 0 }; // other nodes outside the audibility radius of a listener
 
     int hrtfRenders { 0 };
     int hrtfSilentRenders { 0 };
@@ -215,6 +215,9 @@ void AvatarMixer::start() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
+    // every viewer is sent avatar data each frame, so send it together
+    nodeList->setDatagramBatchingEnabled(true);
+
     unsigned int frame = 1;
     auto frameTimestamp = p_high_resolution_clock::now();
 
@@ -261,7 +264,15 @@ void AvatarMixer::start() {
             auto start = usecTimestampNow();
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
                 auto start = usecTimestampNow();
-                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
+
+                // index the avatars once, to be shared by the slaves
+                _spatialIndex.build(cbegin, cend, frame);
+                nodeList->beginDatagramBatch();
+                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio,
+                    &_spatialIndex);
+                nodeList->flushDatagramBatch();
+                _spatialIndex.clear();
+
                 auto end = usecTimestampNow();
                 _broadcastAvatarDataInner += (end - start);
             }, &lockWait, &nodeTransform, &functor);
@@ -774,6 +785,9 @@ void AvatarMixer::sendStatsPacket() {
         float averageOverBudgetAvatars = averageNodes ? stats.overBudgetAvatars / averageNodes : 0.0f;
         slaveObject["sent_7_averageOverBudgetAvatars"] = TIGHT_LOOP_STAT(averageOverBudgetAvatars);
 
+        float averageOthersCulled = averageNodes ? stats.numOthersCulled / averageNodes : 0.0f;
+        slaveObject["sent_8_averageOthersCulled"] = TIGHT_LOOP_STAT(averageOthersCulled);
+
         slaveObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(stats.processIncomingPacketsElapsedTime);
         slaveObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(stats.ignoreCalculationElapsedTime);
         slaveObject["timing_3_toByteArray"] = TIGHT_LOOP_STAT_UINT64(stats.toByteArrayElapsedTime);
@@ -807,6 +821,9 @@ void AvatarMixer::sendStatsPacket() {
     float averageOverBudgetAvatars = averageNodes ? aggregateStats.overBudgetAvatars / averageNodes : 0.0f;
     slavesAggregatObject["sent_7_averageOverBudgetAvatars"] = TIGHT_LOOP_STAT(averageOverBudgetAvatars);
 
+    float averageOthersCulled = averageNodes ? aggregateStats.numOthersCulled / averageNodes : 0.0f;
+    slavesAggregatObject["sent_8_averageOthersCulled"] = TIGHT_LOOP_STAT(averageOthersCulled);
+
     slavesAggregatObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.processIncomingPacketsElapsedTime);
     slavesAggregatObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.ignoreCalculationElapsedTime);
     slavesAggregatObject["timing_3_toByteArray"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.toByteArrayElapsedTime);
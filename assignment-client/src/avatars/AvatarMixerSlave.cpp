@@ -12,6 +12,7 @@
 #include "AvatarMixerSlave.h"
 
 #include <algorithm>
+#include <numeric>
 #include <random>
 
 #include <glm/glm.hpp>
@@ -26,12 +27,14 @@
 #include <OctreeConstants.h>
 #include <PrioritySortUtil.h>
 #include <udt/PacketHeaders.h>
+#include <udt/Socket.h>
 #include <SharedUtil.h>
 #include <StDev.h>
 #include <UUID.h>
 
 #include "AvatarMixer.h"
 #include "AvatarMixerClientData.h"
+#include "AvatarMixerSpatialIndex.h"
 
 void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
     _begin = begin;
@@ -40,12 +43,14 @@ void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
 
 void AvatarMixerSlave::configureBroadcast(ConstIter begin, ConstIter end, 
                                 p_high_resolution_clock::time_point lastFrameTimestamp,
-                                float maxKbpsPerNode, float throttlingRatio) {
+                                float maxKbpsPerNode, float throttlingRatio,
+                                const AvatarMixerSpatialIndex* spatialIndex) {
     _begin = begin;
     _end = end;
     _lastFrameTimestamp = lastFrameTimestamp;
     _maxKbpsPerNode = maxKbpsPerNode;
     _throttlingRatio = throttlingRatio;
+    _spatialIndex = spatialIndex;
 }
 
 void AvatarMixerSlave::harvestStats(AvatarMixerSlaveStats& stats) {
@@ -59,7 +64,13 @@ void AvatarMixerSlave::processIncomingPackets(const SharedNodePointer& node) {
     auto nodeData = dynamic_cast<AvatarMixerClientData*>(node->getLinkedData());
     if (nodeData) {
         _stats.nodesProcessed++;
-        _stats.packetsProcessed += nodeData->processPackets();
+        int packetsProcessed = nodeData->processPackets();
+        _stats.packetsProcessed += packetsProcessed;
+
+        // quantize the avatar once, for every viewer it will be broadcast to
+        if (packetsProcessed > 0) {
+            nodeData->getAvatar().encodeSections();
+        }
     }
     auto end = usecTimestampNow();
     _stats.processIncomingPacketsElapsedTime += (end - start);
@@ -98,6 +109,9 @@ static const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 45;
 void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
     quint64 start = usecTimestampNow();
 
+    // the packets for this node go out with the mixer's batch for the frame
+    udt::Socket::DatagramBatchScope batchScope;
+
     if (node->getType() == NodeType::Agent && node->getLinkedData() && node->getActiveSocket() && !node->isUpstream()) {
         broadcastAvatarDataToAgent(node);
     } else if (node->getType() == NodeType::DownstreamAvatarMixer) {
@@ -183,29 +197,24 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
     nodeBox.embiggen(4.0f);
 
 
-    // setup list of AvatarData as well as maps to map betweeen the AvatarData and the original nodes
-    std::vector<AvatarSharedPointer> avatarsToSort;
-    std::unordered_map<AvatarSharedPointer, SharedNodePointer> avatarDataToNodes;
-    std::unordered_map<QUuid, uint64_t> avatarEncodeTimes;
-    std::for_each(_begin, _end, [&](const SharedNodePointer& otherNode) {
-        // make sure this is an agent that we have avatar data for before considering it for inclusion
-        if (otherNode->getType() == NodeType::Agent
-            && otherNode->getLinkedData()) {
-            const AvatarMixerClientData* otherNodeData = reinterpret_cast<const AvatarMixerClientData*>(otherNode->getLinkedData());
-
-            AvatarSharedPointer otherAvatar = otherNodeData->getAvatarSharedPointer();
-            avatarsToSort.push_back(otherAvatar);
-            avatarDataToNodes[otherAvatar] = otherNode;
-            QUuid id = otherAvatar->getSessionUUID();
-            avatarEncodeTimes[id] = nodeData->getLastOtherAvatarEncodeTime(id);
-        }
-    });
+    // the agents we have avatar data for, indexed by the mixer for this frame
+    const auto& avatarEntries = _spatialIndex->getEntries();
+
+    // gather the avatars of interest to this node, or all of them if the PAL needs them
+    const auto& cameraViews = nodeData->getViewFrustums();
+    if (_spatialIndex->isCulling() && !PALIsOpen) {
+        _spatialIndex->queryInterest(myPosition, cameraViews, _avatarsToSort);
+        _stats.numOthersCulled += (int)(avatarEntries.size() - _avatarsToSort.size());
+    } else {
+        _avatarsToSort.resize(avatarEntries.size());
+        std::iota(_avatarsToSort.begin(), _avatarsToSort.end(), 0);
+    }
 
     class SortableAvatar: public PrioritySortUtil::Sortable {
     public:
         SortableAvatar() = delete;
-        SortableAvatar(const AvatarSharedPointer& avatar, uint64_t lastEncodeTime)
-            : _avatar(avatar), _lastEncodeTime(lastEncodeTime) {}
+        SortableAvatar(const AvatarSharedPointer& avatar, const SharedNodePointer& node, uint64_t lastEncodeTime)
+            : _avatar(avatar), _node(node), _lastEncodeTime(lastEncodeTime) {}
         glm::vec3 getPosition() const override { return _avatar->getWorldPosition(); }
         float getRadius() const override {
             glm::vec3 nodeBoxHalfScale = (_avatar->getWorldPosition() - _avatar->getGlobalBoundingBoxCorner() * _avatar->getSensorToWorldScale());
@@ -215,14 +224,15 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             return _lastEncodeTime;
         }
         AvatarSharedPointer getAvatar() const { return _avatar; }
+        SharedNodePointer getNode() const { return _node; }
 
     private:
         AvatarSharedPointer _avatar;
+        SharedNodePointer _node;
         uint64_t _lastEncodeTime;
     };
 
     // prepare to sort
-    const auto& cameraViews = nodeData->getViewFrustums();
     PrioritySortUtil::PriorityQueue<SortableAvatar> sortedAvatars(cameraViews,
             AvatarData::_avatarSortCoefficientSize,
             AvatarData::_avatarSortCoefficientCenter,
@@ -230,7 +240,8 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
     // ignore or sort
     const AvatarSharedPointer& thisAvatar = nodeData->getAvatarSharedPointer();
-    for (const auto& avatar : avatarsToSort) {
+    for (int index : _avatarsToSort) {
+        const AvatarSharedPointer& avatar = avatarEntries[index].avatar;
         if (avatar == thisAvatar) {
             // don't echo updates to self
             continue;
@@ -243,8 +254,8 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
         //      happen if for example the avatar is connected on a desktop and sending
         //      updates at ~30hz. So every 3 frames we skip a frame.
 
-        auto avatarNode = avatarDataToNodes[avatar];
-        assert(avatarNode); // we can't have gotten here without the avatarData being a valid key in the map
+        const SharedNodePointer& avatarNode = avatarEntries[index].node;
+        assert(avatarNode);
 
         const AvatarMixerClientData* avatarNodeData = reinterpret_cast<const AvatarMixerClientData*>(avatarNode->getLinkedData());
         assert(avatarNodeData); // we can't have gotten here without avatarNode having valid data
@@ -314,12 +325,8 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
         if (!shouldIgnore) {
             // sort this one for later
-            uint64_t lastEncodeTime = 0;
-            std::unordered_map<QUuid, uint64_t>::const_iterator itr = avatarEncodeTimes.find(avatar->getSessionUUID());
-            if (itr != avatarEncodeTimes.end()) {
-                lastEncodeTime = itr->second;
-            }
-            sortedAvatars.push(SortableAvatar(avatar, lastEncodeTime));
+            uint64_t lastEncodeTime = nodeData->getLastOtherAvatarEncodeTime(avatar->getSessionUUID());
+            sortedAvatars.push(SortableAvatar(avatar, avatarNode, lastEncodeTime));
         }
     }
 
@@ -327,12 +334,11 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
     int remainingAvatars = (int)sortedAvatars.size();
     while (!sortedAvatars.empty()) {
-        const auto avatarData = sortedAvatars.top().getAvatar();
+        auto otherNode = sortedAvatars.top().getNode();
         sortedAvatars.pop();
         remainingAvatars--;
 
-        auto otherNode = avatarDataToNodes[avatarData];
-        assert(otherNode); // we can't have gotten here without the avatarData being a valid key in the map
+        assert(otherNode);
 
         // NOTE: Here's where we determine if we are over budget and drop to bare minimum data
         int minimRemainingAvatarBytes = minimumBytesPerAvatar * remainingAvatars;
@@ -15,6 +15,7 @@
 #include <NodeList.h>
 
 class AvatarMixerClientData;
+class AvatarMixerSpatialIndex;
 
 class AvatarMixerSlaveStats {
 public:
@@ -29,6 +30,7 @@ public:
     int numIdentityPackets { 0 };
     int numOthersIncluded { 0 };
     int overBudgetAvatars { 0 };
+    int numOthersCulled { 0 };
 
     quint64 ignoreCalculationElapsedTime { 0 };
     quint64 avatarDataPackingElapsedTime { 0 };
@@ -50,6 +52,7 @@ public:
         numIdentityPackets = 0;
         numOthersIncluded = 0;
         overBudgetAvatars = 0;
+        numOthersCulled = 0;
 
         ignoreCalculationElapsedTime = 0;
         avatarDataPackingElapsedTime = 0;
@@ -70,6 +73,7 @@ public:
         numIdentityPackets += rhs.numIdentityPackets;
         numOthersIncluded += rhs.numOthersIncluded;
         overBudgetAvatars += rhs.overBudgetAvatars;
+        numOthersCulled += rhs.numOthersCulled;
 
         ignoreCalculationElapsedTime += rhs.ignoreCalculationElapsedTime;
         avatarDataPackingElapsedTime += rhs.avatarDataPackingElapsedTime;
@@ -88,7 +92,8 @@ public:
     void configure(ConstIter begin, ConstIter end);
     void configureBroadcast(ConstIter begin, ConstIter end, 
                     p_high_resolution_clock::time_point lastFrameTimestamp, 
-                    float maxKbpsPerNode, float throttlingRatio);
+                    float maxKbpsPerNode, float throttlingRatio,
+                    const AvatarMixerSpatialIndex* spatialIndex);
 
     void processIncomingPackets(const SharedNodePointer& node);
     void broadcastAvatarData(const SharedNodePointer& node);
@@ -109,6 +114,10 @@ private:
     p_high_resolution_clock::time_point _lastFrameTimestamp;
     float _maxKbpsPerNode { 0.0f };
     float _throttlingRatio { 0.0f };
+    const AvatarMixerSpatialIndex* _spatialIndex { nullptr };
+
+    // avatars to consider for the current node, as indices into the spatial index
+    std::vector<int> _avatarsToSort;
 
     AvatarMixerSlaveStats _stats;
 };
@@ -0,0 +1,79 @@
+//
+//  AvatarMixerSpatialIndex.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarMixerSpatialIndex.h"
+
+#include <algorithm>
+
+#include <AABox.h>
+
+#include "AvatarMixerClientData.h"
+
+const int AvatarMixerSpatialIndex::MIN_AVATARS_TO_CULL = 100;
+const float AvatarMixerSpatialIndex::CELL_SIZE = 16.0f;
+const float AvatarMixerSpatialIndex::INTEREST_RADIUS = 16.0f;
+const float AvatarMixerSpatialIndex::CELL_MARGIN = 2.0f;
+const int AvatarMixerSpatialIndex::DISTANT_AVATARS_PER_CELL = 2;
+
+void AvatarMixerSpatialIndex::build(ConstIter begin, ConstIter end, unsigned int frame) {
+    clear();
+    _frame = frame;
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        if (node->getType() == NodeType::Agent && node->getLinkedData()) {
+            const AvatarMixerClientData* nodeData = reinterpret_cast<const AvatarMixerClientData*>(node->getLinkedData());
+            _entries.push_back({ node, nodeData->getAvatarSharedPointer() });
+        }
+    });
+
+    if (!isCulling()) {
+        return;
+    }
+
+    for (int i = 0; i < (int)_entries.size(); ++i) {
+        _grid.insert(_entries[i].avatar->getClientGlobalPosition(), i);
+    }
+    _grid.build();
+}
+
+void AvatarMixerSpatialIndex::clear() {
+    _grid.clear();
+    _entries.clear();
+}
+
+void AvatarMixerSpatialIndex::queryInterest(const glm::vec3& position, const ConicalViewFrustums& views,
+        std::vector<int>& indices) const {
+    indices.clear();
+
+    const auto& gridEntries = _grid.getEntries();
+    for (const auto& cell : _grid.getCells()) {
+        bool isOfInterest = _grid.distanceToCell(position, cell.coordinates) <= INTEREST_RADIUS;
+        if (!isOfInterest) {
+            AABox cellBox(glm::vec3(cell.coordinates) * CELL_SIZE - glm::vec3(CELL_MARGIN),
+                glm::vec3(CELL_SIZE + 2.0f * CELL_MARGIN));
+            isOfInterest = std::any_of(views.begin(), views.end(), [&](const ConicalViewFrustum& view) {
+                return view.intersects(cellBox);
+            });
+        }
+
+        uint32_t numInCell = cell.end - cell.begin;
+        if (isOfInterest || numInCell <= (uint32_t)DISTANT_AVATARS_PER_CELL) {
+            for (uint32_t i = cell.begin; i < cell.end; ++i) {
+                indices.push_back(gridEntries[i].item);
+            }
+        } else {
+            // represent the distant cell by a few of its avatars, taking turns
+            uint32_t first = (_frame * DISTANT_AVATARS_PER_CELL) % numInCell;
+            for (int i = 0; i < DISTANT_AVATARS_PER_CELL; ++i) {
+                indices.push_back(gridEntries[cell.begin + (first + i) % numInCell].item);
+            }
+        }
+    }
+}
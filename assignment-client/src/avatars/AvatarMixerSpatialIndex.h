@@ -0,0 +1,59 @@
+//
+//  AvatarMixerSpatialIndex.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerSpatialIndex_h
+#define hifi_AvatarMixerSpatialIndex_h
+
+#include <vector>
+
+#include <AvatarData.h>
+#include <NodeList.h>
+#include <SpatialHashGrid.h>
+#include <shared/ConicalViewFrustum.h>
+
+// Spatial index of avatar positions
+//   AvatarMixerSpatialIndex is built once per frame, by the mixer, and then queried read-only by the slaves,
+//   so that each viewer only sorts the avatars of interest to it, instead of every other avatar.
+class AvatarMixerSpatialIndex {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    struct Entry {
+        SharedNodePointer node;
+        AvatarSharedPointer avatar;
+    };
+
+    // index the agents with avatar data in [begin, end)
+    void build(ConstIter begin, ConstIter end, unsigned int frame);
+    void clear();
+
+    const std::vector<Entry>& getEntries() const { return _entries; }
+
+    // below this many avatars, every viewer considers every avatar
+    bool isCulling() const { return (int)_entries.size() >= MIN_AVATARS_TO_CULL; }
+
+    // fills indices (into getEntries) with the avatars of interest to a viewer:
+    //   - every avatar in a cell near the viewer, or in a cell intersecting one of its views
+    //   - a few avatars of every other cell, rotating each frame so that every avatar is eventually sent
+    void queryInterest(const glm::vec3& position, const ConicalViewFrustums& views, std::vector<int>& indices) const;
+
+private:
+    static const int MIN_AVATARS_TO_CULL;
+    static const float CELL_SIZE;
+    static const float INTEREST_RADIUS;
+    static const float CELL_MARGIN; // for avatars extending past their cell
+    static const int DISTANT_AVATARS_PER_CELL;
+
+    SpatialHashGrid<int> _grid { CELL_SIZE };
+    std::vector<Entry> _entries;
+    unsigned int _frame { 0 };
+};
+
+#endif // hifi_AvatarMixerSpatialIndex_h
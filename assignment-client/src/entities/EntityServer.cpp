@@ -405,6 +405,11 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    statsString += "<b>Entity Server First Traversal Statistics</b>\r\n";
+    statsString += QString().sprintf("        Traversals... %d\r\n", _traversalCache.getNumTraversals());
+    statsString += QString().sprintf(" Shared traversals... %d\r\n", _traversalCache.getNumSharedTraversals());
+    statsString += "\r\n\r\n";
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
@@ -19,6 +19,7 @@
 #include "EntityItem.h"
 #include "EntityServerConsts.h"
 #include "EntityTree.h"
+#include "EntityTreeTraversalCache.h"
 
 /// Handles assignments of type EntityServer - sending entities to various clients.
 
@@ -60,6 +61,8 @@ public:
 
     virtual void aboutToFinish() override;
 
+    EntityTreeTraversalCache& getTraversalCache() { return _traversalCache; }
+
 public slots:
     virtual void nodeAdded(SharedNodePointer node) override;
     virtual void nodeKilled(SharedNodePointer node) override;
@@ -76,6 +79,7 @@ private slots:
 
 private:
     SimpleEntitySimulationPointer _entitySimulation;
+    EntityTreeTraversalCache _traversalCache;
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
 
     QReadWriteLock _viewerSendingStatsLock;
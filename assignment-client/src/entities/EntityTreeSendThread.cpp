@@ -33,6 +33,8 @@ void EntityTreeSendThread::resetState() {
 
     _knownState.clear();
     _traversal.reset();
+    _sharedFirstTraversal.reset();
+    _firstTraversalResult.reset();
 }
 
 void EntityTreeSendThread::preDistributionProcessing() {
@@ -151,7 +153,17 @@ bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
         #else
         const uint64_t TIME_BUDGET = 200; // usec
         #endif
-        _traversal.traverse(TIME_BUDGET);
+        if (_sharedFirstTraversal) {
+            adoptSharedFirstTraversal(TIME_BUDGET);
+        } else {
+            _traversal.traverse(TIME_BUDGET);
+
+            if (_firstTraversalResult && _traversal.finished()) {
+                auto& traversalCache = static_cast<EntityServer*>(_myServer)->getTraversalCache();
+                traversalCache.addFirstTraversal(std::move(_firstTraversalResult));
+                _firstTraversalResult.reset();
+            }
+        }
         OctreeServer::trackTreeTraverseTime((float)(usecTimestampNow() - startTime));
     }
 
@@ -171,6 +183,31 @@ bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
     return sendComplete;
 }
 
+void EntityTreeSendThread::adoptSharedFirstTraversal(uint64_t timeBudget) {
+    uint64_t expiry = usecTimestampNow() + timeBudget;
+    const auto& view = _traversal.getCurrentView();
+    const auto& entities = _sharedFirstTraversal->entities;
+    while (_nextSharedEntity < entities.size()) {
+        const auto& entity = entities[_nextSharedEntity++].first;
+        // skip entities already queued, or deleted since the traversal
+        if (!entity->isDead() && !_sendQueue.contains(entity.get())) {
+            // another client's priorities don't hold for this view
+            float priority = view.computePriority(entity);
+            if (priority != PrioritizedEntity::DO_NOT_SEND) {
+                _sendQueue.emplace(entity, priority);
+            }
+        }
+        if (usecTimestampNow() > expiry) {
+            break;
+        }
+    }
+
+    if (_nextSharedEntity == entities.size()) {
+        _traversal.finishSharedFirstTraversal(_sharedFirstTraversal->view);
+        _sharedFirstTraversal.reset();
+    }
+}
+
 bool EntityTreeSendThread::addAncestorsToExtraFlaggedEntities(const QUuid& filteredEntityID,
                                                               EntityItem& entityItem, EntityNodeData& nodeData) {
     // check if this entity has a parent that is also an entity
@@ -221,6 +258,9 @@ bool EntityTreeSendThread::addDescendantsToExtraFlaggedEntities(const QUuid& fil
 }
 
 void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, EntityTreeElementPointer root) {
+    // a First traversal that didn't complete is started over
+    _sharedFirstTraversal.reset();
+    _firstTraversalResult.reset();
 
     DiffTraversal::Type type = _traversal.prepareNewTraversal(view, root);
     // there are three types of traversal:
@@ -232,24 +272,39 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
     // The "scanCallback" we provide to the traversal depends on the type:
 
     switch (type) {
-        case DiffTraversal::First:
+        case DiffTraversal::First: {
             // When we get to a First traversal, clear the _knownState
             _knownState.clear();
+
+            // adopt the First traversal of a client with a very similar view, if there is one, rather than walk the tree
+            auto& traversalCache = static_cast<EntityServer*>(_myServer)->getTraversalCache();
+            _sharedFirstTraversal = traversalCache.findFirstTraversal(_traversal.getCurrentView());
+            _nextSharedEntity = 0;
+            if (_sharedFirstTraversal) {
+                _traversal.setScanCallback(nullptr);
+                break;
+            }
+
+            // otherwise walk it within the time budget, and share what it finds once it completes
+            _firstTraversalResult = std::make_shared<EntityTreeTraversalCache::Result>();
+            _firstTraversalResult->view = _traversal.getCurrentView();
             _traversal.setScanCallback([this](DiffTraversal::VisibleElement& next) {
                 next.element->forEachEntity([&](EntityItemPointer entity) {
-                    // Bail early if we've already checked this entity this frame
-                    if (_sendQueue.contains(entity.get())) {
-                        return;
-                    }
                     const auto& view = _traversal.getCurrentView();
                     float priority = view.computePriority(entity);
+                    if (priority == PrioritizedEntity::DO_NOT_SEND) {
+                        return;
+                    }
 
-                    if (priority != PrioritizedEntity::DO_NOT_SEND) {
+                    _firstTraversalResult->entities.emplace_back(entity, priority);
+                    // don't queue it twice if we've already checked this entity this frame
+                    if (!_sendQueue.contains(entity.get())) {
                         _sendQueue.emplace(entity, priority);
                     }
                 });
             });
             break;
+        }
         case DiffTraversal::Repeat:
             _traversal.setScanCallback([this](DiffTraversal::VisibleElement& next) {
                 uint64_t startOfCompletedTraversal = _traversal.getStartOfCompletedTraversal();
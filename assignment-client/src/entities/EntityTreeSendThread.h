@@ -20,6 +20,8 @@
 #include <EntityPriorityQueue.h>
 #include <shared/ConicalViewFrustum.h>
 
+#include "EntityTreeTraversalCache.h"
+
 
 class EntityNodeData;
 class EntityItem;
@@ -43,6 +45,8 @@ private:
     bool addDescendantsToExtraFlaggedEntities(const QUuid& filteredEntityID, EntityItem& entityItem, EntityNodeData& nodeData);
 
     void startNewTraversal(const DiffTraversal::View& viewFrustum, EntityTreeElementPointer root);
+    // queues the entities of a shared First traversal, within the time budget, and completes it once all are queued
+    void adoptSharedFirstTraversal(uint64_t timeBudget);
     bool traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) override;
 
     void preDistributionProcessing() override;
@@ -51,6 +55,12 @@ private:
 
     DiffTraversal _traversal;
     EntityPriorityQueue _sendQueue;
+
+    // the First traversal of another client with a very similar view, adopted in place of walking the tree
+    EntityTreeTraversalCache::ResultPointer _sharedFirstTraversal;
+    size_t _nextSharedEntity { 0 };
+    // the entities found so far by this client's own First traversal, shared once it completes
+    std::shared_ptr<EntityTreeTraversalCache::Result> _firstTraversalResult;
     std::unordered_map<EntityItem*, uint64_t> _knownState;
 
     // packet construction stuff
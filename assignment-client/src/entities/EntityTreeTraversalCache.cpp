@@ -0,0 +1,47 @@
+//
+//  EntityTreeTraversalCache.cpp
+//  assignment-client/src/entities
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeTraversalCache.h"
+
+#include <algorithm>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+// a result is reused for this long after it completed, after which the traversals that follow it have more to catch up on
+static const uint64_t MAX_SHARED_TRAVERSAL_AGE = USECS_PER_SECOND;
+
+EntityTreeTraversalCache::ResultPointer EntityTreeTraversalCache::findFirstTraversal(const DiffTraversal::View& view) {
+    uint64_t now = usecTimestampNow();
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // drop stale results
+    _results.erase(std::remove_if(_results.begin(), _results.end(), [&](const ResultPointer& result) {
+        return result->completedTime + MAX_SHARED_TRAVERSAL_AGE < now;
+    }), _results.end());
+
+    auto itr = std::find_if(_results.begin(), _results.end(), [&](const ResultPointer& result) {
+        return result->view.isVerySimilar(view);
+    });
+    if (itr == _results.end()) {
+        return ResultPointer();
+    }
+
+    ++_numSharedTraversals;
+    return *itr;
+}
+
+void EntityTreeTraversalCache::addFirstTraversal(std::shared_ptr<Result> result) {
+    result->completedTime = usecTimestampNow();
+    ++_numTraversals;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _results.push_back(std::move(result));
+}
@@ -0,0 +1,53 @@
+//
+//  EntityTreeTraversalCache.h
+//  assignment-client/src/entities
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeTraversalCache_h
+#define hifi_EntityTreeTraversalCache_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <DiffTraversal.h>
+
+// Cache of First traversals, shared across EntityTreeSendThreads
+//   When many clients join at once they tend to share a view (e.g. at a spawn point), so the entities found by
+//   a completed First traversal are reused by the clients with a very similar view that join shortly after.
+//   A client reusing a result re-prioritizes its entities for its own view, and follows it with a Differential
+//   traversal against the result's view, which picks up whatever only its own view sees or changed since.
+class EntityTreeTraversalCache {
+public:
+    struct Result {
+        DiffTraversal::View view; // including the start time of the traversal
+        DiffTraversal::VisibleEntities entities;
+        uint64_t completedTime { 0 };
+    };
+    using ResultPointer = std::shared_ptr<const Result>;
+
+    // returns a recently completed First traversal of a very similar view, or nullptr
+    // traversals still in progress on other threads are never waited on
+    ResultPointer findFirstTraversal(const DiffTraversal::View& view);
+
+    // shares a completed First traversal with the clients that join shortly after
+    void addFirstTraversal(std::shared_ptr<Result> result);
+
+    int getNumSharedTraversals() const { return _numSharedTraversals; }
+    int getNumTraversals() const { return _numTraversals; }
+
+private:
+    std::mutex _mutex;
+    std::vector<ResultPointer> _results; // guarded by _mutex
+
+    std::atomic<int> _numSharedTraversals { 0 };
+    std::atomic<int> _numTraversals { 0 };
+};
+
+#endif // hifi_EntityTreeTraversalCache_h
@@ -16,6 +16,7 @@
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <PerfStat.h>
+#include <shared/ParallelFor.h>
 
 #include "OctreeServer.h"
 #include "OctreeServerConsts.h"
@@ -23,6 +24,11 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// packets decoded by each decoding task, below which decoding on another thread isn't worth it
+const size_t MIN_PACKETS_PER_DECODE_TASK = 4;
+// edits applied per hold of the tree's write lock, so that readers (e.g. the send threads) aren't starved
+const size_t MAX_EDITS_PER_WRITE_LOCK = 256;
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -225,6 +231,154 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
     }
 }
 
+bool OctreeInboundPacketProcessor::isBatchedEditPacket(PacketType packetType) const {
+    return packetType != PacketType::ChallengeOwnership &&
+        packetType != PacketType::ChallengeOwnershipRequest &&
+        packetType != PacketType::ChallengeOwnershipReply &&
+        _myServer->getOctree()->handlesEditPacketType(packetType);
+}
+
+void OctreeInboundPacketProcessor::processPackets(std::list<NodeSharedReceivedMessagePair>& packets) {
+    if (_shuttingDown) {
+        ReceivedPacketProcessor::processPackets(packets);
+        return;
+    }
+
+    // runs of consecutive edit packets are decoded together, and then applied in order
+    std::vector<DecodedEditPacket> editPackets;
+    auto packetItr = packets.begin();
+    while (packetItr != packets.end()) {
+        editPackets.clear();
+        while (packetItr != packets.end() && isBatchedEditPacket(packetItr->second->getType())) {
+            DecodedEditPacket packet;
+            packet.message = packetItr->second;
+            packet.sendingNode = packetItr->first;
+            editPackets.push_back(std::move(packet));
+            ++packetItr;
+        }
+
+        if (editPackets.empty()) {
+            processPacket(packetItr->second, packetItr->first);
+            midProcess();
+            ++packetItr;
+        } else {
+            processEditPackets(editPackets);
+        }
+    }
+}
+
+void OctreeInboundPacketProcessor::decodeEditPacket(DecodedEditPacket& packet) {
+    quint64 startDecode = usecTimestampNow();
+    auto& message = packet.message;
+
+    message->readPrimitive(&packet.sequence);
+
+    quint64 sentAt;
+    message->readPrimitive(&sentAt);
+
+    quint64 arrivedAt = usecTimestampNow();
+    if (sentAt > arrivedAt) {
+        if (_myServer->wantsDebugReceiving()) {
+            qDebug() << "unreasonable sentAt=" << sentAt << " usecs";
+            qDebug() << "setting sentAt to arrivedAt=" << arrivedAt << " usecs";
+        }
+        sentAt = arrivedAt;
+    }
+    packet.transitTime = arrivedAt - sentAt;
+
+    auto tree = _myServer->getOctree();
+    while (message->getBytesLeftToRead() > 0) {
+        auto editData = reinterpret_cast<const unsigned char*>(message->getRawMessage() + message->getPosition());
+        int maxSize = message->getBytesLeftToRead();
+
+        int editDataBytesRead = 0;
+        auto edit = tree->decodeEditPacketData(*message, editData, maxSize, packet.sendingNode, editDataBytesRead);
+        if (!edit) {
+            if (packet.edits.empty()) {
+                // the tree can't decode these edits, so leave the whole packet to processPacket()
+                message->seek(0);
+                return;
+            }
+            break;
+        }
+        packet.edits.push_back(std::move(edit));
+
+        if (editDataBytesRead <= 0) {
+            break;
+        }
+        // skip to next edit record in the packet
+        message->seek(message->getPosition() + editDataBytesRead);
+    }
+
+    packet.isDecoded = true;
+    packet.decodeTime = usecTimestampNow() - startDecode;
+}
+
+void OctreeInboundPacketProcessor::processEditPackets(std::vector<DecodedEditPacket>& packets) {
+    // decode, spreading the packets across the shared worker threads when there are enough of them
+    parallelFor(packets.size(), MIN_PACKETS_PER_DECODE_TASK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            decodeEditPacket(packets[i]);
+        }
+    });
+
+    // apply, in the order the packets arrived
+    auto tree = _myServer->getOctree();
+    size_t next = 0;
+    while (next < packets.size()) {
+        if (!packets[next].isDecoded) {
+            processPacket(packets[next].message, packets[next].sendingNode);
+            midProcess();
+            ++next;
+            continue;
+        }
+
+        // apply as many packets as fit in one hold of the write lock
+        size_t end = next;
+        quint64 startLock = usecTimestampNow();
+        tree->withWriteLock([&] {
+            quint64 startProcess = usecTimestampNow();
+            // the wait is charged to the first packet of the batch
+            packets[next].lockWaitTime = startProcess - startLock;
+
+            size_t editsApplied = 0;
+            while (end < packets.size() && packets[end].isDecoded &&
+                    (end == next || editsApplied + packets[end].edits.size() <= MAX_EDITS_PER_WRITE_LOCK)) {
+                auto& packet = packets[end];
+                for (auto& edit : packet.edits) {
+                    tree->applyEdit(*edit, packet.sendingNode);
+                }
+                editsApplied += packet.edits.size();
+
+                quint64 endProcess = usecTimestampNow();
+                packet.applyTime = endProcess - startProcess;
+                startProcess = endProcess;
+                ++end;
+            }
+        });
+
+        for (; next < end; ++next) {
+            auto& packet = packets[next];
+            _receivedPacketCount++;
+
+            if (_myServer->wantsDebugReceiving()) {
+                qDebug() << "PROCESSING THREAD: applied '" << packet.message->getType() << "' packet - "
+                    << _receivedPacketCount << " command from client";
+                qDebug() << "         sequence=" << packet.sequence;
+                qDebug() << "    editsInPacket=" << packet.edits.size();
+                qDebug() << "      transitTime=" << packet.transitTime << " usecs";
+                qDebug() << "       decodeTime=" << packet.decodeTime << " usecs";
+                qDebug() << "        applyTime=" << packet.applyTime << " usecs";
+            }
+
+            QUuid nodeUUID = packet.sendingNode ? packet.sendingNode->getUUID() : QUuid();
+            trackInboundPacket(nodeUUID, packet.sequence, packet.transitTime, (int)packet.edits.size(),
+                packet.decodeTime + packet.applyTime, packet.lockWaitTime);
+            midProcess();
+        }
+    }
+}
+
 void OctreeInboundPacketProcessor::trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
             int editsInPacket, quint64 processTime, quint64 lockWaitTime) {
 
@@ -14,6 +14,9 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <vector>
+
+#include <Octree.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -79,6 +82,7 @@ public:
 protected:
 
     virtual void processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) override;
+    virtual void processPackets(std::list<NodeSharedReceivedMessagePair>& packets) override;
 
     virtual uint32_t getMaxWait() const override;
     virtual void preProcess() override;
@@ -87,6 +91,23 @@ protected:
 private:
     int sendNackPackets();
 
+    // an edit packet, decoded without the tree lock
+    struct DecodedEditPacket {
+        QSharedPointer<ReceivedMessage> message;
+        SharedNodePointer sendingNode;
+        unsigned short int sequence { 0 };
+        quint64 transitTime { 0 };
+        quint64 decodeTime { 0 };
+        quint64 applyTime { 0 };
+        quint64 lockWaitTime { 0 };
+        std::vector<OctreeEditPointer> edits;
+        bool isDecoded { false }; // otherwise the tree can't decode it, and it goes through processPacket()
+    };
+
+    bool isBatchedEditPacket(PacketType packetType) const;
+    void decodeEditPacket(DecodedEditPacket& packet);
+    void processEditPackets(std::vector<DecodedEditPacket>& packets);
+
 private:
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
             int elementsInPacket, quint64 processTime, quint64 lockWaitTime);
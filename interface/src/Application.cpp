@@ -4969,8 +4969,12 @@ void Application::init() {
         return atan2(maxSize, distance);
     });
 
+    _shapeManager.initializeShapeCache();
     ObjectMotionState::setShapeManager(&_shapeManager);
     _physicsEngine->init();
+    if (Menu::getInstance()->isOptionChecked(MenuOption::PhysicsMultithreadedSolver)) {
+        setMultithreadedPhysicsSolver(true);
+    }
 
     EntityTreePointer tree = getEntities()->getTree();
     _entitySimulation->init(tree, _physicsEngine, &_entityEditSender);
@@ -8195,6 +8199,10 @@ void Application::setShowBulletConstraintLimits(bool value) {
     _physicsEngine->setShowBulletConstraintLimits(value);
 }
 
+void Application::setMultithreadedPhysicsSolver(bool value) {
+    _physicsEngine->setNumSolverThreads(value ? QThread::idealThreadCount() : 1);
+}
+
 void Application::startHMDStandBySession() {
     _autoSwitchDisplayModeSupportedHMDPlugin->startStandBySession();
 }
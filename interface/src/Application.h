@@ -486,6 +486,7 @@ private slots:
     void setShowBulletContactPoints(bool value);
     void setShowBulletConstraints(bool value);
     void setShowBulletConstraintLimits(bool value);
+    void setMultithreadedPhysicsSolver(bool value);
 
 private:
     void init();
@@ -15,6 +15,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include <algorithm>
+
 #include "AudioHRTFData.h"
 
 #if defined(_MSC_VER)
@@ -276,6 +278,66 @@ static void FIR_1x4_SSE(float* src, float* dst0, float* dst1, float* dst2, float
     }
 }
 
+// 2 channel input, 4 channel output (src0 to dst0/dst1, src1 to dst2/dst3)
+static void FIR_2x4_SSE(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
+    float* coef1 = coef[1] + HRTF_TAPS - 1;
+    float* coef2 = coef[2] + HRTF_TAPS - 1;
+    float* coef3 = coef[3] + HRTF_TAPS - 1;
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        __m128 acc2 = _mm_setzero_ps();
+        __m128 acc3 = _mm_setzero_ps();
+
+        float* ps0 = &src0[i - HRTF_TAPS + 1];  // process forwards
+        float* ps1 = &src1[i - HRTF_TAPS + 1];
+
+        assert(HRTF_TAPS % 4 == 0);
+
+        for (int k = 0; k < HRTF_TAPS; k += 4) {
+
+            __m128 x0 = _mm_loadu_ps(&ps0[k+0]);
+            __m128 y0 = _mm_loadu_ps(&ps1[k+0]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef0[-k-0]), x0));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef1[-k-0]), x0));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef2[-k-0]), y0));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef3[-k-0]), y0));
+
+            __m128 x1 = _mm_loadu_ps(&ps0[k+1]);
+            __m128 y1 = _mm_loadu_ps(&ps1[k+1]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef0[-k-1]), x1));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef1[-k-1]), x1));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef2[-k-1]), y1));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef3[-k-1]), y1));
+
+            __m128 x2 = _mm_loadu_ps(&ps0[k+2]);
+            __m128 y2 = _mm_loadu_ps(&ps1[k+2]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef0[-k-2]), x2));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef1[-k-2]), x2));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef2[-k-2]), y2));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef3[-k-2]), y2));
+
+            __m128 x3 = _mm_loadu_ps(&ps0[k+3]);
+            __m128 y3 = _mm_loadu_ps(&ps1[k+3]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef0[-k-3]), x3));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef1[-k-3]), x3));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef2[-k-3]), y3));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef3[-k-3]), y3));
+        }
+
+        _mm_storeu_ps(&dst0[i], acc0);
+        _mm_storeu_ps(&dst1[i], acc1);
+        _mm_storeu_ps(&dst2[i], acc2);
+        _mm_storeu_ps(&dst3[i], acc3);
+    }
+}
+
 //
 // Runtime CPU dispatch
 //
@@ -291,6 +353,15 @@ static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* ds
     (*f)(src, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
 }
 
+void FIR_2x4_AVX2(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void FIR_2x4_AVX512(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+
+static void FIR_2x4(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    static auto f = cpuSupportsAVX512() ? FIR_2x4_AVX512 : (cpuSupportsAVX2() ? FIR_2x4_AVX2 : FIR_2x4_SSE);
+    (*f)(src0, src1, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
+}
+
 // 4 channel planar to interleaved
 static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
@@ -434,6 +505,34 @@ static void crossfade_4x2(float* src, float* dst, const float* win, int numFrame
     }
 }
 
+// sum 2 stereo pairs into 1 output with accumulation (interleaved)
+static void accumulate_4x2(float* src, float* dst, int numFrames) {
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        __m128 x0 = _mm_loadu_ps(&src[4*i+0]);
+        __m128 x1 = _mm_loadu_ps(&src[4*i+4]);
+        __m128 x2 = _mm_loadu_ps(&src[4*i+8]);
+        __m128 x3 = _mm_loadu_ps(&src[4*i+12]);
+
+        __m128 y0 = _mm_loadu_ps(&dst[2*i+0]);
+        __m128 y1 = _mm_loadu_ps(&dst[2*i+4]);
+
+        // first pair + second pair
+        x0 = _mm_add_ps(_mm_movelh_ps(x0, x1), _mm_movehl_ps(x1, x0));
+        x1 = _mm_add_ps(_mm_movelh_ps(x2, x3), _mm_movehl_ps(x3, x2));
+
+        // accumulate
+        y0 = _mm_add_ps(y0, x0);
+        y1 = _mm_add_ps(y1, x1);
+
+        _mm_storeu_ps(&dst[2*i+0], y0);
+        _mm_storeu_ps(&dst[2*i+4], y1);
+    }
+}
+
 // linear interpolation with gain
 static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
 
@@ -520,6 +619,38 @@ static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* ds
     }
 }
 
+// 2 channel input, 4 channel output (src0 to dst0/dst1, src1 to dst2/dst3)
+static void FIR_2x4(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
+    float* coef1 = coef[1] + HRTF_TAPS - 1;
+    float* coef2 = coef[2] + HRTF_TAPS - 1;
+    float* coef3 = coef[3] + HRTF_TAPS - 1;
+
+    for (int i = 0; i < numFrames; i++) {
+
+        float* ps0 = &src0[i - HRTF_TAPS + 1];  // process forwards
+        float* ps1 = &src1[i - HRTF_TAPS + 1];
+
+        float acc0 = 0.0f;
+        float acc1 = 0.0f;
+        float acc2 = 0.0f;
+        float acc3 = 0.0f;
+
+        for (int k = 0; k < HRTF_TAPS; k++) {
+            acc0 += coef0[-k] * ps0[k];
+            acc1 += coef1[-k] * ps0[k];
+            acc2 += coef2[-k] * ps1[k];
+            acc3 += coef3[-k] * ps1[k];
+        }
+
+        dst0[i] = acc0;
+        dst1[i] = acc1;
+        dst2[i] = acc2;
+        dst3[i] = acc3;
+    }
+}
+
 // 4 channel planar to interleaved
 static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
@@ -714,6 +845,16 @@ static void crossfade_4x2(float* src, float* dst, const float* win, int numFrame
     }
 }
 
+// sum 2 stereo pairs into 1 output with accumulation (interleaved)
+static void accumulate_4x2(float* src, float* dst, int numFrames) {
+
+    for (int i = 0; i < numFrames; i++) {
+
+        dst[2*i+0] += src[4*i+0] + src[4*i+2];
+        dst[2*i+1] += src[4*i+1] + src[4*i+3];
+    }
+}
+
 // linear interpolation with gain
 static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
 
@@ -1167,3 +1308,163 @@ void AudioHRTF::renderSilent(int16_t* input, float* output, int index, float azi
 
     _silentState = true;
 }
+
+void AudioHRTF::reset() {
+    memset(_firState, 0, sizeof(_firState));
+    memset(_delayState, 0, sizeof(_delayState));
+    memset(_bqState, 0, sizeof(_bqState));
+
+    _azimuthState = 0.0f;
+    _distanceState = 0.0f;
+    _gainState = 0.0f;
+
+    _silentState = false;
+}
+
+void AudioHRTFBatch::add(AudioHRTF& hrtf, const int16_t* input, float azimuth, float distance, float gain) {
+
+    // sort key is the azimuth table index
+    float x = azimuth * (HRTF_AZIMUTHS / TWOPI);
+    if (x < 0.0f) {
+        x += HRTF_AZIMUTHS;
+    }
+    int bucket = MIN((int)x, HRTF_AZIMUTHS - 1);
+
+    int offset = (int)_inputs.size();
+    _inputs.insert(_inputs.end(), input, input + HRTF_BLOCK);
+
+    _sources.push_back({ &hrtf, bucket, offset, azimuth, distance, gain });
+}
+
+void AudioHRTFBatch::clear() {
+    _sources.clear();
+    _static.clear();
+    _inputs.clear();
+}
+
+void AudioHRTFBatch::render(float* output, int index, int numFrames) {
+
+    assert(index >= 0);
+    assert(index < HRTF_TABLES);
+    assert(numFrames == HRTF_BLOCK);
+
+    std::sort(_sources.begin(), _sources.end(), [](const Source& a, const Source& b) {
+        return a.bucket < b.bucket;
+    });
+
+    for (auto& source : _sources) {
+        AudioHRTF& hrtf = *source.hrtf;
+
+        // when old and new parameters match, the crossfade is a no-op and the source can be paired
+        bool isStatic = (source.azimuth == hrtf._azimuthState) &&
+                        (source.distance == hrtf._distanceState) &&
+                        (source.gain * hrtf._gainAdjust == hrtf._gainState);
+
+        if (isStatic) {
+            _static.push_back(source);
+        } else {
+            hrtf.render(&_inputs[source.offset], output, index, source.azimuth, source.distance, source.gain, numFrames);
+        }
+    }
+
+    size_t numPairs = _static.size() / 2;
+    for (size_t i = 0; i < numPairs; i++) {
+        renderPair(_static[2*i+0], _static[2*i+1], output, index);
+    }
+
+    if (_static.size() % 2) {
+        Source& source = _static.back();
+        source.hrtf->render(&_inputs[source.offset], output, index, source.azimuth, source.distance, source.gain, numFrames);
+    }
+
+    clear();
+}
+
+void AudioHRTFBatch::renderPair(Source& a, Source& b, float* output, int index) {
+
+    ALIGN32 float in[2][HRTF_TAPS + HRTF_BLOCK];            // 2 x mono
+    ALIGN32 float firCoef[4][HRTF_TAPS];                    // 4-channel
+    ALIGN32 float firBuffer[4][HRTF_DELAY + HRTF_BLOCK];    // 4-channel
+    ALIGN32 float bqCoef[5][8];                             // 4-channel (interleaved)
+    ALIGN32 float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
+    float bqState[3][8];                                    // 4-channel (interleaved)
+    int delay[4];                                           // 4-channel (interleaved)
+
+    AudioHRTF* hrtf[2] = { a.hrtf, b.hrtf };
+    const int16_t* input[2] = { &_inputs[a.offset], &_inputs[b.offset] };
+
+    // source a uses the old filter slots, source b uses the new filter slots
+    setFilters(firCoef, bqCoef, delay, index, a.hrtf->_azimuthState, a.hrtf->_distanceState, a.hrtf->_gainState, AudioHRTF::L0);
+    setFilters(firCoef, bqCoef, delay, index, b.hrtf->_azimuthState, b.hrtf->_distanceState, b.hrtf->_gainState, AudioHRTF::L1);
+
+    for (int j = 0; j < 2; j++) {
+
+        // convert mono input to float
+        for (int i = 0; i < HRTF_BLOCK; i++) {
+            in[j][HRTF_TAPS+i] = (float)input[j][i] * (1/32768.0f);
+        }
+
+        // FIR state update
+        memcpy(in[j], hrtf[j]->_firState, HRTF_TAPS * sizeof(float));
+        memcpy(hrtf[j]->_firState, &in[j][HRTF_BLOCK], HRTF_TAPS * sizeof(float));
+    }
+
+    // process both FIR
+    FIR_2x4(&in[0][HRTF_TAPS],
+            &in[1][HRTF_TAPS],
+            &firBuffer[AudioHRTF::L0][HRTF_DELAY],
+            &firBuffer[AudioHRTF::R0][HRTF_DELAY],
+            &firBuffer[AudioHRTF::L1][HRTF_DELAY],
+            &firBuffer[AudioHRTF::R1][HRTF_DELAY],
+            firCoef, HRTF_BLOCK);
+
+    // delay state update (old and new state are identical)
+    for (int j = 0; j < 2; j++) {
+        int L = AudioHRTF::L0 + 2*j;
+        int R = AudioHRTF::R0 + 2*j;
+
+        memcpy(firBuffer[L], hrtf[j]->_delayState[AudioHRTF::L1], HRTF_DELAY * sizeof(float));
+        memcpy(firBuffer[R], hrtf[j]->_delayState[AudioHRTF::R1], HRTF_DELAY * sizeof(float));
+
+        memcpy(hrtf[j]->_delayState[AudioHRTF::L0], &firBuffer[L][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+        memcpy(hrtf[j]->_delayState[AudioHRTF::R0], &firBuffer[R][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+        memcpy(hrtf[j]->_delayState[AudioHRTF::L1], &firBuffer[L][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+        memcpy(hrtf[j]->_delayState[AudioHRTF::R1], &firBuffer[R][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+    }
+
+    // interleave with integer delay
+    interleave_4x4(&firBuffer[AudioHRTF::L0][HRTF_DELAY] - delay[AudioHRTF::L0],
+                   &firBuffer[AudioHRTF::R0][HRTF_DELAY] - delay[AudioHRTF::R0],
+                   &firBuffer[AudioHRTF::L1][HRTF_DELAY] - delay[AudioHRTF::L1],
+                   &firBuffer[AudioHRTF::R1][HRTF_DELAY] - delay[AudioHRTF::R1],
+                   bqBuffer, HRTF_BLOCK);
+
+    // gather biquad state, from the new channels of each source
+    for (int k = 0; k < 3; k++) {
+        for (int j = 0; j < 2; j++) {
+            bqState[k][AudioHRTF::L0 + 2*j] = hrtf[j]->_bqState[k][AudioHRTF::L1];
+            bqState[k][AudioHRTF::R0 + 2*j] = hrtf[j]->_bqState[k][AudioHRTF::R1];
+            bqState[k][AudioHRTF::L2 + 2*j] = hrtf[j]->_bqState[k][AudioHRTF::L3];
+            bqState[k][AudioHRTF::R2 + 2*j] = hrtf[j]->_bqState[k][AudioHRTF::R3];
+        }
+    }
+
+    // process both biquads
+    biquad2_4x4(bqBuffer, bqBuffer, bqCoef, bqState, HRTF_BLOCK);
+
+    // scatter biquad state, to both old and new channels
+    for (int k = 0; k < 3; k++) {
+        for (int j = 0; j < 2; j++) {
+            hrtf[j]->_bqState[k][AudioHRTF::L0] = hrtf[j]->_bqState[k][AudioHRTF::L1] = bqState[k][AudioHRTF::L0 + 2*j];
+            hrtf[j]->_bqState[k][AudioHRTF::R0] = hrtf[j]->_bqState[k][AudioHRTF::R1] = bqState[k][AudioHRTF::R0 + 2*j];
+            hrtf[j]->_bqState[k][AudioHRTF::L2] = hrtf[j]->_bqState[k][AudioHRTF::L3] = bqState[k][AudioHRTF::L2 + 2*j];
+            hrtf[j]->_bqState[k][AudioHRTF::R2] = hrtf[j]->_bqState[k][AudioHRTF::R3] = bqState[k][AudioHRTF::R2 + 2*j];
+        }
+    }
+
+    // sum both outputs and accumulate
+    accumulate_4x2(bqBuffer, output, HRTF_BLOCK);
+
+    a.hrtf->_silentState = false;
+    b.hrtf->_silentState = false;
+}
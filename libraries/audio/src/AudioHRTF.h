@@ -13,6 +13,7 @@
 #define hifi_AudioHRTF_h
 
 #include <stdint.h>
+#include <vector>
 
 static const int HRTF_AZIMUTHS = 72;    // 360 / 5-degree steps
 static const int HRTF_TAPS = 64;        // minimum-phase FIR coefficients
@@ -50,6 +51,12 @@ public:
     //
     void renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
 
+    //
+    // Clear the filter and parameter history, for a source that stopped being rendered without a silent block.
+    // The next block fades in from silence. The gain adjustment is kept.
+    //
+    void reset();
+
     //
     // HRTF local gain adjustment in amplitude (1.0 == unity)
     //
@@ -57,6 +64,8 @@ public:
     float getGainAdjustment() { return _gainAdjust; }
 
 private:
+    friend class AudioHRTFBatch;
+
     AudioHRTF(const AudioHRTF&) = delete;
     AudioHRTF& operator=(const AudioHRTF&) = delete;
 
@@ -91,4 +100,53 @@ private:
     bool _silentState = false;
 };
 
+//
+// Batched rendering of all sources for one listener.
+//
+// Sources are sorted by azimuth, so that neighbouring sources share HRTF table rows.
+// Sources whose parameters are unchanged since the previous block do not need the
+// old/new filter crossfade, so they are rendered two at a time by a single 2x4 FIR pass.
+// The output is identical to calling AudioHRTF::render() for each source.
+//
+class AudioHRTFBatch {
+
+public:
+    AudioHRTFBatch() {};
+
+    //
+    // hrtf: per-source state, must remain valid until render()
+    // input: mono source, copied into the batch
+    // azimuth, distance, gain: as for AudioHRTF::render()
+    //
+    void add(AudioHRTF& hrtf, const int16_t* input, float azimuth, float distance, float gain);
+
+    //
+    // Render all queued sources, accumulating into output (interleaved stereo), then clear the batch.
+    // numFrames: must be HRTF_BLOCK in this version
+    //
+    void render(float* output, int index, int numFrames);
+
+    void clear();
+    int size() const { return (int)_sources.size(); }
+
+private:
+    AudioHRTFBatch(const AudioHRTFBatch&) = delete;
+    AudioHRTFBatch& operator=(const AudioHRTFBatch&) = delete;
+
+    struct Source {
+        AudioHRTF* hrtf;
+        int bucket;         // azimuth table index, used for sorting
+        int offset;         // into _inputs
+        float azimuth;
+        float distance;
+        float gain;
+    };
+
+    void renderPair(Source& a, Source& b, float* output, int index);
+
+    std::vector<Source> _sources;
+    std::vector<Source> _static;
+    std::vector<int16_t> _inputs;
+};
+
 #endif // AudioHRTF_h
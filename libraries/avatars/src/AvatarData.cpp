@@ -217,6 +217,58 @@ float AvatarData::getDistanceBasedMinTranslationDistance(glm::vec3 viewerPositio
 }
 
 
+static void packSensorToWorldMatrix(AvatarDataPacket::SensorToWorldMatrix* data, const glm::mat4& sensorToWorldMatrix) {
+    packOrientationQuatToSixBytes(data->sensorToWorldQuat, glmExtractRotation(sensorToWorldMatrix));
+    glm::vec3 scale = extractScale(sensorToWorldMatrix);
+    packFloatScalarToSignedTwoByteFixed((uint8_t*)&data->sensorToWorldScale, scale.x, SENSOR_TO_WORLD_SCALE_RADIX);
+    data->sensorToWorldTrans[0] = sensorToWorldMatrix[3][0];
+    data->sensorToWorldTrans[1] = sensorToWorldMatrix[3][1];
+    data->sensorToWorldTrans[2] = sensorToWorldMatrix[3][2];
+}
+
+// returns the number of bytes packed
+static int packFauxJoints(unsigned char* destinationBuffer, const glm::mat4& controllerLeftHandMatrix,
+        const glm::mat4& controllerRightHandMatrix) {
+    unsigned char* startPosition = destinationBuffer;
+    Transform controllerLeftHandTransform = Transform(controllerLeftHandMatrix);
+    destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
+    destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerLeftHandTransform.getTranslation(),
+        TRANSLATION_COMPRESSION_RADIX);
+    Transform controllerRightHandTransform = Transform(controllerRightHandMatrix);
+    destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerRightHandTransform.getRotation());
+    destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerRightHandTransform.getTranslation(),
+        TRANSLATION_COMPRESSION_RADIX);
+    return (int)(destinationBuffer - startPosition);
+}
+
+void AvatarData::encodeSections() {
+    packOrientationQuatToSixBytes(_encodedSections.orientation, getOrientationOutbound());
+    packSensorToWorldMatrix(&_encodedSections.sensorToWorldMatrix, getSensorToWorldMatrix());
+
+    QReadLocker readLock(&_jointDataLock);
+    int numJoints = _jointData.size();
+    _encodedSections.jointRotations.resize(numJoints * sizeof(AvatarDataPacket::SixByteQuat));
+    _encodedSections.jointTranslations.resize(numJoints * sizeof(AvatarDataPacket::SixByteTrans));
+    for (int i = 0; i < numJoints; i++) {
+        const JointData& data = _jointData[i];
+        if (!data.rotationIsDefaultPose) {
+            packOrientationQuatToSixBytes(&_encodedSections.jointRotations[i * sizeof(AvatarDataPacket::SixByteQuat)],
+                data.rotation);
+        }
+        if (!data.translationIsDefaultPose) {
+            packFloatVec3ToSignedTwoByteFixed(&_encodedSections.jointTranslations[i * sizeof(AvatarDataPacket::SixByteTrans)],
+                data.translation, TRANSLATION_COMPRESSION_RADIX);
+        }
+    }
+
+    const int NUM_FAUX_JOINTS = 2;
+    _encodedSections.fauxJoints.resize(NUM_FAUX_JOINTS *
+        (sizeof(AvatarDataPacket::SixByteQuat) + sizeof(AvatarDataPacket::SixByteTrans)));
+    packFauxJoints(_encodedSections.fauxJoints.data(), getControllerLeftHandMatrix(), getControllerRightHandMatrix());
+
+    _encodedSections.isValid = true;
+}
+
 // we want to track outbound data in this case...
 QByteArray AvatarData::toByteArrayStateful(AvatarDataDetail dataDetail, bool dropFaceTracking) {
     AvatarDataPacket::HasFlags hasFlagsOut;
@@ -266,6 +318,9 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 
     auto parentID = getParentID();
 
+    // copy the sections quantized by encodeSections, if they are still valid
+    bool useEncodedSections = _encodedSections.isValid;
+
     bool hasAvatarGlobalPosition = true; // always include global position
     bool hasAvatarOrientation = false;
     bool hasAvatarBoundingBox = false;
@@ -372,8 +427,13 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 
     if (hasAvatarOrientation) {
         auto startSection = destinationBuffer;
-        auto localOrientation = getOrientationOutbound();
-        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, localOrientation);
+        if (useEncodedSections) {
+            memcpy(destinationBuffer, _encodedSections.orientation, sizeof(_encodedSections.orientation));
+            destinationBuffer += sizeof(_encodedSections.orientation);
+        } else {
+            auto localOrientation = getOrientationOutbound();
+            destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, localOrientation);
+        }
 
         int numBytes = destinationBuffer - startSection;
         if (outboundDataRateOut) {
@@ -424,13 +484,11 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
     if (hasSensorToWorldMatrix) {
         auto startSection = destinationBuffer;
         auto data = reinterpret_cast<AvatarDataPacket::SensorToWorldMatrix*>(destinationBuffer);
-        glm::mat4 sensorToWorldMatrix = getSensorToWorldMatrix();
-        packOrientationQuatToSixBytes(data->sensorToWorldQuat, glmExtractRotation(sensorToWorldMatrix));
-        glm::vec3 scale = extractScale(sensorToWorldMatrix);
-        packFloatScalarToSignedTwoByteFixed((uint8_t*)&data->sensorToWorldScale, scale.x, SENSOR_TO_WORLD_SCALE_RADIX);
-        data->sensorToWorldTrans[0] = sensorToWorldMatrix[3][0];
-        data->sensorToWorldTrans[1] = sensorToWorldMatrix[3][1];
-        data->sensorToWorldTrans[2] = sensorToWorldMatrix[3][2];
+        if (useEncodedSections) {
+            memcpy(data, &_encodedSections.sensorToWorldMatrix, sizeof(AvatarDataPacket::SensorToWorldMatrix));
+        } else {
+            packSensorToWorldMatrix(data, getSensorToWorldMatrix());
+        }
         destinationBuffer += sizeof(AvatarDataPacket::SensorToWorldMatrix);
 
         int numBytes = destinationBuffer - startSection;
@@ -548,6 +606,10 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         int numJoints = _jointData.size();
         *destinationBuffer++ = (uint8_t)numJoints;
 
+        // the joints may have changed size since they were encoded
+        bool useEncodedJoints = useEncodedSections &&
+            _encodedSections.jointRotations.size() == numJoints * sizeof(AvatarDataPacket::SixByteQuat);
+
         unsigned char* validityPosition = destinationBuffer;
         unsigned char validity = 0;
         int validityBit = 0;
@@ -589,7 +651,13 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 #ifdef WANT_DEBUG
                         rotationSentCount++;
 #endif
-                        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
+                        if (useEncodedJoints) {
+                            memcpy(destinationBuffer, &_encodedSections.jointRotations[i * sizeof(AvatarDataPacket::SixByteQuat)],
+                                sizeof(AvatarDataPacket::SixByteQuat));
+                            destinationBuffer += sizeof(AvatarDataPacket::SixByteQuat);
+                        } else {
+                            destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
+                        }
 
                         if (sentJointDataOut) {
                             localSentJointDataOut[i].rotation = data.rotation;
@@ -638,8 +706,14 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
                         maxTranslationDimension = glm::max(fabsf(data.translation.y), maxTranslationDimension);
                         maxTranslationDimension = glm::max(fabsf(data.translation.z), maxTranslationDimension);
 
-                        destinationBuffer +=
-                            packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
+                        if (useEncodedJoints) {
+                            memcpy(destinationBuffer, &_encodedSections.jointTranslations[i * sizeof(AvatarDataPacket::SixByteTrans)],
+                                sizeof(AvatarDataPacket::SixByteTrans));
+                            destinationBuffer += sizeof(AvatarDataPacket::SixByteTrans);
+                        } else {
+                            destinationBuffer +=
+                                packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
+                        }
 
                         if (sentJointDataOut) {
                             localSentJointDataOut[i].translation = data.translation;
@@ -659,14 +733,12 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         }
 
         // faux joints
-        Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
-        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
-        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerLeftHandTransform.getTranslation(),
-            TRANSLATION_COMPRESSION_RADIX);
-        Transform controllerRightHandTransform = Transform(getControllerRightHandMatrix());
-        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerRightHandTransform.getRotation());
-        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerRightHandTransform.getTranslation(),
-            TRANSLATION_COMPRESSION_RADIX);
+        if (useEncodedSections) {
+            memcpy(destinationBuffer, _encodedSections.fauxJoints.data(), _encodedSections.fauxJoints.size());
+            destinationBuffer += _encodedSections.fauxJoints.size();
+        } else {
+            destinationBuffer += packFauxJoints(destinationBuffer, getControllerLeftHandMatrix(), getControllerRightHandMatrix());
+        }
 
 #ifdef WANT_DEBUG
         if (sendAll) {
@@ -809,6 +881,9 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     // lazily allocate memory for HeadData in case we're not an Avatar instance
     lazyInitHeadData();
 
+    // the encoded sections no longer match the data
+    _encodedSections.isValid = false;
+
     AvatarDataPacket::HasFlags packetStateFlags;
 
     const unsigned char* startPosition = reinterpret_cast<const unsigned char*>(buffer.data());
@@ -438,6 +438,11 @@ public:
 
     virtual void doneEncoding(bool cullSmallChanges);
 
+    // quantize the sections of toByteArray that do not depend on the viewer (orientation, sensor to world matrix,
+    // and joints), so that later calls to toByteArray copy them instead of packing them again for every viewer
+    // the sections are valid until the next call to parseDataFromBuffer, so this is only meant for the avatar mixer
+    void encodeSections();
+
     /// \return true if an error should be logged
     bool shouldLogError(const quint64& now);
 
@@ -1305,6 +1310,17 @@ protected:
     QVector<JointData> _lastSentJointData; ///< the state of the skeleton joints last time we transmitted
     mutable QReadWriteLock _jointDataLock;
 
+    // sections of toByteArray shared by every viewer, see encodeSections
+    struct EncodedSections {
+        bool isValid { false };
+        AvatarDataPacket::SixByteQuat orientation;
+        AvatarDataPacket::SensorToWorldMatrix sensorToWorldMatrix;
+        std::vector<uint8_t> jointRotations; // SixByteQuat per joint, for joints not in their default pose
+        std::vector<uint8_t> jointTranslations; // SixByteTrans per joint, for joints not in their default pose
+        std::vector<uint8_t> fauxJoints;
+    };
+    EncodedSections _encodedSections;
+
     // key state
     KeyState _keyState;
 
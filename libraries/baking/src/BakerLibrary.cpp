@@ -0,0 +1,49 @@
+//
+//  BakerLibrary.cpp
+//  libraries/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakerLibrary.h"
+
+#include <QtGui/QImageReader>
+
+#include "FBXBaker.h"
+#include "JSBaker.h"
+#include "TextureBaker.h"
+
+std::unique_ptr<Baker> createBakerForType(const QUrl& inputUrl, const QString& type, const QString& outputPath,
+                                          TextureBakerThreadGetter textureThreadGetter, QString& error) {
+    static const QString MODEL_EXTENSION { "fbx" };
+    static const QString SCRIPT_EXTENSION { "js" };
+
+    if (type == MODEL_EXTENSION) {
+        return std::unique_ptr<Baker> { new FBXBaker(inputUrl, textureThreadGetter, outputPath) };
+    }
+
+    if (type == SCRIPT_EXTENSION) {
+        return std::unique_ptr<Baker> { new JSBaker(inputUrl, outputPath) };
+    }
+
+    // If the type doesn't match the above, we assume we have a texture, and the type specified is the
+    // texture usage type (albedo, cubemap, normals, etc.)
+    auto url = inputUrl.toDisplayString();
+    auto idx = url.lastIndexOf('.');
+    auto extension = idx >= 0 ? url.mid(idx + 1).toLower() : "";
+    if (!QImageReader::supportedImageFormats().contains(extension.toLatin1())) {
+        error = "Failed to determine baker type for file " + url;
+        return nullptr;
+    }
+
+    image::TextureUsage::Type textureType;
+    if (!image::TextureUsage::getTextureUsageTypeFromName(type, textureType)) {
+        error = "Unknown texture usage type: " + type;
+        return nullptr;
+    }
+
+    return std::unique_ptr<Baker> { new TextureBaker(inputUrl, textureType, outputPath) };
+}
@@ -0,0 +1,33 @@
+//
+//  BakerLibrary.h
+//  libraries/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakerLibrary_h
+#define hifi_BakerLibrary_h
+
+#include <functional>
+#include <memory>
+
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+#include "Baker.h"
+
+class QThread;
+
+using TextureBakerThreadGetter = std::function<QThread*()>;
+
+// Create the baker for an asset of the given type, the way the oven's command line interface does.
+// `type` is "fbx" for models, "js" for scripts, or a texture usage name ("albedo", "cube", ...) for images.
+// Returns nullptr and fills `error` if no baker can handle the input.
+// The baker is not started and has the calling thread's affinity; callers move it and invoke `bake` themselves.
+std::unique_ptr<Baker> createBakerForType(const QUrl& inputUrl, const QString& type, const QString& outputPath,
+                                          TextureBakerThreadGetter textureThreadGetter, QString& error);
+
+#endif // hifi_BakerLibrary_h
@@ -1353,6 +1353,9 @@ void ModelEntityRenderer::doRenderUpdateSynchronousTyped(const ScenePointer& sce
         });
     }
 
+    // keep streaming the model's textures in the order of how much of the view they cover
+    model->setLoadingPriority(EntityTreeRenderer::getEntityLoadingPriority(*entity));
+
     // Check for initializing the model
     // FIXME: There are several places below here where we are modifying the entity, which we should not be doing from the renderable
     if (!entity->_dimensionsInitialized) {
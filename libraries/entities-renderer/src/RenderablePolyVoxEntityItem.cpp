@@ -13,11 +13,13 @@
 #include "RenderablePolyVoxEntityItem.h"
 
 #include <math.h>
+#include <algorithm>
 
 #include <glm/gtx/transform.hpp>
 
 #include <QObject>
 #include <QByteArray>
+#include <QtConcurrent/QtConcurrentMap>
 #include <QtConcurrent/QtConcurrentRun>
 
 #include <model-networking/SimpleMeshProxy.h>
@@ -108,6 +110,12 @@ const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
   to run on a thread that has other things to do.  These use QtConcurrent::run to spawn a thread.  As each thread
   finishes, it adjusts the dirty flags so that the next call to render() will kick off the next step.
 
+  Edits track the region of _volData they changed.  The volume is meshed in chunks of MESH_CHUNK_SIZE voxels, and
+  recomputeMesh() only extracts the chunks near that region again (in parallel) before stitching all of the chunks
+  into _mesh.  The collision hulls are kept per chunk in the same way.  Only one recomputeMesh() and one
+  computeShapeInfoWorker() run at a time for an entity, and edits made while they run are picked up by the next one.
+  Likewise, edits made while compressVolumeDataAndSendEditPacket is running are sent together once it is done.
+
   polyvoxes are designed to seemlessly fit up against neighbors.  If voxels go right up to the edge of polyvox,
   the resulting mesh wont be closed -- the library assumes you'll have another polyvox next to it to continue the
   mesh.
@@ -190,6 +198,7 @@ void RenderablePolyVoxEntityItem::setVoxelSurfaceStyle(PolyVoxSurfaceStyle voxel
         bool wasEdged = isEdged();
         bool willBeEdged = isEdged(voxelSurfaceStyle);
 
+        _allChunksDirty = true;
         if (wasEdged != willBeEdged) {
             _volDataDirty = true;
             _volData.reset();
@@ -734,9 +743,12 @@ bool RenderablePolyVoxEntityItem::isReadyToComputeShape() const {
     // we determine if we are ready to compute the physics shape by actually doing so.
     // if _voxelDataDirty or _volDataDirty is set, don't do this yet -- wait for their
     // threads to finish before creating the collision shape.
-    if (_meshDirty && !_voxelDataDirty && !_volDataDirty) {
-        const_cast<RenderablePolyVoxEntityItem*>(this)->_meshDirty = false;
-        const_cast<RenderablePolyVoxEntityItem*>(this)->computeShapeInfoWorker();
+    if (_meshDirty && !_voxelDataDirty && !_volDataDirty && !_meshing) {
+        // wait for a shape that is already being computed, since its hulls are the starting point for the next one
+        if (!_computingShape) {
+            const_cast<RenderablePolyVoxEntityItem*>(this)->_meshDirty = false;
+            const_cast<RenderablePolyVoxEntityItem*>(this)->computeShapeInfoWorker();
+        }
         return false;
     }
     return true;
@@ -758,20 +770,26 @@ void RenderablePolyVoxEntityItem::computeShapeInfo(ShapeInfo& info) {
 bool RenderablePolyVoxEntityItem::updateDependents() {
     bool voxelDataDirty;
     bool volDataDirty;
+    bool startMeshing = false;
     withWriteLock([&] {
         voxelDataDirty = _voxelDataDirty;
         volDataDirty = _volDataDirty;
         if (_voxelDataDirty) {
             _voxelDataDirty = false;
         } else if (_volDataDirty) {
-            _volDataDirty = false;
+            // if a mesh is already being computed, leave the flag set so that a later call picks these edits up
+            startMeshing = !_meshing;
+            if (startMeshing) {
+                _volDataDirty = false;
+                _meshing = true;
+            }
         } else {
             _meshReady = true;
         }
     });
     if (voxelDataDirty) {
         decompressVolumeData();
-    } else if (volDataDirty) {
+    } else if (startMeshing) {
         recomputeMesh();
     }
 
@@ -789,6 +807,7 @@ void RenderablePolyVoxEntityItem::setVoxelVolumeSize(const glm::vec3& voxelVolum
         }
 
         _voxelDataDirty = true;
+        _allChunksDirty = true;
         _voxelVolumeSize = voxelVolumeSize;
         _volData.reset();
         _onCount = 0;
@@ -873,11 +892,11 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(const ivec3& v, uint8_t toVal
 
     result = updateOnCount(v, toValue);
 
-    if (isEdged()) {
-        _volData->setVoxelAt(v.x + 1, v.y + 1, v.z + 1, toValue);
-    } else {
-        _volData->setVoxelAt(v.x, v.y, v.z, toValue);
+    ivec3 volCoords = isEdged() ? v + 1 : v;
+    if (_volData->getVoxelAt(volCoords.x, volCoords.y, volCoords.z) != toValue) {
+        markVoxelDirty(volCoords);
     }
+    _volData->setVoxelAt(volCoords.x, volCoords.y, volCoords.z, toValue);
 
     if (glm::any(glm::equal(ivec3(0), v))) {
         _neighborsNeedUpdate = true;
@@ -971,6 +990,38 @@ void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacket() {
     // compress the data in _volData and save the results.  The compressed form is used during
     // saves to disk and for transmission over the wire to the entity-server
 
+    // while sculpting, edits arrive much faster than the volume can be compressed, so if a compression is
+    // already running it goes around again when it is done, and sends all of the edits made meanwhile at once.
+    bool alreadyCompressing;
+    withWriteLock([&] {
+        alreadyCompressing = _compressing;
+        _compressing = true;
+        _compressPending = alreadyCompressing;
+    });
+    if (alreadyCompressing) {
+        return;
+    }
+
+    EntityItemPointer entity = getThisPointer();
+    EntityTreeElementPointer element = getElement();
+    EntityTreePointer tree = element ? element->getTree() : nullptr;
+
+    QtConcurrent::run([entity, tree] {
+        auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
+        bool compressAgain;
+        do {
+            polyVoxEntity->compressVolumeData(tree);
+            polyVoxEntity->withWriteLock([&] {
+                compressAgain = polyVoxEntity->_compressPending;
+                polyVoxEntity->_compressPending = false;
+                polyVoxEntity->_compressing = compressAgain;
+            });
+        } while (compressAgain);
+    });
+}
+
+void RenderablePolyVoxEntityItem::compressVolumeData(EntityTreePointer tree) {
+    // this is run off the main thread, by compressVolumeDataAndSendEditPacket
     EntityItemPointer entity = getThisPointer();
 
     quint16 voxelXSize;
@@ -982,47 +1033,44 @@ void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacket() {
         voxelZSize = _voxelVolumeSize.z;
     });
 
-    EntityTreeElementPointer element = getElement();
-    EntityTreePointer tree = element ? element->getTree() : nullptr;
-
-    QtConcurrent::run([voxelXSize, voxelYSize, voxelZSize, entity, tree] {
-        auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
-        QByteArray uncompressedData = polyVoxEntity->volDataToArray(voxelXSize, voxelYSize, voxelZSize);
+    QByteArray uncompressedData = volDataToArray(voxelXSize, voxelYSize, voxelZSize);
 
-        QByteArray newVoxelData;
-        QDataStream writer(&newVoxelData, QIODevice::WriteOnly | QIODevice::Truncate);
+    QByteArray newVoxelData;
+    QDataStream writer(&newVoxelData, QIODevice::WriteOnly | QIODevice::Truncate);
 
-        writer << voxelXSize << voxelYSize << voxelZSize;
+    writer << voxelXSize << voxelYSize << voxelZSize;
 
-        QByteArray compressedData = qCompress(uncompressedData, 9);
-        writer << compressedData;
+    QByteArray compressedData = qCompress(uncompressedData, 9);
+    writer << compressedData;
 
-        // make sure the compressed data can be sent over the wire-protocol
-        if (newVoxelData.size() > 1150) {
-            // HACK -- until we have a way to allow for properties larger than MTU, don't update.
-            // revert the active voxel-space to the last version that fit.
-            qCDebug(entitiesrenderer) << "compressed voxel data is too large" << entity->getName() << entity->getID();
-            return;
-        }
+    // make sure the compressed data can be sent over the wire-protocol
+    if (newVoxelData.size() > 1150) {
+        // HACK -- until we have a way to allow for properties larger than MTU, don't update.
+        // revert the active voxel-space to the last version that fit.
+        qCDebug(entitiesrenderer) << "compressed voxel data is too large" << entity->getName() << entity->getID();
+        return;
+    }
 
-        auto now = usecTimestampNow();
-        entity->setLastEdited(now);
-        entity->setLastBroadcast(now);
+    auto now = usecTimestampNow();
+    entity->setLastEdited(now);
+    entity->setLastBroadcast(now);
 
-        std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity)->setVoxelData(newVoxelData);
+    setVoxelData(newVoxelData);
 
-        tree->withReadLock([&] {
-            EntityItemProperties properties = entity->getProperties();
-            properties.setVoxelDataDirty();
-            properties.setLastEdited(now);
+    if (!tree) {
+        return;
+    }
+    tree->withReadLock([&] {
+        EntityItemProperties properties = entity->getProperties();
+        properties.setVoxelDataDirty();
+        properties.setLastEdited(now);
 
-            EntitySimulationPointer simulation = tree ? tree->getSimulation() : nullptr;
-            PhysicalEntitySimulationPointer peSimulation = std::static_pointer_cast<PhysicalEntitySimulation>(simulation);
-            EntityEditPacketSender* packetSender = peSimulation ? peSimulation->getPacketSender() : nullptr;
-            if (packetSender) {
-                packetSender->queueEditEntityMessage(PacketType::EntityEdit, tree, entity->getID(), properties);
-            }
-        });
+        EntitySimulationPointer simulation = tree->getSimulation();
+        PhysicalEntitySimulationPointer peSimulation = std::static_pointer_cast<PhysicalEntitySimulation>(simulation);
+        EntityEditPacketSender* packetSender = peSimulation ? peSimulation->getPacketSender() : nullptr;
+        if (packetSender) {
+            packetSender->queueEditEntityMessage(PacketType::EntityEdit, tree, entity->getID(), properties);
+        }
     });
 }
 
@@ -1083,8 +1131,11 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int y = 0; y < _volData->getHeight(); y++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentXPNeighbor->getVoxel({ 0, y, z });
-                    if ((y == 0 || z == 0) && _volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
-                        bonkNeighbors();
+                    if (_volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
+                        if (y == 0 || z == 0) {
+                            bonkNeighbors();
+                        }
+                        markVoxelDirty({ _volData->getWidth() - 1, y, z });
                     }
                     _volData->setVoxelAt(_volData->getWidth() - 1, y, z, neighborValue);
                 }
@@ -1098,8 +1149,11 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentYPNeighbor->getVoxel({ x, 0, z });
-                    if ((x == 0 || z == 0) && _volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
-                        bonkNeighbors();
+                    if (_volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
+                        if (x == 0 || z == 0) {
+                            bonkNeighbors();
+                        }
+                        markVoxelDirty({ x, _volData->getHeight() - 1, z });
                     }
                     _volData->setVoxelAt(x, _volData->getHeight() - 1, z, neighborValue);
                 }
@@ -1113,9 +1167,11 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int y = 0; y < _volData->getHeight(); y++) {
                     uint8_t neighborValue = currentZPNeighbor->getVoxel({ x, y, 0 });
-                    _volData->setVoxelAt(x, y, _volData->getDepth() - 1, neighborValue);
-                    if ((x == 0 || y == 0) && _volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
-                        bonkNeighbors();
+                    if (_volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
+                        if (x == 0 || y == 0) {
+                            bonkNeighbors();
+                        }
+                        markVoxelDirty({ x, y, _volData->getDepth() - 1 });
                     }
                     _volData->setVoxelAt(x, y, _volData->getDepth() - 1, neighborValue);
                 }
@@ -1124,8 +1180,127 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
     }
 }
 
+// the volume is meshed, and its collision hulls are built, in cubes of this many voxels, so that an
+// edit only re-extracts the chunks around the voxels it changed
+const int MESH_CHUNK_SIZE = 16;
+
+class RenderablePolyVoxEntityItem::MeshChunk {
+public:
+    // in _volData coordinates
+    std::vector<PolyVox::PositionMaterialNormal> vertices;
+    std::vector<uint32_t> indices;
+};
+
+class RenderablePolyVoxEntityItem::HullChunk {
+public:
+    ShapeInfo::PointCollection pointCollection;
+    AABox box;
+};
+
+static int chunkIndex(const ivec3& chunk, const ivec3& numChunks) {
+    return (chunk.z * numChunks.y + chunk.y) * numChunks.x + chunk.x;
+}
+
+static ivec3 chunkCoordinates(int index, const ivec3& numChunks) {
+    return ivec3(index % numChunks.x, (index / numChunks.x) % numChunks.y, index / (numChunks.x * numChunks.y));
+}
+
+static graphics::MeshPointer buildMesh(const std::vector<PolyVox::PositionMaterialNormal>& vecVertices,
+                                       const std::vector<uint32_t>& vecIndices) {
+    // convert PolyVox mesh to a Sam mesh
+    graphics::MeshPointer mesh(new graphics::Mesh());
+
+    auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
+                                                     (gpu::Byte*)vecIndices.data());
+    auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
+    gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
+    mesh->setIndexBuffer(indexBufferView);
+
+    auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
+                                                      (gpu::Byte*)vecVertices.data());
+    auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
+    gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
+                                     vertexBufferPtr->getSize(),
+                                     sizeof(PolyVox::PositionMaterialNormal),
+                                     gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+    mesh->setVertexBuffer(vertexBufferView);
+
+
+    // TODO -- use 3-byte normals rather than 3-float normals
+    mesh->addAttribute(gpu::Stream::NORMAL,
+                       gpu::BufferView(vertexBufferPtr,
+                                       sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
+                                       vertexBufferPtr->getSize(),
+                                       sizeof(PolyVox::PositionMaterialNormal),
+                                       gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+
+    std::vector<graphics::Mesh::Part> parts;
+    parts.emplace_back(graphics::Mesh::Part((graphics::Index)0, // startIndex
+                                         (graphics::Index)vecIndices.size(), // numIndices
+                                         (graphics::Index)0, // baseVertex
+                                         graphics::Mesh::TRIANGLES)); // topology
+    mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(graphics::Mesh::Part),
+                                                        (gpu::Byte*) parts.data()), gpu::Element::PART_DRAWCALL));
+    return mesh;
+}
+
+ivec3 RenderablePolyVoxEntityItem::getNumMeshChunks() const {
+    // this assumes that the caller has locked the entity.
+    // the extractors make cells between each voxel and the next, so the last layer of voxels only closes cells
+    PolyVox::Vector3DInt32 upper = _volData->getEnclosingRegion().getUpperCorner();
+    ivec3 numCells(upper.getX(), upper.getY(), upper.getZ());
+    return glm::max((numCells + (MESH_CHUNK_SIZE - 1)) / MESH_CHUNK_SIZE, ivec3(1));
+}
+
+void RenderablePolyVoxEntityItem::markVoxelDirty(const ivec3& v) {
+    // v is in _volData coordinates.  This assumes that the caller has write-locked the entity.
+    if (_dirtyLow.x > _dirtyHigh.x) {
+        _dirtyLow = v;
+        _dirtyHigh = v;
+    } else {
+        _dirtyLow = glm::min(_dirtyLow, v);
+        _dirtyHigh = glm::max(_dirtyHigh, v);
+    }
+}
+
+RenderablePolyVoxEntityItem::MeshChunkPointer RenderablePolyVoxEntityItem::extractMeshChunk(
+        PolyVox::SimpleVolume<uint8_t>* volData, PolyVoxSurfaceStyle voxelSurfaceStyle, const ivec3& low, const ivec3& high) {
+    // A mesh object to hold the result of surface extraction
+    PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+    PolyVox::Region region(PolyVox::Vector3DInt32(low.x, low.y, low.z), PolyVox::Vector3DInt32(high.x, high.y, high.z));
+
+    switch (voxelSurfaceStyle) {
+        case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES:
+        case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
+            PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                (volData, region, &polyVoxMesh);
+            surfaceExtractor.execute();
+            break;
+        }
+        case PolyVoxEntityItem::SURFACE_EDGED_CUBIC:
+        case PolyVoxEntityItem::SURFACE_CUBIC: {
+            PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                (volData, region, &polyVoxMesh);
+            surfaceExtractor.execute();
+            break;
+        }
+    }
+
+    auto chunk = std::make_shared<MeshChunk>();
+    chunk->indices = polyVoxMesh.getIndices();
+    chunk->vertices = polyVoxMesh.getRawVertexData();
+
+    // the extractors place vertices relative to the lower corner of the region
+    PolyVox::Vector3DFloat offset((float)low.x, (float)low.y, (float)low.z);
+    for (auto& vertex : chunk->vertices) {
+        vertex.setPosition(vertex.getPosition() + offset);
+    }
+    return chunk;
+}
+
 void RenderablePolyVoxEntityItem::recomputeMesh() {
-    // use _volData to make a renderable mesh
+    // use _volData to make a renderable mesh.  Only the chunks near voxels that changed since the last
+    // mesh are extracted again, in parallel, and then all the chunks are stitched into one mesh.
     PolyVoxSurfaceStyle voxelSurfaceStyle;
     withReadLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
@@ -1134,83 +1309,78 @@ void RenderablePolyVoxEntityItem::recomputeMesh() {
     cacheNeighbors();
     copyUpperEdgesFromNeighbors();
 
-    auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
+    ivec3 numChunks;
+    std::vector<int> dirtyChunks;
+    std::vector<MeshChunkPointer> meshChunks;
+    withWriteLock([&] {
+        numChunks = getNumMeshChunks();
+        int totalChunks = numChunks.x * numChunks.y * numChunks.z;
+        if (numChunks != _numMeshChunks || (int)_meshChunks.size() != totalChunks) {
+            _numMeshChunks = numChunks;
+            _meshChunks.assign(totalChunks, nullptr);
+            _allChunksDirty = true;
+        }
 
-    QtConcurrent::run([entity, voxelSurfaceStyle] {
-        graphics::MeshPointer mesh(new graphics::Mesh());
+        if (_allChunksDirty) {
+            for (int i = 0; i < totalChunks; ++i) {
+                dirtyChunks.push_back(i);
+            }
+        } else if (_dirtyLow.x <= _dirtyHigh.x) {
+            // a chunk reads one layer of voxels past its upper corner, and its normals read one more on either side
+            ivec3 low = glm::max((_dirtyLow - 2) / MESH_CHUNK_SIZE, ivec3(0));
+            ivec3 high = glm::min((_dirtyHigh + 1) / MESH_CHUNK_SIZE, numChunks - 1);
+            loop3(low, high + 1, [&](const ivec3& chunk) {
+                dirtyChunks.push_back(chunkIndex(chunk, numChunks));
+            });
+        }
+        _allChunksDirty = false;
+        _dirtyLow = ivec3(0);
+        _dirtyHigh = ivec3(-1);
+        meshChunks = _meshChunks;
+    });
 
-        // A mesh object to hold the result of surface extraction
-        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+    auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
+    QtConcurrent::run([entity, voxelSurfaceStyle, numChunks, dirtyChunks, meshChunks]() mutable {
         entity->withReadLock([&] {
             PolyVox::SimpleVolume<uint8_t>* volData = entity->getVolData();
-            switch (voxelSurfaceStyle) {
-                case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_EDGED_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
+            PolyVox::Vector3DInt32 upper = volData->getEnclosingRegion().getUpperCorner();
+            ivec3 numCells(upper.getX(), upper.getY(), upper.getZ());
+            QtConcurrent::blockingMap(dirtyChunks, [&](int index) {
+                ivec3 low = chunkCoordinates(index, numChunks) * MESH_CHUNK_SIZE;
+                ivec3 high = glm::min(low + MESH_CHUNK_SIZE, numCells);
+                meshChunks[index] = extractMeshChunk(volData, voxelSurfaceStyle, low, high);
+            });
+        });
+
+        size_t numVertices = 0;
+        size_t numIndices = 0;
+        for (auto& chunk : meshChunks) {
+            if (chunk) {
+                numVertices += chunk->vertices.size();
+                numIndices += chunk->indices.size();
+            }
+        }
+        std::vector<PolyVox::PositionMaterialNormal> vertices;
+        std::vector<uint32_t> indices;
+        vertices.reserve(numVertices);
+        indices.reserve(numIndices);
+        for (auto& chunk : meshChunks) {
+            if (chunk) {
+                uint32_t baseVertex = (uint32_t)vertices.size();
+                vertices.insert(vertices.end(), chunk->vertices.begin(), chunk->vertices.end());
+                for (uint32_t index : chunk->indices) {
+                    indices.push_back(baseVertex + index);
                 }
             }
-        });
+        }
 
-        // convert PolyVox mesh to a Sam mesh
-        const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
-        auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
-                                                         (gpu::Byte*)vecIndices.data());
-        auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
-        gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
-        mesh->setIndexBuffer(indexBufferView);
-
-        const std::vector<PolyVox::PositionMaterialNormal>& vecVertices = polyVoxMesh.getRawVertexData();
-        auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
-                                                          (gpu::Byte*)vecVertices.data());
-        auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
-        gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
-                                         vertexBufferPtr->getSize(),
-                                         sizeof(PolyVox::PositionMaterialNormal),
-                                         gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-        mesh->setVertexBuffer(vertexBufferView);
-
-
-        // TODO -- use 3-byte normals rather than 3-float normals
-        mesh->addAttribute(gpu::Stream::NORMAL,
-                           gpu::BufferView(vertexBufferPtr,
-                                           sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
-                                           vertexBufferPtr->getSize(),
-                                           sizeof(PolyVox::PositionMaterialNormal),
-                                           gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
-
-        std::vector<graphics::Mesh::Part> parts;
-        parts.emplace_back(graphics::Mesh::Part((graphics::Index)0, // startIndex
-                                             (graphics::Index)vecIndices.size(), // numIndices
-                                             (graphics::Index)0, // baseVertex
-                                             graphics::Mesh::TRIANGLES)); // topology
-        mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(graphics::Mesh::Part),
-                                                            (gpu::Byte*) parts.data()), gpu::Element::PART_DRAWCALL));
-        entity->setMesh(mesh);
+        entity->setMesh(buildMesh(vertices, indices), meshChunks, dirtyChunks);
     });
 }
 
-void RenderablePolyVoxEntityItem::setMesh(graphics::MeshPointer mesh) {
+void RenderablePolyVoxEntityItem::setMesh(graphics::MeshPointer mesh, const std::vector<MeshChunkPointer>& meshChunks,
+                                          const std::vector<int>& dirtyChunks) {
     // this catches the payload from recomputeMesh
     bool neighborsNeedUpdate;
     withWriteLock([&] {
@@ -1218,6 +1388,9 @@ void RenderablePolyVoxEntityItem::setMesh(graphics::MeshPointer mesh) {
             _flags |= Simulation::DIRTY_SHAPE | Simulation::DIRTY_MASS;
         }
         _mesh = mesh;
+        _meshChunks = meshChunks;
+        _dirtyHullChunks.insert(_dirtyHullChunks.end(), dirtyChunks.begin(), dirtyChunks.end());
+        _meshing = false;
         _meshDirty = true;
         _meshReady = true;
         neighborsNeedUpdate = _neighborsNeedUpdate;
@@ -1232,142 +1405,190 @@ void RenderablePolyVoxEntityItem::setMesh(graphics::MeshPointer mesh) {
 
 void RenderablePolyVoxEntityItem::computeShapeInfoWorker() {
     // this creates a collision-shape for the physics engine.  The shape comes from
-    // _volData for cubic extractors and from _mesh for marching-cube extractors
+    // _volData for cubic extractors and from _mesh for marching-cube extractors.
+    // The hulls are kept per mesh chunk, and only the chunks that were re-meshed are rebuilt.
     if (!_meshReady) {
         return;
     }
 
     EntityItemPointer entity = getThisPointer();
+    glm::mat4 vtoM = voxelToLocalMatrix();
 
     PolyVoxSurfaceStyle voxelSurfaceStyle;
     glm::vec3 voxelVolumeSize;
-    graphics::MeshPointer mesh;
+    ivec3 numChunks;
+    std::vector<MeshChunkPointer> meshChunks;
+    std::vector<HullChunkPointer> hullChunks;
+    std::vector<int> dirtyChunks;
 
-    withReadLock([&] {
+    withWriteLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
         voxelVolumeSize = _voxelVolumeSize;
-        mesh = _mesh;
+        numChunks = getNumMeshChunks();
+        meshChunks = _meshChunks;
+        hullChunks = _hullChunks;
+
+        int totalChunks = numChunks.x * numChunks.y * numChunks.z;
+        if ((int)hullChunks.size() != totalChunks || vtoM != _hullChunksTransform) {
+            // the hulls are in model-frame, so they all move when the voxels do
+            hullChunks.assign(totalChunks, nullptr);
+            for (int i = 0; i < totalChunks; ++i) {
+                dirtyChunks.push_back(i);
+            }
+        } else {
+            dirtyChunks = _dirtyHullChunks;
+            std::sort(dirtyChunks.begin(), dirtyChunks.end());
+            dirtyChunks.erase(std::unique(dirtyChunks.begin(), dirtyChunks.end()), dirtyChunks.end());
+        }
+        if ((int)meshChunks.size() != totalChunks) {
+            meshChunks.clear();
+        }
+        _dirtyHullChunks.clear();
+        _hullChunksTransform = vtoM;
+        _computingShape = true;
     });
 
-    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize, mesh] {
+    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize, vtoM, numChunks, meshChunks, hullChunks, dirtyChunks]() mutable {
         auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
-        QVector<QVector<glm::vec3>> pointCollection;
-        AABox box;
-        glm::mat4 vtoM = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity)->voxelToLocalMatrix();
-
-        if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
-            voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES) {
-            // pull each triangle in the mesh into a polyhedron which can be collided with
-            unsigned int i = 0;
-
-            const gpu::BufferView& vertexBufferView = mesh->getVertexBuffer();
-            const gpu::BufferView& indexBufferView = mesh->getIndexBuffer();
-
-            gpu::BufferView::Iterator<const uint32_t> it = indexBufferView.cbegin<uint32_t>();
-            while (it != indexBufferView.cend<uint32_t>()) {
-                uint32_t p0Index = *(it++);
-                uint32_t p1Index = *(it++);
-                uint32_t p2Index = *(it++);
-
-                const glm::vec3& p0 = vertexBufferView.get<const glm::vec3>(p0Index);
-                const glm::vec3& p1 = vertexBufferView.get<const glm::vec3>(p1Index);
-                const glm::vec3& p2 = vertexBufferView.get<const glm::vec3>(p2Index);
-
-                glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
-                glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
-                glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
-
-                glm::vec3 p0Model = glm::vec3(vtoM * glm::vec4(p0, 1.0f));
-                glm::vec3 p1Model = glm::vec3(vtoM * glm::vec4(p1, 1.0f));
-                glm::vec3 p2Model = glm::vec3(vtoM * glm::vec4(p2, 1.0f));
-                glm::vec3 p3Model = glm::vec3(vtoM * glm::vec4(p3, 1.0f));
-
-                box += p0Model;
-                box += p1Model;
-                box += p2Model;
-                box += p3Model;
-
-                QVector<glm::vec3> pointsInPart;
-                pointsInPart << p0Model;
-                pointsInPart << p1Model;
-                pointsInPart << p2Model;
-                pointsInPart << p3Model;
-                // add next convex hull
-                QVector<glm::vec3> newMeshPoints;
-                pointCollection << newMeshPoints;
-                // add points to the new convex hull
-                pointCollection[i++] << pointsInPart;
-            }
-        } else {
-            unsigned int i = 0;
-            polyVoxEntity->forEachVoxelValue(voxelVolumeSize, [&](const ivec3& v, uint8_t value) {
-                if (value > 0) {
-                    const auto& x = v.x;
-                    const auto& y = v.y;
-                    const auto& z = v.z;
-                    if (glm::all(glm::greaterThan(v, ivec3(0))) && 
-                        glm::all(glm::lessThan(v, ivec3(voxelVolumeSize) - 1)) && 
-                        (polyVoxEntity->getVoxelInternal({ x - 1, y, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y - 1, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y, z - 1 }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x + 1, y, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y + 1, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y, z + 1 }) > 0)) {
-                        // this voxel has neighbors in every cardinal direction, so there's no need
-                        // to include it in the collision hull.
+        bool isMarchingCubes = voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
+            voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES;
+        // user voxel-coords are offset from _volData coords when edged
+        ivec3 edgeOffset(PolyVoxEntityItem::isEdged(voxelSurfaceStyle) ? 1 : 0);
+
+        polyVoxEntity->withReadLock([&] {
+            QtConcurrent::blockingMap(dirtyChunks, [&](int index) {
+                auto hullChunk = std::make_shared<HullChunk>();
+                QVector<QVector<glm::vec3>>& pointCollection = hullChunk->pointCollection;
+                AABox& box = hullChunk->box;
+
+                if (isMarchingCubes) {
+                    if (index >= (int)meshChunks.size() || !meshChunks[index]) {
+                        hullChunks[index] = hullChunk;
                         return;
                     }
 
-                    QVector<glm::vec3> pointsInPart;
-
-                    float offL = -0.5f;
-                    float offH = 0.5f;
-                    if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
-                        offL += 1.0f;
-                        offH += 1.0f;
+                    // pull each triangle in the mesh into a polyhedron which can be collided with
+                    const MeshChunk& meshChunk = *meshChunks[index];
+                    for (size_t i = 0; i + 2 < meshChunk.indices.size(); i += 3) {
+                        PolyVox::Vector3DFloat v0 = meshChunk.vertices[meshChunk.indices[i]].getPosition();
+                        PolyVox::Vector3DFloat v1 = meshChunk.vertices[meshChunk.indices[i + 1]].getPosition();
+                        PolyVox::Vector3DFloat v2 = meshChunk.vertices[meshChunk.indices[i + 2]].getPosition();
+                        glm::vec3 p0(v0.getX(), v0.getY(), v0.getZ());
+                        glm::vec3 p1(v1.getX(), v1.getY(), v1.getZ());
+                        glm::vec3 p2(v2.getX(), v2.getY(), v2.getZ());
+
+                        glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
+                        glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+                        glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
+
+                        glm::vec3 p0Model = glm::vec3(vtoM * glm::vec4(p0, 1.0f));
+                        glm::vec3 p1Model = glm::vec3(vtoM * glm::vec4(p1, 1.0f));
+                        glm::vec3 p2Model = glm::vec3(vtoM * glm::vec4(p2, 1.0f));
+                        glm::vec3 p3Model = glm::vec3(vtoM * glm::vec4(p3, 1.0f));
+
+                        box += p0Model;
+                        box += p1Model;
+                        box += p2Model;
+                        box += p3Model;
+
+                        QVector<glm::vec3> pointsInPart;
+                        pointsInPart << p0Model;
+                        pointsInPart << p1Model;
+                        pointsInPart << p2Model;
+                        pointsInPart << p3Model;
+                        // add next convex hull
+                        pointCollection << pointsInPart;
                     }
-
-                    glm::vec3 p000 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offL, 1.0f));
-                    glm::vec3 p001 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offH, 1.0f));
-                    glm::vec3 p010 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offL, 1.0f));
-                    glm::vec3 p011 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offH, 1.0f));
-                    glm::vec3 p100 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offL, 1.0f));
-                    glm::vec3 p101 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offH, 1.0f));
-                    glm::vec3 p110 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offL, 1.0f));
-                    glm::vec3 p111 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offH, 1.0f));
-
-                    box += p000;
-                    box += p001;
-                    box += p010;
-                    box += p011;
-                    box += p100;
-                    box += p101;
-                    box += p110;
-                    box += p111;
-
-                    pointsInPart << p000;
-                    pointsInPart << p001;
-                    pointsInPart << p010;
-                    pointsInPart << p011;
-                    pointsInPart << p100;
-                    pointsInPart << p101;
-                    pointsInPart << p110;
-                    pointsInPart << p111;
-
-                    // add next convex hull
-                    QVector<glm::vec3> newMeshPoints;
-                    pointCollection << newMeshPoints;
-                    // add points to the new convex hull
-                    pointCollection[i++] << pointsInPart;
+                } else {
+                    // each voxel belongs to the chunk that contains it
+                    ivec3 low = chunkCoordinates(index, numChunks) * MESH_CHUNK_SIZE - edgeOffset;
+                    ivec3 high = glm::min(low + MESH_CHUNK_SIZE, ivec3(voxelVolumeSize));
+                    low = glm::max(low, ivec3(0));
+                    loop3(low, high, [&](const ivec3& v) {
+                        if (polyVoxEntity->getVoxelInternal(v) == 0) {
+                            return;
+                        }
+
+                        const auto& x = v.x;
+                        const auto& y = v.y;
+                        const auto& z = v.z;
+                        if (glm::all(glm::greaterThan(v, ivec3(0))) &&
+                            glm::all(glm::lessThan(v, ivec3(voxelVolumeSize) - 1)) &&
+                            (polyVoxEntity->getVoxelInternal({ x - 1, y, z }) > 0) &&
+                            (polyVoxEntity->getVoxelInternal({ x, y - 1, z }) > 0) &&
+                            (polyVoxEntity->getVoxelInternal({ x, y, z - 1 }) > 0) &&
+                            (polyVoxEntity->getVoxelInternal({ x + 1, y, z }) > 0) &&
+                            (polyVoxEntity->getVoxelInternal({ x, y + 1, z }) > 0) &&
+                            (polyVoxEntity->getVoxelInternal({ x, y, z + 1 }) > 0)) {
+                            // this voxel has neighbors in every cardinal direction, so there's no need
+                            // to include it in the collision hull.
+                            return;
+                        }
+
+                        QVector<glm::vec3> pointsInPart;
+
+                        float offL = -0.5f;
+                        float offH = 0.5f;
+                        if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
+                            offL += 1.0f;
+                            offH += 1.0f;
+                        }
+
+                        glm::vec3 p000 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offL, 1.0f));
+                        glm::vec3 p001 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offH, 1.0f));
+                        glm::vec3 p010 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offL, 1.0f));
+                        glm::vec3 p011 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offH, 1.0f));
+                        glm::vec3 p100 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offL, 1.0f));
+                        glm::vec3 p101 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offH, 1.0f));
+                        glm::vec3 p110 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offL, 1.0f));
+                        glm::vec3 p111 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offH, 1.0f));
+
+                        box += p000;
+                        box += p001;
+                        box += p010;
+                        box += p011;
+                        box += p100;
+                        box += p101;
+                        box += p110;
+                        box += p111;
+
+                        pointsInPart << p000;
+                        pointsInPart << p001;
+                        pointsInPart << p010;
+                        pointsInPart << p011;
+                        pointsInPart << p100;
+                        pointsInPart << p101;
+                        pointsInPart << p110;
+                        pointsInPart << p111;
+
+                        // add next convex hull
+                        pointCollection << pointsInPart;
+                    });
                 }
+                hullChunks[index] = hullChunk;
             });
+        });
+
+        QVector<QVector<glm::vec3>> pointCollection;
+        AABox box;
+        for (auto& hullChunk : hullChunks) {
+            if (hullChunk && !hullChunk->pointCollection.isEmpty()) {
+                pointCollection << hullChunk->pointCollection;
+                box += hullChunk->box;
+            }
         }
-        polyVoxEntity->setCollisionPoints(pointCollection, box);
+        polyVoxEntity->setCollisionPoints(pointCollection, box, hullChunks);
     });
 }
 
-void RenderablePolyVoxEntityItem::setCollisionPoints(ShapeInfo::PointCollection pointCollection, AABox box) {
+void RenderablePolyVoxEntityItem::setCollisionPoints(ShapeInfo::PointCollection pointCollection, AABox box,
+                                                     const std::vector<HullChunkPointer>& hullChunks) {
     // this catches the payload from computeShapeInfoWorker
+    withWriteLock([&] {
+        _hullChunks = hullChunks;
+        _computingShape = false;
+    });
+
     if (pointCollection.isEmpty()) {
         EntityItem::computeShapeInfo(_shapeInfo);
         return;
@@ -1383,7 +1604,6 @@ void RenderablePolyVoxEntityItem::setCollisionPoints(ShapeInfo::PointCollection
             QString::number(_registrationPoint.z);
         _shapeInfo.setParams(SHAPE_TYPE_COMPOUND, collisionModelDimensions, shapeKey);
         _shapeInfo.setPointCollection(pointCollection);
-        _meshDirty = false;
     });
 }
 
@@ -13,6 +13,8 @@
 #define hifi_RenderablePolyVoxEntityItem_h
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #include <QSemaphore>
 
@@ -35,6 +37,12 @@ class PolyVoxEntityRenderer;
 class RenderablePolyVoxEntityItem : public PolyVoxEntityItem, public scriptable::ModelProvider {
     friend class render::entities::PolyVoxEntityRenderer;
 
+    // the extracted surface and collision hulls of one chunk of the volume
+    class MeshChunk;
+    class HullChunk;
+    using MeshChunkPointer = std::shared_ptr<const MeshChunk>;
+    using HullChunkPointer = std::shared_ptr<const HullChunk>;
+
 public:
     static EntityItemPointer factory(const EntityItemID& entityID, const EntityItemProperties& properties);
     RenderablePolyVoxEntityItem(const EntityItemID& entityItemID);
@@ -108,8 +116,8 @@ public:
     void forEachVoxelValue(const ivec3& voxelSize, std::function<void(const ivec3&, uint8_t)> thunk);
     QByteArray volDataToArray(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) const;
 
-    void setMesh(graphics::MeshPointer mesh);
-    void setCollisionPoints(ShapeInfo::PointCollection points, AABox box);
+    void setMesh(graphics::MeshPointer mesh, const std::vector<MeshChunkPointer>& meshChunks, const std::vector<int>& dirtyChunks);
+    void setCollisionPoints(ShapeInfo::PointCollection points, AABox box, const std::vector<HullChunkPointer>& hullChunks);
     PolyVox::SimpleVolume<uint8_t>* getVolData() { return _volData.get(); }
 
     uint8_t getVoxelInternal(const ivec3& v) const;
@@ -125,6 +133,10 @@ private:
     PolyVox::RaycastResult doRayCast(glm::vec4 originInVoxel, glm::vec4 farInVoxel, glm::vec4& result) const;
 
     void recomputeMesh();
+    ivec3 getNumMeshChunks() const;
+    void markVoxelDirty(const ivec3& v);
+    static MeshChunkPointer extractMeshChunk(PolyVox::SimpleVolume<uint8_t>* volData, PolyVoxSurfaceStyle voxelSurfaceStyle,
+                                             const ivec3& low, const ivec3& high);
     void cacheNeighbors();
     void copyUpperEdgesFromNeighbors();
     void bonkNeighbors();
@@ -133,6 +145,7 @@ private:
     // these are run off the main thread
     void decompressVolumeData();
     void compressVolumeDataAndSendEditPacket();
+    void compressVolumeData(EntityTreePointer tree);
     void computeShapeInfoWorker();
 
     // The PolyVoxEntityItem class has _voxelData which contains dimensions and compressed voxel data.  The dimensions
@@ -148,6 +161,22 @@ private:
     bool _volDataDirty { false }; // does recomputeMesh need to be called?
     int _onCount; // how many non-zero voxels are in _volData
 
+    // the region of _volData changed since the last mesh, empty when _dirtyLow > _dirtyHigh
+    ivec3 _dirtyLow { 0 };
+    ivec3 _dirtyHigh { -1 };
+    bool _allChunksDirty { true };
+    bool _meshing { false }; // is recomputeMesh running?
+    ivec3 _numMeshChunks { 0 };
+    std::vector<MeshChunkPointer> _meshChunks;
+
+    bool _computingShape { false }; // is computeShapeInfoWorker running?
+    std::vector<HullChunkPointer> _hullChunks;
+    std::vector<int> _dirtyHullChunks; // re-meshed since the hulls were last built
+    glm::mat4 _hullChunksTransform;
+
+    bool _compressing { false }; // is compressVolumeDataAndSendEditPacket running?
+    bool _compressPending { false }; // were there edits while it was?
+
     bool _neighborsNeedUpdate { false };
 
     // these are cached lookups of _xNNeighborID, _yNNeighborID, _zNNeighborID, _xPNeighborID, _yPNeighborID, _zPNeighborID
@@ -219,7 +219,7 @@ DiffTraversal::Type DiffTraversal::prepareNewTraversal(const DiffTraversal::View
         _getNextVisibleElementCallback = [this](DiffTraversal::VisibleElement& next) {
             _path.back().getNextVisibleElementFirstTime(next, _currentView);
         };
-    } else if (!_currentView.usesViewFrustums() || _completedView.isVerySimilar(view)) {
+    } else if (!_currentView.usesViewFrustums() || (!_forceDifferential && _completedView.isVerySimilar(view))) {
         type = Type::Repeat;
         _getNextVisibleElementCallback = [this](DiffTraversal::VisibleElement& next) {
             _path.back().getNextVisibleElementRepeat(next, _completedView, _completedView.startTime);
@@ -233,6 +233,8 @@ DiffTraversal::Type DiffTraversal::prepareNewTraversal(const DiffTraversal::View
         };
     }
 
+    _forceDifferential = false;
+
     _path.clear();
     _path.push_back(DiffTraversal::Waypoint(root));
     // set root fork's index such that root element returned at getNextElement()
@@ -274,6 +276,13 @@ void DiffTraversal::getNextVisibleElement(DiffTraversal::VisibleElement& next) {
     }
 }
 
+void DiffTraversal::finishSharedFirstTraversal(const View& sharedView) {
+    _path.clear();
+    // what was sent so far is what sharedView sees
+    _completedView = sharedView;
+    _forceDifferential = true;
+}
+
 void DiffTraversal::setScanCallback(std::function<void (DiffTraversal::VisibleElement&)> cb) {
     if (!cb) {
         _scanElementCallback = [](DiffTraversal::VisibleElement& a){};
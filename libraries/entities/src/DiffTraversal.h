@@ -12,6 +12,9 @@
 #ifndef hifi_DiffTraversal_h
 #define hifi_DiffTraversal_h
 
+#include <utility>
+#include <vector>
+
 #include <shared/ConicalViewFrustum.h>
 
 #include "EntityTreeElement.h"
@@ -59,6 +62,9 @@ public:
 
     typedef enum { First, Repeat, Differential } Type;
 
+    // entities found in view by a First traversal, with their priority
+    using VisibleEntities = std::vector<std::pair<EntityItemPointer, float>>;
+
     DiffTraversal();
 
     Type prepareNewTraversal(const DiffTraversal::View& view, EntityTreeElementPointer root);
@@ -73,12 +79,18 @@ public:
 
     void reset() { _path.clear(); _completedView.startTime = 0; } // resets our state to force a new "First" traversal
 
+    // completes the prepared First traversal without walking the tree, because its entities were collected by
+    // another client's traversal of sharedView. The next traversal is a Differential one against sharedView,
+    // to pick up what only this view sees.
+    void finishSharedFirstTraversal(const View& sharedView);
+
 private:
     void getNextVisibleElement(VisibleElement& next);
 
     View _currentView;
     View _completedView;
     std::vector<Waypoint> _path;
+    bool _forceDifferential { false };
     std::function<void (VisibleElement&)> _getNextVisibleElementCallback { nullptr };
     std::function<void (VisibleElement&)> _scanElementCallback { [](VisibleElement& e){} };
 };
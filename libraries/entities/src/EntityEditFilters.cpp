@@ -41,6 +41,16 @@ QList<EntityItemID> EntityEditFilters::getZonesByPosition(glm::vec3& position) {
     return zones;
 }
 
+// the properties the edit changes, as passed to the filter
+static QScriptValue changedPropertiesToScriptValue(QScriptEngine* engine, EntityItemProperties& properties) {
+    auto oldProperties = properties.getDesiredProperties();
+    auto specifiedProperties = properties.getChangedProperties();
+    properties.setDesiredProperties(specifiedProperties);
+    QScriptValue values = properties.copyToScriptValue(engine, false, true, true);
+    properties.setDesiredProperties(oldProperties);
+    return values;
+}
+
 bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut,
         bool& wasChanged, EntityTree::FilterType filterType, EntityItemID& itemID, EntityItemPointer& existingEntity) {
     
@@ -72,103 +82,127 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 return true; // accept the message
             }
 
-            auto oldProperties = propertiesIn.getDesiredProperties();
-            auto specifiedProperties = propertiesIn.getChangedProperties();
-            propertiesIn.setDesiredProperties(specifiedProperties);
-            QScriptValue inputValues = propertiesIn.copyToScriptValue(filterData.engine, false, true, true);
-            propertiesIn.setDesiredProperties(oldProperties);
-
-            auto in = QJsonValue::fromVariant(inputValues.toVariant()); // grab json copy now, because the inputValues might be side effected by the filter.
+            // skip the script if the edit changes none of the properties this filter looks at
+            if (filterData.wantsToFilterProperties && filterType != EntityTree::FilterType::Delete &&
+                !(propertiesIn.getChangedProperties() & filterData.filteredProperties)) {
+                continue;
+            }
 
-            QScriptValueList args;
-            args << inputValues;
-            args << filterType;
+            // filterData holds a reference to the pool, so its engines outlive a concurrent removeFilter()
+            auto filterEngine = filterData.engines->acquire();
+            if (!filterEngine) {
+                return false;
+            }
+            bool accepted = runFilter(*filterEngine, filterData, id, propertiesIn, propertiesOut, wasChanged,
+                                      filterType, existingEntity);
+            filterData.engines->release(filterEngine);
 
-            // get the current properties for then entity and include them for the filter call
-            if (existingEntity && filterData.wantsOriginalProperties) {
-                auto currentProperties = existingEntity->getProperties(filterData.includedOriginalProperties);
-                QScriptValue currentValues = currentProperties.copyToScriptValue(filterData.engine, false, true, true);
-                args << currentValues;
+            if (!accepted) {
+                return false;
             }
+        }
+    }
+    // if we made it here, 
+    return true;
+}
 
+bool EntityEditFilters::runFilter(FilterEngine& filterEngine, FilterData& filterData, const EntityItemID& zoneID,
+        EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged,
+        EntityTree::FilterType filterType, EntityItemPointer& existingEntity) {
+    QScriptEngine* engine = filterEngine.engine.get();
 
-            // get the zone properties
-            if (filterData.wantsZoneProperties) {
-                auto zoneEntity = _tree->findEntityByEntityItemID(id);
-                if (zoneEntity) {
-                    auto zoneProperties = zoneEntity->getProperties(filterData.includedZoneProperties);
-                    QScriptValue zoneValues = zoneProperties.copyToScriptValue(filterData.engine, false, true, true);
-
-                    if (filterData.wantsZoneBoundingBox) {
-                        bool success = true;
-                        AABox aaBox = zoneEntity->getAABox(success);
-                        if (success) {
-                            QScriptValue boundingBox = filterData.engine->newObject();
-                            QScriptValue bottomRightNear = vec3toScriptValue(filterData.engine, aaBox.getCorner());
-                            QScriptValue topFarLeft = vec3toScriptValue(filterData.engine, aaBox.calcTopFarLeft());
-                            QScriptValue center = vec3toScriptValue(filterData.engine, aaBox.calcCenter());
-                            QScriptValue boundingBoxDimensions = vec3toScriptValue(filterData.engine, aaBox.getDimensions());
-                            boundingBox.setProperty("brn", bottomRightNear);
-                            boundingBox.setProperty("tfl", topFarLeft);
-                            boundingBox.setProperty("center", center);
-                            boundingBox.setProperty("dimensions", boundingBoxDimensions);
-                            zoneValues.setProperty("boundingBox", boundingBox);
-                        }
-                    }
+    QScriptValueList args;
+    args << changedPropertiesToScriptValue(engine, propertiesIn);
+    args << filterType;
 
-                    // If this is an add or delete, or original properties weren't requested
-                    // there won't be original properties in the args, but zone properties need
-                    // to be the fourth parameter, so we need to pad the args accordingly
-                    int EXPECTED_ARGS = 3;
-                    if (args.length() < EXPECTED_ARGS) {
-                        args << QScriptValue();
-                    }
-                    assert(args.length() == EXPECTED_ARGS); // we MUST have 3 args by now!
-                    args << zoneValues;
+    // get the current properties for then entity and include them for the filter call
+    if (existingEntity && filterData.wantsOriginalProperties) {
+        auto currentProperties = existingEntity->getProperties(filterData.includedOriginalProperties);
+        QScriptValue currentValues = currentProperties.copyToScriptValue(engine, false, true, true);
+        args << currentValues;
+    }
+
+    // get the zone properties
+    if (filterData.wantsZoneProperties) {
+        auto zoneEntity = _tree->findEntityByEntityItemID(zoneID);
+        if (zoneEntity) {
+            quint64 zoneLastEdited = zoneEntity->getLastEdited();
+            if (!filterEngine.hasZoneProperties || filterEngine.zoneLastEdited != zoneLastEdited) {
+                filterEngine.zoneProperties = zoneEntity->getProperties(filterData.includedZoneProperties);
+                filterEngine.zoneLastEdited = zoneLastEdited;
+                filterEngine.hasZoneProperties = true;
+            }
+            QScriptValue zoneValues = filterEngine.zoneProperties.copyToScriptValue(engine, false, true, true);
+
+            if (filterData.wantsZoneBoundingBox) {
+                // the box also moves with the zone's parent, so it isn't cached with the properties
+                bool success = true;
+                AABox aaBox = zoneEntity->getAABox(success);
+                if (success) {
+                    QScriptValue boundingBox = engine->newObject();
+                    QScriptValue bottomRightNear = vec3toScriptValue(engine, aaBox.getCorner());
+                    QScriptValue topFarLeft = vec3toScriptValue(engine, aaBox.calcTopFarLeft());
+                    QScriptValue center = vec3toScriptValue(engine, aaBox.calcCenter());
+                    QScriptValue boundingBoxDimensions = vec3toScriptValue(engine, aaBox.getDimensions());
+                    boundingBox.setProperty("brn", bottomRightNear);
+                    boundingBox.setProperty("tfl", topFarLeft);
+                    boundingBox.setProperty("center", center);
+                    boundingBox.setProperty("dimensions", boundingBoxDimensions);
+                    zoneValues.setProperty("boundingBox", boundingBox);
                 }
             }
 
-            QScriptValue result = filterData.filterFn.call(_nullObjectForFilter, args);
-
-            if (filterData.uncaughtExceptions()) {
-                return false;
+            // If this is an add or delete, or original properties weren't requested
+            // there won't be original properties in the args, but zone properties need
+            // to be the fourth parameter, so we need to pad the args accordingly
+            int EXPECTED_ARGS = 3;
+            if (args.length() < EXPECTED_ARGS) {
+                args << QScriptValue();
             }
+            assert(args.length() == EXPECTED_ARGS); // we MUST have 3 args by now!
+            args << zoneValues;
+        }
+    }
 
-            if (result.isObject()) {
-                // make propertiesIn reflect the changes, for next filter...
-                propertiesIn.copyFromScriptValue(result, false);
+    QScriptValue result = filterEngine.filterFn.call(filterEngine.nullObject, args);
 
-                // and update propertiesOut too.  TODO: this could be more efficient...
-                propertiesOut.copyFromScriptValue(result, false);
-                // Javascript objects are == only if they are the same object. To compare arbitrary values, we need to use JSON.
-                auto out = QJsonValue::fromVariant(result.toVariant());
-                wasChanged |= (in != out);
-            } else if (result.isBool()) {
+    if (filterData.engines->hadUncaughtExceptions(filterEngine)) {
+        return false;
+    }
 
-                // if the filter returned false, then it's authoritative
-                if (!result.toBool()) {
-                    return false;
-                }
+    if (result.isObject()) {
+        // the filter may have side effected the values it was passed, so compare against a fresh copy of them,
+        // which is only made when the filter returns properties
+        // Javascript objects are == only if they are the same object. To compare arbitrary values, we need to use JSON.
+        auto in = QJsonValue::fromVariant(changedPropertiesToScriptValue(engine, propertiesIn).toVariant());
 
-                // otherwise, assume it wants to pass all properties
-                propertiesOut = propertiesIn;
-                wasChanged = false;
-                
-            } else {
-                return false;
-            }
+        // make propertiesIn reflect the changes, for next filter...
+        propertiesIn.copyFromScriptValue(result, false);
+
+        // and update propertiesOut too.  TODO: this could be more efficient...
+        propertiesOut.copyFromScriptValue(result, false);
+        auto out = QJsonValue::fromVariant(result.toVariant());
+        wasChanged |= (in != out);
+    } else if (result.isBool()) {
+
+        // if the filter returned false, then it's authoritative
+        if (!result.toBool()) {
+            return false;
         }
+
+        // otherwise, assume it wants to pass all properties
+        propertiesOut = propertiesIn;
+        wasChanged = false;
+
+    } else {
+        return false;
     }
-    // if we made it here, 
     return true;
 }
 
 void EntityEditFilters::removeFilter(EntityItemID entityID) {
+    // the engines are deleted along with the last reference to their pool
     QWriteLocker writeLock(&_lock);
-    FilterData filterData = _filterDataMap.value(entityID);
-    if (filterData.valid()) {
-        delete filterData.engine;
-    }
     _filterDataMap.remove(entityID);
 }
 
@@ -247,6 +281,54 @@ static bool hadUncaughtExceptions(QScriptEngine& engine, const QString& fileName
     return false;
 }
 
+EntityEditFilters::FilterEnginePointer EntityEditFilters::FilterEnginePool::createEngine() const {
+    auto filterEngine = std::make_shared<FilterEngine>();
+    filterEngine->engine.reset(new QScriptEngine());
+    QScriptEngine* engine = filterEngine->engine.get();
+
+    engine->evaluate(_scriptContents, _scriptURL);
+    if (hadUncaughtExceptions(*filterEngine)) {
+        return nullptr;
+    }
+
+    auto global = engine->globalObject();
+    auto entitiesObject = engine->newObject();
+    entitiesObject.setProperty("ADD_FILTER_TYPE", EntityTree::FilterType::Add);
+    entitiesObject.setProperty("EDIT_FILTER_TYPE", EntityTree::FilterType::Edit);
+    entitiesObject.setProperty("PHYSICS_FILTER_TYPE", EntityTree::FilterType::Physics);
+    entitiesObject.setProperty("DELETE_FILTER_TYPE", EntityTree::FilterType::Delete);
+    global.setProperty("Entities", entitiesObject);
+    filterEngine->filterFn = global.property("filter");
+    return filterEngine;
+}
+
+EntityEditFilters::FilterEnginePointer EntityEditFilters::FilterEnginePool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_idleEngines.empty()) {
+            auto filterEngine = _idleEngines.back();
+            _idleEngines.pop_back();
+            return filterEngine;
+        }
+    }
+
+    // evaluating the script may take a while, so it's done without the lock
+    auto filterEngine = createEngine();
+    if (filterEngine && !filterEngine->filterFn.isFunction()) {
+        return nullptr;
+    }
+    return filterEngine;
+}
+
+void EntityEditFilters::FilterEnginePool::release(FilterEnginePointer filterEngine) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _idleEngines.push_back(filterEngine);
+}
+
+bool EntityEditFilters::FilterEnginePool::hadUncaughtExceptions(FilterEngine& filterEngine) const {
+    return ::hadUncaughtExceptions(*filterEngine.engine, _scriptURL);
+}
+
 void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
     qDebug() << "script request completed for entity " << entityID;
     auto scriptRequest = qobject_cast<ResourceRequest*>(sender());
@@ -256,52 +338,42 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
         qInfo() << "Downloaded script:" << scriptContents;
         QScriptProgram program(scriptContents, urlString);
         if (hasCorrectSyntax(program)) {
-            // create a QScriptEngine for this script
-            QScriptEngine* engine = new QScriptEngine();
-            engine->evaluate(scriptContents);
-            if (!hadUncaughtExceptions(*engine, urlString)) {
-                // put the engine in the engine map (so we don't leak them, etc...)
+            // create the pool of engines for this script, and the first engine, to read the filter's options from
+            auto engines = std::make_shared<FilterEnginePool>(scriptContents, urlString);
+            auto filterEngine = engines->createEngine();
+            if (filterEngine) {
                 FilterData filterData;
-                filterData.engine = engine;
+                filterData.engines = engines;
                 filterData.rejectAll = false;
-                
-                // define the uncaughtException function
-                QScriptEngine& engineRef = *engine;
-                filterData.uncaughtExceptions = [&engineRef, urlString]() { return hadUncaughtExceptions(engineRef, urlString); };
 
                 // now get the filter function
-                auto global = engine->globalObject();
-                auto entitiesObject = engine->newObject();
-                entitiesObject.setProperty("ADD_FILTER_TYPE", EntityTree::FilterType::Add);
-                entitiesObject.setProperty("EDIT_FILTER_TYPE", EntityTree::FilterType::Edit);
-                entitiesObject.setProperty("PHYSICS_FILTER_TYPE", EntityTree::FilterType::Physics);
-                entitiesObject.setProperty("DELETE_FILTER_TYPE", EntityTree::FilterType::Delete);
-                global.setProperty("Entities", entitiesObject);
-                filterData.filterFn = global.property("filter");
-                if (!filterData.filterFn.isFunction()) {
+                QScriptValue filterFn = filterEngine->filterFn;
+                if (!filterFn.isFunction()) {
                     qDebug() << "Filter function specified but not found. Will reject all edits for those without lock rights.";
-                    delete engine;
+                    filterData.engines.reset();
                     filterData.rejectAll=true;
+                } else {
+                    engines->release(filterEngine);
                 }
 
                 // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterAddValue = filterData.filterFn.property("wantsToFilterAdd");
+                QScriptValue wantsToFilterAddValue = filterFn.property("wantsToFilterAdd");
                 filterData.wantsToFilterAdd = wantsToFilterAddValue.isBool() ? wantsToFilterAddValue.toBool() : true;
 
                 // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterEditValue = filterData.filterFn.property("wantsToFilterEdit");
+                QScriptValue wantsToFilterEditValue = filterFn.property("wantsToFilterEdit");
                 filterData.wantsToFilterEdit = wantsToFilterEditValue.isBool() ? wantsToFilterEditValue.toBool() : true;
 
                 // if the wantsToFilterPhysics is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterPhysicsValue = filterData.filterFn.property("wantsToFilterPhysics");
+                QScriptValue wantsToFilterPhysicsValue = filterFn.property("wantsToFilterPhysics");
                 filterData.wantsToFilterPhysics = wantsToFilterPhysicsValue.isBool() ? wantsToFilterPhysicsValue.toBool() : true;
 
                 // if the wantsToFilterDelete is a boolean evaluate as a boolean, otherwise assume false
-                QScriptValue wantsToFilterDeleteValue = filterData.filterFn.property("wantsToFilterDelete");
+                QScriptValue wantsToFilterDeleteValue = filterFn.property("wantsToFilterDelete");
                 filterData.wantsToFilterDelete = wantsToFilterDeleteValue.isBool() ? wantsToFilterDeleteValue.toBool() : false;
 
                 // check to see if the filterFn has properties asking for Original props
-                QScriptValue wantsOriginalPropertiesValue = filterData.filterFn.property("wantsOriginalProperties");
+                QScriptValue wantsOriginalPropertiesValue = filterFn.property("wantsOriginalProperties");
                 // if the wantsOriginalProperties is a boolean, or a string, or list of strings, then evaluate as follows:
                 //   - boolean - true  - include all original properties
                 //               false - no properties at all
@@ -322,7 +394,7 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
                 }
 
                 // check to see if the filterFn has properties asking for Zone props
-                QScriptValue wantsZonePropertiesValue = filterData.filterFn.property("wantsZoneProperties");
+                QScriptValue wantsZonePropertiesValue = filterFn.property("wantsZoneProperties");
                 // if the wantsZoneProperties is a boolean, or a string, or list of strings, then evaluate as follows:
                 //   - boolean - true  - include all Zone properties
                 //               false - no properties at all
@@ -363,6 +435,15 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
                     }
                 }
 
+                // check to see if the filterFn has properties limiting which edits it's run on
+                QScriptValue wantsToFilterPropertiesValue = filterFn.property("wantsToFilterProperties");
+                // if the wantsToFilterProperties is a string, or list of strings, then the filter is only run on
+                // adds and edits that change at least one of those properties
+                if (wantsToFilterPropertiesValue.isString() || wantsToFilterPropertiesValue.isArray()) {
+                    EntityPropertyFlagsFromScriptValue(wantsToFilterPropertiesValue, filterData.filteredProperties);
+                    filterData.wantsToFilterProperties = !filterData.filteredProperties.isEmpty();
+                }
+
                 _lock.lockForWrite();
                 _filterDataMap.insert(entityID, filterData);
                 _lock.unlock();
@@ -18,6 +18,9 @@
 #include <glm/glm.hpp>
 
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "EntityItemID.h"
 #include "EntityItemProperties.h"
@@ -26,8 +29,45 @@
 class EntityEditFilters : public QObject, public Dependency {
     Q_OBJECT
 public:
-    struct FilterData {
+    // a filter script, evaluated in its own engine
+    //   an engine is only ever used by one thread at a time, see FilterEnginePool
+    struct FilterEngine {
+        std::unique_ptr<QScriptEngine> engine;
         QScriptValue filterFn;
+        QScriptValue nullObject;
+
+        // the zone's properties are only read again once the zone has been edited,
+        //   and are converted to a fresh script value for every call, since the script may modify what it is passed
+        EntityItemProperties zoneProperties;
+        quint64 zoneLastEdited { 0 };
+        bool hasZoneProperties { false };
+    };
+    using FilterEnginePointer = std::shared_ptr<FilterEngine>;
+
+    // the engines of one filter script
+    //   edits may be filtered on several threads at once, so each caller checks out an engine of its own,
+    //   which is created (and the script evaluated) only when no idle engine is left
+    class FilterEnginePool {
+    public:
+        FilterEnginePool(const QString& scriptContents, const QString& scriptURL) :
+            _scriptContents(scriptContents), _scriptURL(scriptURL) {}
+
+        FilterEnginePointer createEngine() const;
+        FilterEnginePointer acquire();
+        void release(FilterEnginePointer engine);
+
+        bool hadUncaughtExceptions(FilterEngine& engine) const;
+
+    private:
+        QString _scriptContents;
+        QString _scriptURL;
+
+        std::mutex _mutex;
+        std::vector<FilterEnginePointer> _idleEngines;
+    };
+
+    struct FilterData {
+        std::shared_ptr<FilterEnginePool> engines;
         bool wantsOriginalProperties { false };
         bool wantsZoneProperties { false };
 
@@ -40,12 +80,13 @@ public:
         EntityPropertyFlags includedZoneProperties;
         bool wantsZoneBoundingBox { false };
 
-        std::function<bool()> uncaughtExceptions;
-        QScriptEngine* engine;
-        bool rejectAll;
-        
-        FilterData(): engine(nullptr), rejectAll(false) {};
-        bool valid() { return (rejectAll || (engine != nullptr && filterFn.isFunction() && uncaughtExceptions)); }
+        // edits that change none of these properties are accepted without running the script
+        bool wantsToFilterProperties { false };
+        EntityPropertyFlags filteredProperties;
+
+        bool rejectAll { false };
+
+        bool valid() { return (rejectAll || engines != nullptr); }
     };
 
     EntityEditFilters() {};
@@ -65,11 +106,13 @@ private slots:
     
 private:
     QList<EntityItemID> getZonesByPosition(glm::vec3& position);
+    bool runFilter(FilterEngine& filterEngine, FilterData& filterData, const EntityItemID& zoneID,
+                   EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged,
+                   EntityTree::FilterType filterType, EntityItemPointer& existingEntity);
 
     EntityTreePointer _tree {};
     bool _rejectAll {false};
-    QScriptValue _nullObjectForFilter{};
-    
+
     QReadWriteLock _lock;
     QMap<EntityItemID, FilterData> _filterDataMap;
 };
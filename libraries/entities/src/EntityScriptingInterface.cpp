@@ -871,6 +871,76 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorke
     return result;
 }
 
+QVector<RayToEntityIntersectionResult> EntityScriptingInterface::findRayIntersections(const QVector<PickRay>& rays,
+                bool precisionPicking, const QScriptValue& entityIdsToInclude, const QScriptValue& entityIdsToDiscard,
+                bool visibleOnly, bool collidableOnly) {
+    QVector<EntityItemID> entitiesToInclude = qVectorEntityItemIDFromScriptValue(entityIdsToInclude);
+    QVector<EntityItemID> entitiesToDiscard = qVectorEntityItemIDFromScriptValue(entityIdsToDiscard);
+
+    return findRayIntersectionsVector(rays, precisionPicking, entitiesToInclude, entitiesToDiscard, visibleOnly, collidableOnly);
+}
+
+QVector<RayToEntityIntersectionResult> EntityScriptingInterface::findRayIntersectionsVector(const QVector<PickRay>& rays,
+                bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude,
+                const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    QVector<RayToEntityIntersectionResult> results(rays.size());
+    if (_entityTree) {
+        std::vector<EntityTree::PickIntersection> intersections;
+        bool accurate = _entityTree->findRayIntersections(rays.toStdVector(), entityIdsToInclude, entityIdsToDiscard,
+            visibleOnly, collidableOnly, precisionPicking, intersections, Octree::Lock);
+        for (int i = 0; i < rays.size(); ++i) {
+            const EntityTree::PickIntersection& intersection = intersections[i];
+            RayToEntityIntersectionResult& result = results[i];
+            result.accurate = accurate;
+            result.entityID = intersection.entityID;
+            result.intersects = !intersection.entityID.isNull();
+            result.distance = intersection.distance;
+            result.face = intersection.face;
+            result.surfaceNormal = intersection.surfaceNormal;
+            result.extraInfo = intersection.extraInfo;
+            if (result.intersects) {
+                result.intersection = rays[i].origin + (rays[i].direction * result.distance);
+            }
+        }
+    }
+    return results;
+}
+
+QVector<ParabolaToEntityIntersectionResult> EntityScriptingInterface::findParabolaIntersectionsVector(
+                const QVector<PickParabola>& parabolas, bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude,
+                const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    QVector<ParabolaToEntityIntersectionResult> results(parabolas.size());
+    if (_entityTree) {
+        std::vector<EntityTree::PickIntersection> intersections;
+        bool accurate = _entityTree->findParabolaIntersections(parabolas.toStdVector(), entityIdsToInclude, entityIdsToDiscard,
+            visibleOnly, collidableOnly, precisionPicking, intersections, Octree::Lock);
+        for (int i = 0; i < parabolas.size(); ++i) {
+            const EntityTree::PickIntersection& intersection = intersections[i];
+            const PickParabola& parabola = parabolas[i];
+            ParabolaToEntityIntersectionResult& result = results[i];
+            result.accurate = accurate;
+            result.entityID = intersection.entityID;
+            result.intersects = !intersection.entityID.isNull();
+            float parabolicDistance = intersection.distance;
+            result.parabolicDistance = parabolicDistance;
+            result.distance = FLT_MAX;
+            result.face = intersection.face;
+            result.surfaceNormal = intersection.surfaceNormal;
+            result.extraInfo = intersection.extraInfo;
+            if (result.intersects) {
+                result.intersection = parabola.origin + parabola.velocity * parabolicDistance +
+                    0.5f * parabola.acceleration * parabolicDistance * parabolicDistance;
+                result.distance = glm::distance(result.intersection, parabola.origin);
+            }
+        }
+    }
+    return results;
+}
+
 ParabolaToEntityIntersectionResult EntityScriptingInterface::findParabolaIntersectionVector(const PickParabola& parabola, bool precisionPicking,
     const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly) {
     PROFILE_RANGE(script_entities, __FUNCTION__);
@@ -81,6 +81,7 @@ public:
     QVariantMap extraInfo;
 };
 Q_DECLARE_METATYPE(RayToEntityIntersectionResult)
+Q_DECLARE_METATYPE(QVector<RayToEntityIntersectionResult>)
 QScriptValue RayToEntityIntersectionResultToScriptValue(QScriptEngine* engine, const RayToEntityIntersectionResult& results);
 void RayToEntityIntersectionResultFromScriptValue(const QScriptValue& object, RayToEntityIntersectionResult& results);
 
@@ -493,6 +494,36 @@ public slots:
     Q_INVOKABLE RayToEntityIntersectionResult findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking = false, 
         const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue());
 
+    /**jsdoc
+     * Find the first entity intersected by each of several {@link PickRay|PickRays}. This gives the same results as calling 
+     * {@link Entities.findRayIntersection|findRayIntersection} for each ray, but is much faster for many rays: they are all 
+     * found together, spread across threads.
+     * @function Entities.findRayIntersections
+     * @param {PickRay[]} pickRays - The PickRays to use for finding entities.
+     * @param {boolean} [precisionPicking=false] - If <code>true</code> and an intersected entity is a <code>Model</code> 
+     *     entity, its result's <code>extraInfo</code> property includes more information than it otherwise would.
+     * @param {Uuid[]} [entitiesToInclude=[]] - If not empty then the search is restricted to these entities.
+     * @param {Uuid[]} [entitiesToDiscard=[]] - Entities to ignore during the search.
+     * @param {boolean} [visibleOnly=false] - If <code>true</code> then only entities that are 
+     *     <code>{@link Entities.EntityProperties|visible}<code> are searched.
+     * @param {boolean} [collideableOnly=false] - If <code>true</code> then only entities that are not 
+     *     <code>{@link Entities.EntityProperties|collisionless}</code> are searched.
+     * @returns {Entities.RayToEntityIntersectionResult[]} The result of the search for each of the pick rays, in order.
+     */
+    Q_INVOKABLE QVector<RayToEntityIntersectionResult> findRayIntersections(const QVector<PickRay>& rays,
+        bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(),
+        const QScriptValue& entityIdsToDiscard = QScriptValue(), bool visibleOnly = false, bool collidableOnly = false);
+
+    /// Same as above but with QVectors
+    QVector<RayToEntityIntersectionResult> findRayIntersectionsVector(const QVector<PickRay>& rays, bool precisionPicking,
+        const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
+        bool visibleOnly, bool collidableOnly);
+
+    /// Batched findParabolaIntersectionVector()
+    QVector<ParabolaToEntityIntersectionResult> findParabolaIntersectionsVector(const QVector<PickParabola>& parabolas,
+        bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
+        bool visibleOnly, bool collidableOnly);
+
 
     /**jsdoc
      * Reloads an entity's server entity script such that the latest version re-downloaded.
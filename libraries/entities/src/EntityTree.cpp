@@ -10,6 +10,7 @@
 //
 
 #include "EntityTree.h"
+
 #include <QtCore/QDateTime>
 #include <QtCore/QQueue>
 #include <openssl/err.h>
@@ -20,11 +21,13 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <QDataStream>
 
 #include <QtScript/QScriptEngine>
 
 #include <Extents.h>
 #include <PerfStat.h>
+#include <PickPackets.h>
 #include <Profile.h>
 
 #include "EntitySimulation.h"
@@ -298,6 +301,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
     }
 
     _isDirty = true;
+    trackPersistChange(entity->getEntityItemID());
 
     // find and hook up any entities with this entity as a (previously) missing parent
     fixupNeedsParentFixups();
@@ -363,6 +367,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                     emit editingEntityPointer(entity);
                 }
                 _isDirty = true;
+                trackPersistChange(entity->getEntityItemID());
             }
         }
     } else {
@@ -498,6 +503,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
         }
 
         _isDirty = true;
+        trackPersistChange(entity->getEntityItemID());
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -681,6 +687,7 @@ void EntityTree::cleanupCloneIDs(const EntityItemID& entityID) {
             EntityItemPointer cloneChild = findEntityByEntityItemID(cloneChildID);
             if (cloneChild) {
                 cloneChild->setCloneOriginID(QUuid());
+                trackPersistChange(cloneChildID);
             }
         }
     }
@@ -733,6 +740,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
     const RemovedEntities& entities = theOperator.getEntities();
     foreach(const EntityToDeleteDetails& details, entities) {
         EntityItemPointer theEntity = details.entity;
+        trackPersistChange(theEntity->getEntityItemID());
 
         if (getIsServer()) {
             QSet<EntityItemID> childrenIDs;
@@ -897,6 +905,140 @@ EntityItemID EntityTree::findParabolaIntersection(const PickParabola& parabola,
     return args.entityID;
 }
 
+// combines the arguments of a batch of picks
+template <typename T>
+class PickBatchArgs {
+public:
+    // Inputs
+    const std::vector<T>& picks;
+    const QVector<EntityItemID>& entityIdsToInclude;
+    const QVector<EntityItemID>& entityIdsToDiscard;
+    bool visibleOnly;
+    bool collidableOnly;
+    bool precisionPicking;
+
+    // Outputs
+    std::vector<EntityTree::PickIntersection>& intersections;
+};
+
+// Tests the lanes of a packet (the picks from begin) against an element, as findRayIntersectionOp does one ray,
+// and then recurses into the children with the lanes that may still find something closer.
+static void findRayIntersectionsInElement(const EntityTreeElementPointer& element, PickBatchArgs<PickRay>& args,
+        size_t begin, uint32_t activeLanes, int recursionCount = 0) {
+    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
+        return;
+    }
+
+    for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+        if (!(activeLanes & (1 << lane))) {
+            continue;
+        }
+        const PickRay& ray = args.picks[begin + lane];
+        EntityTree::PickIntersection& intersection = args.intersections[begin + lane];
+        bool keepSearching = true;
+        EntityItemID entityID = element->findRayIntersection(ray.origin, ray.direction, keepSearching,
+            intersection.element, intersection.distance, intersection.face, intersection.surfaceNormal,
+            args.entityIdsToInclude, args.entityIdsToDiscard, args.visibleOnly, args.collidableOnly,
+            intersection.extraInfo, args.precisionPicking);
+        if (!entityID.isNull()) {
+            intersection.entityID = entityID;
+        }
+        if (!keepSearching) {
+            activeLanes &= ~(1 << lane);
+        }
+    }
+
+    if (activeLanes) {
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            EntityTreeElementPointer child = element->getChildAtIndex(i);
+            if (child) {
+                findRayIntersectionsInElement(child, args, begin, activeLanes, recursionCount + 1);
+            }
+        }
+    }
+}
+
+static void findParabolaIntersectionsInElement(const EntityTreeElementPointer& element, PickBatchArgs<PickParabola>& args,
+        size_t begin, uint32_t activeLanes, int recursionCount = 0) {
+    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
+        return;
+    }
+
+    for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+        if (!(activeLanes & (1 << lane))) {
+            continue;
+        }
+        const PickParabola& parabola = args.picks[begin + lane];
+        EntityTree::PickIntersection& intersection = args.intersections[begin + lane];
+        bool keepSearching = true;
+        EntityItemID entityID = element->findParabolaIntersection(parabola.origin, parabola.velocity, parabola.acceleration,
+            keepSearching, intersection.element, intersection.distance, intersection.face, intersection.surfaceNormal,
+            args.entityIdsToInclude, args.entityIdsToDiscard, args.visibleOnly, args.collidableOnly,
+            intersection.extraInfo, args.precisionPicking);
+        if (!entityID.isNull()) {
+            intersection.entityID = entityID;
+        }
+        if (!keepSearching) {
+            activeLanes &= ~(1 << lane);
+        }
+    }
+
+    if (activeLanes) {
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            EntityTreeElementPointer child = element->getChildAtIndex(i);
+            if (child) {
+                findParabolaIntersectionsInElement(child, args, begin, activeLanes, recursionCount + 1);
+            }
+        }
+    }
+}
+
+bool EntityTree::findRayIntersections(const std::vector<PickRay>& rays,
+                                      const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
+                                      bool visibleOnly, bool collidableOnly, bool precisionPicking,
+                                      std::vector<PickIntersection>& intersections, Octree::lockType lockType) {
+    intersections.assign(rays.size(), PickIntersection());
+    PickBatchArgs<PickRay> args = { rays, entityIdsToInclude, entityIdsToDiscard,
+        visibleOnly, collidableOnly, precisionPicking, intersections };
+
+    bool requireLock = lockType == Octree::Lock;
+    return withReadLock([&] {
+        EntityTreeElementPointer root = getRoot();
+        forEachPickPacket(rays.size(), [&](size_t begin, size_t end) {
+            uint32_t activeLanes = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (rays[i]) {
+                    activeLanes |= 1 << (i - begin);
+                }
+            }
+            findRayIntersectionsInElement(root, args, begin, activeLanes);
+        });
+    }, requireLock);
+}
+
+bool EntityTree::findParabolaIntersections(const std::vector<PickParabola>& parabolas,
+                                           const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
+                                           bool visibleOnly, bool collidableOnly, bool precisionPicking,
+                                           std::vector<PickIntersection>& intersections, Octree::lockType lockType) {
+    intersections.assign(parabolas.size(), PickIntersection());
+    PickBatchArgs<PickParabola> args = { parabolas, entityIdsToInclude, entityIdsToDiscard,
+        visibleOnly, collidableOnly, precisionPicking, intersections };
+
+    bool requireLock = lockType == Octree::Lock;
+    return withReadLock([&] {
+        EntityTreeElementPointer root = getRoot();
+        forEachPickPacket(parabolas.size(), [&](size_t begin, size_t end) {
+            uint32_t activeLanes = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (parabolas[i]) {
+                    activeLanes |= 1 << (i - begin);
+                }
+            }
+            findParabolaIntersectionsInElement(root, args, begin, activeLanes);
+        });
+    }, requireLock);
+}
+
 
 EntityItemPointer EntityTree::findClosestEntity(const glm::vec3& position, float targetRadius) {
     FindNearPointArgs args = { position, targetRadius, false, NULL, FLT_MAX };
@@ -1499,8 +1641,6 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
     }
 
     int processedBytes = 0;
-    bool isAdd = false;
-    bool isClone = false;
     // we handle these types of "edit" packets
     switch (message.getType()) {
         case PacketType::EntityErase: {
@@ -1510,290 +1650,360 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
         }
 
         case PacketType::EntityClone:
-            isClone = true; // fall through to next case
-            // FALLTHRU
         case PacketType::EntityAdd:
-            isAdd = true;  // fall through to next case
-            // FALLTHRU
         case PacketType::EntityPhysics:
         case PacketType::EntityEdit: {
-            quint64 startDecode = 0, endDecode = 0;
-            quint64 startLookup = 0, endLookup = 0;
-            quint64 startUpdate = 0, endUpdate = 0;
-            quint64 startCreate = 0, endCreate = 0;
-            quint64 startFilter = 0, endFilter = 0;
-            quint64 startLogging = 0, endLogging = 0;
-
-            bool suppressDisallowedClientScript = false;
-            bool suppressDisallowedServerScript = false;
-            bool isPhysics = message.getType() == PacketType::EntityPhysics;
-
-            _totalEditMessages++;
-
-            EntityItemID entityItemID;
-            EntityItemProperties properties;
-            startDecode = usecTimestampNow();
-
-            bool validEditPacket = false;
-            EntityItemID entityIDToClone;
-            EntityItemPointer entityToClone;
-            if (isClone) {
-                QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<const char*>(editData), maxLength);
-                validEditPacket = EntityItemProperties::decodeCloneEntityMessage(buffer, processedBytes, entityIDToClone, entityItemID);
-                if (validEditPacket) {
-                    entityToClone = findEntityByEntityItemID(entityIDToClone);
-                    if (entityToClone) {
-                        properties = entityToClone->getProperties();
-                    }
-                }
-            } else {
-                validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes, entityItemID, properties);
-            }
+            EntityEdit edit;
+            decodeEntityEdit(message.getType(), editData, maxLength, processedBytes, edit);
+            applyEdit(edit, senderNode);
+            break;
+        }
 
-            endDecode = usecTimestampNow();
-
-            EntityItemPointer existingEntity;
-            if (!isAdd) {
-                // search for the entity by EntityItemID
-                startLookup = usecTimestampNow();
-                existingEntity = findEntityByEntityItemID(entityItemID);
-                endLookup = usecTimestampNow();
-                if (!existingEntity) {
-                    // this is not an add-entity operation, and we don't know about the identified entity.
-                    validEditPacket = false;
-                }
+        default:
+            processedBytes = 0;
+            break;
+    }
+    return processedBytes;
+}
+
+OctreeEditPointer EntityTree::decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                                   const SharedNodePointer& senderNode, int& processedBytes) {
+    processedBytes = 0;
+    if (!getIsServer()) {
+        return nullptr;
+    }
+
+    switch (message.getType()) {
+        case PacketType::EntityClone:
+        case PacketType::EntityAdd:
+        case PacketType::EntityPhysics:
+        case PacketType::EntityEdit: {
+            std::unique_ptr<EntityEdit> edit { new EntityEdit() };
+            decodeEntityEdit(message.getType(), editData, maxLength, processedBytes, *edit);
+            if (!edit->isClone()) {
+                // clones are validated once the properties of the entity to clone are known, in applyEdit
+                validateEntityEdit(*edit, senderNode);
+            }
+            if (edit->type == PacketType::EntityAdd && edit->isValid) {
+                // an add doesn't depend on an existing entity, so its filters can be run here too,
+                // under the read lock, since the filters look up and read the zones the entity is added in
+                EntityItemPointer noExistingEntity;
+                withReadLock([&] {
+                    filterEntityEdit(*edit, senderNode, noExistingEntity);
+                });
             }
+            return std::move(edit);
+        }
 
-            if (validEditPacket && !_entityScriptSourceWhitelist.isEmpty()) {
+        default:
+            // erases are only processed by processEditPacketData
+            return nullptr;
+    }
+}
 
-                bool wasDeletedBecauseOfClientScript = false;
+void EntityTree::decodeEntityEdit(PacketType type, const unsigned char* editData, int maxLength, int& processedBytes,
+                                  EntityEdit& edit) {
+    quint64 startDecode = usecTimestampNow();
 
-                // check the client entity script to make sure its URL is in the whitelist
-                if (!properties.getScript().isEmpty()) {
-                    bool clientScriptPassedWhitelist = isScriptInWhitelist(properties.getScript());
+    edit.type = type;
+    if (edit.isClone()) {
+        QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<const char*>(editData), maxLength);
+        edit.isValid = EntityItemProperties::decodeCloneEntityMessage(buffer, processedBytes, edit.entityIDToClone,
+                                                                      edit.entityItemID);
+    } else {
+        edit.isValid = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes, edit.entityItemID,
+                                                                    edit.properties);
+    }
 
-                    if (!clientScriptPassedWhitelist) {
-                        if (wantEditLogging()) {
-                            qCDebug(entities) << "User [" << senderNode->getUUID()
-                                << "] attempting to set entity script not on whitelist, edit rejected";
-                        }
+    edit.decodeTime = usecTimestampNow() - startDecode;
+}
 
-                        // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
-                        if (isAdd) {
-                            QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                            _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                            validEditPacket = false;
-                            wasDeletedBecauseOfClientScript = true;
-                        } else {
-                            suppressDisallowedClientScript = true;
-                        }
-                    }
-                }
+void EntityTree::validateEntityEdit(EntityEdit& edit, const SharedNodePointer& senderNode) {
+    bool isAdd = edit.isAdd();
+    bool isClone = edit.isClone();
+    EntityItemID& entityItemID = edit.entityItemID;
+    EntityItemProperties& properties = edit.properties;
 
-                // check all server entity scripts to make sure their URLs are in the whitelist
-                if (!properties.getServerScripts().isEmpty()) {
-                    bool serverScriptPassedWhitelist = isScriptInWhitelist(properties.getServerScripts());
+    edit.isValidated = true;
 
-                    if (!serverScriptPassedWhitelist) {
-                        if (wantEditLogging()) {
-                            qCDebug(entities) << "User [" << senderNode->getUUID()
-                                << "] attempting to set server entity script not on whitelist, edit rejected";
-                        }
+    if (edit.isValid && !_entityScriptSourceWhitelist.isEmpty()) {
 
-                        // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
-                        if (isAdd) {
-                            // Make sure we didn't already need to send back a delete because the client script failed
-                            // the whitelist check
-                            if (!wasDeletedBecauseOfClientScript) {
-                                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                                _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                                validEditPacket = false;
-                            }
-                        } else {
-                            suppressDisallowedServerScript = true;
-                        }
-                    }
-                }
+        bool wasDeletedBecauseOfClientScript = false;
 
-            }
+        // check the client entity script to make sure its URL is in the whitelist
+        if (!properties.getScript().isEmpty()) {
+            bool clientScriptPassedWhitelist = isScriptInWhitelist(properties.getScript());
 
-            if (!isClone) {
-                if ((isAdd || properties.lifetimeChanged()) &&
-                    ((!senderNode->getCanRez() && senderNode->getCanRezTmp()) ||
-                    (!senderNode->getCanRezCertified() && senderNode->getCanRezTmpCertified()))) {
-                    // this node is only allowed to rez temporary entities.  if need be, cap the lifetime.
-                    if (properties.getLifetime() == ENTITY_ITEM_IMMORTAL_LIFETIME ||
-                        properties.getLifetime() > _maxTmpEntityLifetime) {
-                        properties.setLifetime(_maxTmpEntityLifetime);
-                        bumpTimestamp(properties);
-                    }
+            if (!clientScriptPassedWhitelist) {
+                if (wantEditLogging()) {
+                    qCDebug(entities) << "User [" << senderNode->getUUID()
+                        << "] attempting to set entity script not on whitelist, edit rejected";
                 }
 
-                if (isAdd && properties.getLocked() && !senderNode->isAllowedEditor()) {
-                    // if a node can't change locks, don't allow it to create an already-locked entity -- automatically
-                    // clear the locked property and allow the unlocked entity to be created.
-                    properties.setLocked(false);
-                    bumpTimestamp(properties);
+                // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
+                if (isAdd) {
+                    QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                    _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+                    edit.isValid = false;
+                    wasDeletedBecauseOfClientScript = true;
+                } else {
+                    edit.suppressDisallowedClientScript = true;
                 }
             }
+        }
+
+        // check all server entity scripts to make sure their URLs are in the whitelist
+        if (!properties.getServerScripts().isEmpty()) {
+            bool serverScriptPassedWhitelist = isScriptInWhitelist(properties.getServerScripts());
 
-            // If we got a valid edit packet, then it could be a new entity or it could be an update to
-            // an existing entity... handle appropriately
-            if (validEditPacket) {
-                startFilter = usecTimestampNow();
-                bool wasChanged = false;
-                // Having (un)lock rights bypasses the filter, unless it's a physics result.
-                FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
-                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
-                if (!allowed) {
-                    auto timestamp = properties.getLastEdited();
-                    properties = EntityItemProperties();
-                    properties.setLastEdited(timestamp);
+            if (!serverScriptPassedWhitelist) {
+                if (wantEditLogging()) {
+                    qCDebug(entities) << "User [" << senderNode->getUUID()
+                        << "] attempting to set server entity script not on whitelist, edit rejected";
                 }
-                if (!allowed || wasChanged) {
-                    bumpTimestamp(properties);
-                    // For now, free ownership on any modification.
-                    properties.clearSimulationOwner();
+
+                // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
+                if (isAdd) {
+                    // Make sure we didn't already need to send back a delete because the client script failed
+                    // the whitelist check
+                    if (!wasDeletedBecauseOfClientScript) {
+                        QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                        _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+                        edit.isValid = false;
+                    }
+                } else {
+                    edit.suppressDisallowedServerScript = true;
                 }
-                endFilter = usecTimestampNow();
+            }
+        }
+    }
 
-                if (existingEntity && !isAdd) {
+    if (!isClone) {
+        if ((isAdd || properties.lifetimeChanged()) &&
+            ((!senderNode->getCanRez() && senderNode->getCanRezTmp()) ||
+            (!senderNode->getCanRezCertified() && senderNode->getCanRezTmpCertified()))) {
+            // this node is only allowed to rez temporary entities.  if need be, cap the lifetime.
+            if (properties.getLifetime() == ENTITY_ITEM_IMMORTAL_LIFETIME ||
+                properties.getLifetime() > _maxTmpEntityLifetime) {
+                properties.setLifetime(_maxTmpEntityLifetime);
+                bumpTimestamp(properties);
+            }
+        }
 
-                    if (suppressDisallowedClientScript) {
-                        bumpTimestamp(properties);
-                        properties.setScript(existingEntity->getScript());
-                    }
+        if (isAdd && properties.getLocked() && !senderNode->isAllowedEditor()) {
+            // if a node can't change locks, don't allow it to create an already-locked entity -- automatically
+            // clear the locked property and allow the unlocked entity to be created.
+            properties.setLocked(false);
+            bumpTimestamp(properties);
+        }
+    }
+}
+
+void EntityTree::filterEntityEdit(EntityEdit& edit, const SharedNodePointer& senderNode,
+                                  EntityItemPointer& existingEntity) {
+    EntityItemProperties& properties = edit.properties;
+    bool isPhysics = edit.isPhysics();
+
+    bool wasChanged = false;
+    // Having (un)lock rights bypasses the filter, unless it's a physics result.
+    FilterType filterType = isPhysics ? FilterType::Physics : (edit.isAdd() ? FilterType::Add : FilterType::Edit);
+    bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
+    if (!allowed) {
+        auto timestamp = properties.getLastEdited();
+        properties = EntityItemProperties();
+        properties.setLastEdited(timestamp);
+    }
+    if (!allowed || wasChanged) {
+        bumpTimestamp(properties);
+        // For now, free ownership on any modification.
+        properties.clearSimulationOwner();
+    }
+    edit.isFiltered = true;
+    edit.isAllowed = allowed;
+}
+
+void EntityTree::applyEdit(OctreeEdit& octreeEdit, const SharedNodePointer& senderNode) {
+    EntityEdit& edit = static_cast<EntityEdit&>(octreeEdit);
+
+    quint64 startLookup = 0, endLookup = 0;
+    quint64 startUpdate = 0, endUpdate = 0;
+    quint64 startCreate = 0, endCreate = 0;
+    quint64 startFilter = 0, endFilter = 0;
+    quint64 startLogging = 0, endLogging = 0;
+
+    bool isAdd = edit.isAdd();
+    bool isClone = edit.isClone();
+    bool isPhysics = edit.isPhysics();
+    EntityItemID& entityItemID = edit.entityItemID;
+    EntityItemID& entityIDToClone = edit.entityIDToClone;
+    EntityItemProperties& properties = edit.properties;
+
+    _totalEditMessages++;
+
+    EntityItemPointer entityToClone;
+    if (isClone && edit.isValid) {
+        entityToClone = findEntityByEntityItemID(entityIDToClone);
+        if (entityToClone) {
+            properties = entityToClone->getProperties();
+        }
+    }
+
+    if (!edit.isValidated) {
+        validateEntityEdit(edit, senderNode);
+    }
+    bool validEditPacket = edit.isValid;
+    bool suppressDisallowedClientScript = edit.suppressDisallowedClientScript;
+    bool suppressDisallowedServerScript = edit.suppressDisallowedServerScript;
+
+    EntityItemPointer existingEntity;
+    if (!isAdd) {
+        // search for the entity by EntityItemID
+        startLookup = usecTimestampNow();
+        existingEntity = findEntityByEntityItemID(entityItemID);
+        endLookup = usecTimestampNow();
+        if (!existingEntity) {
+            // this is not an add-entity operation, and we don't know about the identified entity.
+            validEditPacket = false;
+        }
+    }
+
+    // If we got a valid edit packet, then it could be a new entity or it could be an update to
+    // an existing entity... handle appropriately
+    if (validEditPacket) {
+        startFilter = usecTimestampNow();
+        if (!edit.isFiltered) {
+            filterEntityEdit(edit, senderNode, existingEntity);
+        }
+        bool allowed = edit.isAllowed;
+        endFilter = usecTimestampNow();
+
+        if (existingEntity && !isAdd) {
+
+            if (suppressDisallowedClientScript) {
+                bumpTimestamp(properties);
+                properties.setScript(existingEntity->getScript());
+            }
 
-                    if (suppressDisallowedServerScript) {
-                        bumpTimestamp(properties);
-                        properties.setServerScripts(existingEntity->getServerScripts());
+            if (suppressDisallowedServerScript) {
+                bumpTimestamp(properties);
+                properties.setServerScripts(existingEntity->getServerScripts());
+            }
+
+            // if the EntityItem exists, then update it
+            startLogging = usecTimestampNow();
+            if (wantEditLogging()) {
+                qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+                qCDebug(entities) << "   properties:" << properties;
+            }
+            if (wantTerseEditLogging()) {
+                QList<QString> changedProperties = properties.listChangedProperties();
+                fixupTerseEditLogging(properties, changedProperties);
+                qCDebug(entities) << senderNode->getUUID() << "edit" <<
+                    existingEntity->getDebugName() << changedProperties;
+            }
+            endLogging = usecTimestampNow();
+
+            startUpdate = usecTimestampNow();
+            if (!isPhysics) {
+                properties.setLastEditedBy(senderNode->getUUID());
+            }
+            updateEntity(existingEntity, properties, senderNode);
+            existingEntity->markAsChangedOnServer();
+            endUpdate = usecTimestampNow();
+            _totalUpdates++;
+        } else if (isAdd) {
+            bool failedAdd = !allowed;
+            bool isCertified = !properties.getCertificateID().isEmpty();
+            bool isCloneable = properties.getCloneable();
+            int cloneLimit = properties.getCloneLimit();
+            if (!allowed) {
+                qCDebug(entities) << "Filtered entity add. ID:" << entityItemID;
+            } else if (!isClone && !isCertified && !senderNode->getCanRez() && !senderNode->getCanRezTmp()) {
+                failedAdd = true;
+                qCDebug(entities) << "User without 'uncertified rez rights' [" << senderNode->getUUID()
+                    << "] attempted to add an uncertified entity with ID:" << entityItemID;
+            } else if (!isClone && isCertified && !senderNode->getCanRezCertified() && !senderNode->getCanRezTmpCertified()) {
+                failedAdd = true;
+                qCDebug(entities) << "User without 'certified rez rights' [" << senderNode->getUUID()
+                    << "] attempted to add a certified entity with ID:" << entityItemID;
+            } else if (isClone && isCertified) {
+                failedAdd = true;
+                qCDebug(entities) << "User attempted to clone certified entity from entity ID:" << entityIDToClone;
+            } else if (isClone && !isCloneable) {
+                failedAdd = true;
+                qCDebug(entities) << "User attempted to clone non-cloneable entity from entity ID:" << entityIDToClone;
+            } else if (isClone && entityToClone && entityToClone->getCloneIDs().size() >= cloneLimit && cloneLimit != 0) {
+                failedAdd = true;
+                qCDebug(entities) << "User attempted to clone entity ID:" << entityIDToClone << " which reached it's cloneable limit.";
+            } else {
+                if (isClone) {
+                    properties.convertToCloneProperties(entityIDToClone);
+                }
+
+                // this is a new entity... assign a new entityID
+                properties.setCreated(properties.getLastEdited());
+                properties.setLastEditedBy(senderNode->getUUID());
+                startCreate = usecTimestampNow();
+                EntityItemPointer newEntity = addEntity(entityItemID, properties);
+                endCreate = usecTimestampNow();
+                _totalCreates++;
+
+                if (newEntity && isCertified && getIsServer()) {
+                    if (!properties.verifyStaticCertificateProperties()) {
+                        qCDebug(entities) << "User" << senderNode->getUUID()
+                            << "attempted to add a certified entity with ID" << entityItemID << "which failed"
+                            << "static certificate verification.";
+                        // Delete the entity we just added if it doesn't pass static certificate verification
+                        deleteEntity(entityItemID, true);
+                    } else {
+                        validatePop(properties.getCertificateID(), entityItemID, senderNode);
                     }
+                }
 
-                    // if the EntityItem exists, then update it
+                if (newEntity && isClone) {
+                    entityToClone->addCloneID(newEntity->getEntityItemID());
+                    newEntity->setCloneOriginID(entityIDToClone);
+                }
+
+                if (newEntity) {
+                    newEntity->markAsChangedOnServer();
+                    notifyNewlyCreatedEntity(*newEntity, senderNode);
+                    
                     startLogging = usecTimestampNow();
                     if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
+                                          << newEntity->getEntityItemID();
                         qCDebug(entities) << "   properties:" << properties;
                     }
                     if (wantTerseEditLogging()) {
                         QList<QString> changedProperties = properties.listChangedProperties();
                         fixupTerseEditLogging(properties, changedProperties);
-                        qCDebug(entities) << senderNode->getUUID() << "edit" <<
-                            existingEntity->getDebugName() << changedProperties;
+                        qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
                     }
                     endLogging = usecTimestampNow();
 
-                    startUpdate = usecTimestampNow();
-                    if (!isPhysics) {
-                        properties.setLastEditedBy(senderNode->getUUID());
-                    }
-                    updateEntity(existingEntity, properties, senderNode);
-                    existingEntity->markAsChangedOnServer();
-                    endUpdate = usecTimestampNow();
-                    _totalUpdates++;
-                } else if (isAdd) {
-                    bool failedAdd = !allowed;
-                    bool isCertified = !properties.getCertificateID().isEmpty();
-                    bool isCloneable = properties.getCloneable();
-                    int cloneLimit = properties.getCloneLimit();
-                    if (!allowed) {
-                        qCDebug(entities) << "Filtered entity add. ID:" << entityItemID;
-                    } else if (!isClone && !isCertified && !senderNode->getCanRez() && !senderNode->getCanRezTmp()) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User without 'uncertified rez rights' [" << senderNode->getUUID()
-                            << "] attempted to add an uncertified entity with ID:" << entityItemID;
-                    } else if (!isClone && isCertified && !senderNode->getCanRezCertified() && !senderNode->getCanRezTmpCertified()) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User without 'certified rez rights' [" << senderNode->getUUID()
-                            << "] attempted to add a certified entity with ID:" << entityItemID;
-                    } else if (isClone && isCertified) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User attempted to clone certified entity from entity ID:" << entityIDToClone;
-                    } else if (isClone && !isCloneable) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User attempted to clone non-cloneable entity from entity ID:" << entityIDToClone;
-                    } else if (isClone && entityToClone && entityToClone->getCloneIDs().size() >= cloneLimit && cloneLimit != 0) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User attempted to clone entity ID:" << entityIDToClone << " which reached it's cloneable limit.";
-                    } else {
-                        if (isClone) {
-                            properties.convertToCloneProperties(entityIDToClone);
-                        }
-
-                        // this is a new entity... assign a new entityID
-                        properties.setCreated(properties.getLastEdited());
-                        properties.setLastEditedBy(senderNode->getUUID());
-                        startCreate = usecTimestampNow();
-                        EntityItemPointer newEntity = addEntity(entityItemID, properties);
-                        endCreate = usecTimestampNow();
-                        _totalCreates++;
-
-                        if (newEntity && isCertified && getIsServer()) {
-                            if (!properties.verifyStaticCertificateProperties()) {
-                                qCDebug(entities) << "User" << senderNode->getUUID()
-                                    << "attempted to add a certified entity with ID" << entityItemID << "which failed"
-                                    << "static certificate verification.";
-                                // Delete the entity we just added if it doesn't pass static certificate verification
-                                deleteEntity(entityItemID, true);
-                            } else {
-                                validatePop(properties.getCertificateID(), entityItemID, senderNode);
-                            }
-                        }
-
-                        if (newEntity && isClone) {
-                            entityToClone->addCloneID(newEntity->getEntityItemID());
-                            newEntity->setCloneOriginID(entityIDToClone);
-                        }
-
-                        if (newEntity) {
-                            newEntity->markAsChangedOnServer();
-                            notifyNewlyCreatedEntity(*newEntity, senderNode);
-                            
-                            startLogging = usecTimestampNow();
-                            if (wantEditLogging()) {
-                                qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
-                                                  << newEntity->getEntityItemID();
-                                qCDebug(entities) << "   properties:" << properties;
-                            }
-                            if (wantTerseEditLogging()) {
-                                QList<QString> changedProperties = properties.listChangedProperties();
-                                fixupTerseEditLogging(properties, changedProperties);
-                                qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
-                            }
-                            endLogging = usecTimestampNow();
-
-                        } else {
-                            failedAdd = true;
-                            qCDebug(entities) << "Add entity failed ID:" << entityItemID;
-                        }
-                    }
-                    if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
-                        QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                        _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                    }
                 } else {
-                    HIFI_FCDEBUG(entities(), "Edit failed. [" << message.getType() <<"] " <<
-                            "entity id:" << entityItemID << 
-                            "existingEntity pointer:" << existingEntity.get());
+                    failedAdd = true;
+                    qCDebug(entities) << "Add entity failed ID:" << entityItemID;
                 }
             }
-
-
-            _totalDecodeTime += endDecode - startDecode;
-            _totalLookupTime += endLookup - startLookup;
-            _totalUpdateTime += endUpdate - startUpdate;
-            _totalCreateTime += endCreate - startCreate;
-            _totalLoggingTime += endLogging - startLogging;
-            _totalFilterTime += endFilter - startFilter;
-
-            break;
+            if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
+                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+            }
+        } else {
+            HIFI_FCDEBUG(entities(), "Edit failed. [" << edit.type <<"] " <<
+                    "entity id:" << entityItemID << 
+                    "existingEntity pointer:" << existingEntity.get());
         }
-
-        default:
-            processedBytes = 0;
-            break;
     }
-    return processedBytes;
+
+    _totalDecodeTime += edit.decodeTime;
+    _totalLookupTime += endLookup - startLookup;
+    _totalUpdateTime += endUpdate - startUpdate;
+    _totalCreateTime += endCreate - startCreate;
+    _totalLoggingTime += endLogging - startLogging;
+    _totalFilterTime += endFilter - startFilter;
 }
 
 
@@ -1831,6 +2041,7 @@ void EntityTree::entityChanged(EntityItemPointer entity) {
     if (entity->isSimulated()) {
         _simulation->changeEntity(entity);
     }
+    trackPersistChange(entity->getEntityItemID());
 }
 
 void EntityTree::fixupNeedsParentFixups() {
@@ -2611,6 +2822,225 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     return success;
 }
 
+// Binary persistence
+//   a snapshot is the named paths, followed by a (QUuid id, QByteArray record) pair for every entity
+//   a block of changes is a list of (quint8 change, QUuid id) pairs, followed by the record of each edited entity
+enum class PersistChange : quint8 {
+    Edit = 0,
+    Delete
+};
+
+// most entities fit in a single edit packet, large ones grow the buffer from there
+static const int PERSIST_RECORD_INITIAL_SIZE = 1500;
+static const int PERSIST_RECORD_MAX_SIZE = 64 * 1024 * 1024;
+
+QByteArray EntityTree::encodePersistRecord(const EntityItemPointer& entity) {
+    EntityItemProperties properties = entity->getProperties();
+    properties.markAllChanged();
+    EntityPropertyFlags requestedProperties = properties.getChangedProperties();
+    EntityPropertyFlags didntFitProperties;
+
+    QByteArray encoded;
+    int bufferSize = PERSIST_RECORD_INITIAL_SIZE;
+    while (true) {
+        encoded.fill(0, bufferSize);
+        auto appendState = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entity->getEntityItemID(),
+                                                                        properties, encoded, requestedProperties,
+                                                                        didntFitProperties);
+        if (appendState == OctreeElement::COMPLETED) {
+            break;
+        }
+        if (bufferSize >= PERSIST_RECORD_MAX_SIZE) {
+            qCWarning(entities) << "Entity" << entity->getEntityItemID() << "is too large to persist";
+            return QByteArray();
+        }
+        bufferSize *= 2;
+    }
+
+    // the edit encoding leaves out the properties that can't be edited
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream << entity->getCreated() << entity->getCloneOriginID() << entity->getLastEditedBy() << encoded;
+    return record;
+}
+
+bool EntityTree::decodePersistRecord(const QByteArray& record, EntityItemID& entityID, EntityItemProperties& properties) {
+    quint64 created;
+    QUuid cloneOriginID;
+    QUuid lastEditedBy;
+    QByteArray encoded;
+
+    QDataStream stream(record);
+    stream >> created >> cloneOriginID >> lastEditedBy >> encoded;
+    if (stream.status() != QDataStream::Ok || encoded.isEmpty()) {
+        return false;
+    }
+
+    int processedBytes = 0;
+    if (!EntityItemProperties::decodeEntityEditPacket(reinterpret_cast<const unsigned char*>(encoded.constData()),
+                                                      encoded.size(), processedBytes, entityID, properties)) {
+        return false;
+    }
+
+    properties.setCreated(created);
+    properties.setCloneOriginID(cloneOriginID);
+    properties.setLastEditedBy(lastEditedBy);
+    return true;
+}
+
+void EntityTree::trackPersistChange(const EntityItemID& entityID) {
+    if (_isTrackingPersistChanges) {
+        QWriteLocker locker(&_persistChangesLock);
+        _persistChanges.insert(entityID);
+    }
+}
+
+bool EntityTree::writeBinarySnapshot(QDataStream& stream) {
+    withReadLock([&] {
+        // the snapshot includes every change so far, only those made from here on need to be written as changes
+        {
+            QWriteLocker locker(&_persistChangesLock);
+            _persistChanges.clear();
+            _isTrackingPersistChanges = true;
+        }
+
+        QVariantMap namedPaths;
+        for (auto& namedPath : _namedPaths) {
+            namedPaths[namedPath.first] = namedPath.second;
+        }
+        stream << namedPaths;
+
+        QVector<EntityItemPointer> entities;
+        {
+            QReadLocker locker(&_entityMapLock);
+            entities.reserve(_entityMap.size());
+            for (auto& entity : _entityMap) {
+                // like the JSON, skip those with a parent we weren't able to resolve
+                if (!entity->isDead() && entity->isParentIDValid()) {
+                    entities.push_back(entity);
+                }
+            }
+        }
+
+        stream << (quint32)entities.size();
+        for (auto& entity : entities) {
+            stream << (QUuid)entity->getEntityItemID() << encodePersistRecord(entity);
+        }
+    });
+    return stream.status() == QDataStream::Ok;
+}
+
+int EntityTree::writeBinaryChanges(QDataStream& stream) {
+    QSet<EntityItemID> changes;
+    withReadLock([&] {
+        {
+            QWriteLocker locker(&_persistChangesLock);
+            changes.swap(_persistChanges);
+        }
+
+        stream << (quint32)changes.size();
+        for (auto& entityID : changes) {
+            // the latest state of an entity is written, whatever the number of edits since the last write
+            EntityItemPointer entity = findEntityByEntityItemID(entityID);
+            if (entity && !entity->isDead() && entity->isParentIDValid()) {
+                stream << (quint8)PersistChange::Edit << (QUuid)entityID << encodePersistRecord(entity);
+            } else {
+                stream << (quint8)PersistChange::Delete << (QUuid)entityID;
+            }
+        }
+    });
+    return stream.status() == QDataStream::Ok ? changes.size() : -1;
+}
+
+bool EntityTree::readBinarySnapshot(QDataStream& snapshot, const QVector<QByteArray>& changes) {
+    QVariantMap namedPaths;
+    quint32 numEntities = 0;
+    snapshot >> namedPaths >> numEntities;
+
+    // apply the changes to the records before adding anything, so that each entity is added once, in its latest state
+    QHash<QUuid, QByteArray> records;
+    records.reserve(numEntities);
+    for (quint32 i = 0; i < numEntities && snapshot.status() == QDataStream::Ok; ++i) {
+        QUuid entityID;
+        QByteArray record;
+        snapshot >> entityID >> record;
+        records[entityID] = record;
+    }
+    if (snapshot.status() != QDataStream::Ok) {
+        qCWarning(entities) << "Failed to read binary snapshot, read" << records.size() << "of" << numEntities << "entities";
+        return false;
+    }
+
+    for (auto& block : changes) {
+        QDataStream stream(block);
+        quint32 numChanges = 0;
+        stream >> numChanges;
+        for (quint32 i = 0; i < numChanges && stream.status() == QDataStream::Ok; ++i) {
+            quint8 change;
+            QUuid entityID;
+            stream >> change >> entityID;
+            if ((PersistChange)change == PersistChange::Edit) {
+                QByteArray record;
+                stream >> record;
+                records[entityID] = record;
+            } else {
+                records.remove(entityID);
+            }
+        }
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(entities) << "Failed to read binary changes";
+            return false;
+        }
+    }
+
+    _namedPaths.clear();
+    for (auto itr = namedPaths.constBegin(); itr != namedPaths.constEnd(); ++itr) {
+        _namedPaths[itr.key()] = itr.value().toString();
+    }
+
+    // map of entity -> list of its clones
+    QMap<QUuid, QVector<QUuid>> cloneIDs;
+
+    bool success = true;
+    for (auto itr = records.constBegin(); itr != records.constEnd(); ++itr) {
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+        if (!decodePersistRecord(itr.value(), entityItemID, properties)) {
+            qCDebug(entities) << "decoding Entity failed:" << itr.key();
+            success = false;
+            continue;
+        }
+
+        EntityItemPointer entity = addEntity(entityItemID, properties);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            success = false;
+            continue;
+        }
+
+        const QUuid& cloneOriginID = entity->getCloneOriginID();
+        if (!cloneOriginID.isNull()) {
+            cloneIDs[cloneOriginID].push_back(entity->getEntityItemID());
+        }
+    }
+
+    for (const auto& entityID : cloneIDs.keys()) {
+        auto entity = findEntityByID(entityID);
+        if (entity) {
+            entity->setCloneIDs(cloneIDs.value(entityID));
+        }
+    }
+
+    // the tree now matches the snapshot and changes, track from here on
+    {
+        QWriteLocker locker(&_persistChangesLock);
+        _persistChanges.clear();
+        _isTrackingPersistChanges = true;
+    }
+
+    return success;
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
@@ -12,6 +12,8 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <atomic>
+
 #include <QSet>
 #include <QVector>
 
@@ -88,6 +90,31 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
+
+    // an add, clone or edit, decoded (and validated, unless it's a clone) without the tree lock, to be applied with it
+    // adds are filtered when they're decoded too, since they don't depend on an existing entity
+    class EntityEdit : public OctreeEdit {
+    public:
+        PacketType type { PacketType::Unknown };
+        bool isValid { false };
+        bool isValidated { false };
+        bool suppressDisallowedClientScript { false };
+        bool suppressDisallowedServerScript { false };
+        bool isFiltered { false };
+        bool isAllowed { true }; // by the edit filters, once filtered
+        EntityItemID entityItemID;
+        EntityItemID entityIDToClone;
+        EntityItemProperties properties;
+        quint64 decodeTime { 0 };
+
+        bool isAdd() const { return type == PacketType::EntityAdd || type == PacketType::EntityClone; }
+        bool isClone() const { return type == PacketType::EntityClone; }
+        bool isPhysics() const { return type == PacketType::EntityPhysics; }
+    };
+
+    virtual OctreeEditPointer decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                                   const SharedNodePointer& senderNode, int& processedBytes) override;
+    virtual void applyEdit(OctreeEdit& edit, const SharedNodePointer& senderNode) override;
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
@@ -106,6 +133,28 @@ public:
         BoxFace& face, glm::vec3& surfaceNormal, QVariantMap& extraInfo,
         Octree::lockType lockType = Octree::TryLock, bool* accurateResult = NULL);
 
+    // the result of one pick of a batch
+    struct PickIntersection {
+        EntityItemID entityID;
+        OctreeElementPointer element;
+        float distance { FLT_MAX }; // parabolic distance, for parabolas
+        BoxFace face;
+        glm::vec3 surfaceNormal;
+        QVariantMap extraInfo;
+    };
+
+    // Batched picking: the batch is picked under a single hold of the read lock, each packet of picks walks the tree
+    // once, and large batches are spread across threads.  Returns false when the lock couldn't be taken.
+    bool findRayIntersections(const std::vector<PickRay>& rays,
+        const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
+        bool visibleOnly, bool collidableOnly, bool precisionPicking,
+        std::vector<PickIntersection>& intersections, Octree::lockType lockType = Octree::TryLock);
+
+    bool findParabolaIntersections(const std::vector<PickParabola>& parabolas,
+        const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
+        bool visibleOnly, bool collidableOnly, bool precisionPicking,
+        std::vector<PickIntersection>& intersections, Octree::lockType lockType = Octree::TryLock);
+
     virtual bool rootElementHasData() const override { return true; }
 
     virtual void releaseSceneEncodeData(OctreeElementExtraEncodeData* extraEncodeData) const override;
@@ -225,6 +274,11 @@ public:
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
 
+    virtual bool supportsBinaryPersistence() const override { return true; }
+    virtual bool writeBinarySnapshot(QDataStream& stream) override;
+    virtual int writeBinaryChanges(QDataStream& stream) override;
+    virtual bool readBinarySnapshot(QDataStream& snapshot, const QVector<QByteArray>& changes) override;
+
     glm::vec3 getContentsDimensions();
     float getContentsLargestDimension();
 
@@ -350,6 +404,17 @@ protected:
         _deletedEntityItemIDs << id;
     }
 
+    // binary persistence records are the entity's edit encoding, plus the properties edits don't carry
+    static QByteArray encodePersistRecord(const EntityItemPointer& entity);
+    static bool decodePersistRecord(const QByteArray& record, EntityItemID& entityID, EntityItemProperties& properties);
+
+    // entities changed since the last binary snapshot or changes were written,
+    // only tracked once the tree has been persisted (or loaded) as a binary snapshot
+    void trackPersistChange(const EntityItemID& entityID);
+    std::atomic<bool> _isTrackingPersistChanges { false };
+    mutable QReadWriteLock _persistChangesLock;
+    QSet<EntityItemID> _persistChanges;
+
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
 
@@ -394,6 +459,11 @@ protected:
 
     float _maxTmpEntityLifetime { DEFAULT_MAX_TMP_ENTITY_LIFETIME };
 
+    void decodeEntityEdit(PacketType type, const unsigned char* editData, int maxLength, int& processedBytes,
+                          EntityEdit& edit);
+    void validateEntityEdit(EntityEdit& edit, const SharedNodePointer& senderNode);
+    void filterEntityEdit(EntityEdit& edit, const SharedNodePointer& senderNode, EntityItemPointer& existingEntity);
+
     bool filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType);
     bool _hasEntityEditFilter{ false };
     QStringList _entityScriptSourceWhitelist;
@@ -245,8 +245,8 @@ public:
     graphics::MeshPointer _mesh;
     bool wasCompressed { false };
 
-    void createMeshTangents(bool generateFromTexCoords);
-    void createBlendShapeTangents(bool generateTangents);
+    // creates the tangents of the mesh and of its blendshapes, in parallel
+    void createTangents(bool generateFromTexCoords);
 };
 
 class ExtractedMesh {
@@ -12,6 +12,9 @@
 #include "FBXReader.h"
 
 #include <iostream>
+#include <memory>
+#include <numeric>
+
 #include <QBuffer>
 #include <QDataStream>
 #include <QIODevice>
@@ -20,6 +23,7 @@
 #include <QtDebug>
 #include <QtEndian>
 #include <QFileInfo>
+#include <QtConcurrent/QtConcurrentMap>
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -263,7 +267,7 @@ public:
     glm::vec3 geometricScaling;
 };
 
-glm::mat4 getGlobalTransform(const QMultiMap<QString, QString>& _connectionParentMap,
+glm::mat4 getGlobalTransform(const QMultiHash<QString, QString>& _connectionParentMap,
         const QHash<QString, FBXModel>& models, QString nodeID, bool mixamoHack, const QString& url) {
     glm::mat4 globalTransform;
     QVector<QString> visitedNodes; // Used to prevent following a cycle
@@ -328,7 +332,7 @@ public:
     glm::mat4 transformLink;
 };
 
-void appendModelIDs(const QString& parentID, const QMultiMap<QString, QString>& connectionChildMap,
+void appendModelIDs(const QString& parentID, const QMultiHash<QString, QString>& connectionChildMap,
         QHash<QString, FBXModel>& models, QSet<QString>& remainingModels, QVector<QString>& modelIDs, bool isRootNode = false) {
     if (remainingModels.contains(parentID)) {
         modelIDs.append(parentID);
@@ -362,76 +366,153 @@ FBXBlendshape extractBlendshape(const FBXNode& object) {
     return blendshape;
 }
 
-using IndexAccessor = std::function<glm::vec3*(const FBXMesh&, int, int, glm::vec3*, glm::vec3&)>;
-
-static void setTangents(const FBXMesh& mesh, const IndexAccessor& vertexAccessor, int firstIndex, int secondIndex,
-                        const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals, QVector<glm::vec3>& tangents) {
-    glm::vec3 vertex[2];
-    glm::vec3 normal;
-    glm::vec3* tangent = vertexAccessor(mesh, firstIndex, secondIndex, vertex, normal);
-    if (tangent) {
-        glm::vec3 bitangent = glm::cross(normal, vertex[1] - vertex[0]);
-        if (glm::length(bitangent) < EPSILON) {
-            return;
+// The edges tangents are accumulated over: each edge of each quad and triangle adds to the tangent of its first vertex.
+// The rotation from an edge's texture coordinates only depends on the mesh, so it's computed once and shared by the
+// mesh and all of its blendshapes.
+struct TangentEdges {
+    std::vector<int> firstIndices;
+    std::vector<int> secondIndices;
+    // the cosine and sine of -atan2(-texCoordDelta.t, texCoordDelta.s)
+    std::vector<float> cosAngles;
+    std::vector<float> sinAngles;
+};
+
+static void addTangentEdge(const FBXMesh& mesh, int firstIndex, int secondIndex, TangentEdges& edges) {
+    glm::vec2 texCoordDelta = mesh.texCoords.at(secondIndex) - mesh.texCoords.at(firstIndex);
+    float length = glm::length(texCoordDelta);
+    edges.firstIndices.push_back(firstIndex);
+    edges.secondIndices.push_back(secondIndex);
+    edges.cosAngles.push_back(length > 0.0f ? texCoordDelta.s / length : 1.0f);
+    edges.sinAngles.push_back(length > 0.0f ? texCoordDelta.t / length : 0.0f);
+}
+
+static void collectTangentEdges(const FBXMesh& mesh, TangentEdges& edges) {
+    foreach(const FBXMeshPart& part, mesh.parts) {
+        for (int i = 0; i < part.quadIndices.size(); i += 4) {
+            addTangentEdge(mesh, part.quadIndices.at(i), part.quadIndices.at(i + 1), edges);
+            addTangentEdge(mesh, part.quadIndices.at(i + 1), part.quadIndices.at(i + 2), edges);
+            addTangentEdge(mesh, part.quadIndices.at(i + 2), part.quadIndices.at(i + 3), edges);
+            addTangentEdge(mesh, part.quadIndices.at(i + 3), part.quadIndices.at(i), edges);
+        }
+        // <= size - 3 in order to prevent overflowing triangleIndices when (i % 3) != 0
+        // This is most likely evidence of a further problem in extractMesh()
+        for (int i = 0; i <= part.triangleIndices.size() - 3; i += 3) {
+            addTangentEdge(mesh, part.triangleIndices.at(i), part.triangleIndices.at(i + 1), edges);
+            addTangentEdge(mesh, part.triangleIndices.at(i + 1), part.triangleIndices.at(i + 2), edges);
+            addTangentEdge(mesh, part.triangleIndices.at(i + 2), part.triangleIndices.at(i), edges);
+        }
+        if ((part.triangleIndices.size() % 3) != 0) {
+            qCDebug(modelformat) << "Error in extractFBXGeometry part.triangleIndices.size() is not divisible by three ";
         }
-        glm::vec2 texCoordDelta = mesh.texCoords.at(secondIndex) - mesh.texCoords.at(firstIndex);
-        glm::vec3 normalizedNormal = glm::normalize(normal);
-        *tangent += glm::cross(glm::angleAxis(-atan2f(-texCoordDelta.t, texCoordDelta.s), normalizedNormal) *
-                                       glm::normalize(bitangent), normalizedNormal);
     }
 }
 
-static void createTangents(const FBXMesh& mesh, bool generateFromTexCoords,
-                           const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals, QVector<glm::vec3>& tangents,
-                           IndexAccessor accessor) {
-    // if we have a normal map (and texture coordinates), we must compute tangents
-    if (generateFromTexCoords && !mesh.texCoords.isEmpty()) {
-        tangents.resize(vertices.size());
-
-        foreach(const FBXMeshPart& part, mesh.parts) {
-            for (int i = 0; i < part.quadIndices.size(); i += 4) {
-                setTangents(mesh, accessor, part.quadIndices.at(i), part.quadIndices.at(i + 1), vertices, normals, tangents);
-                setTangents(mesh, accessor, part.quadIndices.at(i + 1), part.quadIndices.at(i + 2), vertices, normals, tangents);
-                setTangents(mesh, accessor, part.quadIndices.at(i + 2), part.quadIndices.at(i + 3), vertices, normals, tangents);
-                setTangents(mesh, accessor, part.quadIndices.at(i + 3), part.quadIndices.at(i), vertices, normals, tangents);
-            }
-            // <= size - 3 in order to prevent overflowing triangleIndices when (i % 3) != 0
-            // This is most likely evidence of a further problem in extractMesh()
-            for (int i = 0; i <= part.triangleIndices.size() - 3; i += 3) {
-                setTangents(mesh, accessor, part.triangleIndices.at(i), part.triangleIndices.at(i + 1), vertices, normals, tangents);
-                setTangents(mesh, accessor, part.triangleIndices.at(i + 1), part.triangleIndices.at(i + 2), vertices, normals, tangents);
-                setTangents(mesh, accessor, part.triangleIndices.at(i + 2), part.triangleIndices.at(i), vertices, normals, tangents);
-            }
-            if ((part.triangleIndices.size() % 3) != 0) {
-                qCDebug(modelformat) << "Error in extractFBXGeometry part.triangleIndices.size() is not divisible by three ";
-            }
-        }
+// Edges are processed in blocks, gathered into structure-of-arrays form so that the tangent math runs without branches
+// over contiguous floats, and can be vectorized by the compiler.
+static const int TANGENT_BLOCK_SIZE = 256;
+
+struct TangentBlock {
+    float edgeX[TANGENT_BLOCK_SIZE], edgeY[TANGENT_BLOCK_SIZE], edgeZ[TANGENT_BLOCK_SIZE];
+    float normalX[TANGENT_BLOCK_SIZE], normalY[TANGENT_BLOCK_SIZE], normalZ[TANGENT_BLOCK_SIZE];
+    float cosAngle[TANGENT_BLOCK_SIZE], sinAngle[TANGENT_BLOCK_SIZE];
+    float tangentX[TANGENT_BLOCK_SIZE], tangentY[TANGENT_BLOCK_SIZE], tangentZ[TANGENT_BLOCK_SIZE];
+    int target[TANGENT_BLOCK_SIZE];
+};
+
+// tangent = cross(angleAxis(angle, n) * normalize(cross(normal, edge)), n), where n = normalize(normal)
+// the rotated vector is perpendicular to n, so the rotation reduces to v * cos + cross(n, v) * sin
+static void computeTangentBlock(TangentBlock& block, int count) {
+    for (int i = 0; i < count; ++i) {
+        float nx = block.normalX[i], ny = block.normalY[i], nz = block.normalZ[i];
+        float ex = block.edgeX[i], ey = block.edgeY[i], ez = block.edgeZ[i];
+
+        // bitangent = cross(normal, edge)
+        float bx = ny * ez - nz * ey;
+        float by = nz * ex - nx * ez;
+        float bz = nx * ey - ny * ex;
+        float bitangentLength = sqrtf(bx * bx + by * by + bz * bz);
+        float normalLength = sqrtf(nx * nx + ny * ny + nz * nz);
+        bool isValid = bitangentLength >= EPSILON;
+
+        float inverseBitangentLength = isValid ? 1.0f / bitangentLength : 0.0f;
+        float inverseNormalLength = normalLength > 0.0f ? 1.0f / normalLength : 0.0f;
+        bx *= inverseBitangentLength;
+        by *= inverseBitangentLength;
+        bz *= inverseBitangentLength;
+        nx *= inverseNormalLength;
+        ny *= inverseNormalLength;
+        nz *= inverseNormalLength;
+
+        // rotated = bitangent * cos + cross(n, bitangent) * sin
+        float c = block.cosAngle[i], s = block.sinAngle[i];
+        float rx = bx * c + (ny * bz - nz * by) * s;
+        float ry = by * c + (nz * bx - nx * bz) * s;
+        float rz = bz * c + (nx * by - ny * bx) * s;
+
+        // tangent = cross(rotated, n)
+        block.tangentX[i] = isValid ? ry * nz - rz * ny : 0.0f;
+        block.tangentY[i] = isValid ? rz * nx - rx * nz : 0.0f;
+        block.tangentZ[i] = isValid ? rx * ny - ry * nx : 0.0f;
     }
 }
 
-static void _createBlendShapeTangents(FBXMesh& mesh, bool generateFromTexCoords, FBXBlendshape& blendShape);
+// accessor(firstIndex, secondIndex, outVertices, outNormal) returns the index of the tangent to accumulate into,
+// or -1 to skip the edge
+template <typename Accessor>
+static void accumulateTangents(const TangentEdges& edges, QVector<glm::vec3>& tangents, Accessor accessor) {
+    std::unique_ptr<TangentBlock> block { new TangentBlock() };
+    glm::vec3* tangentData = tangents.data();
+
+    int numEdges = (int)edges.firstIndices.size();
+    for (int blockStart = 0; blockStart < numEdges; blockStart += TANGENT_BLOCK_SIZE) {
+        int count = std::min(TANGENT_BLOCK_SIZE, numEdges - blockStart);
+
+        // gather
+        glm::vec3 vertex[2];
+        glm::vec3 normal;
+        for (int i = 0; i < count; ++i) {
+            int edge = blockStart + i;
+            int target = accessor(edges.firstIndices[edge], edges.secondIndices[edge], vertex, normal);
+            block->target[i] = target;
+            if (target < 0) {
+                vertex[0] = vertex[1] = normal = glm::vec3(0.0f);
+            }
+            glm::vec3 edgeVector = vertex[1] - vertex[0];
+            block->edgeX[i] = edgeVector.x;
+            block->edgeY[i] = edgeVector.y;
+            block->edgeZ[i] = edgeVector.z;
+            block->normalX[i] = normal.x;
+            block->normalY[i] = normal.y;
+            block->normalZ[i] = normal.z;
+            block->cosAngle[i] = edges.cosAngles[edge];
+            block->sinAngle[i] = edges.sinAngles[edge];
+        }
+
+        computeTangentBlock(*block, count);
 
-void FBXMesh::createBlendShapeTangents(bool generateTangents) {
-    for (auto& blendShape : blendshapes) {
-        _createBlendShapeTangents(*this, generateTangents, blendShape);
+        // scatter
+        for (int i = 0; i < count; ++i) {
+            int target = block->target[i];
+            if (target >= 0) {
+                tangentData[target] += glm::vec3(block->tangentX[i], block->tangentY[i], block->tangentZ[i]);
+            }
+        }
     }
 }
 
-void FBXMesh::createMeshTangents(bool generateFromTexCoords) {
-    FBXMesh& mesh = *this;
-    // This is the only workaround I've found to trick the compiler into understanding that mesh.tangents isn't
-    // const in the lambda function.
-    auto& tangents = mesh.tangents;
-    createTangents(mesh, generateFromTexCoords, mesh.vertices, mesh.normals, mesh.tangents, 
-                   [&](const FBXMesh& mesh, int firstIndex, int secondIndex, glm::vec3* outVertices, glm::vec3& outNormal) {
-        outVertices[0] = mesh.vertices[firstIndex];
-        outVertices[1] = mesh.vertices[secondIndex];
-        outNormal = mesh.normals[firstIndex];
-        return &(tangents[firstIndex]);
+static void createMeshTangents(FBXMesh& mesh, const TangentEdges& edges) {
+    mesh.tangents.resize(mesh.vertices.size());
+    const glm::vec3* vertices = mesh.vertices.constData();
+    const glm::vec3* normals = mesh.normals.constData();
+    accumulateTangents(edges, mesh.tangents, [&](int firstIndex, int secondIndex, glm::vec3* outVertices, glm::vec3& outNormal) {
+        outVertices[0] = vertices[firstIndex];
+        outVertices[1] = vertices[secondIndex];
+        outNormal = normals[firstIndex];
+        return firstIndex;
     });
 }
 
-static void _createBlendShapeTangents(FBXMesh& mesh, bool generateFromTexCoords, FBXBlendshape& blendShape) {
+static void createBlendShapeTangents(const FBXMesh& mesh, const TangentEdges& edges, FBXBlendshape& blendShape) {
     // Create lookup to get index in blend shape from vertex index in mesh
     std::vector<int> reverseIndices;
     reverseIndices.resize(mesh.vertices.size());
@@ -442,24 +523,53 @@ static void _createBlendShapeTangents(FBXMesh& mesh, bool generateFromTexCoords,
         reverseIndices[indexInMesh] = indexInBlendShape;
     }
 
-    createTangents(mesh, generateFromTexCoords, blendShape.vertices, blendShape.normals, blendShape.tangents,
-                   [&](const FBXMesh& mesh, int firstIndex, int secondIndex, glm::vec3* outVertices, glm::vec3& outNormal) {
+    blendShape.tangents.resize(blendShape.vertices.size());
+    const glm::vec3* meshVertices = mesh.vertices.constData();
+    const glm::vec3* vertices = blendShape.vertices.constData();
+    const glm::vec3* normals = blendShape.normals.constData();
+    const int numVertices = blendShape.vertices.size();
+    accumulateTangents(edges, blendShape.tangents, [&](int firstIndex, int secondIndex, glm::vec3* outVertices, glm::vec3& outNormal) {
         const auto index1 = reverseIndices[firstIndex];
         const auto index2 = reverseIndices[secondIndex];
 
-        if (index1 < blendShape.vertices.size()) {
-            outVertices[0] = blendShape.vertices[index1];
-            if (index2 < blendShape.vertices.size()) {
-                outVertices[1] = blendShape.vertices[index2];
+        if (index1 < numVertices) {
+            outVertices[0] = vertices[index1];
+            if (index2 < numVertices) {
+                outVertices[1] = vertices[index2];
             } else {
                 // Index isn't in the blend shape so return vertex from mesh
-                outVertices[1] = mesh.vertices[secondIndex];
+                outVertices[1] = meshVertices[secondIndex];
             }
-            outNormal = blendShape.normals[index1];
-            return &blendShape.tangents[index1];
+            outNormal = normals[index1];
+            return index1;
+        } else {
+            // Index isn't in blend shape so skip the edge
+            return -1;
+        }
+    });
+}
+
+void FBXMesh::createTangents(bool generateFromTexCoords) {
+    // if we have a normal map (and texture coordinates), we must compute tangents
+    if (!generateFromTexCoords || texCoords.isEmpty()) {
+        return;
+    }
+
+    TangentEdges edges;
+    collectTangentEdges(*this, edges);
+
+    // the mesh (-1) and each of its blendshapes are independent, so process them in parallel
+    QVector<int> targets;
+    targets.reserve(blendshapes.size() + 1);
+    for (int i = -1; i < blendshapes.size(); ++i) {
+        targets.push_back(i);
+    }
+    blendshapes.detach();
+    QtConcurrent::blockingMap(targets, [&](int target) {
+        if (target < 0) {
+            createMeshTangents(*this, edges);
         } else {
-            // Index isn't in blend shape so return nullptr
-            return (glm::vec3*)nullptr;
+            createBlendShapeTangents(*this, edges, blendshapes[target]);
         }
     });
 }
@@ -502,7 +612,7 @@ void addBlendshapes(const ExtractedBlendshape& extracted, const QList<WeightedIn
     }
 }
 
-QString getTopModelID(const QMultiMap<QString, QString>& connectionParentMap,
+QString getTopModelID(const QMultiHash<QString, QString>& connectionParentMap,
         const QHash<QString, FBXModel>& models, const QString& modelID, const QString& url) {
     QString topID = modelID;
     QVector<QString> visitedNodes; // Used to prevent following a cycle
@@ -540,7 +650,7 @@ public:
 };
 
 bool checkMaterialsHaveTextures(const QHash<QString, FBXMaterial>& materials,
-        const QHash<QString, QByteArray>& textureFilenames, const QMultiMap<QString, QString>& _connectionChildMap) {
+        const QHash<QString, QByteArray>& textureFilenames, const QMultiHash<QString, QString>& _connectionChildMap) {
     foreach (const QString& materialID, materials.keys()) {
         foreach (const QString& childID, _connectionChildMap.values(materialID)) {
             if (textureFilenames.contains(childID)) {
@@ -1669,6 +1779,7 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
     // see if any materials have texture children
     bool materialsHaveTextures = checkMaterialsHaveTextures(_fbxMaterials, _textureFilenames, _connectionChildMap);
 
+    QVector<QString> meshModelIDs; // by mesh index
     for (QMap<QString, ExtractedMesh>::iterator it = meshes.begin(); it != meshes.end(); it++) {
         ExtractedMesh& extracted = it.value();
 
@@ -1726,8 +1837,7 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
             }
         }
 
-        extracted.mesh.createMeshTangents(generateTangents);
-        extracted.mesh.createBlendShapeTangents(generateTangents);
+        extracted.mesh.createTangents(generateTangents);
 
         // find the clusters with which the mesh is associated
         QVector<QString> clusterIDs;
@@ -1900,17 +2010,24 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
                 }
             }
         }
-        buildModelMesh(extracted.mesh, url);
-
         geometry.meshes.append(extracted.mesh);
         int meshIndex = geometry.meshes.size() - 1;
-        if (extracted.mesh._mesh) {
-            extracted.mesh._mesh->displayName = QString("%1#/mesh/%2").arg(url).arg(meshIndex).toStdString();
-            extracted.mesh._mesh->modelName = modelIDsToNames.value(modelID).toStdString();
-        }
+        meshModelIDs.append(modelID);
         meshIDsToMeshIndices.insert(it.key(), meshIndex);
     }
 
+    // the meshes' buffers don't depend on each other, so build them in parallel
+    QtConcurrent::blockingMap(geometry.meshes, [&](FBXMesh& mesh) {
+        buildModelMesh(mesh, url);
+    });
+    for (int meshIndex = 0; meshIndex < geometry.meshes.size(); ++meshIndex) {
+        const FBXMesh& mesh = geometry.meshes.at(meshIndex);
+        if (mesh._mesh) {
+            mesh._mesh->displayName = QString("%1#/mesh/%2").arg(url).arg(meshIndex).toStdString();
+            mesh._mesh->modelName = modelIDsToNames.value(meshModelIDs.at(meshIndex)).toStdString();
+        }
+    }
+
     const float INV_SQRT_3 = 0.57735026918f;
     ShapeVertices cardinalDirections = {
         Vectors::UNIT_X,
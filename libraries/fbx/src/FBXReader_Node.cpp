@@ -11,7 +11,11 @@
 
 #include "FBXReader.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <type_traits>
+
 #include <QtCore/QBuffer>
 #include <QtCore/QDataStream>
 #include <QtCore/QIODevice>
@@ -20,184 +24,180 @@
 #include <QtCore/QDebug>
 #include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFileDevice>
+
+#include <zlib.h>
 
 #include <shared/NsightHelpers.h>
 #include "ModelFormatLogging.h"
 
+// Reads the binary FBX format straight out of a contiguous buffer (a mapped file, or the data of a buffer),
+// rather than through a QDataStream, and decodes arrays in place: uncompressed arrays are copied, and compressed
+// arrays inflated, directly into the storage of their vectors.
+// see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
+// of the FBX binary format
+class BinaryFBXParser {
+public:
+    BinaryFBXParser(const char* data, qint64 size, qint64 position) : _data(data), _size(size), _position(position) { }
+
+    qint64 getPosition() const { return _position; }
+    bool atEnd() const { return _position >= _size; }
+
+    template<class T> T read();
+    FBXNode parseNode(bool has64BitPositions);
+
+private:
+    const char* take(qint64 length);
+    QVariant parseProperty();
+    template<class T> QVariant parseArray();
+
+    const char* _data;
+    qint64 _size;
+    qint64 _position;
+};
+
+const char* BinaryFBXParser::take(qint64 length) {
+    if (length < 0 || length > _size - _position) {
+        throw QString("corrupt fbx file");
+    }
+    const char* data = _data + _position;
+    _position += length;
+    return data;
+}
+
 template<class T>
-int streamSize() {
-    return sizeof(T);
+T BinaryFBXParser::read() {
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(take(sizeof(T))));
+}
+
+template<>
+bool BinaryFBXParser::read<bool>() {
+    return *take(1) != 0;
 }
 
-template<bool>
-int streamSize() {
-    return 1;
+template<>
+float BinaryFBXParser::read<float>() {
+    quint32 bits = read<quint32>();
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+template<>
+double BinaryFBXParser::read<double>() {
+    quint64 bits = read<quint64>();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
 }
 
 template<class T>
-QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
-
-    in >> arrayLength;
-    in >> encoding;
-    in >> compressedLength;
-    position += sizeof(quint32) * 3;
-
-    QVector<T> values;
-    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
-        values.resize(arrayLength);
-        QByteArray arrayData;
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            arrayData = qUncompress(compressed);
-            if (arrayData.isEmpty() ||
-                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-        } else {
-            arrayData.resize(sizeof(T) * arrayLength);
-            position += sizeof(T) * arrayLength;
-            in.readRawData(arrayData.data(), arrayData.size());
-        }
+static void swapFromLittleEndian(QVector<T>& values) {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    for (T& value : values) {
+        std::reverse(reinterpret_cast<char*>(&value), reinterpret_cast<char*>(&value) + sizeof(T));
+    }
+#endif
+}
 
-        if (arrayData.size() > 0) {
-            memcpy(&values[0], arrayData.constData(), arrayData.size());
+template<class T>
+QVariant BinaryFBXParser::parseArray() {
+    quint32 arrayLength = read<quint32>();
+    quint32 encoding = read<quint32>();
+    quint32 compressedLength = read<quint32>();
+
+    // bools are stored as single bytes, the same as in memory
+    static_assert(!std::is_same<T, bool>::value || sizeof(bool) == 1, "bools must be a byte");
+
+    // computed in 64 bits, since uLong is only 32 bits on some platforms, and checked against every size it is
+    // narrowed to (a QVector holds at most INT_MAX bytes) before anything is allocated or inflated
+    quint64 arraySize64 = (quint64)arrayLength * sizeof(T);
+    if (arraySize64 > (quint64)std::numeric_limits<int>::max() ||
+            arraySize64 > (quint64)std::numeric_limits<uLongf>::max()) {
+        throw QString("corrupt fbx file");
+    }
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        // deflate can't do better than about 1032:1, so don't allocate for more than the data can inflate to
+        const quint64 MAX_DEFLATE_RATIO = 1032;
+        if (arraySize64 > (quint64)compressedLength * MAX_DEFLATE_RATIO) {
+            throw QString("corrupt fbx file");
         }
-    } else {
-        values.reserve(arrayLength);
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            QByteArray uncompressed = qUncompress(compressed);
-            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-            QDataStream uncompressedIn(uncompressed);
-            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                uncompressedIn >> value;
-                values.append(value);
-            }
-        } else {
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                in >> value;
-                position += streamSize<T>();
-                values.append(value);
-            }
+    } else if ((qint64)arraySize64 > _size - _position) {
+        throw QString("corrupt fbx file");
+    }
+    uLongf arraySize = (uLongf)arraySize64;
+
+    QVector<T> values(arrayLength);
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        auto compressed = reinterpret_cast<const Bytef*>(take(compressedLength));
+        uLongf uncompressedSize = arraySize;
+        if (arraySize > 0 && (uncompress(reinterpret_cast<Bytef*>(values.data()), &uncompressedSize,
+                compressed, compressedLength) != Z_OK || uncompressedSize != arraySize)) {
+            throw QString("corrupt fbx file");
         }
+    } else if (arraySize > 0) {
+        memcpy(values.data(), take(arraySize), arraySize);
     }
+    swapFromLittleEndian(values);
+
     return QVariant::fromValue(values);
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
+QVariant BinaryFBXParser::parseProperty() {
+    char ch = *take(1);
     switch (ch) {
-        case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
-        }
-        case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
-        }
-        case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
-        }
-        case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
-        }
-        case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
-        }
-        case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
-        }
-        case 'f': {
-            return readBinaryArray<float>(in, position);
-        }
-        case 'd': {
-            return readBinaryArray<double>(in, position);
-        }
-        case 'l': {
-            return readBinaryArray<qint64>(in, position);
-        }
-        case 'i': {
-            return readBinaryArray<qint32>(in, position);
-        }
-        case 'b': {
-            return readBinaryArray<bool>(in, position);
-        }
+        case 'Y':
+            return QVariant::fromValue(read<qint16>());
+        case 'C':
+            return QVariant::fromValue(read<bool>());
+        case 'I':
+            return QVariant::fromValue(read<qint32>());
+        case 'F':
+            return QVariant::fromValue(read<float>());
+        case 'D':
+            return QVariant::fromValue(read<double>());
+        case 'L':
+            return QVariant::fromValue(read<qint64>());
+        case 'f':
+            return parseArray<float>();
+        case 'd':
+            return parseArray<double>();
+        case 'l':
+            return parseArray<qint64>();
+        case 'i':
+            return parseArray<qint32>();
+        case 'b':
+            return parseArray<bool>();
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            quint32 length = read<quint32>();
+            // copied, since the nodes outlive the buffer
+            return QVariant::fromValue(QByteArray(take(length), length));
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+FBXNode BinaryFBXParser::parseNode(bool has64BitPositions) {
     qint64 endOffset;
     quint64 propertyCount;
     quint64 propertyListLength;
-    quint8 nameLength;
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
     // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
-    // values and then assign to our actual 64bit values.
+    // from here on out, but if the file is an older format we read the 32bit values and assign
+    // them to our actual 64bit values.
     if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+        endOffset = read<qint64>();
+        propertyCount = read<quint64>();
+        propertyListLength = read<quint64>();
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = read<qint32>();
+        propertyCount = read<quint32>();
+        propertyListLength = read<quint32>();
+    }
+    quint8 nameLength = read<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -205,15 +205,16 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = QByteArray(take(nameLength), nameLength);
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    // the property count comes from the file, so the properties aren't reserved up front: a corrupt count would
+    // allocate for properties that were never there, where appending stops with the first one that can't be read
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseProperty());
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (endOffset > _position) {
+        FBXNode child = parseNode(has64BitPositions);
         if (!child.name.isNull()) {
             node.children.append(child);
         }
@@ -363,37 +364,62 @@ FBXNode FBXReader::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-
-    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
-    // of the FBX binary format
-
-    // The first 27 bytes contain the header.
-    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
-    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
-    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
-    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
-    qCDebug(modelformat) << "fileVersion:" << fileVersion;
-    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
-
-    // parse the top-level node
+
+    // parse straight out of memory: map files, use the data of buffers, and only read other devices into memory
+    qint64 startPosition = device->pos();
+    const char* data = nullptr;
+    qint64 size = 0;
+    uchar* mapped = nullptr;
+    QByteArray contents;
+    auto file = qobject_cast<QFileDevice*>(device);
+    auto buffer = qobject_cast<QBuffer*>(device);
+    if (file && (mapped = file->map(startPosition, file->size() - startPosition))) {
+        data = reinterpret_cast<const char*>(mapped);
+        size = file->size() - startPosition;
+    } else if (buffer) {
+        data = buffer->data().constData() + startPosition;
+        size = buffer->data().size() - startPosition;
+    } else {
+        contents = device->readAll();
+        data = contents.constData();
+        size = contents.size();
+    }
+
     FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
-        if (next.name.isNull()) {
-            return top;
+    try {
+        // The first 27 bytes contain the header.
+        //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
+        //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
+        //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
+        BinaryFBXParser parser(data, size, FBX_HEADER_BYTES_BEFORE_VERSION);
+        quint32 fileVersion = parser.read<quint32>();
+        qCDebug(modelformat) << "fileVersion:" << fileVersion;
+        bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
+
+        // parse the top-level node
+        while (!parser.atEnd()) {
+            FBXNode next = parser.parseNode(has64BitPositions);
+            if (next.name.isNull()) {
+                break;
+            } else {
+                top.children.append(next);
+            }
+        }
 
-        } else {
-            top.children.append(next);
+        if (contents.isNull()) {
+            // leave the device where the parsing stopped, as when reading from it
+            device->seek(startPosition + parser.getPosition());
+        }
+    } catch (...) {
+        if (mapped) {
+            file->unmap(mapped);
         }
+        throw;
     }
 
+    if (mapped) {
+        file->unmap(mapped);
+    }
     return top;
 }
 
@@ -337,7 +337,7 @@ public:
     class KtxStorage : public Storage {
     public:
         KtxStorage(const std::string& filename);
-        KtxStorage(const cache::FilePointer& file);
+        KtxStorage(const cache::FilePointer& file, uint16 minResidentMip = 0);
         PixelsPointer getMipFace(uint16 level, uint8 face = 0) const override;
         Size getMipFaceSize(uint16 level, uint8 face = 0) const override;
         bool isMipAvailable(uint16 level, uint8 face = 0) const override;
@@ -534,7 +534,8 @@ public:
 
     void setStorage(std::unique_ptr<Storage>& newStorage);
     void setKtxBacking(const std::string& filename);
-    void setKtxBacking(const cache::FilePointer& cacheEntry);
+    // With minResidentMip, the mips above it are left in the file and reported as unavailable
+    void setKtxBacking(const cache::FilePointer& cacheEntry, uint16 minResidentMip = 0);
 
     // Usage is a a set of flags providing Semantic about the usage of the Texture.
     void setUsage(const Usage& usage) { _usage = usage; }
@@ -567,7 +568,8 @@ public:
 
     static TexturePointer build(const ktx::KTXDescriptor& descriptor);
     static TexturePointer unserialize(const std::string& ktxFile);
-    static TexturePointer unserialize(const cache::FilePointer& cacheEntry, const std::string& source = std::string());
+    static TexturePointer unserialize(const cache::FilePointer& cacheEntry, const std::string& source = std::string(),
+                                      uint16 minResidentMip = 0);
 
     static bool evalKTXFormat(const Element& mipFormat, const Element& texelFormat, ktx::Header& header);
     static bool evalTextureFormat(const ktx::Header& header, Element& mipFormat, Element& texelFormat);
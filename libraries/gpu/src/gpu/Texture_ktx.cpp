@@ -159,8 +159,11 @@ struct IrradianceKTXPayload {
 };
 const std::string IrradianceKTXPayload::KEY{ "hifi.irradianceSH" };
 
-KtxStorage::KtxStorage(const cache::FilePointer& cacheEntry) : KtxStorage(cacheEntry->getFilepath())  {
+KtxStorage::KtxStorage(const cache::FilePointer& cacheEntry, uint16 minResidentMip) : KtxStorage(cacheEntry->getFilepath())  {
     _cacheEntry = cacheEntry;
+    if (minResidentMip > _minMipLevelAvailable) {
+        _minMipLevelAvailable = (uint8_t)minResidentMip;
+    }
 }
 
 KtxStorage::KtxStorage(const std::string& filename) : _filename(filename) {
@@ -301,8 +304,11 @@ void KtxStorage::assignMipData(uint16 level, const storage::StoragePointer& stor
         memcpy(imageData, storage->data(), storage->size());
         _minMipLevelAvailable = level;
         if (_offsetToMinMipKV > 0) {
+            // the file may already hold more mips than this storage exposes, never move its min mip back up
             auto minMipKeyData = fileData + ktx::KTX_HEADER_SIZE + _offsetToMinMipKV;
-            memcpy(minMipKeyData, (void*)&_minMipLevelAvailable, 1);
+            if (*minMipKeyData > _minMipLevelAvailable) {
+                memcpy(minMipKeyData, (void*)&_minMipLevelAvailable, 1);
+            }
         }
     }
 }
@@ -330,13 +336,13 @@ void Texture::setKtxBacking(const std::string& filename) {
     setStorage(newBacking);
 }
 
-void Texture::setKtxBacking(const cache::FilePointer& cacheEntry) {
+void Texture::setKtxBacking(const cache::FilePointer& cacheEntry, uint16 minResidentMip) {
     // Check the KTX file for validity before using it as backing storage
     if (!validKtx(cacheEntry->getFilepath())) {
         return;
     }
 
-    auto newBacking = std::unique_ptr<Storage>(new KtxStorage(cacheEntry));
+    auto newBacking = std::unique_ptr<Storage>(new KtxStorage(cacheEntry, minResidentMip));
     setStorage(newBacking);
 }
 
@@ -531,7 +537,7 @@ TexturePointer Texture::build(const ktx::KTXDescriptor& descriptor) {
     return texture;
 }
 
-TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry, const std::string& source) {
+TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry, const std::string& source, uint16 minResidentMip) {
     std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(std::make_shared<storage::FileStorage>(cacheEntry->getFilepath().c_str()));
     if (!ktxPointer) {
         return nullptr;
@@ -539,7 +545,7 @@ TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry, const
 
     auto texture = build(ktxPointer->toDescriptor());
     if (texture) {
-        texture->setKtxBacking(cacheEntry);
+        texture->setKtxBacking(cacheEntry, minResidentMip);
         if (texture->source().empty()) {
             texture->setSource(source);
         }
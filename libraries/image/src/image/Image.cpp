@@ -11,9 +11,14 @@
 
 #include "Image.h"
 
+#include <condition_variable>
+#include <mutex>
+
 #include <glm/gtc/packing.hpp>
 
 #include <QtCore/QtGlobal>
+#include <QtCore/QHash>
+#include <QtCore/QThreadPool>
 #include <QUrl>
 #include <QImage>
 #include <QBuffer>
@@ -73,6 +78,83 @@ glm::uvec2 rectifySize(const glm::uvec2& size) {
 
 namespace image {
 
+// Shared by every texture being processed: cube faces, mip levels and nvtt's block rows are all spread over it
+static QThreadPool& getCompressionThreadPool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+void setCompressionThreadCount(int count) {
+    getCompressionThreadPool().setMaxThreadCount(std::max(count, 1));
+}
+
+int getCompressionThreadCount() {
+    return getCompressionThreadPool().maxThreadCount();
+}
+
+// Runs `job` for every index in [0, count) on the compression pool, with the calling thread taking its share.
+// Because the caller keeps pulling jobs itself, a job may call parallelFor again without starving the pool,
+// and helpers that only get a thread after all the jobs are taken simply find nothing left to do.
+// Jobs that haven't started yet are skipped once `abortProcessing` is set.
+class ParallelJobs {
+public:
+    using Job = std::function<void(int)>;
+
+    static void run(int count, const std::atomic<bool>& abortProcessing, const Job& job) {
+        auto& pool = getCompressionThreadPool();
+        int helperCount = std::min(count, pool.maxThreadCount()) - 1;
+        if (helperCount <= 0) {
+            for (int i = 0; i < count && !abortProcessing.load(); ++i) {
+                job(i);
+            }
+            return;
+        }
+
+        auto jobs = std::make_shared<ParallelJobs>(count, abortProcessing, job);
+        for (int i = 0; i < helperCount; ++i) {
+            pool.start(new Helper(jobs));
+        }
+        jobs->work();
+
+        std::unique_lock<std::mutex> lock(jobs->_mutex);
+        jobs->_allFinished.wait(lock, [&] { return jobs->_finished.load() == count; });
+    }
+
+    ParallelJobs(int count, const std::atomic<bool>& abortProcessing, const Job& job) :
+        _count(count), _abortProcessing(abortProcessing), _job(job) {}
+
+private:
+    class Helper : public QRunnable {
+    public:
+        Helper(const std::shared_ptr<ParallelJobs>& jobs) : _jobs(jobs) {}
+        void run() override { _jobs->work(); }
+    private:
+        std::shared_ptr<ParallelJobs> _jobs;
+    };
+
+    void work() {
+        int index;
+        while ((index = _next++) < _count) {
+            // the job and the abort flag belong to the caller, which waits for every claimed index to finish
+            if (!_abortProcessing.load()) {
+                _job(index);
+            }
+            if (++_finished == _count) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _allFinished.notify_all();
+            }
+        }
+    }
+
+    const int _count;
+    const std::atomic<bool>& _abortProcessing;
+    const Job& _job;
+    std::atomic<int> _next { 0 };
+    std::atomic<int> _finished { 0 };
+    std::mutex _mutex;
+    std::condition_variable _allFinished;
+};
+
 const QStringList getSupportedFormats() {
     auto formats = QImageReader::supportedImageFormats();
     QStringList stringFormats;
@@ -89,6 +171,32 @@ QImage::Format QIMAGE_HDR_FORMAT = QImage::Format_RGB30;
 QImage::Format QIMAGE_HDR_FORMAT = QImage::Format_RGB32;
 #endif
 
+bool TextureUsage::getTextureUsageTypeFromName(const QString& name, Type& type) {
+    static const QHash<QString, Type> TEXTURE_USAGE_TYPES_BY_NAME {
+        { "default", DEFAULT_TEXTURE },
+        { "strict", STRICT_TEXTURE },
+        { "albedo", ALBEDO_TEXTURE },
+        { "normal", NORMAL_TEXTURE },
+        { "bump", BUMP_TEXTURE },
+        { "specular", SPECULAR_TEXTURE },
+        { "metallic", METALLIC_TEXTURE },
+        { "roughness", ROUGHNESS_TEXTURE },
+        { "gloss", GLOSS_TEXTURE },
+        { "emissive", EMISSIVE_TEXTURE },
+        { "cube", CUBE_TEXTURE },
+        { "occlusion", OCCLUSION_TEXTURE },
+        { "scattering", SCATTERING_TEXTURE },
+        { "lightmap", LIGHTMAP_TEXTURE },
+    };
+
+    auto it = TEXTURE_USAGE_TYPES_BY_NAME.find(name);
+    if (it == TEXTURE_USAGE_TYPES_BY_NAME.end()) {
+        return false;
+    }
+    type = it.value();
+    return true;
+}
+
 TextureUsage::TextureLoader TextureUsage::getTextureLoaderForType(Type type, const QVariantMap& options) {
     switch (type) {
         case ALBEDO_TEXTURE:
@@ -302,15 +410,48 @@ QImage processSourceImage(QImage&& srcImage, bool cubemap) {
     return localCopy;
 }
 
+// Mips compressed for a texture, possibly from several threads at once. They are handed to the texture afterwards
+// from the thread that owns it, since gpu::Texture storage doesn't take concurrent assignments.
+class CompressedMips {
+public:
+    void add(int level, int face, const storage::StoragePointer& storage) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _mips.push_back({ level, face, storage });
+    }
+
+    void assignTo(gpu::Texture* texture) {
+        for (auto& mip : _mips) {
+            if (mip.face >= 0) {
+                texture->assignStoredMipFace(mip.level, mip.face, mip.storage);
+            } else {
+                texture->assignStoredMip(mip.level, mip.storage);
+            }
+        }
+        _mips.clear();
+    }
+
+private:
+    struct Mip {
+        int level;
+        int face;
+        storage::StoragePointer storage;
+    };
+
+    std::mutex _mutex;
+    std::vector<Mip> _mips;
+};
+
 #if defined(NVTT_API)
 struct OutputHandler : public nvtt::OutputHandler {
-    OutputHandler(gpu::Texture* texture, int face) : _texture(texture), _face(face) {}
+    OutputHandler(CompressedMips& mips, int face) : _mips(mips), _face(face) {}
 
     virtual void beginImage(int size, int width, int height, int depth, int face, int miplevel) override {
         _size = size;
         _miplevel = miplevel;
 
-        _data = static_cast<gpu::Byte*>(malloc(size));
+        // write straight into the storage the texture will keep
+        _storage = std::make_shared<storage::MemoryStorage>(size);
+        _data = _storage->data();
         _current = _data;
     }
 
@@ -322,25 +463,22 @@ struct OutputHandler : public nvtt::OutputHandler {
     }
 
     virtual void endImage() override {
-        if (_face >= 0) {
-            _texture->assignStoredMipFace(_miplevel, _face, _size, static_cast<const gpu::Byte*>(_data));
-        } else {
-            _texture->assignStoredMip(_miplevel, _size, static_cast<const gpu::Byte*>(_data));
-        }
-        free(_data);
+        _mips.add(_miplevel, _face, _storage);
+        _storage.reset();
         _data = nullptr;
     }
 
+    CompressedMips& _mips;
+    std::shared_ptr<storage::MemoryStorage> _storage;
     gpu::Byte* _data{ nullptr };
     gpu::Byte* _current{ nullptr };
-    gpu::Texture* _texture{ nullptr };
     int _miplevel = 0;
     int _size = 0;
     int _face = -1;
 };
 
 struct PackedFloatOutputHandler : public OutputHandler {
-    PackedFloatOutputHandler(gpu::Texture* texture, int face, gpu::Element format) : OutputHandler(texture, face) {
+    PackedFloatOutputHandler(CompressedMips& mips, int face, gpu::Element format) : OutputHandler(mips, face) {
         if (format == gpu::Element::COLOR_RGB9E5) {
             _packFunc = glm::packF3x9_E1x5;
         } else if (format == gpu::Element::COLOR_R11G11B10) {
@@ -389,24 +527,21 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
     }
 };
 
-class SequentialTaskDispatcher : public nvtt::TaskDispatcher {
+// Spreads the rows of blocks nvtt compresses for one mip over the compression pool
+class ParallelTaskDispatcher : public nvtt::TaskDispatcher {
 public:
-    SequentialTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
+    ParallelTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
 
     const std::atomic<bool>& _abortProcessing;
 
     virtual void dispatch(nvtt::Task* task, void* context, int count) override {
-        for (int i = 0; i < count; i++) {
-            if (!_abortProcessing.load()) {
-                task(context, i);
-            } else {
-                break;
-            }
-        }
+        ParallelJobs::run(count, _abortProcessing, [&](int i) {
+            task(context, i);
+        });
     }
 };
 
-void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
+void generateHDRMips(CompressedMips& mips, gpu::Element mipFormat, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(image);
@@ -416,7 +551,6 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
     const int width = localCopy.width(), height = localCopy.height();
     std::vector<glm::vec4> data;
     std::vector<glm::vec4>::iterator dataIt;
-    auto mipFormat = texture->getStoredMipFormat();
     std::function<glm::vec3(uint32)> unpackFunc;
 
     nvtt::InputFormat inputFormat = nvtt::InputFormat_RGBA_32F;
@@ -470,40 +604,46 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
     // We're done with the localCopy, free up the memory to avoid bloating the heap
     localCopy = QImage(); // QImage doesn't have a clear function, so override it with an empty one.
 
-    nvtt::OutputOptions outputOptions;
-    outputOptions.setOutputHeader(false);
-    std::unique_ptr<nvtt::OutputHandler> outputHandler;
-    MyErrorHandler errorHandler;
-    outputOptions.setErrorHandler(&errorHandler);
-    nvtt::Context context;
-    int mipLevel = 0;
-
-    if (mipFormat == gpu::Element::COLOR_RGB9E5 || mipFormat == gpu::Element::COLOR_R11G11B10) {
-        // Don't use NVTT (at least version 2.1) as it outputs wrong RGB9E5 and R11G11B10F values from floats
-        outputHandler.reset(new PackedFloatOutputHandler(texture, face, mipFormat));
-    } else {
-        outputHandler.reset(new OutputHandler(texture, face));
+    // Each level only depends on the previous one, so build the whole chain up front (a third more than the
+    // top level) and then compress all the levels at once
+    std::vector<nvtt::Surface> surfaces(1);
+    surfaces[0].setImage(inputFormat, width, height, 1, &(*data.begin()));
+    surfaces[0].setAlphaMode(alphaMode);
+    surfaces[0].setWrapMode(wrapMode);
+    data.clear();
+    data.shrink_to_fit();
+
+    while (surfaces.back().canMakeNextMipmap() && !abortProcessing.load()) {
+        nvtt::Surface nextMip = surfaces.back();
+        nextMip.buildNextMipmap(nvtt::MipmapFilter_Box);
+        surfaces.push_back(std::move(nextMip));
     }
 
-    outputOptions.setOutputHandler(outputHandler.get());
+    ParallelJobs::run((int)surfaces.size(), abortProcessing, [&](int mipLevel) {
+        nvtt::OutputOptions outputOptions;
+        outputOptions.setOutputHeader(false);
+        std::unique_ptr<nvtt::OutputHandler> outputHandler;
+        MyErrorHandler errorHandler;
+        outputOptions.setErrorHandler(&errorHandler);
 
-    nvtt::Surface surface;
-    surface.setImage(inputFormat, width, height, 1, &(*data.begin()));
-    surface.setAlphaMode(alphaMode);
-    surface.setWrapMode(wrapMode);
+        if (mipFormat == gpu::Element::COLOR_RGB9E5 || mipFormat == gpu::Element::COLOR_R11G11B10) {
+            // Don't use NVTT (at least version 2.1) as it outputs wrong RGB9E5 and R11G11B10F values from floats
+            outputHandler.reset(new PackedFloatOutputHandler(mips, face, mipFormat));
+        } else {
+            outputHandler.reset(new OutputHandler(mips, face));
+        }
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
-    nvtt::Compressor compressor;
-    context.setTaskDispatcher(&dispatcher);
+        outputOptions.setOutputHandler(outputHandler.get());
 
-    context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-    while (surface.canMakeNextMipmap() && !abortProcessing.load()) {
-        surface.buildNextMipmap(nvtt::MipmapFilter_Box);
-        context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-    }
+        ParallelTaskDispatcher dispatcher(abortProcessing);
+        nvtt::Context context;
+        context.setTaskDispatcher(&dispatcher);
+
+        context.compress(surfaces[mipLevel], face, mipLevel, compressionOptions, outputOptions);
+    });
 }
 
-void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
+void generateLDRMips(CompressedMips& mips, gpu::Element mipFormat, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(image);
@@ -513,7 +653,6 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
     }
 
     const int width = localCopy.width(), height = localCopy.height();
-    auto mipFormat = texture->getStoredMipFormat();
 
 #ifndef USE_GLES
     const void* data = static_cast<const void*>(localCopy.constBits());
@@ -620,12 +759,14 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
     nvtt::OutputOptions outputOptions;
     outputOptions.setOutputHeader(false);
-    OutputHandler outputHandler(texture, face);
+    OutputHandler outputHandler(mips, face);
     outputOptions.setOutputHandler(&outputHandler);
     MyErrorHandler errorHandler;
     outputOptions.setErrorHandler(&errorHandler);
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
+    // The compressor builds each mip from the previous one and runs its gamma and alpha handling in between,
+    // so the levels stay in order here and the parallelism comes from the block rows within each level
+    ParallelTaskDispatcher dispatcher(abortProcessing);
     nvtt::Compressor compressor;
     compressor.setTaskDispatcher(&dispatcher);
     compressor.process(inputOptions, compressionOptions, outputOptions);
@@ -690,11 +831,8 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
     for (int i = 0; i < numMips; i++) {
         if (mipMaps[i].paucEncodingBits.get()) {
-            if (face >= 0) {
-                texture->assignStoredMipFace(i, face, mipMaps[i].uiEncodingBitsBytes, static_cast<const gpu::Byte*>(mipMaps[i].paucEncodingBits.get()));
-            } else {
-                texture->assignStoredMip(i, mipMaps[i].uiEncodingBitsBytes, static_cast<const gpu::Byte*>(mipMaps[i].paucEncodingBits.get()));
-            }
+            mips.add(i, face, std::make_shared<storage::MemoryStorage>(mipMaps[i].uiEncodingBitsBytes,
+                static_cast<const gpu::Byte*>(mipMaps[i].paucEncodingBits.get())));
         }
     }
 
@@ -704,19 +842,41 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
 #endif
 
-void generateMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing = false, int face = -1) {
-#if CPU_MIPMAPS
-    PROFILE_RANGE(resource_parse, "generateMips");
-
+void compressMips(CompressedMips& mips, gpu::Element mipFormat, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
 #ifndef USE_GLES
     if (image.format() == QIMAGE_HDR_FORMAT) {
-        generateHDRMips(texture, std::move(image), abortProcessing, face);
+        generateHDRMips(mips, mipFormat, std::move(image), abortProcessing, face);
     } else  {
-        generateLDRMips(texture, std::move(image), abortProcessing, face);
+        generateLDRMips(mips, mipFormat, std::move(image), abortProcessing, face);
     }
 #else
-    generateLDRMips(texture, std::move(image), abortProcessing, face);
+    generateLDRMips(mips, mipFormat, std::move(image), abortProcessing, face);
 #endif
+}
+
+void generateMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing = false, int face = -1) {
+#if CPU_MIPMAPS
+    PROFILE_RANGE(resource_parse, "generateMips");
+
+    CompressedMips mips;
+    compressMips(mips, texture->getStoredMipFormat(), std::move(image), abortProcessing, face);
+    mips.assignTo(texture);
+#else
+    texture->setAutoGenerateMips(true);
+#endif
+}
+
+void generateCubeMips(gpu::Texture* texture, std::vector<QImage>&& faces, const std::atomic<bool>& abortProcessing) {
+#if CPU_MIPMAPS
+    PROFILE_RANGE(resource_parse, "generateCubeMips");
+
+    // the faces are independent, compress them all at once
+    CompressedMips mips;
+    auto mipFormat = texture->getStoredMipFormat();
+    ParallelJobs::run((int)faces.size(), abortProcessing, [&](int face) {
+        compressMips(mips, mipFormat, std::move(faces[face]), abortProcessing, face);
+    });
+    mips.assignTo(texture);
 #else
     texture->setAutoGenerateMips(true);
 #endif
@@ -1396,9 +1556,7 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(QImage&& srcI
             theTexture->overrideIrradiance(irradiance);
         }
 
-        for (uint8 face = 0; face < faces.size(); ++face) {
-            generateMips(theTexture.get(), std::move(faces[face]), abortProcessing, face);
-        }
+        generateCubeMips(theTexture.get(), std::move(faces), abortProcessing);
     }
 
     return theTexture;
@@ -44,6 +44,9 @@ enum Type {
 using TextureLoader = std::function<gpu::TexturePointer(QImage&&, const std::string&, bool, const std::atomic<bool>&)>;
 TextureLoader getTextureLoaderForType(Type type, const QVariantMap& options = QVariantMap());
 
+// looks up a texture usage by the name the oven and tools take ("albedo", "cube", ...), returns false if it is unknown
+bool getTextureUsageTypeFromName(const QString& name, Type& type);
+
 gpu::TexturePointer create2DTextureFromImage(QImage&& image, const std::string& srcImageName,
                                              bool compress, const std::atomic<bool>& abortProcessing);
 gpu::TexturePointer createStrict2DTextureFromImage(QImage&& image, const std::string& srcImageName,
@@ -82,6 +85,11 @@ gpu::TexturePointer processCubeTextureColorFromImage(QImage&& srcImage, const st
 
 const QStringList getSupportedFormats();
 
+// How many threads texture compression spreads cube faces, mip levels and blocks over (the ideal thread count
+// by default). With 1, everything is compressed on the calling thread.
+void setCompressionThreadCount(int count);
+int getCompressionThreadCount();
+
 gpu::TexturePointer processImage(std::shared_ptr<QIODevice> content, const std::string& url,
                                  int maxNumPixels, TextureUsage::Type textureType,
                                  bool compress = false, const std::atomic<bool>& abortProcessing = false);
@@ -410,6 +410,16 @@ void Geometry::setTextures(const QVariantMap& textureMap) {
     }
 }
 
+void Geometry::setTextureImportance(const QPointer<QObject>& owner, float importance) const {
+    for (auto& material : _materials) {
+        for (auto& texture : material->_textures) {
+            if (texture.texture) {
+                texture.texture->setImportance(owner, importance);
+            }
+        }
+    }
+}
+
 bool Geometry::areTexturesLoaded() const {
     if (!_areTexturesLoaded) {
         for (auto& material : _materials) {
@@ -54,6 +54,10 @@ public:
     void setTextures(const QVariantMap& textureMap);
 
     virtual bool areTexturesLoaded() const;
+
+    /// Reports how much of the view the owner draws this geometry's textures over (see NetworkTexture::setImportance)
+    void setTextureImportance(const QPointer<QObject>& owner, float importance) const;
+
     const QUrl& getAnimGraphOverrideUrl() const { return _animGraphOverrideUrl; }
     const QVariantHash& getMapping() const { return _mapping; }
 
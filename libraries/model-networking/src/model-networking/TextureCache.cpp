@@ -18,6 +18,7 @@
 #include <QCryptographicHash>
 #include <QImageReader>
 #include <QRunnable>
+#include <QThread>
 #include <QThreadPool>
 #include <QNetworkReply>
 #include <QPainter>
@@ -38,6 +39,7 @@
 #include <NumericalConstants.h>
 #include <shared/NsightHelpers.h>
 #include <shared/FileUtils.h>
+#include <shared/QtHelpers.h>
 #include <PathUtils.h>
 #include <Finally.h>
 #include <Profile.h>
@@ -70,6 +72,12 @@ static const QUrl HMD_PREVIEW_FRAME_URL("resource://hmdPreviewFrame");
 static const float SKYBOX_LOAD_PRIORITY { 10.0f }; // Make sure skybox loads first
 static const float HIGH_MIPS_LOAD_PRIORITY { 9.0f }; // Make sure high mips loads after skybox but before models
 
+// Textures nobody reports an importance for (UI, skyboxes, ...) rank with the largest entities
+static const float UNREPORTED_TEXTURE_IMPORTANCE { PI_OVER_TWO };
+// Evicted textures keep the mips up to about the size the initial KTX load brings in
+static const uint32_t EVICTED_MIP_MAX_SIZE { 64 };
+static const int STREAMING_UPDATE_INTERVAL_MSECS { 500 };
+
 TextureCache::TextureCache() {
     _ktxCache->initialize();
 #if defined(DISABLE_KTX_CACHE)
@@ -77,6 +85,10 @@ TextureCache::TextureCache() {
 #endif
     setUnusedResourceCacheSize(0);
     setObjectName("TextureCache");
+
+    // importance changes as the view moves, so give the textures waiting for mips another look every so often
+    connect(&_streamingTimer, &QTimer::timeout, this, [this] { _streamingScheduler.update(); });
+    _streamingTimer.start(STREAMING_UPDATE_INTERVAL_MSECS);
 }
 
 TextureCache::~TextureCache() {
@@ -213,6 +225,33 @@ NetworkTexturePointer TextureCache::getTexture(const QUrl& url, image::TextureUs
     return ResourceCache::getResource(modifiedUrl, QUrl(), &extra).staticCast<NetworkTexture>();
 }
 
+void TextureCache::setStreamingInFlightByteBudget(qint64 budget) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "setStreamingInFlightByteBudget", Q_ARG(qint64, budget));
+        return;
+    }
+    _streamingScheduler.setInFlightByteBudget(budget);
+    _streamingScheduler.update();
+}
+
+void TextureCache::setStreamingResidentByteBudget(qint64 budget) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "setStreamingResidentByteBudget", Q_ARG(qint64, budget));
+        return;
+    }
+    _streamingScheduler.setResidentByteBudget(budget);
+    _streamingScheduler.update();
+}
+
+QVariantMap TextureCache::getStreamingStats() {
+    if (QThread::currentThread() != thread()) {
+        QVariantMap result;
+        BLOCKING_INVOKE_METHOD(this, "getStreamingStats", Q_RETURN_ARG(QVariantMap, result));
+        return result;
+    }
+    return _streamingScheduler.getStats();
+}
+
 gpu::TexturePointer TextureCache::getTextureByHash(const std::string& hash) {
     std::weak_ptr<gpu::Texture> weakPointer;
     {
@@ -387,6 +426,12 @@ private:
 };
 
 NetworkTexture::~NetworkTexture() {
+    auto textureCache = DependencyManager::get<TextureCache>();
+    if (textureCache) {
+        textureCache->_streamingScheduler.removeTexture(this);
+        finishScheduledMipRequest(false);
+    }
+
     if (_ktxHeaderRequest || _ktxMipRequest) {
         if (_ktxHeaderRequest) {
             _ktxHeaderRequest->disconnect(this);
@@ -574,16 +619,185 @@ void NetworkTexture::startRequestForNextMipLevel() {
         return;
     }
 
+    auto& scheduler = DependencyManager::get<TextureCache>()->_streamingScheduler;
+    StreamedTextureWeakPointer weakSelf = qWeakPointerCast<NetworkTexture, Resource>(_self);
+    scheduler.addTexture(weakSelf);
+
     _lowestKnownPopulatedMip = texture->minAvailableMipLevel();
-    if (_lowestRequestedMipLevel < _lowestKnownPopulatedMip) {
-        _ktxResourceState = PENDING_MIP_REQUEST;
+    if (wantsNextMip()) {
+        // the scheduler calls startScheduledMipRequest once it is this texture's turn
+        scheduler.requestNextMip(weakSelf);
+    }
+}
+
+void NetworkTexture::setImportance(const QPointer<QObject>& owner, float importance) {
+    // drop the owners that went away here, rather than every time the scheduler asks
+    for (auto it = _importances.begin(); it != _importances.end();) {
+        if (it.key().isNull()) {
+            it = _importances.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    _importances.insert(owner, importance);
+    _hasImportanceOwners = true;
+}
+
+void NetworkTexture::clearImportance(const QPointer<QObject>& owner) {
+    _importances.remove(owner);
+}
 
-        init(false);
-        float priority = -(float)_originalKtxDescriptor->header.numberOfMipmapLevels + (float)_lowestKnownPopulatedMip;
-        setLoadPriority(this, priority);
-        _url.setFragment(QString::number(_lowestKnownPopulatedMip - 1));
-        TextureCache::attemptRequest(self);
+float NetworkTexture::getImportance() const {
+    if (!_hasImportanceOwners) {
+        return UNREPORTED_TEXTURE_IMPORTANCE;
     }
+
+    float highestImportance = 0.0f;
+    for (auto it = _importances.cbegin(); it != _importances.cend(); ++it) {
+        if (!it.key().isNull()) {
+            highestImportance = std::max(highestImportance, it.value());
+        }
+    }
+    return highestImportance;
+}
+
+static qint64 evalMipBytes(const gpu::Texture& texture, uint16_t fromLevel, uint16_t toLevel) {
+    qint64 bytes = 0;
+    for (auto level = fromLevel; level < toLevel; ++level) {
+        bytes += texture.evalStoredMipSize(level, texture.getStoredMipFormat());
+    }
+    return bytes;
+}
+
+static uint16_t evalEvictionMipLevel(const gpu::Texture& texture) {
+    uint16_t level = 0;
+    auto size = std::max(texture.getWidth(), texture.getHeight());
+    while ((size >> level) > EVICTED_MIP_MAX_SIZE && level + 1 < texture.getNumMips()) {
+        ++level;
+    }
+    return level;
+}
+
+uint16_t NetworkTexture::getMinAvailableMipLevel() const {
+    auto texture = _textureSource->getGPUTexture();
+    return texture ? texture->minAvailableMipLevel() : 0;
+}
+
+bool NetworkTexture::wantsNextMip() const {
+    auto texture = _textureSource->getGPUTexture();
+    return texture && _ktxResourceState == WAITING_FOR_MIP_REQUEST &&
+        (isEvicted() || _lowestRequestedMipLevel < texture->minAvailableMipLevel());
+}
+
+qint64 NetworkTexture::getResidentMipBytes() const {
+    auto texture = _textureSource->getGPUTexture();
+    return texture ? evalMipBytes(*texture, texture->minAvailableMipLevel(), texture->getNumMips()) : 0;
+}
+
+qint64 NetworkTexture::getNextMipBytes() const {
+    auto texture = _textureSource->getGPUTexture();
+    if (!texture) {
+        return 0;
+    }
+    if (isEvicted()) {
+        return evalMipBytes(*texture, _mipLevelBeforeEviction, _evictedMipLevel);
+    }
+    auto minMipLevel = texture->minAvailableMipLevel();
+    return minMipLevel > 0 ? evalMipBytes(*texture, minMipLevel - 1, minMipLevel) : 0;
+}
+
+void NetworkTexture::startScheduledMipRequest(qint64 bytes) {
+    auto self = _self.lock();
+    if (!self) {
+        return;
+    }
+
+    _scheduledMipBytes = bytes;
+    _ktxResourceState = PENDING_MIP_REQUEST;
+
+    init(false);
+    float priority = -(float)_originalKtxDescriptor->header.numberOfMipmapLevels + (float)_lowestKnownPopulatedMip;
+    setLoadPriority(this, priority);
+    _url.setFragment(QString::number(_lowestKnownPopulatedMip - 1));
+    TextureCache::attemptRequest(self);
+}
+
+void NetworkTexture::finishScheduledMipRequest(bool success) {
+    if (_scheduledMipBytes > 0) {
+        auto bytes = _scheduledMipBytes;
+        _scheduledMipBytes = 0;
+        DependencyManager::get<TextureCache>()->_streamingScheduler.mipRequestFinished(bytes, success);
+    }
+}
+
+bool NetworkTexture::canEvictHighMips() const {
+    // Only textures streamed through the KTX cache can get their mips back from it, and only between requests
+    auto texture = _textureSource->getGPUTexture();
+    return texture && !_ktxHash.empty() && !isEvicted() && _type != image::TextureUsage::CUBE_TEXTURE &&
+        _ktxResourceState == WAITING_FOR_MIP_REQUEST && texture->minAvailableMipLevel() < evalEvictionMipLevel(*texture);
+}
+
+qint64 NetworkTexture::evictHighMips() {
+    // the scheduler doesn't ask textures that share their gpu texture with another one
+    if (!canEvictHighMips()) {
+        return 0;
+    }
+    auto texture = _textureSource->getGPUTexture();
+
+    auto textureCache = DependencyManager::get<TextureCache>();
+    auto ktxFile = textureCache->_ktxCache->getFile(_ktxHash);
+    if (!ktxFile) {
+        return 0;
+    }
+
+    // A new texture backed by the same cache file that only exposes the low mips. Its gpu objects are built from
+    // scratch, so the memory for the high mips goes away with the old texture.
+    auto evictionMipLevel = evalEvictionMipLevel(*texture);
+    auto evictedTexture = gpu::Texture::unserialize(ktxFile, texture->source(), evictionMipLevel);
+    if (!evictedTexture) {
+        return 0;
+    }
+
+    auto minMipLevel = texture->minAvailableMipLevel();
+    auto evictedBytes = evalMipBytes(*texture, minMipLevel, evictionMipLevel);
+
+    _mipLevelBeforeEviction = minMipLevel;
+    _evictedMipLevel = evictionMipLevel;
+    _lowestKnownPopulatedMip = evictionMipLevel;
+    _textureSource->resetTexture(evictedTexture);
+
+    return evictedBytes;
+}
+
+void NetworkTexture::restoreEvictedMips() {
+    if (!isEvicted()) {
+        return;
+    }
+
+    auto textureCache = DependencyManager::get<TextureCache>();
+    auto evictedTexture = _textureSource->getGPUTexture();
+
+    // someone else may have loaded the whole texture in the meantime
+    auto texture = textureCache->getTextureByHash(_ktxHash);
+    if (!texture) {
+        auto ktxFile = textureCache->_ktxCache->getFile(_ktxHash);
+        if (ktxFile) {
+            texture = gpu::Texture::unserialize(ktxFile, evictedTexture ? evictedTexture->source() : std::string());
+            if (texture) {
+                texture = textureCache->cacheTextureByHash(_ktxHash, texture);
+            }
+        }
+    }
+
+    _evictedMipLevel = NULL_MIP_LEVEL;
+    _mipLevelBeforeEviction = NULL_MIP_LEVEL;
+
+    // without the cache file the evicted texture streams its mips from the network again
+    if (texture) {
+        _textureSource->resetTexture(texture);
+    }
+
+    startRequestForNextMipLevel();
 }
 
 // Load mips in the range [low, high] (inclusive)
@@ -600,6 +814,7 @@ void NetworkTexture::startMipRangeRequest(uint16_t low, uint16_t high) {
         qCWarning(networking).noquote() << "Failed to get request for" << _url.toDisplayString();
 
         PROFILE_ASYNC_END(resource, "Resource:" + getType(), QString::number(_requestID));
+        finishScheduledMipRequest(false);
         return;
     }
 
@@ -771,6 +986,11 @@ void NetworkTexture::ktxMipRequestFinished() {
     _ktxMipRequest->disconnect(this);
     _ktxMipRequest->deleteLater();
     _ktxMipRequest = nullptr;
+
+    // unless it is being retried, the mip stops counting against the streaming bandwidth
+    if (_ktxResourceState != PENDING_MIP_REQUEST) {
+        finishScheduledMipRequest(result == ResourceRequest::Success);
+    }
 }
 
 // This is called when the header and top mips have been loaded
@@ -933,6 +1153,8 @@ void NetworkTexture::handleFinishedInitialLoad() {
             texture = textureCache->cacheTextureByHash(filename, texture);
         }
 
+        QMetaObject::invokeMethod(resource.data(), "setKtxHash", Q_ARG(QString, QString::fromStdString(hash)));
+
         QMetaObject::invokeMethod(resource.data(), "setImage",
             Q_ARG(gpu::TexturePointer, texture),
             Q_ARG(int, texture->getWidth()),
@@ -16,6 +16,7 @@
 
 #include <QImage>
 #include <QMap>
+#include <QTimer>
 #include <QColor>
 #include <QMetaEnum>
 
@@ -28,6 +29,7 @@
 
 #include <gpu/Context.h>
 #include "KTXCache.h"
+#include "TextureStreamingScheduler.h"
 
 namespace gpu {
 class Batch;
@@ -41,7 +43,7 @@ public:
 };
 
 /// A texture loaded from the network.
-class NetworkTexture : public Resource, public Texture {
+class NetworkTexture : public Resource, public Texture, public StreamedTexture {
     Q_OBJECT
 
 public:
@@ -62,6 +64,17 @@ public:
     void refresh() override;
 
     Q_INVOKABLE void setOriginalDescriptor(ktx::KTXDescriptor* descriptor) { _originalKtxDescriptor.reset(descriptor); }
+    Q_INVOKABLE void setKtxHash(const QString& hash) { _ktxHash = hash.toStdString(); }
+
+    /// Sets how much of the view this texture covers for one owner, as the angular size of what it is drawn on.
+    /// Streaming higher mips goes to the textures that cover the most for the resolution they have. Owners that go
+    /// away stop counting, and a texture that was reported on but has no owners left is the first to give up its
+    /// high mips when the streaming memory budget is full.
+    void setImportance(const QPointer<QObject>& owner, float importance);
+    void clearImportance(const QPointer<QObject>& owner);
+
+    /// Returns the highest importance across all owners
+    float getImportance() const override;
 
 signals:
     void networkTextureCreated(const QWeakPointer<NetworkTexture>& self);
@@ -95,6 +108,19 @@ private:
     friend class KTXReader;
     friend class ImageReader;
 
+    // Used by the TextureStreamingScheduler
+    const std::string& getContentHash() const override { return _ktxHash; }
+    uint16_t getMinAvailableMipLevel() const override;
+    bool wantsNextMip() const override;
+    bool isEvicted() const override { return _evictedMipLevel != NULL_MIP_LEVEL; }
+    qint64 getResidentMipBytes() const override;
+    qint64 getNextMipBytes() const override;
+    void startScheduledMipRequest(qint64 bytes) override;
+    void finishScheduledMipRequest(bool success);
+    bool canEvictHighMips() const override;
+    qint64 evictHighMips() override;
+    void restoreEvictedMips() override;
+
     image::TextureUsage::Type _type;
 
     enum class ResourceType {
@@ -134,6 +160,19 @@ private:
     // mip offsets to change.
     ktx::KTXDescriptorPointer _originalKtxDescriptor;
 
+    // The KTX cache entry holding the mips streamed so far
+    std::string _ktxHash;
+
+    // Bytes of the mip in flight that the scheduler has accounted for
+    qint64 _scheduledMipBytes { 0 };
+
+    // When the high mips were evicted, the mips from _mipLevelBeforeEviction up to _evictedMipLevel are only in the
+    // KTX cache file
+    uint16_t _evictedMipLevel { NULL_MIP_LEVEL };
+    uint16_t _mipLevelBeforeEviction { NULL_MIP_LEVEL };
+
+    QHash<QPointer<QObject>, float> _importances;
+    bool _hasImportanceOwners { false };
 
     int _originalWidth { 0 };
     int _originalHeight { 0 };
@@ -195,6 +234,13 @@ public:
     void setGPUContext(const gpu::ContextPointer& context) { _gpuContext = context; }
     gpu::ContextPointer getGPUContext() const { return _gpuContext; }
 
+    /// Limits the bytes of KTX mips being downloaded at once
+    Q_INVOKABLE void setStreamingInFlightByteBudget(qint64 budget);
+    /// Limits the bytes of mips streamed textures hold before less important ones give up their high mips
+    Q_INVOKABLE void setStreamingResidentByteBudget(qint64 budget);
+    /// Counters of the KTX mip streaming, for stats displays and benchmarks
+    Q_INVOKABLE QVariantMap getStreamingStats();
+
 signals:
     void spectatorCameraFramebufferReset();
 
@@ -222,6 +268,9 @@ private:
 
     std::shared_ptr<cache::FileCache> _ktxCache { std::make_shared<KTXCache>(KTX_DIRNAME, KTX_EXT) };
 
+    TextureStreamingScheduler _streamingScheduler;
+    QTimer _streamingTimer;
+
     // Map from image hashes to texture weak pointers
     std::unordered_map<std::string, std::weak_ptr<gpu::Texture>> _texturesByHashes;
     std::mutex _texturesByHashesMutex;
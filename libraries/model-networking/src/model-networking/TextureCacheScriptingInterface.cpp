@@ -21,3 +21,7 @@ TextureCacheScriptingInterface::TextureCacheScriptingInterface() :
 ScriptableResource* TextureCacheScriptingInterface::prefetch(const QUrl& url, int type, int maxNumPixels) {
     return DependencyManager::get<TextureCache>()->prefetch(url, type, maxNumPixels);
 }
+
+QVariantMap TextureCacheScriptingInterface::getStreamingStats() {
+    return DependencyManager::get<TextureCache>()->getStreamingStats();
+}
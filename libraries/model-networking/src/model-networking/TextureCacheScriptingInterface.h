@@ -54,6 +54,14 @@ public:
      */
     Q_INVOKABLE ScriptableResource* prefetch(const QUrl& url, int type, int maxNumPixels = ABSOLUTE_MAX_TEXTURE_NUM_PIXELS);
 
+    /**jsdoc
+     * Get the counters of the KTX mip streaming: requests and bytes in flight, bytes held by streamed textures, how
+     * often mips had to wait for bandwidth or memory, and how many textures gave up their high mips.
+     * @function TextureCache.getStreamingStats
+     * @returns {object}
+     */
+    Q_INVOKABLE QVariantMap getStreamingStats();
+
 signals:
     /**jsdoc
      * @function TextureCache.spectatorCameraFramebufferReset
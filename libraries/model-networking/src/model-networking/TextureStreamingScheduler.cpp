@@ -0,0 +1,230 @@
+//
+//  TextureStreamingScheduler.cpp
+//  libraries/model-networking/src/model-networking
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureStreamingScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QtCore/QSet>
+
+static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+
+const qint64 TextureStreamingScheduler::DEFAULT_IN_FLIGHT_BYTE_BUDGET = 16 * BYTES_PER_MEGABYTE;
+const qint64 TextureStreamingScheduler::DEFAULT_RESIDENT_BYTE_BUDGET = 1024 * BYTES_PER_MEGABYTE;
+
+// Keeps textures nobody reports on ordered by how blurry they are
+static const float MIN_SCORE_IMPORTANCE = 0.001f;
+
+void TextureStreamingScheduler::addTexture(const StreamedTextureWeakPointer& texture) {
+    auto strongTexture = texture.lock();
+    if (!strongTexture || _textures.contains(strongTexture.data())) {
+        return;
+    }
+
+    Entry entry { texture, strongTexture->getContentHash() };
+    if (!entry.contentHash.empty()) {
+        ++_texturesPerContentHash[entry.contentHash];
+    }
+    _textures.insert(strongTexture.data(), entry);
+}
+
+void TextureStreamingScheduler::removeTexture(StreamedTexture* texture) {
+    auto it = _textures.find(texture);
+    if (it != _textures.end()) {
+        auto hashIt = _texturesPerContentHash.find(it->contentHash);
+        if (hashIt != _texturesPerContentHash.end() && --hashIt->second <= 0) {
+            _texturesPerContentHash.erase(hashIt);
+        }
+        _textures.erase(it);
+    }
+    _waiting.remove(texture);
+}
+
+void TextureStreamingScheduler::requestNextMip(const StreamedTextureWeakPointer& texture) {
+    auto strongTexture = texture.lock();
+    if (strongTexture) {
+        addTexture(texture);
+        _waiting.insert(strongTexture.data(), texture);
+        update();
+    }
+}
+
+void TextureStreamingScheduler::mipRequestFinished(qint64 bytes, bool success) {
+    _inFlightBytes = std::max(_inFlightBytes - bytes, (qint64)0);
+    _inFlightRequests = std::max(_inFlightRequests - 1, 0);
+    if (success) {
+        ++_completedMips;
+    } else {
+        ++_failedMips;
+    }
+    update();
+}
+
+float TextureStreamingScheduler::getScore(const StreamedTexture& texture) {
+    // Each mip we're missing halves the resolution the texture is shown at, so weigh how much of the screen it
+    // covers by how far it is from full resolution
+    return (texture.getImportance() + MIN_SCORE_IMPORTANCE) * std::ldexp(1.0f, texture.getMinAvailableMipLevel());
+}
+
+void TextureStreamingScheduler::update() {
+    if (_updating) {
+        // starting a request can finish it right away, pick up anything that changed once we're done
+        _updateAgain = true;
+        return;
+    }
+    _updating = true;
+
+    do {
+        _updateAgain = false;
+
+        // recount what is resident, mips land and textures go away between updates
+        _residentBytes = 0;
+        std::vector<StreamedTexture*> removedTextures;
+        for (auto it = _textures.begin(); it != _textures.end(); ++it) {
+            auto texture = it->texture.lock();
+            if (!texture) {
+                removedTextures.push_back(it.key());
+                continue;
+            }
+            _residentBytes += texture->getResidentMipBytes();
+        }
+        for (auto texture : removedTextures) {
+            removeTexture(texture);
+        }
+        // count the mips in flight as resident already, they will be once they land
+        _residentBytes += _inFlightBytes;
+
+        // textures that can't make room for their mips this time around
+        QSet<StreamedTexture*> outOfMemory;
+
+        while (!_waiting.isEmpty()) {
+            QSharedPointer<StreamedTexture> best;
+            float bestScore = -1.0f;
+            for (auto it = _waiting.begin(); it != _waiting.end();) {
+                auto texture = it.value().lock();
+                if (!texture || !texture->wantsNextMip()) {
+                    it = _waiting.erase(it);
+                    continue;
+                }
+                if (outOfMemory.contains(it.key())) {
+                    ++it;
+                    continue;
+                }
+                auto score = getScore(*texture);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = texture;
+                }
+                ++it;
+            }
+
+            if (!best) {
+                break;
+            }
+
+            // The best texture waits for bandwidth rather than letting lesser ones jump ahead of it. When it can't
+            // make room in memory though, the textures behind it may still be able to push out less important ones
+            bool isRestore = best->isEvicted();
+            auto bytes = best->getNextMipBytes();
+            if (!isRestore && _inFlightBytes > 0 && _inFlightBytes + bytes > _inFlightByteBudget) {
+                ++_deferredForBandwidth;
+                break;
+            }
+            if (_residentBytes + bytes > _residentByteBudget &&
+                !evictFor(_residentBytes + bytes - _residentByteBudget, best->getImportance())) {
+                ++_deferredForMemory;
+                outOfMemory.insert(best.data());
+                continue;
+            }
+
+            _waiting.remove(best.data());
+            _residentBytes += bytes;
+            if (isRestore) {
+                ++_restores;
+                best->restoreEvictedMips();
+            } else {
+                ++_requestedMips;
+                ++_inFlightRequests;
+                _inFlightBytes += bytes;
+                best->startScheduledMipRequest(bytes);
+            }
+        }
+    } while (_updateAgain);
+
+    _updating = false;
+}
+
+bool TextureStreamingScheduler::isShared(const Entry& entry) const {
+    if (entry.contentHash.empty()) {
+        return false;
+    }
+    auto it = _texturesPerContentHash.find(entry.contentHash);
+    return it != _texturesPerContentHash.end() && it->second > 1;
+}
+
+bool TextureStreamingScheduler::evictFor(qint64 bytes, float importance) {
+    std::vector<std::pair<float, QSharedPointer<StreamedTexture>>> candidates;
+    for (auto& entry : _textures) {
+        auto texture = entry.texture.lock();
+        // a texture that is also used by another one wouldn't free anything
+        if (texture && !isShared(entry) && texture->canEvictHighMips()) {
+            auto textureImportance = texture->getImportance();
+            // strictly less important, so textures that matter as much don't keep trading mips
+            if (textureImportance < importance) {
+                candidates.emplace_back(textureImportance, texture);
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    qint64 freedBytes = 0;
+    for (auto& candidate : candidates) {
+        if (freedBytes >= bytes) {
+            break;
+        }
+        auto& texture = candidate.second;
+        auto evictedBytes = texture->evictHighMips();
+        if (evictedBytes > 0) {
+            freedBytes += evictedBytes;
+            _residentBytes -= evictedBytes;
+            _evictedBytes += evictedBytes;
+            ++_evictions;
+
+            // it gets its mips back from the KTX cache once it is the most important texture waiting
+            _waiting.insert(texture.data(), texture);
+        }
+    }
+    return freedBytes >= bytes;
+}
+
+QVariantMap TextureStreamingScheduler::getStats() const {
+    QVariantMap stats;
+    stats["streamingTextures"] = _textures.size();
+    stats["waitingTextures"] = _waiting.size();
+    stats["inFlightRequests"] = _inFlightRequests;
+    stats["inFlightBytes"] = _inFlightBytes;
+    stats["inFlightByteBudget"] = _inFlightByteBudget;
+    stats["residentBytes"] = _residentBytes;
+    stats["residentByteBudget"] = _residentByteBudget;
+    stats["requestedMips"] = _requestedMips;
+    stats["completedMips"] = _completedMips;
+    stats["failedMips"] = _failedMips;
+    stats["deferredForBandwidth"] = _deferredForBandwidth;
+    stats["deferredForMemory"] = _deferredForMemory;
+    stats["evictions"] = _evictions;
+    stats["evictedBytes"] = _evictedBytes;
+    stats["restores"] = _restores;
+    return stats;
+}
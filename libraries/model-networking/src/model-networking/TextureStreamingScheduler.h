@@ -0,0 +1,124 @@
+//
+//  TextureStreamingScheduler.h
+//  libraries/model-networking/src/model-networking
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureStreamingScheduler_h
+#define hifi_TextureStreamingScheduler_h
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <QtCore/QHash>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVariantMap>
+
+/// A texture that streams its mips through the TextureStreamingScheduler, see NetworkTexture
+class StreamedTexture {
+public:
+    virtual ~StreamedTexture() {}
+
+    /// How much of the view the texture covers, as the angular size of what it is drawn on
+    virtual float getImportance() const = 0;
+
+    /// Textures with the same non-empty content hash share one gpu texture, so evicting one frees nothing
+    virtual const std::string& getContentHash() const = 0;
+
+    virtual uint16_t getMinAvailableMipLevel() const = 0;
+    virtual qint64 getResidentMipBytes() const = 0;
+
+    /// Whether the texture is waiting for its next mip, or for its evicted mips back
+    virtual bool wantsNextMip() const = 0;
+    virtual qint64 getNextMipBytes() const = 0;
+
+    /// Starts the request for the next mip, which reports back through TextureStreamingScheduler::mipRequestFinished
+    virtual void startScheduledMipRequest(qint64 bytes) = 0;
+
+    virtual bool canEvictHighMips() const = 0;
+    virtual bool isEvicted() const = 0;
+
+    /// Drops the high mips, returning the bytes freed
+    virtual qint64 evictHighMips() = 0;
+    virtual void restoreEvictedMips() = 0;
+};
+using StreamedTextureWeakPointer = QWeakPointer<StreamedTexture>;
+
+/// Decides which KTX textures get to stream their next mip.
+///
+/// Textures that want a higher resolution mip queue up here instead of going straight to the ResourceCache. Mips are
+/// handed out to the textures that cover the most of the screen for the resolution they have, as long as the bytes
+/// in flight and the bytes of mips held by streamed textures stay within their budgets. When the resident budget is
+/// full, textures that matter less give up their high mips. Those mips stay in the KTX cache file, and are restored
+/// from it instead of the network once the texture matters again.
+///
+/// Only used from the TextureCache thread.
+class TextureStreamingScheduler {
+public:
+    static const qint64 DEFAULT_IN_FLIGHT_BYTE_BUDGET;
+    static const qint64 DEFAULT_RESIDENT_BYTE_BUDGET;
+
+    void setInFlightByteBudget(qint64 budget) { _inFlightByteBudget = budget; }
+    qint64 getInFlightByteBudget() const { return _inFlightByteBudget; }
+    void setResidentByteBudget(qint64 budget) { _residentByteBudget = budget; }
+    qint64 getResidentByteBudget() const { return _residentByteBudget; }
+
+    /// Starts tracking a texture that has finished its initial load
+    void addTexture(const StreamedTextureWeakPointer& texture);
+    void removeTexture(StreamedTexture* texture);
+
+    /// Queues a texture that wants its next mip, or its evicted mips back
+    void requestNextMip(const StreamedTextureWeakPointer& texture);
+
+    /// Called when a mip request started by the scheduler is done, whether it succeeded or not
+    void mipRequestFinished(qint64 bytes, bool success);
+
+    /// Hands out as many mip requests as the budgets allow
+    void update();
+
+    QVariantMap getStats() const;
+
+private:
+    struct Entry {
+        StreamedTextureWeakPointer texture;
+        std::string contentHash; // as it was when the texture was added, to release its count
+    };
+
+    static float getScore(const StreamedTexture& texture);
+
+    // Whether another streamed texture holds the same gpu texture
+    bool isShared(const Entry& entry) const;
+
+    // Frees at least `bytes` of resident mips from textures less important than `importance`
+    bool evictFor(qint64 bytes, float importance);
+
+    qint64 _inFlightByteBudget { DEFAULT_IN_FLIGHT_BYTE_BUDGET };
+    qint64 _residentByteBudget { DEFAULT_RESIDENT_BYTE_BUDGET };
+
+    QHash<StreamedTexture*, Entry> _textures;
+    QHash<StreamedTexture*, StreamedTextureWeakPointer> _waiting;
+    std::unordered_map<std::string, int> _texturesPerContentHash;
+
+    bool _updating { false };
+    bool _updateAgain { false };
+
+    qint64 _inFlightBytes { 0 };
+    qint64 _residentBytes { 0 };
+    int _inFlightRequests { 0 };
+
+    quint64 _requestedMips { 0 };
+    quint64 _completedMips { 0 };
+    quint64 _failedMips { 0 };
+    quint64 _deferredForBandwidth { 0 };
+    quint64 _deferredForMemory { 0 };
+    quint64 _evictions { 0 };
+    quint64 _evictedBytes { 0 };
+    quint64 _restores { 0 };
+};
+
+#endif // hifi_TextureStreamingScheduler_h
@@ -302,6 +302,11 @@ public:
 
     void setConnectionMaxBandwidth(int maxBandwidth) { _nodeSocket.setConnectionMaxBandwidth(maxBandwidth); }
 
+    // see udt::Socket
+    void setDatagramBatchingEnabled(bool enabled) { _nodeSocket.setDatagramBatchingEnabled(enabled); }
+    void beginDatagramBatch() { _nodeSocket.beginDatagramBatch(); }
+    void flushDatagramBatch() { _nodeSocket.flushDatagramBatch(); }
+
     void setPacketFilterOperator(udt::PacketFilterOperator filterOperator) { _nodeSocket.setPacketFilterOperator(filterOperator); }
     bool packetVersionMatch(const udt::Packet& packet);
 
@@ -68,6 +68,7 @@ NLPacket::NLPacket(PacketType type, qint64 size, bool isReliable, bool isPartOfM
     _type(type),
     _version((version == 0) ? versionForPacketType(type) : version)
 {
+    _bufferOwner = PacketBufferPool::Owner::NLPacket;
     adjustPayloadStartAndCapacity(NLPacket::localHeaderSize(_type));
 
     writeTypeAndVersion();
@@ -76,6 +77,7 @@ NLPacket::NLPacket(PacketType type, qint64 size, bool isReliable, bool isPartOfM
 NLPacket::NLPacket(Packet&& packet) :
     Packet(std::move(packet))
 {
+    _bufferOwner = PacketBufferPool::Owner::NLPacket;
     readType();
     readVersion();
     readSourceID();
@@ -84,6 +86,7 @@ NLPacket::NLPacket(Packet&& packet) :
 }
 
 NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
+    _bufferOwner = PacketBufferPool::Owner::NLPacket;
     _type = other._type;
     _version = other._version;
     _sourceID = other._sourceID;
@@ -92,6 +95,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
 NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
+    _bufferOwner = PacketBufferPool::Owner::NLPacket;
     // sanity check before we decrease the payloadSize with the payloadCapacity
     Q_ASSERT(_payloadSize == _payloadCapacity);
     
@@ -105,6 +109,7 @@ NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr
 NLPacket::NLPacket(NLPacket&& other) :
     Packet(std::move(other))
 {
+    _bufferOwner = PacketBufferPool::Owner::NLPacket;
     _type = other._type;
     _version = other._version;
     _sourceID = std::move(other._sourceID);
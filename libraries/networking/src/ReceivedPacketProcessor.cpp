@@ -71,11 +71,8 @@ bool ReceivedPacketProcessor::process() {
     currentPackets.swap(_packets);
     unlock();
 
-    for(auto& packetPair : currentPackets) {
-        processPacket(packetPair.second, packetPair.first);
-        _lastWindowProcessedPackets++;
-        midProcess();
-    }
+    processPackets(currentPackets);
+    _lastWindowProcessedPackets += (int)currentPackets.size();
 
     lock();
     for(auto& packetPair : currentPackets) {
@@ -87,6 +84,13 @@ bool ReceivedPacketProcessor::process() {
     return isStillRunning();  // keep running till they terminate us
 }
 
+void ReceivedPacketProcessor::processPackets(std::list<NodeSharedReceivedMessagePair>& packets) {
+    for (auto& packetPair : packets) {
+        processPacket(packetPair.second, packetPair.first);
+        midProcess();
+    }
+}
+
 void ReceivedPacketProcessor::nodeKilled(SharedNodePointer node) {
     lock();
     _nodePacketCounts.remove(node->getUUID());
@@ -69,6 +69,10 @@ protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process() override;
 
+    /// Processes the packets taken from the queue, in order. Default calls processPacket() and then midProcess() for each
+    /// packet, override to process them in batches.
+    virtual void processPackets(std::list<NodeSharedReceivedMessagePair>& packets);
+
     /// Determines the timeout of the wait when there are no packets to process. Default value is 100ms to allow for regular event processing.
     virtual uint32_t getMaxWait() const { return MAX_WAIT_TIME; }
 
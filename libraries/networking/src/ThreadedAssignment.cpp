@@ -20,6 +20,7 @@
 #include <LogHandler.h>
 
 #include "NetworkLogging.h"
+#include "udt/PacketBufferPool.h"
 
 ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     Assignment(message),
@@ -105,6 +106,8 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
     ioStats["outbound_packets_per_s"] = packetsOutPerSecond;
 
     statsObject["io_stats"] = ioStats;
+    statsObject["packet_buffer_pool"] = udt::PacketBufferPool::getStats();
+    udt::PacketBufferPool::resetStats();
 
     nodeList->sendStatsToDomainServer(statsObject);
 }
@@ -60,7 +60,8 @@ BasePacket::BasePacket(qint64 size) {
     Q_ASSERT(size >= 0 || size < maxPayload);
     
     _packetSize = size;
-    _packet.reset(new char[_packetSize]());
+    allocateBuffer();
+    memset(_packet.get(), 0, _packetSize);
     _payloadCapacity = _packetSize;
     _payloadSize = 0;
     _payloadStart = _packet.get();
@@ -77,6 +78,30 @@ BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSock
     
 }
 
+BasePacket::~BasePacket() {
+    releaseBuffer();
+}
+
+void BasePacket::allocateBuffer() {
+    if (_packetSize <= PacketBufferPool::BUFFER_SIZE) {
+        _packet = PacketBufferPool::acquire(&_isBufferRecycled);
+        _isBufferPooled = true;
+    } else {
+        _packet.reset(new char[_packetSize]);
+        _isBufferPooled = false;
+        _isBufferRecycled = false;
+    }
+}
+
+void BasePacket::releaseBuffer() {
+    if (_isBufferPooled) {
+        PacketBufferPool::recordPacket(_bufferOwner, _isBufferRecycled);
+        PacketBufferPool::release(std::move(_packet));
+        _isBufferPooled = false;
+        _isBufferRecycled = false;
+    }
+}
+
 BasePacket::BasePacket(const BasePacket& other) :
     QIODevice()
 {
@@ -84,8 +109,9 @@ BasePacket::BasePacket(const BasePacket& other) :
 }
 
 BasePacket& BasePacket::operator=(const BasePacket& other) {
+    releaseBuffer();
     _packetSize = other._packetSize;
-    _packet = std::unique_ptr<char[]>(new char[_packetSize]);
+    allocateBuffer();
     memcpy(_packet.get(), other._packet.get(), _packetSize);
     
     _payloadStart = _packet.get() + (other._payloadStart - other._packet.get());
@@ -109,8 +135,14 @@ BasePacket::BasePacket(BasePacket&& other) {
 }
 
 BasePacket& BasePacket::operator=(BasePacket&& other) {
+    // the buffer moves, but its owner (for stats) remains the class of this packet
+    releaseBuffer();
     _packetSize = other._packetSize;
     _packet = std::move(other._packet);
+    _isBufferPooled = other._isBufferPooled;
+    _isBufferRecycled = other._isBufferRecycled;
+    other._isBufferPooled = false;
+    other._isBufferRecycled = false;
     
     _payloadStart = other._payloadStart;
     _payloadCapacity = other._payloadCapacity;
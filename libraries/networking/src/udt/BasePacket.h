@@ -22,6 +22,7 @@
 
 #include "../HifiSockAddr.h"
 #include "Constants.h"
+#include "PacketBufferPool.h"
 
 namespace udt {
     
@@ -33,6 +34,8 @@ public:
     static std::unique_ptr<BasePacket> create(qint64 size = -1);
     static std::unique_ptr<BasePacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
                                                           const HifiSockAddr& senderSockAddr);
+
+    virtual ~BasePacket();
     
     // Current level's header size
     static int localHeaderSize();
@@ -85,6 +88,11 @@ public:
 
     void setReceiveTime(p_high_resolution_clock::time_point receiveTime) { _receiveTime = receiveTime; }
     p_high_resolution_clock::time_point getReceiveTime() const { return _receiveTime; }
+
+    // Hands the packet's buffer back to PacketBufferPool once the packet is done with it
+    // Only for received packets, whose data came from PacketBufferPool::acquire
+    void setBufferPooled(bool wasRecycled) { _isBufferPooled = true; _isBufferRecycled = wasRecycled; }
+    bool isBufferPooled() const { return _isBufferPooled; }
    
     template<typename T> qint64 peekPrimitive(T* data);
     template<typename T> qint64 readPrimitive(T* data);
@@ -103,6 +111,11 @@ protected:
     virtual qint64 readData(char* data, qint64 maxSize) override;
     
     void adjustPayloadStartAndCapacity(qint64 headerSize, bool shouldDecreasePayloadSize = false);
+
+    // allocates _packet for _packetSize bytes, from the pool if it fits
+    void allocateBuffer();
+    // returns _packet to the pool, if it came from there
+    void releaseBuffer();
     
     qint64 _packetSize = 0;        // Total size of the allocated memory
     std::unique_ptr<char[]> _packet; // Allocated memory
@@ -115,6 +128,10 @@ protected:
     HifiSockAddr _senderSockAddr;  // sender address for packet (only used on receiving end)
 
     p_high_resolution_clock::time_point _receiveTime; // captures the time the packet received (only used on receiving end)
+
+    bool _isBufferPooled { false };   // _packet came from PacketBufferPool
+    bool _isBufferRecycled { false }; // ... and was reused rather than allocated
+    PacketBufferPool::Owner _bufferOwner { PacketBufferPool::Owner::BasePacket }; // set by each subclass, for pool stats
 };
 
 template<typename T> qint64 BasePacket::peekPrimitive(T* data) {
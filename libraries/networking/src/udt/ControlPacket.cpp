@@ -49,6 +49,7 @@ ControlPacket::ControlPacket(Type type, qint64 size) :
     BasePacket((size == -1) ? -1 : ControlPacket::localHeaderSize() + size),
     _type(type)
 {
+    _bufferOwner = PacketBufferPool::Owner::ControlPacket;
     adjustPayloadStartAndCapacity(ControlPacket::localHeaderSize());
     
     open(QIODevice::ReadWrite);
@@ -59,6 +60,7 @@ ControlPacket::ControlPacket(Type type, qint64 size) :
 ControlPacket::ControlPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
     BasePacket(std::move(data), size, senderSockAddr)
 {
+    _bufferOwner = PacketBufferPool::Owner::ControlPacket;
     // sanity check before we decrease the payloadSize with the payloadCapacity
     Q_ASSERT(_payloadSize == _payloadCapacity);
     
@@ -70,6 +72,7 @@ ControlPacket::ControlPacket(std::unique_ptr<char[]> data, qint64 size, const Hi
 ControlPacket::ControlPacket(ControlPacket&& other) :
     BasePacket(std::move(other))
 {
+    _bufferOwner = PacketBufferPool::Owner::ControlPacket;
     _type = other._type;
 }
 
@@ -82,6 +82,7 @@ Packet::Packet(qint64 size, bool isReliable, bool isPartOfMessage) :
     _isReliable(isReliable),
     _isPartOfMessage(isPartOfMessage)
 {
+    _bufferOwner = PacketBufferPool::Owner::Packet;
     adjustPayloadStartAndCapacity(Packet::localHeaderSize(_isPartOfMessage));
     // set the UDT header to default values
     writeHeader();
@@ -90,6 +91,7 @@ Packet::Packet(qint64 size, bool isReliable, bool isPartOfMessage) :
 Packet::Packet(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
     BasePacket(std::move(data), size, senderSockAddr)
 {
+    _bufferOwner = PacketBufferPool::Owner::Packet;
     readHeader();
 
     adjustPayloadStartAndCapacity(Packet::localHeaderSize(_isPartOfMessage), _payloadSize > 0);
@@ -115,6 +117,7 @@ Packet::Packet(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& se
 }
 
 Packet::Packet(const Packet& other) : BasePacket(other) {
+    _bufferOwner = PacketBufferPool::Owner::Packet;
     copyMembers(other);
 }
 
@@ -127,6 +130,7 @@ Packet& Packet::operator=(const Packet& other) {
 }
 
 Packet::Packet(Packet&& other) : BasePacket(std::move(other)) {
+    _bufferOwner = PacketBufferPool::Owner::Packet;
     copyMembers(other);
 }
 
@@ -0,0 +1,156 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+using namespace udt;
+
+PacketBufferPool::PacketBufferPool() : _nodes(new Node[MAX_POOLED_BUFFERS]) {
+    // every node starts out free
+    for (uint32_t i = 0; i < (uint32_t)MAX_POOLED_BUFFERS; ++i) {
+        _nodes[i].next.store(i + 2 <= (uint32_t)MAX_POOLED_BUFFERS ? i + 2 : 0, std::memory_order_relaxed);
+        _nodes[i].buffer = nullptr;
+    }
+    _freeHead.store(1, std::memory_order_relaxed);
+}
+
+PacketBufferPool& PacketBufferPool::instance() {
+    // never destroyed, since packets may outlive static destruction
+    // (constructed in static storage, which honours the alignment of its members)
+    static std::aligned_storage<sizeof(PacketBufferPool), alignof(PacketBufferPool)>::type storage;
+    static PacketBufferPool* pool = new (&storage) PacketBufferPool();
+    return *pool;
+}
+
+std::unique_ptr<char[]> PacketBufferPool::acquire(bool* isRecycled) {
+    auto& pool = instance();
+
+    char* buffer = nullptr;
+    bool recycled = pool.pop(buffer);
+    if (!recycled) {
+        buffer = new char[BUFFER_SIZE];
+        pool._numAllocated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (isRecycled) {
+        *isRecycled = recycled;
+    }
+    return std::unique_ptr<char[]>(buffer);
+}
+
+void PacketBufferPool::release(std::unique_ptr<char[]> buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    auto& pool = instance();
+    if (pool.push(buffer.get())) {
+        buffer.release();
+    } else {
+        // the pool is full, so let the buffer be freed
+        pool._numFreed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PacketBufferPool::recordPacket(Owner owner, bool wasRecycled) {
+    auto& stats = instance()._ownerStats[(int)owner];
+    stats.packets.fetch_add(1, std::memory_order_relaxed);
+    if (wasRecycled) {
+        stats.recycled.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int PacketBufferPool::getNumPooledBuffers() {
+    return std::max(instance()._numPooled.load(std::memory_order_relaxed), 0);
+}
+
+QJsonObject PacketBufferPool::getStats() {
+    static const char* OWNER_NAMES[(int)Owner::NumOwners] = { "base_packet", "control_packet", "packet", "nl_packet" };
+
+    auto& pool = instance();
+    QJsonObject stats;
+    for (int i = 0; i < (int)Owner::NumOwners; ++i) {
+        QJsonObject ownerStats;
+        ownerStats["packets"] = (double)pool._ownerStats[i].packets.load(std::memory_order_relaxed);
+        ownerStats["recycled"] = (double)pool._ownerStats[i].recycled.load(std::memory_order_relaxed);
+        stats[OWNER_NAMES[i]] = ownerStats;
+    }
+    stats["pooled"] = getNumPooledBuffers();
+    stats["allocated"] = (double)pool._numAllocated.load(std::memory_order_relaxed);
+    stats["freed"] = (double)pool._numFreed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PacketBufferPool::resetStats() {
+    auto& pool = instance();
+    for (auto& ownerStats : pool._ownerStats) {
+        ownerStats.packets.store(0, std::memory_order_relaxed);
+        ownerStats.recycled.store(0, std::memory_order_relaxed);
+    }
+    pool._numAllocated.store(0, std::memory_order_relaxed);
+    pool._numFreed.store(0, std::memory_order_relaxed);
+}
+
+bool PacketBufferPool::push(char* buffer) {
+    uint32_t index;
+    if (!popNode(_freeHead, index)) {
+        // full
+        return false;
+    }
+    _nodes[index].buffer = buffer;
+    pushNode(_pooledHead, index);
+    _numPooled.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool PacketBufferPool::pop(char*& buffer) {
+    uint32_t index;
+    if (!popNode(_pooledHead, index)) {
+        // empty
+        return false;
+    }
+    _numPooled.fetch_sub(1, std::memory_order_relaxed);
+    buffer = _nodes[index].buffer;
+    pushNode(_freeHead, index);
+    return true;
+}
+
+bool PacketBufferPool::popNode(std::atomic<uint64_t>& head, uint32_t& index) {
+    uint64_t current = head.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t top = (uint32_t)current;
+        if (top == 0) {
+            return false;
+        }
+
+        // next may be stale if the node was popped (and pushed again) meanwhile, in which case the tag has moved on
+        uint32_t next = _nodes[top - 1].next.load(std::memory_order_relaxed);
+        uint64_t tag = (current >> 32) + 1;
+        if (head.compare_exchange_weak(current, (tag << 32) | next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            index = top - 1;
+            return true;
+        }
+    }
+}
+
+void PacketBufferPool::pushNode(std::atomic<uint64_t>& head, uint32_t index) {
+    uint64_t current = head.load(std::memory_order_relaxed);
+    while (true) {
+        _nodes[index].next.store((uint32_t)current, std::memory_order_relaxed);
+        uint64_t tag = (current >> 32) + 1;
+        if (head.compare_exchange_weak(current, (tag << 32) | (index + 1), std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
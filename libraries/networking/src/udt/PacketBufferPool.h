@@ -0,0 +1,92 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <atomic>
+#include <memory>
+
+#include <QtCore/QJsonObject>
+
+#include "Constants.h"
+
+namespace udt {
+
+// Lock-free pool of packet buffers
+//   Buffers are BUFFER_SIZE bytes, allocated with new[], so they can be handed around as std::unique_ptr<char[]>
+//   (and freed normally if they never come back). Any thread may acquire or release a buffer.
+//   Released buffers are kept on a bounded Treiber stack (nodes linked by index, with a tag against ABA),
+//   and freed once it is full. The most recently released buffer is reused first, while still warm in cache.
+class PacketBufferPool {
+public:
+    // large enough for any datagram read from the socket
+    static const int BUFFER_SIZE = MAX_PACKET_SIZE_WITH_UDP_HEADER;
+    static const int MAX_POOLED_BUFFERS = 4096;
+
+    // the class of packet owning a buffer, for stats
+    enum class Owner : uint8_t {
+        BasePacket = 0,
+        ControlPacket,
+        Packet,
+        NLPacket,
+        NumOwners
+    };
+
+    // returns a buffer of BUFFER_SIZE bytes (contents undefined), and whether it was recycled rather than allocated
+    static std::unique_ptr<char[]> acquire(bool* isRecycled = nullptr);
+
+    // takes back a buffer returned by acquire
+    static void release(std::unique_ptr<char[]> buffer);
+
+    // counts a packet whose buffer was drawn from the pool, once it is done with it
+    static void recordPacket(Owner owner, bool wasRecycled);
+
+    static int getNumPooledBuffers();
+    static QJsonObject getStats();
+    static void resetStats();
+
+private:
+    PacketBufferPool();
+
+    static PacketBufferPool& instance();
+
+    bool push(char* buffer);
+    bool pop(char*& buffer);
+
+    // stacks of nodes, with heads packed as (tag << 32) | (index + 1), where an index + 1 of 0 is empty
+    bool popNode(std::atomic<uint64_t>& head, uint32_t& index);
+    void pushNode(std::atomic<uint64_t>& head, uint32_t index);
+
+    struct Node {
+        std::atomic<uint32_t> next; // index + 1
+        char* buffer;
+    };
+    std::unique_ptr<Node[]> _nodes;
+
+    alignas(64) std::atomic<uint64_t> _pooledHead { 0 }; // nodes holding a buffer
+    alignas(64) std::atomic<uint64_t> _freeHead { 0 }; // nodes without one
+    alignas(64) std::atomic<int> _numPooled { 0 };
+
+    struct alignas(64) OwnerStats {
+        std::atomic<uint64_t> packets { 0 };
+        std::atomic<uint64_t> recycled { 0 };
+    };
+    OwnerStats _ownerStats[(int)Owner::NumOwners];
+
+    alignas(64) std::atomic<uint64_t> _numAllocated { 0 };
+    std::atomic<uint64_t> _numFreed { 0 };
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
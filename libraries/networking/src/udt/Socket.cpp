@@ -15,6 +15,11 @@
 #include <sys/socket.h>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <string.h>
+#endif
+
 #include <QtCore/QThread>
 
 #include <shared/QtHelpers.h>
@@ -26,11 +31,22 @@
 #include "Packet.h"
 #include "../NLPacket.h"
 #include "../NLPacketList.h"
+#include "PacketBufferPool.h"
 #include "PacketList.h"
 #include <Trace.h>
 
 using namespace udt;
 
+#ifdef Q_OS_LINUX
+// a full batch is sent right away, rather than waiting for the flush
+static const int MAX_BATCHED_DATAGRAMS = 256;
+
+// whether the current thread is in a DatagramBatchScope
+static thread_local bool t_isInDatagramBatchScope { false };
+// datagrams pulled by each recvmmsg
+static const int MAX_RECEIVED_DATAGRAMS = 32;
+#endif
+
 Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     QObject(parent),
     _synTimer(new QTimer(this)),
@@ -225,6 +241,13 @@ qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr&
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
 
+#ifdef Q_OS_LINUX
+    if (t_isInDatagramBatchScope && _isBatchingDatagrams.load(std::memory_order_acquire) &&
+        queueDatagram(datagram.constData(), datagram.size(), sockAddr)) {
+        return datagram.size();
+    }
+#endif
+
     qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
 
     if (bytesWritten < 0) {
@@ -235,6 +258,221 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     return bytesWritten;
 }
 
+bool Socket::canBatchDatagrams() const {
+#ifdef Q_OS_LINUX
+    // batches are addressed with sockaddr_in
+    return _isDatagramBatchingEnabled && _udpSocket.localAddress().protocol() == QAbstractSocket::IPv4Protocol;
+#else
+    return false;
+#endif
+}
+
+void Socket::beginDatagramBatch() {
+    if (canBatchDatagrams()) {
+        _isBatchingDatagrams.store(true, std::memory_order_release);
+    }
+}
+
+void Socket::flushDatagramBatch() {
+#ifdef Q_OS_LINUX
+    Lock sendLock(_sendMutex);
+    {
+        // writers check the flag under the same lock, so once it is cleared nothing more is queued
+        // and every datagram that was goes out now
+        Lock batchLock(_batchMutex);
+        if (!_isBatchingDatagrams.load(std::memory_order_acquire)) {
+            return;
+        }
+        _isBatchingDatagrams.store(false, std::memory_order_release);
+        _sendBuffer.swap(_batchBuffer);
+        _sendDatagrams.swap(_batchDatagrams);
+    }
+    sendQueuedDatagrams();
+#else
+    _isBatchingDatagrams.store(false, std::memory_order_release);
+#endif
+}
+
+Socket::DatagramBatchScope::DatagramBatchScope() : _wasInScope(t_isInDatagramBatchScope) {
+    t_isInDatagramBatchScope = true;
+}
+
+Socket::DatagramBatchScope::~DatagramBatchScope() {
+    t_isInDatagramBatchScope = _wasInScope;
+}
+
+#ifdef Q_OS_LINUX
+
+bool Socket::queueDatagram(const char* data, int size, const HifiSockAddr& sockAddr) {
+    const QHostAddress& address = sockAddr.getAddress();
+    if (address.protocol() != QAbstractSocket::IPv4Protocol) {
+        return false;
+    }
+
+    QueuedDatagram datagram;
+    datagram.size = size;
+    memset(&datagram.destination, 0, sizeof(datagram.destination));
+    datagram.destination.sin_family = AF_INET;
+    datagram.destination.sin_addr.s_addr = htonl(address.toIPv4Address());
+    datagram.destination.sin_port = htons(sockAddr.getPort());
+
+    bool isFull = false;
+    {
+        Lock lock(_batchMutex);
+        if (!_isBatchingDatagrams.load(std::memory_order_acquire)) {
+            // the batch was flushed in the meantime, write it on its own
+            return false;
+        }
+        datagram.offset = (int)_batchBuffer.size();
+        _batchBuffer.insert(_batchBuffer.end(), data, data + size);
+        _batchDatagrams.push_back(datagram);
+        isFull = (int)_batchDatagrams.size() >= MAX_BATCHED_DATAGRAMS;
+    }
+
+    if (isFull) {
+        // send what has been queued so far, and keep batching
+        Lock sendLock(_sendMutex);
+        {
+            Lock batchLock(_batchMutex);
+            _sendBuffer.swap(_batchBuffer);
+            _sendDatagrams.swap(_batchDatagrams);
+        }
+        sendQueuedDatagrams();
+    }
+
+    return true;
+}
+
+void Socket::sendQueuedDatagrams() {
+    // requires _sendMutex
+    int numDatagrams = (int)_sendDatagrams.size();
+    if (numDatagrams == 0) {
+        return;
+    }
+
+    // the buffer is complete, so the vectors can now point into it
+    _sendHeaders.resize(numDatagrams);
+    _sendVectors.resize(numDatagrams);
+    for (int i = 0; i < numDatagrams; ++i) {
+        auto& datagram = _sendDatagrams[i];
+        _sendVectors[i].iov_base = _sendBuffer.data() + datagram.offset;
+        _sendVectors[i].iov_len = datagram.size;
+
+        auto& header = _sendHeaders[i];
+        memset(&header, 0, sizeof(header));
+        header.msg_hdr.msg_name = &datagram.destination;
+        header.msg_hdr.msg_namelen = sizeof(datagram.destination);
+        header.msg_hdr.msg_iov = &_sendVectors[i];
+        header.msg_hdr.msg_iovlen = 1;
+    }
+
+    int socketDescriptor = (int)_udpSocket.socketDescriptor();
+    int numSent = 0;
+    while (numSent < numDatagrams) {
+        int result = sendmmsg(socketDescriptor, &_sendHeaders[numSent], numDatagrams - numSent, 0);
+        if (result < 0) {
+            int error = errno;
+            if (error == EINTR) {
+                continue;
+            }
+
+            // when saturating a link this isn't an uncommon message - suppress it so it doesn't bomb the debug
+            HIFI_FCDEBUG(networking(), "Socket::sendQueuedDatagrams" << strerror(error));
+
+            if (error == EAGAIN || error == EWOULDBLOCK) {
+                // the send buffer is full, so drop the rest, as writeDatagram would have
+                break;
+            }
+
+            // otherwise drop only the datagram that failed
+            result = 1;
+        }
+        numSent += result;
+    }
+
+    _sendBuffer.clear();
+    _sendDatagrams.clear();
+}
+
+void Socket::readBatchedDatagrams() {
+    if (_receiveBuffers.empty()) {
+        _receiveBuffers.resize(MAX_RECEIVED_DATAGRAMS);
+        _receiveBuffersRecycled.resize(MAX_RECEIVED_DATAGRAMS);
+        _receiveAddresses.resize(MAX_RECEIVED_DATAGRAMS);
+        _receiveHeaders.resize(MAX_RECEIVED_DATAGRAMS);
+        _receiveVectors.resize(MAX_RECEIVED_DATAGRAMS);
+    }
+
+    int socketDescriptor = (int)_udpSocket.socketDescriptor();
+    int numReceived = MAX_RECEIVED_DATAGRAMS;
+    while (numReceived == MAX_RECEIVED_DATAGRAMS) {
+        // replace the buffers handed off to packets by the last batch
+        for (int i = 0; i < MAX_RECEIVED_DATAGRAMS; ++i) {
+            if (!_receiveBuffers[i]) {
+                bool wasRecycled = false;
+                _receiveBuffers[i] = PacketBufferPool::acquire(&wasRecycled);
+                _receiveBuffersRecycled[i] = wasRecycled;
+            }
+            _receiveVectors[i].iov_base = _receiveBuffers[i].get();
+            _receiveVectors[i].iov_len = PacketBufferPool::BUFFER_SIZE;
+
+            auto& header = _receiveHeaders[i];
+            memset(&header, 0, sizeof(header));
+            header.msg_hdr.msg_name = &_receiveAddresses[i];
+            header.msg_hdr.msg_namelen = sizeof(_receiveAddresses[i]);
+            header.msg_hdr.msg_iov = &_receiveVectors[i];
+            header.msg_hdr.msg_iovlen = 1;
+        }
+
+        numReceived = recvmmsg(socketDescriptor, _receiveHeaders.data(), MAX_RECEIVED_DATAGRAMS, MSG_DONTWAIT, nullptr);
+        if (numReceived <= 0) {
+            break;
+        }
+
+        // we're reading packets so re-start the readyRead backup timer
+        _readyReadBackupTimer->start();
+
+        // the whole batch shares a receive time
+        auto receiveTime = p_high_resolution_clock::now();
+
+        for (int i = 0; i < numReceived; ++i) {
+            auto& header = _receiveHeaders[i];
+            int sizeRead = (int)header.msg_len;
+            HifiSockAddr senderSockAddr(reinterpret_cast<const sockaddr*>(&_receiveAddresses[i]));
+
+            _lastPacketSizeRead = sizeRead;
+            _lastPacketSockAddr = senderSockAddr;
+
+            if (sizeRead <= 0 || (header.msg_hdr.msg_flags & MSG_TRUNC)) {
+                continue;
+            }
+
+            processDatagram(std::move(_receiveBuffers[i]), sizeRead, senderSockAddr, receiveTime,
+                            true, _receiveBuffersRecycled[i]);
+        }
+    }
+
+    // QUdpSocket ignores read notifications until a datagram is read through it,
+    // so finish the drain with a regular read (which fails harmlessly if nothing is left)
+    if (!_receiveBuffers[0]) {
+        bool wasRecycled = false;
+        _receiveBuffers[0] = PacketBufferPool::acquire(&wasRecycled);
+        _receiveBuffersRecycled[0] = wasRecycled;
+    }
+    HifiSockAddr senderSockAddr;
+    auto sizeRead = _udpSocket.readDatagram(_receiveBuffers[0].get(), PacketBufferPool::BUFFER_SIZE,
+                                            senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+    if (sizeRead > 0) {
+        _readyReadBackupTimer->start();
+        _lastPacketSizeRead = sizeRead;
+        _lastPacketSockAddr = senderSockAddr;
+        processDatagram(std::move(_receiveBuffers[0]), sizeRead, senderSockAddr, p_high_resolution_clock::now(),
+                        true, _receiveBuffersRecycled[0]);
+    }
+}
+
+#endif
+
 Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr) {
     auto it = _connectionsHash.find(sockAddr);
 
@@ -322,6 +560,12 @@ void Socket::checkForReadyReadBackup() {
 }
 
 void Socket::readPendingDatagrams() {
+#ifdef Q_OS_LINUX
+    if (canBatchDatagrams()) {
+        readBatchedDatagrams();
+    }
+#endif
+
     int packetSizeWithHeader = -1;
 
     while (_udpSocket.hasPendingDatagrams() && (packetSizeWithHeader = _udpSocket.pendingDatagramSize()) != -1) {
@@ -336,7 +580,10 @@ void Socket::readPendingDatagrams() {
         HifiSockAddr senderSockAddr;
 
         // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        bool isBufferPooled = packetSizeWithHeader <= PacketBufferPool::BUFFER_SIZE;
+        bool wasBufferRecycled = false;
+        auto buffer = isBufferPooled ? PacketBufferPool::acquire(&wasBufferRecycled)
+                                     : std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
 
         // pull the datagram
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
@@ -349,72 +596,93 @@ void Socket::readPendingDatagrams() {
         if (sizeRead <= 0) {
             // we either didn't pull anything for this packet or there was an error reading (this seems to trigger
             // on windows even if there's not a packet available)
+            if (isBufferPooled) {
+                PacketBufferPool::release(std::move(buffer));
+            }
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr, receiveTime,
+                        isBufferPooled, wasBufferRecycled);
+    }
+}
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
+void Socket::processDatagram(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                             p_high_resolution_clock::time_point receiveTime, bool isBufferPooled, bool wasBufferRecycled) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            basePacket->setReceiveTime(receiveTime);
+            if (isBufferPooled) {
+                basePacket->setBufferPooled(wasBufferRecycled);
             }
+            it->second(std::move(basePacket));
+        }
 
-            continue;
+        if (isBufferPooled) {
+            PacketBufferPool::release(std::move(buffer));
         }
+        return;
+    }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        controlPacket->setReceiveTime(receiveTime);
+        if (isBufferPooled) {
+            controlPacket->setBufferPooled(wasBufferRecycled);
+        }
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr);
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr);
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
-            }
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
-
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto connection = findOrCreateConnection(senderSockAddr);
-
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        packet->setReceiveTime(receiveTime);
+        if (isBufferPooled) {
+            packet->setBufferPooled(wasBufferRecycled);
+        }
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto connection = findOrCreateConnection(senderSockAddr);
+
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize())) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
 #ifdef UDT_CONNECTION_DEBUG
-                        qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
-                            << ", type" << NLPacket::typeInHeader(*packet);
+                    qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
+                        << ", type" << NLPacket::typeInHeader(*packet);
 #endif
-                        continue;
-                    }
+                    return;
                 }
+            }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnection(senderSockAddr);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
                 }
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
             }
         }
     }
@@ -513,6 +781,10 @@ std::vector<HifiSockAddr> Socket::getConnectionSockAddrs() {
 }
 
 void Socket::handleSocketError(QAbstractSocket::SocketError socketError) {
+    if (socketError == QAbstractSocket::TemporaryError && canBatchDatagrams()) {
+        // expected when readBatchedDatagrams finds nothing left to read
+        return;
+    }
     HIFI_FCDEBUG(networking(), "udt::Socket error - " << socketError);
 }
 
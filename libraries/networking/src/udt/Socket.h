@@ -14,14 +14,22 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtNetwork/QUdpSocket>
 
+// after the Qt headers, which define Q_OS_LINUX
+#ifdef Q_OS_LINUX
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
@@ -66,6 +74,26 @@ public:
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
     
+    // Batched datagrams (Linux only, elsewhere datagrams are always written and read one at a time)
+    //   When enabled, pending datagrams are drained with recvmmsg into a pool of receive buffers,
+    //   and datagrams written between beginDatagramBatch() and flushDatagramBatch() are queued,
+    //   then sent with sendmmsg. Only datagrams written by a thread inside a DatagramBatchScope are queued,
+    //   everything else (reliable traffic, acks, pings) is written right away.
+    void setDatagramBatchingEnabled(bool enabled) { _isDatagramBatchingEnabled = enabled; }
+    bool isDatagramBatchingEnabled() const { return _isDatagramBatchingEnabled; }
+    void beginDatagramBatch();
+    void flushDatagramBatch();
+
+    // Lets the datagrams the current thread writes while it lives join the current batch, if any
+    class DatagramBatchScope {
+    public:
+        DatagramBatchScope();
+        ~DatagramBatchScope();
+
+    private:
+        bool _wasInScope;
+    };
+
     void bind(const QHostAddress& address, quint16 port = 0);
     void rebind(quint16 port);
     void rebind();
@@ -110,6 +138,15 @@ private slots:
 private:
     void setSystemBufferSizes();
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
+    void processDatagram(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime, bool isBufferPooled, bool wasBufferRecycled);
+    bool canBatchDatagrams() const;
+
+#ifdef Q_OS_LINUX
+    bool queueDatagram(const char* data, int size, const HifiSockAddr& sockAddr);
+    void sendQueuedDatagrams();
+    void readBatchedDatagrams();
+#endif
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
@@ -148,6 +185,36 @@ private:
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
+
+    std::atomic<bool> _isDatagramBatchingEnabled { false };
+    std::atomic<bool> _isBatchingDatagrams { false };
+
+#ifdef Q_OS_LINUX
+    struct QueuedDatagram {
+        int offset; // into the batch buffer
+        int size;
+        sockaddr_in destination;
+    };
+
+    // the batch being written, guarded by _batchMutex, as is clearing _isBatchingDatagrams
+    Mutex _batchMutex;
+    std::vector<char> _batchBuffer;
+    std::vector<QueuedDatagram> _batchDatagrams;
+
+    // the batch being sent, guarded by _sendMutex (so writers are not held up by sendmmsg)
+    Mutex _sendMutex;
+    std::vector<char> _sendBuffer;
+    std::vector<QueuedDatagram> _sendDatagrams;
+    std::vector<mmsghdr> _sendHeaders;
+    std::vector<iovec> _sendVectors;
+
+    // the receive pool, only touched on the socket thread
+    std::vector<std::unique_ptr<char[]>> _receiveBuffers; // from PacketBufferPool
+    std::vector<uint8_t> _receiveBuffersRecycled;
+    std::vector<sockaddr_in> _receiveAddresses;
+    std::vector<mmsghdr> _receiveHeaders;
+    std::vector<iovec> _receiveVectors;
+#endif
     
     friend UDTTest;
 };
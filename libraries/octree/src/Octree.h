@@ -16,6 +16,7 @@
 #include <set>
 #include <stdint.h>
 
+#include <QDataStream>
 #include <QHash>
 #include <QObject>
 #include <QtCore/QJsonObject>
@@ -37,6 +38,13 @@ class OctreePacketData;
 class Shape;
 using OctreePointer = std::shared_ptr<Octree>;
 
+/// an edit decoded from an edit packet, see Octree::decodeEditPacketData()
+class OctreeEdit {
+public:
+    virtual ~OctreeEdit() {}
+};
+using OctreeEditPointer = std::unique_ptr<OctreeEdit>;
+
 extern QVector<QString> PERSIST_EXTENSIONS;
 
 /// derive from this class to use the Octree::recurseTreeWithOperator() method
@@ -135,6 +143,16 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    // Edits may also be decoded without holding the tree lock, and then applied with the write lock, so that the lock
+    // is only held while the tree changes. decodeEditPacketData returns nullptr for edits that can only be processed
+    // with processEditPacketData.
+    virtual OctreeEditPointer decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                                   const SharedNodePointer& sourceNode, int& processedBytes) {
+        processedBytes = 0;
+        return nullptr;
+    }
+    virtual void applyEdit(OctreeEdit& edit, const SharedNodePointer& sourceNode) { }
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
@@ -221,6 +239,16 @@ public:
     bool readJSONFromGzippedFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Binary persistence
+    //   a tree that supports it is persisted as a snapshot of all of its records, plus a journal of the records
+    //   changed since the snapshot (see OctreePersistThread); the caller writes the framing around both
+    virtual bool supportsBinaryPersistence() const { return false; }
+    virtual bool writeBinarySnapshot(QDataStream& stream) { return false; }
+    // writes the records changed since the last snapshot or changes were written, returns the number of changes or -1
+    virtual int writeBinaryChanges(QDataStream& stream) { return -1; }
+    // reads a snapshot, and applies the blocks of changes written since
+    virtual bool readBinarySnapshot(QDataStream& snapshot, const QVector<QByteArray>& changes) { return false; }
+
     uint64_t getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -264,6 +292,8 @@ public:
     virtual quint64 getAverageFilterTime() const { return 0; }
 
     void incrementPersistDataVersion() { _persistDataVersion++; }
+    QUuid getPersistID() const { return _persistID; }
+    int getPersistDataVersion() const { return _persistDataVersion; }
 
 
 protected:
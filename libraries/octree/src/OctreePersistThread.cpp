@@ -27,6 +27,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QRegExp>
+#include <QSaveFile>
 
 #include <NumericalConstants.h>
 #include <PerfStat.h>
@@ -42,6 +43,22 @@ constexpr std::chrono::milliseconds TIME_BETWEEN_PROCESSING { 10 };
 constexpr int MAX_OCTREE_REPLACEMENT_BACKUP_FILES_COUNT { 20 };
 constexpr int64_t MAX_OCTREE_REPLACEMENT_BACKUP_FILES_SIZE_BYTES { 50 * 1000 * 1000 };
 
+// binary persistence
+//   the snapshot is a header (magic, format version, packet version, id, data version) followed by the tree's records,
+//   the journal is a header (magic, format version, id, data version of the snapshot) followed by blocks of changes,
+//   each block being (data version, changes, checksum of changes) so that an incomplete last block can be ignored
+const QString BINARY_SNAPSHOT_EXTENSION { "bin" };
+const QString BINARY_JOURNAL_EXTENSION { "journal" };
+constexpr quint32 BINARY_SNAPSHOT_MAGIC { 0x48464f53 }; // "HFOS"
+constexpr quint32 BINARY_JOURNAL_MAGIC { 0x48464f4a }; // "HFOJ"
+constexpr quint32 BINARY_FORMAT_VERSION { 1 };
+constexpr QDataStream::Version BINARY_STREAM_VERSION { QDataStream::Qt_5_6 };
+
+// a new snapshot is written (and the JSON exported) once the journal is this large relative to the snapshot...
+constexpr qint64 MAX_BINARY_JOURNAL_TO_SNAPSHOT_RATIO { 2 };
+// ...or once the snapshot is this old
+constexpr std::chrono::minutes MAX_BINARY_SNAPSHOT_AGE { 10 };
+
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, std::chrono::milliseconds persistInterval,
                                          bool debugTimestampNow, QString persistAsFileType) :
     _tree(tree),
@@ -57,6 +74,10 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+
+    _isBinaryPersistEnabled = _tree->supportsBinaryPersistence();
+    _snapshotFilename = sansExt + "." + BINARY_SNAPSHOT_EXTENSION;
+    _journalFilename = sansExt + "." + BINARY_JOURNAL_EXTENSION;
 }
 
 void OctreePersistThread::start() {
@@ -72,7 +93,14 @@ void OctreePersistThread::start() {
 
     OctreeUtils::RawOctreeData data;
     qCDebug(octree) << "Reading octree data from" << _filename;
-    if (data.readOctreeDataInfoFromFile(_filename)) {
+    bool hasOctreeData = data.readOctreeDataInfoFromFile(_filename);
+    _isBinarySnapshotNewer = hasNewerBinarySnapshot(hasOctreeData, data.id, data.version);
+    if (_isBinarySnapshotNewer) {
+        qCDebug(octree) << "Reading newer octree data from" << _snapshotFilename;
+        hasOctreeData = readBinaryPersistInfo(data.id, data.version);
+    }
+
+    if (hasOctreeData) {
         qCDebug(octree) << "Current octree data: ID(" << data.id << ") DataVersion(" << data.version << ")";
         packet->writePrimitive(true);
         auto id = data.id.toRfc4122();
@@ -134,14 +162,25 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
         _tree->setOctreeVersionInfo(data.id, data.version);
     }
 
-    bool persistentFileRead;
+    bool persistentFileRead = false;
 
-    _tree->withWriteLock([&] {
-        PerformanceWarning warn(true, "Loading Octree File", true);
+    // the DS has no newer data than what was reported, which is the binary snapshot if it was newer
+    if (replacementData.isNull() && _isBinarySnapshotNewer) {
+        persistentFileRead = loadBinarySnapshot();
+        if (!persistentFileRead) {
+            qCWarning(octree) << "Failed to load" << _snapshotFilename << "- loading" << _filename << "instead";
+            _tree->eraseAllOctreeElements();
+        }
+    }
 
-        persistentFileRead = _tree->readFromFile(_filename.toLocal8Bit().constData());
-        _tree->pruneTree();
-    });
+    if (!persistentFileRead) {
+        _tree->withWriteLock([&] {
+            PerformanceWarning warn(true, "Loading Octree File", true);
+
+            persistentFileRead = _tree->readFromFile(_filename.toLocal8Bit().constData());
+            _tree->pruneTree();
+        });
+    }
 
     quint64 loadDone = usecTimestampNow();
     _loadTimeUSecs = loadDone - loadStarted;
@@ -194,6 +233,9 @@ QString OctreePersistThread::getPersistFileMimeType() const {
 void OctreePersistThread::replaceData(QByteArray data) {
     backupCurrentFile();
 
+    // the binary snapshot and journal are of the data being replaced
+    removeBinarySnapshot();
+
     QFile currentFile { _filename };
     if (currentFile.open(QIODevice::WriteOnly)) {
         currentFile.write(data);
@@ -238,6 +280,11 @@ void OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
+    if (_hasUnexportedChanges) {
+        // write a snapshot, so that the journaled changes are also exported to the JSON file
+        _needsBinarySnapshot = true;
+        _tree->setDirtyBit();
+    }
     persist();
     qCDebug(octree) << "Persist thread done with about to finish...";
 }
@@ -292,6 +339,27 @@ void OctreePersistThread::persist() {
 
         _tree->incrementPersistDataVersion();
 
+        if (_isBinaryPersistEnabled && !shouldWriteBinarySnapshot()) {
+            // only the changes since the last persist are written, the JSON file is written along with the next snapshot
+            if (appendBinaryJournal()) {
+                // the domain-server's copy is what the entity server starts from if it is relocated, so it is still
+                // sent every persist
+                sendLatestEntityDataToDS();
+                return;
+            }
+            qCWarning(octree) << "Failed to append changes to" << _journalFilename << "- writing a new snapshot";
+            _needsBinarySnapshot = true;
+        }
+
+        if (_isBinaryPersistEnabled) {
+            qCDebug(octree) << "Saving Octree binary snapshot to:" << _snapshotFilename;
+            if (writeBinarySnapshot()) {
+                qCDebug(octree) << "DONE saving Octree binary snapshot to" << _snapshotFilename;
+            } else {
+                qCWarning(octree) << "Failed to save Octree binary snapshot to" << _snapshotFilename;
+            }
+        }
+
         qCDebug(octree) << "Saving Octree data to:" << _filename;
         if (_tree->writeToFile(_filename.toLocal8Bit().constData(), nullptr, _persistAsFileType)) {
             _tree->clearDirtyBit(); // tree is clean after saving
@@ -318,3 +386,235 @@ void OctreePersistThread::sendLatestEntityDataToDS() {
         qCWarning(octree) << "Failed to persist octree to DS";
     }
 }
+
+static bool readBinarySnapshotHeader(QDataStream& stream, PacketVersion expectedVersion,
+                                     QUuid& id, OctreeUtils::Version& dataVersion) {
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    quint8 packetVersion = 0;
+    qint64 version = 0;
+    stream >> magic >> formatVersion >> packetVersion >> id >> version;
+    if (stream.status() != QDataStream::Ok || magic != BINARY_SNAPSHOT_MAGIC || formatVersion != BINARY_FORMAT_VERSION) {
+        return false;
+    }
+    if (packetVersion != expectedVersion) {
+        // records are only readable by the version that wrote them, the JSON is used to upgrade
+        qCDebug(octree) << "Ignoring binary snapshot of packet version" << (int)packetVersion
+            << "expected" << (int)expectedVersion;
+        return false;
+    }
+    dataVersion = version;
+    return true;
+}
+
+bool OctreePersistThread::readBinaryPersistInfo(QUuid& id, OctreeUtils::Version& dataVersion,
+                                                QVector<QByteArray>* changes, qint64* journalSize) const {
+    if (journalSize) {
+        *journalSize = 0;
+    }
+
+    QFile snapshotFile(_snapshotFilename);
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream snapshot(&snapshotFile);
+    snapshot.setVersion(BINARY_STREAM_VERSION);
+    if (!readBinarySnapshotHeader(snapshot, _tree->expectedVersion(), id, dataVersion)) {
+        return false;
+    }
+
+    QFile journalFile(_journalFilename);
+    if (!journalFile.open(QIODevice::ReadOnly)) {
+        return true;
+    }
+    QDataStream journal(&journalFile);
+    journal.setVersion(BINARY_STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    QUuid snapshotID;
+    qint64 snapshotVersion = 0;
+    journal >> magic >> formatVersion >> snapshotID >> snapshotVersion;
+    if (journal.status() != QDataStream::Ok || magic != BINARY_JOURNAL_MAGIC || formatVersion != BINARY_FORMAT_VERSION ||
+        snapshotID != id || snapshotVersion != dataVersion) {
+        // a journal of a previous snapshot, which wasn't reset after the snapshot was written
+        return true;
+    }
+
+    qint64 validSize = journalFile.pos();
+    while (!journal.atEnd()) {
+        qint64 blockVersion = 0;
+        QByteArray block;
+        quint16 checksum = 0;
+        journal >> blockVersion >> block >> checksum;
+        if (journal.status() != QDataStream::Ok || checksum != qChecksum(block.constData(), block.size())) {
+            qCWarning(octree) << "Ignoring incomplete changes at the end of" << _journalFilename;
+            break;
+        }
+
+        dataVersion = blockVersion;
+        if (changes) {
+            changes->push_back(block);
+        }
+        validSize = journalFile.pos();
+    }
+
+    if (journalSize) {
+        *journalSize = validSize;
+    }
+    return true;
+}
+
+bool OctreePersistThread::hasNewerBinarySnapshot(bool hasOctreeData, const QUuid& id, OctreeUtils::Version dataVersion) const {
+    if (!_isBinaryPersistEnabled) {
+        return false;
+    }
+
+    QUuid binaryID;
+    OctreeUtils::Version binaryVersion;
+    if (!readBinaryPersistInfo(binaryID, binaryVersion)) {
+        return false;
+    }
+
+    // the JSON is exported along with each snapshot, so the snapshot and its journal are at least as recent
+    return !hasOctreeData || (binaryID == id && binaryVersion >= dataVersion);
+}
+
+bool OctreePersistThread::loadBinarySnapshot() {
+    QUuid id;
+    OctreeUtils::Version dataVersion;
+    QVector<QByteArray> changes;
+    qint64 journalSize = 0;
+    if (!readBinaryPersistInfo(id, dataVersion, &changes, &journalSize)) {
+        return false;
+    }
+
+    QFile snapshotFile(_snapshotFilename);
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream snapshot(&snapshotFile);
+    snapshot.setVersion(BINARY_STREAM_VERSION);
+    QUuid snapshotID;
+    OctreeUtils::Version snapshotVersion;
+    if (!readBinarySnapshotHeader(snapshot, _tree->expectedVersion(), snapshotID, snapshotVersion)) {
+        return false;
+    }
+
+    qCDebug(octree) << "loading Octree binary snapshot from" << _snapshotFilename << "with" << changes.size()
+        << "blocks of changes...";
+
+    bool success = false;
+    _tree->withWriteLock([&] {
+        PerformanceWarning warn(true, "Loading Octree Binary Snapshot", true);
+
+        success = _tree->readBinarySnapshot(snapshot, changes);
+        _tree->pruneTree();
+    });
+    if (!success) {
+        return false;
+    }
+
+    _tree->setOctreeVersionInfo(id, dataVersion);
+
+    if (journalSize > 0) {
+        // drop any incomplete changes, so that the next changes are appended after the last complete ones
+        QFile journalFile(_journalFilename);
+        if (journalFile.size() > journalSize && !journalFile.resize(journalSize)) {
+            qCWarning(octree) << "Failed to truncate" << _journalFilename;
+            journalSize = 0;
+        }
+    }
+
+    _snapshotSize = snapshotFile.size();
+    _journalSize = journalSize;
+    _lastBinarySnapshot = std::chrono::steady_clock::now();
+    // without a usable journal, the next persist needs a new snapshot
+    _needsBinarySnapshot = (journalSize == 0);
+    _hasUnexportedChanges = !changes.isEmpty();
+    return true;
+}
+
+bool OctreePersistThread::writeBinarySnapshot() {
+    QUuid id = _tree->getPersistID();
+    qint64 dataVersion = _tree->getPersistDataVersion();
+
+    QSaveFile snapshotFile(_snapshotFilename);
+    if (!snapshotFile.open(QIODevice::WriteOnly)) {
+        qCWarning(octree) << "Failed to open" << _snapshotFilename << "for writing";
+        return false;
+    }
+    QDataStream snapshot(&snapshotFile);
+    snapshot.setVersion(BINARY_STREAM_VERSION);
+    snapshot << BINARY_SNAPSHOT_MAGIC << BINARY_FORMAT_VERSION << (quint8)_tree->expectedVersion() << id << dataVersion;
+    if (!_tree->writeBinarySnapshot(snapshot) || !snapshotFile.commit()) {
+        _needsBinarySnapshot = true;
+        return false;
+    }
+
+    // start a new journal of the changes to this snapshot
+    QSaveFile journalFile(_journalFilename);
+    bool journalStarted = false;
+    if (journalFile.open(QIODevice::WriteOnly)) {
+        QDataStream journal(&journalFile);
+        journal.setVersion(BINARY_STREAM_VERSION);
+        journal << BINARY_JOURNAL_MAGIC << BINARY_FORMAT_VERSION << id << dataVersion;
+        journalStarted = (journal.status() == QDataStream::Ok) && journalFile.commit();
+    }
+    if (!journalStarted) {
+        // the snapshot is complete without it, but changes can't be appended until a new journal is started
+        qCWarning(octree) << "Failed to start a new" << _journalFilename;
+        _needsBinarySnapshot = true;
+        return true;
+    }
+
+    _snapshotSize = QFileInfo(_snapshotFilename).size();
+    _journalSize = QFileInfo(_journalFilename).size();
+    _lastBinarySnapshot = std::chrono::steady_clock::now();
+    _needsBinarySnapshot = false;
+    _hasUnexportedChanges = false;
+    return true;
+}
+
+bool OctreePersistThread::appendBinaryJournal() {
+    // edits made while the changes are written will mark the tree dirty again
+    _tree->clearDirtyBit();
+
+    QByteArray changes;
+    QDataStream changesStream(&changes, QIODevice::WriteOnly);
+    changesStream.setVersion(BINARY_STREAM_VERSION);
+    int numChanges = _tree->writeBinaryChanges(changesStream);
+    if (numChanges < 0) {
+        _tree->setDirtyBit();
+        return false;
+    }
+
+    QByteArray block;
+    QDataStream blockStream(&block, QIODevice::WriteOnly);
+    blockStream.setVersion(BINARY_STREAM_VERSION);
+    blockStream << (qint64)_tree->getPersistDataVersion() << changes << qChecksum(changes.constData(), changes.size());
+
+    QFile journalFile(_journalFilename);
+    if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append) ||
+        journalFile.write(block) != block.size() || !journalFile.flush()) {
+        // the changes were taken from the tree, so only a new snapshot can persist them now
+        _tree->setDirtyBit();
+        return false;
+    }
+
+    _journalSize += block.size();
+    _hasUnexportedChanges = true;
+    qCDebug(octree) << "Appended" << numChanges << "changes to" << _journalFilename;
+    return true;
+}
+
+bool OctreePersistThread::shouldWriteBinarySnapshot() const {
+    return _needsBinarySnapshot || _journalSize * MAX_BINARY_JOURNAL_TO_SNAPSHOT_RATIO > _snapshotSize ||
+        std::chrono::steady_clock::now() - _lastBinarySnapshot > MAX_BINARY_SNAPSHOT_AGE;
+}
+
+void OctreePersistThread::removeBinarySnapshot() {
+    QFile::remove(_snapshotFilename);
+    QFile::remove(_journalFilename);
+    _needsBinarySnapshot = true;
+}
@@ -17,6 +17,7 @@
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeDataUtils.h"
 
 class OctreePersistThread : public QObject {
     Q_OBJECT
@@ -65,6 +66,19 @@ protected:
     void replaceData(QByteArray data);
     void sendLatestEntityDataToDS();
 
+    // binary persistence, for trees that support it
+    //   the tree is persisted as a binary snapshot, plus a journal of the changes since the snapshot; the snapshot
+    //   is rewritten (and the JSON file exported) once the journal has grown large or the snapshot is old, while the
+    //   domain-server's copy is still sent every persist
+    bool readBinaryPersistInfo(QUuid& id, OctreeUtils::Version& dataVersion, QVector<QByteArray>* changes = nullptr,
+                               qint64* journalSize = nullptr) const;
+    bool hasNewerBinarySnapshot(bool hasOctreeData, const QUuid& id, OctreeUtils::Version dataVersion) const;
+    bool loadBinarySnapshot();
+    bool writeBinarySnapshot();
+    bool appendBinaryJournal();
+    bool shouldWriteBinarySnapshot() const;
+    void removeBinarySnapshot();
+
 private:
     OctreePointer _tree;
     QString _filename;
@@ -78,6 +92,16 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    bool _isBinaryPersistEnabled { false };
+    QString _snapshotFilename;
+    QString _journalFilename;
+    qint64 _snapshotSize { 0 };
+    qint64 _journalSize { 0 };
+    bool _isBinarySnapshotNewer { false }; // than the JSON, when starting
+    bool _needsBinarySnapshot { true };
+    bool _hasUnexportedChanges { false }; // journaled since the last JSON file export
+    std::chrono::steady_clock::time_point _lastBinarySnapshot;
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -70,6 +70,7 @@ void PhysicalEntitySimulation::removeEntityInternal(EntityItemPointer entity) {
     if (entity->isSimulated()) {
         EntitySimulation::removeEntityInternal(entity);
         _entitiesToAddToPhysics.remove(entity);
+        cancelShapeRequest(entity);
 
         EntityMotionState* motionState = static_cast<EntityMotionState*>(entity->getPhysicsInfo());
         if (motionState) {
@@ -166,6 +167,7 @@ void PhysicalEntitySimulation::changeEntityInternal(EntityItemPointer entity) {
         // The intent is for this object to be in the PhysicsEngine, but it has no MotionState yet.
         // Perhaps it's shape has changed and it can now be added?
         _entitiesToAddToPhysics.insert(entity);
+        cancelShapeRequest(entity); // its shape may have changed since it was requested
         SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
         if (itr != _simpleKinematicEntities.end()) {
             _simpleKinematicEntities.erase(itr);
@@ -207,6 +209,10 @@ void PhysicalEntitySimulation::clearEntitiesInternal() {
     // clear all other lists specific to this derived class
     _entitiesToRemoveFromPhysics.clear();
     _entitiesToAddToPhysics.clear();
+    for (auto& request : _shapeRequests) {
+        ObjectMotionState::getShapeManager()->cancelShapeRequest(request.shapeInfo);
+    }
+    _shapeRequests.clear();
     _incomingChanges.clear();
 }
 
@@ -255,6 +261,14 @@ void PhysicalEntitySimulation::deleteObjectsRemovedFromPhysics() {
     _objectsToDelete.clear();
 }
 
+void PhysicalEntitySimulation::cancelShapeRequest(const EntityItemPointer& entity) {
+    auto requestItr = _shapeRequests.find(entity);
+    if (requestItr != _shapeRequests.end()) {
+        ObjectMotionState::getShapeManager()->cancelShapeRequest(requestItr->shapeInfo);
+        _shapeRequests.erase(requestItr);
+    }
+}
+
 void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& result) {
     result.clear();
     QMutexLocker lock(&_mutex);
@@ -263,10 +277,12 @@ void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& re
         EntityItemPointer entity = (*entityItr);
         assert(!entity->getPhysicsInfo());
         if (entity->isDead()) {
+            cancelShapeRequest(entity);
             prepareEntityForDelete(entity);
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
         } else if (!entity->shouldBePhysical()) {
             // this entity should no longer be on the internal _entitiesToAddToPhysics
+            cancelShapeRequest(entity);
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
             if (entity->isMovingRelativeToParent()) {
                 SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
@@ -275,28 +291,41 @@ void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& re
                 }
             }
         } else if (entity->isReadyToComputeShape()) {
-            ShapeInfo shapeInfo;
-            entity->computeShapeInfo(shapeInfo);
-            int numPoints = shapeInfo.getLargestSubshapePointCount();
-            if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
-                if (numPoints > MAX_HULL_POINTS) {
-                    qWarning() << "convex hull with" << numPoints
-                        << "points for entity" << entity->getName()
-                        << "at" << entity->getWorldPosition() << " will be reduced";
+            // the shape is built on the worker pool, and the entity is added once it is ready
+            auto requestItr = _shapeRequests.find(entity);
+            if (requestItr == _shapeRequests.end()) {
+                ShapeRequest request;
+                entity->computeShapeInfo(request.shapeInfo);
+                int numPoints = request.shapeInfo.getLargestSubshapePointCount();
+                if (request.shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
+                    if (numPoints > MAX_HULL_POINTS) {
+                        qWarning() << "convex hull with" << numPoints
+                            << "points for entity" << entity->getName()
+                            << "at" << entity->getWorldPosition() << " will be reduced";
+                    }
                 }
+                request.shape = ObjectMotionState::getShapeManager()->requestShape(request.shapeInfo);
+                requestItr = _shapeRequests.insert(entity, request);
             }
-            btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
-            if (shape) {
-                EntityMotionState* motionState = new EntityMotionState(shape, entity);
-                entity->setPhysicsInfo(static_cast<void*>(motionState));
-                _physicalObjects.insert(motionState);
-                result.push_back(motionState);
-                entityItr = _entitiesToAddToPhysics.erase(entityItr);
-
-                // make sure the motionState's region is up-to-date before it is actually added to physics
-                motionState->setRegion(_space->getRegion(entity->getSpaceIndex()));
+
+            if (requestItr->shape.isFinished()) {
+                const ShapeInfo shapeInfo = requestItr->shapeInfo;
+                _shapeRequests.erase(requestItr);
+                btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
+                if (shape) {
+                    EntityMotionState* motionState = new EntityMotionState(shape, entity);
+                    entity->setPhysicsInfo(static_cast<void*>(motionState));
+                    _physicalObjects.insert(motionState);
+                    result.push_back(motionState);
+                    entityItr = _entitiesToAddToPhysics.erase(entityItr);
+
+                    // make sure the motionState's region is up-to-date before it is actually added to physics
+                    motionState->setRegion(_space->getRegion(entity->getSpaceIndex()));
+                } else {
+                    //qWarning() << "Failed to generate new shape for entity." << entity->getName();
+                    ++entityItr;
+                }
             } else {
-                //qWarning() << "Failed to generate new shape for entity." << entity->getName();
                 ++entityItr;
             }
         } else {
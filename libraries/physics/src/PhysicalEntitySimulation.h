@@ -23,6 +23,7 @@
 
 #include "PhysicsEngine.h"
 #include "EntityMotionState.h"
+#include "ShapeManager.h"
 
 class PhysicalEntitySimulation;
 using PhysicalEntitySimulationPointer = std::shared_ptr<PhysicalEntitySimulation>;
@@ -97,8 +98,18 @@ public:
     void sendOwnedUpdates(uint32_t numSubsteps);
 
 private:
+    // tells the ShapeManager the entity won't claim the shape it requested
+    void cancelShapeRequest(const EntityItemPointer& entity);
+
+    class ShapeRequest {
+    public:
+        ShapeInfo shapeInfo;
+        ShapeManager::ShapeFuture shape;
+    };
+
     SetOfEntities _entitiesToAddToPhysics;
     SetOfEntities _entitiesToRemoveFromPhysics;
+    QHash<EntityItemPointer, ShapeRequest> _shapeRequests; // shapes being built for _entitiesToAddToPhysics
 
     VectorOfMotionStates _objectsToDelete;
 
@@ -451,6 +451,14 @@ void PhysicsEngine::harvestPerformanceStats() {
             itr->Next();
         }
     }
+
+    // the solver threads are invisible to Bullet's profiler, so report them separately
+    if (_dynamicsWorld->getNumSolverThreads() > 1) {
+        std::vector<quint64> solverTimes = _dynamicsWorld->getSolverThreadTimes();
+        for (size_t i = 0; i < solverTimes.size(); ++i) {
+            PerformanceTimer::addTimerRecord(QString("physics/.../solverThread%1").arg(i), solverTimes[i]);
+        }
+    }
 }
 
 void PhysicsEngine::printPerformanceStatsToFile(const QString& filename) {
@@ -863,3 +871,12 @@ void PhysicsEngine::setShowBulletConstraintLimits(bool value) {
     }
 }
 
+
+void PhysicsEngine::setNumSolverThreads(int numThreads) {
+    _dynamicsWorld->setNumSolverThreads(numThreads);
+    qCDebug(physics) << "solving simulation islands on" << _dynamicsWorld->getNumSolverThreads() << "threads";
+}
+
+int PhysicsEngine::getNumSolverThreads() const {
+    return _dynamicsWorld->getNumSolverThreads();
+}
@@ -103,6 +103,10 @@ public:
     void setShowBulletConstraints(bool value);
     void setShowBulletConstraintLimits(bool value);
 
+    // solve the simulation islands on this many threads (opt-in, one by default)
+    void setNumSolverThreads(int numThreads);
+    int getNumSolverThreads() const;
+
 private:
     QList<EntityDynamicPointer> removeDynamicsForBody(btRigidBody* body);
     void addObjectToDynamicsWorld(ObjectMotionState* motionState);
@@ -0,0 +1,141 @@
+//
+//  ShapeCache.cpp
+//  libraries/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ShapeCache.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+
+#include <SettingHandle.h>
+
+#include "PhysicsLogging.h"
+#include "ShapeFactory.h"
+
+using File = cache::File;
+using FilePointer = cache::FilePointer;
+
+// Whenever a change is made to the serialized format for the shape cache that isn't backward compatible,
+// this value should be incremented.  This will force the shape cache to be wiped
+const int ShapeCache::CURRENT_VERSION = 0x02;
+const int ShapeCache::INVALID_VERSION = 0x00;
+const char* ShapeCache::SETTING_VERSION_NAME = "hifi.shape.cache_version";
+
+const std::string ShapeCache::DIRNAME { "shape_cache" };
+const std::string ShapeCache::EXT { "shape" };
+
+// written ahead of each shape, and checked against the info when reading
+struct ShapeCacheHeader {
+    uint32_t type { 0 };
+    uint32_t numSubShapes { 0 };
+    uint32_t numPoints { 0 };
+    uint32_t numTriangleIndices { 0 };
+
+    ShapeCacheHeader() {}
+    ShapeCacheHeader(const ShapeInfo& info) :
+        type((uint32_t)info.getType()),
+        numSubShapes(info.getNumSubShapes()),
+        numTriangleIndices((uint32_t)info.getTriangleIndices().size()) {
+        for (const auto& points : info.getPointCollection()) {
+            numPoints += (uint32_t)points.size();
+        }
+    }
+
+    bool operator==(const ShapeCacheHeader& other) const {
+        return type == other.type && numSubShapes == other.numSubShapes && numPoints == other.numPoints &&
+            numTriangleIndices == other.numTriangleIndices;
+    }
+};
+
+static bool isCachedType(ShapeType type) {
+    switch (type) {
+        case SHAPE_TYPE_COMPOUND:
+        case SHAPE_TYPE_SIMPLE_HULL:
+        case SHAPE_TYPE_SIMPLE_COMPOUND:
+        case SHAPE_TYPE_STATIC_MESH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The ShapeInfo hash only covers the type, extents, and a checksum of the url, which stays the same when the model
+// at that url is edited, so cached shapes are keyed by a digest of everything they are built from
+static std::string getKey(const ShapeInfo& info) {
+    QCryptographicHash hasher(QCryptographicHash::Sha1);
+    uint32_t type = (uint32_t)info.getType();
+    hasher.addData(reinterpret_cast<const char*>(&type), sizeof(type));
+    hasher.addData(reinterpret_cast<const char*>(&info.getHalfExtents()), sizeof(glm::vec3));
+    hasher.addData(reinterpret_cast<const char*>(&info.getOffset()), sizeof(glm::vec3));
+    for (const auto& points : info.getPointCollection()) {
+        uint32_t numPoints = (uint32_t)points.size();
+        hasher.addData(reinterpret_cast<const char*>(&numPoints), sizeof(numPoints));
+        hasher.addData(reinterpret_cast<const char*>(points.constData()), numPoints * sizeof(glm::vec3));
+    }
+    const auto& triangleIndices = info.getTriangleIndices();
+    hasher.addData(reinterpret_cast<const char*>(triangleIndices.constData()), triangleIndices.size() * sizeof(int32_t));
+    return hasher.result().toHex().toStdString();
+}
+
+ShapeCache::ShapeCache(const std::string& dir, const std::string& ext) :
+    FileCache(dir, ext) { }
+
+void ShapeCache::initialize() {
+    FileCache::initialize();
+    Setting::Handle<int> cacheVersionHandle(SETTING_VERSION_NAME, INVALID_VERSION);
+    auto cacheVersion = cacheVersionHandle.get();
+    if (cacheVersion != CURRENT_VERSION) {
+        wipe();
+        cacheVersionHandle.set(CURRENT_VERSION);
+    }
+}
+
+const btCollisionShape* ShapeCache::readShape(const ShapeInfo& info) {
+    if (!isCachedType(info.getType())) {
+        return nullptr;
+    }
+
+    FilePointer file = getFile(getKey(info));
+    if (!file) {
+        return nullptr;
+    }
+
+    QFile source(QString::fromStdString(file->getFilepath()));
+    if (!source.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    ShapeCacheHeader header;
+    if (source.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) || !(header == ShapeCacheHeader(info))) {
+        return nullptr;
+    }
+    const btCollisionShape* shape = ShapeFactory::deserializeShape(info, source.readAll());
+    if (!shape) {
+        qCWarning(physics) << "ShapeCache::readShape() failed to read" << file->getFilepath().c_str();
+    }
+    return shape;
+}
+
+void ShapeCache::writeShape(const ShapeInfo& info, const btCollisionShape* shape) {
+    if (!isCachedType(info.getType())) {
+        return;
+    }
+
+    QByteArray data;
+    ShapeCacheHeader header(info);
+    data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    QByteArray shapeData;
+    if (!ShapeFactory::serializeShape(shape, shapeData)) {
+        return;
+    }
+    data.append(shapeData);
+
+    // another worker may have written the same shape already, in which case this is a no-op
+    writeFile(data.constData(), Metadata(getKey(info), (size_t)data.size()));
+}
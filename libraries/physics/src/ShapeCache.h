@@ -0,0 +1,45 @@
+//
+//  ShapeCache.h
+//  libraries/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ShapeCache_h
+#define hifi_ShapeCache_h
+
+#include <btBulletDynamicsCommon.h>
+
+#include <shared/FileCache.h>
+#include <ShapeInfo.h>
+
+// On-disk cache of built shapes, keyed by a digest of the points and triangles they are built from, so that
+// later loads skip the hull reduction and BVH building.  It is thread-safe, and is read and written by the ShapeManager's workers.
+class ShapeCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    // Whenever a change is made to the serialized format for the shape cache that isn't backward compatible,
+    // this value should be incremented.  This will force the shape cache to be wiped
+    static const int CURRENT_VERSION;
+    static const int INVALID_VERSION;
+    static const char* SETTING_VERSION_NAME;
+
+    static const std::string DIRNAME;
+    static const std::string EXT;
+
+    ShapeCache(const std::string& dir = DIRNAME, const std::string& ext = EXT);
+
+    void initialize() override;
+
+    // \return the cached shape for info, or nullptr if there isn't one
+    const btCollisionShape* readShape(const ShapeInfo& info);
+
+    // caches the shape built from info, if its type is worth caching
+    void writeShape(const ShapeInfo& info, const btCollisionShape* shape);
+};
+
+#endif // hifi_ShapeCache_h
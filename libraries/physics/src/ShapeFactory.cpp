@@ -13,6 +13,8 @@
 
 #include <glm/gtx/norm.hpp>
 
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+
 #include <SharedUtil.h> // for MILLIMETERS_PER_METER
 
 #include "BulletUtil.h"
@@ -27,7 +29,23 @@ public:
         assert(_dataArray);
     }
 
+    // uses a BVH that was deserialized in place into bvhBuffer (allocated with btAlignedAlloc), rather than building one
+    StaticMeshShape(btTriangleIndexVertexArray* dataArray, btOptimizedBvh* bvh, void* bvhBuffer)
+    :   btBvhTriangleMeshShape(dataArray, true, false), _dataArray(dataArray), _bvhBuffer(bvhBuffer) {
+        assert(_dataArray);
+        assert(bvh && bvhBuffer);
+        setOptimizedBvh(bvh);
+    }
+
     ~StaticMeshShape() {
+        if (_bvhBuffer) {
+            // the BVH doesn't own its arrays, they live in the buffer
+            m_bvh->~btOptimizedBvh();
+            m_bvh = nullptr;
+            btAlignedFree(_bvhBuffer);
+            _bvhBuffer = nullptr;
+        }
+
         assert(_dataArray);
         IndexedMeshArray& meshes = _dataArray->getIndexedMeshArray();
         for (int32_t i = 0; i < meshes.size(); ++i) {
@@ -47,6 +65,7 @@ public:
 private:
     // the StaticMeshShape owns its vertex/index data
     btTriangleIndexVertexArray* _dataArray;
+    void* _bvhBuffer { nullptr };
 };
 
 // the dataArray must be created before we create the StaticMeshShape
@@ -470,3 +489,185 @@ void ShapeFactory::deleteShape(const btCollisionShape* shape) {
     }
     delete nonConstShape;
 }
+
+// serialized shapes are a tree of tagged nodes
+enum SerializedShapeType : uint8_t {
+    SERIALIZED_HULL = 1,
+    SERIALIZED_COMPOUND,
+    SERIALIZED_STATIC_MESH
+};
+
+// the serialized BVH is copied to memory with this alignment, which deserializing in place requires
+const size_t BVH_BUFFER_ALIGNMENT = 16;
+
+template <typename T>
+static void appendValue(QByteArray& data, const T& value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// reads values from serialized data in order, failing rather than reading past its end
+class SerializedShapeReader {
+public:
+    SerializedShapeReader(const QByteArray& data) : _data(data) {}
+
+    bool read(void* value, size_t size) {
+        if (size > getRemaining()) {
+            return false;
+        }
+        memcpy(value, _data.constData() + _offset, size);
+        _offset += size;
+        return true;
+    }
+
+    template <typename T>
+    bool read(T& value) {
+        return read(&value, sizeof(T));
+    }
+
+    size_t getRemaining() const { return (size_t)_data.size() - _offset; }
+    bool atEnd() const { return getRemaining() == 0; }
+
+private:
+    const QByteArray& _data;
+    size_t _offset { 0 };
+};
+
+static bool serializeShapeNode(const btCollisionShape* shape, QByteArray& data) {
+    switch (shape->getShapeType()) {
+        case CONVEX_HULL_SHAPE_PROXYTYPE: {
+            const btConvexHullShape* hull = static_cast<const btConvexHullShape*>(shape);
+            appendValue(data, SERIALIZED_HULL);
+            appendValue(data, (float)hull->getMargin());
+            uint32_t numPoints = (uint32_t)hull->getNumPoints();
+            appendValue(data, numPoints);
+            const btVector3* points = hull->getUnscaledPoints();
+            for (uint32_t i = 0; i < numPoints; ++i) {
+                appendValue(data, bulletToGLM(points[i]));
+            }
+            return true;
+        }
+        case COMPOUND_SHAPE_PROXYTYPE: {
+            const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+            appendValue(data, SERIALIZED_COMPOUND);
+            uint32_t numChildShapes = (uint32_t)compound->getNumChildShapes();
+            appendValue(data, numChildShapes);
+            for (uint32_t i = 0; i < numChildShapes; ++i) {
+                const btTransform& transform = compound->getChildTransform(i);
+                appendValue(data, bulletToGLM(transform.getOrigin()));
+                appendValue(data, bulletToGLM(transform.getRotation()));
+                if (!serializeShapeNode(compound->getChildShape(i), data)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case TRIANGLE_MESH_SHAPE_PROXYTYPE: {
+            // the triangles are cheap to rebuild from the ShapeInfo, only the BVH is stored
+            const btOptimizedBvh* bvh = static_cast<const btBvhTriangleMeshShape*>(shape)->getOptimizedBvh();
+            if (!bvh) {
+                return false;
+            }
+            uint32_t bvhSize = bvh->calculateSerializeBufferSize();
+            void* bvhBuffer = btAlignedAlloc(bvhSize, BVH_BUFFER_ALIGNMENT);
+            bool serialized = bvh->serializeInPlace(bvhBuffer, bvhSize, false);
+            if (serialized) {
+                appendValue(data, SERIALIZED_STATIC_MESH);
+                appendValue(data, bvhSize);
+                data.append(static_cast<const char*>(bvhBuffer), bvhSize);
+            }
+            btAlignedFree(bvhBuffer);
+            return serialized;
+        }
+        default:
+            // primitives are cheaper to create than to read
+            return false;
+    }
+}
+
+bool ShapeFactory::serializeShape(const btCollisionShape* shape, QByteArray& data) {
+    assert(shape);
+    data.clear();
+    if (!serializeShapeNode(shape, data)) {
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+static btCollisionShape* deserializeShapeNode(const ShapeInfo& info, SerializedShapeReader& reader) {
+    uint8_t type;
+    if (!reader.read(type)) {
+        return nullptr;
+    }
+    switch (type) {
+        case SERIALIZED_HULL: {
+            float margin;
+            uint32_t numPoints;
+            if (!reader.read(margin) || !reader.read(numPoints) || numPoints == 0) {
+                return nullptr;
+            }
+            btConvexHullShape* hull = new btConvexHullShape();
+            for (uint32_t i = 0; i < numPoints; ++i) {
+                glm::vec3 point;
+                if (!reader.read(point)) {
+                    delete hull;
+                    return nullptr;
+                }
+                hull->addPoint(glmToBullet(point), false);
+            }
+            hull->setMargin(margin);
+            hull->recalcLocalAabb();
+            return hull;
+        }
+        case SERIALIZED_COMPOUND: {
+            uint32_t numChildShapes;
+            if (!reader.read(numChildShapes)) {
+                return nullptr;
+            }
+            auto compound = new btCompoundShape();
+            for (uint32_t i = 0; i < numChildShapes; ++i) {
+                glm::vec3 origin;
+                glm::quat rotation;
+                btCollisionShape* child = nullptr;
+                if (!reader.read(origin) || !reader.read(rotation) || !(child = deserializeShapeNode(info, reader))) {
+                    ShapeFactory::deleteShape(compound);
+                    return nullptr;
+                }
+                compound->addChildShape(btTransform(glmToBullet(rotation), glmToBullet(origin)), child);
+            }
+            return compound;
+        }
+        case SERIALIZED_STATIC_MESH: {
+            uint32_t bvhSize;
+            if (!reader.read(bvhSize) || bvhSize > reader.getRemaining()) {
+                return nullptr;
+            }
+            void* bvhBuffer = btAlignedAlloc(bvhSize, BVH_BUFFER_ALIGNMENT);
+            btOptimizedBvh* bvh = nullptr;
+            if (!reader.read(bvhBuffer, bvhSize) || !(bvh = btOptimizedBvh::deSerializeInPlace(bvhBuffer, bvhSize, false))) {
+                btAlignedFree(bvhBuffer);
+                return nullptr;
+            }
+            btTriangleIndexVertexArray* dataArray = createStaticMeshArray(info);
+            if (!dataArray) {
+                bvh->~btOptimizedBvh();
+                btAlignedFree(bvhBuffer);
+                return nullptr;
+            }
+            return new StaticMeshShape(dataArray, bvh, bvhBuffer);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+const btCollisionShape* ShapeFactory::deserializeShape(const ShapeInfo& info, const QByteArray& data) {
+    SerializedShapeReader reader(data);
+    btCollisionShape* shape = deserializeShapeNode(info, reader);
+    if (shape && !reader.atEnd()) {
+        // trailing data means the shape wasn't what was serialized
+        deleteShape(shape);
+        shape = nullptr;
+    }
+    return shape;
+}
@@ -15,13 +15,22 @@
 #include <btBulletDynamicsCommon.h>
 #include <glm/glm.hpp>
 
+#include <QByteArray>
+
 #include <ShapeInfo.h>
 
 // The ShapeFactory assembles and correctly disassembles btCollisionShapes.
+// It is stateless, so shapes may be created on any thread.
 
 namespace ShapeFactory {
     const btCollisionShape* createShapeFromInfo(const ShapeInfo& info);
     void deleteShape(const btCollisionShape* shape);
+
+    // Serialization for the shape cache.  Only the expensive shapes are serialized: convex hulls (after their
+    // points are reduced), the BVHs of static meshes, and compounds of them.
+    bool serializeShape(const btCollisionShape* shape, QByteArray& data);
+    // the info must be the one the shape was created from, since static meshes rebuild their triangles from it
+    const btCollisionShape* deserializeShape(const ShapeInfo& info, const QByteArray& data);
 };
 
 #endif // hifi_ShapeFactory_h
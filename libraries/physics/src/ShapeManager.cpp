@@ -14,13 +14,23 @@
 #include <glm/gtx/norm.hpp>
 
 #include <QDebug>
+#include <QtConcurrent/QtConcurrentRun>
 
+#include "ShapeCache.h"
 #include "ShapeFactory.h"
 
 ShapeManager::ShapeManager() {
 }
 
 ShapeManager::~ShapeManager() {
+    for (auto& pendingShape : _pendingShapes) {
+        const btCollisionShape* shape = pendingShape.second.future.result();
+        if (shape) {
+            ShapeFactory::deleteShape(shape);
+        }
+    }
+    _pendingShapes.clear();
+
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
@@ -29,6 +39,30 @@ ShapeManager::~ShapeManager() {
     _shapeMap.clear();
 }
 
+void ShapeManager::initializeShapeCache() {
+    _shapeCache = std::make_shared<ShapeCache>();
+    _shapeCache->initialize();
+}
+
+const btCollisionShape* ShapeManager::createShape(const ShapeInfo& info, const std::shared_ptr<ShapeCache>& shapeCache) {
+    const btCollisionShape* shape = shapeCache ? shapeCache->readShape(info) : nullptr;
+    if (!shape) {
+        shape = ShapeFactory::createShapeFromInfo(info);
+        if (shape && shapeCache) {
+            shapeCache->writeShape(info, shape);
+        }
+    }
+    return shape;
+}
+
+void ShapeManager::addShape(const HashKey& key, const btCollisionShape* shape, int refCount) {
+    ShapeReference newRef;
+    newRef.refCount = refCount;
+    newRef.shape = shape;
+    newRef.key = key;
+    _shapeMap.insert(key, newRef);
+}
+
 const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
     if (info.getType() == SHAPE_TYPE_NONE) {
         return nullptr;
@@ -39,17 +73,64 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         shapeRef->refCount++;
         return shapeRef->shape;
     }
-    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+
+    const btCollisionShape* shape = nullptr;
+    auto pendingItr = _pendingShapes.find(key.getHash64());
+    if (pendingItr != _pendingShapes.end()) {
+        // blocks until the build finishes
+        shape = pendingItr->second.future.result();
+        _pendingShapes.erase(pendingItr);
+    } else {
+        shape = createShape(info, _shapeCache);
+    }
     if (shape) {
-        ShapeReference newRef;
-        newRef.refCount = 1;
-        newRef.shape = shape;
-        newRef.key = key;
-        _shapeMap.insert(key, newRef);
+        addShape(key, shape, 1);
     }
     return shape;
 }
 
+ShapeManager::ShapeFuture ShapeManager::requestShape(const ShapeInfo& info) {
+    const btCollisionShape* shape = nullptr;
+    if (info.getType() != SHAPE_TYPE_NONE) {
+        HashKey key = info.getHash();
+        ShapeReference* shapeRef = _shapeMap.find(key);
+        if (shapeRef) {
+            shape = shapeRef->shape;
+        } else {
+            auto pendingItr = _pendingShapes.find(key.getHash64());
+            if (pendingItr != _pendingShapes.end()) {
+                ++pendingItr->second.numRequests;
+                return pendingItr->second.future;
+            }
+
+            // the info is copied (with its hash) for the worker
+            std::shared_ptr<ShapeCache> shapeCache = _shapeCache;
+            ShapeFuture future = QtConcurrent::run([info, shapeCache] {
+                return createShape(info, shapeCache);
+            });
+            _pendingShapes[key.getHash64()] = { key, future, 1 };
+            return future;
+        }
+    }
+
+    // nothing to build
+    QFutureInterface<const btCollisionShape*> finished;
+    finished.reportStarted();
+    finished.reportFinished(&shape);
+    return finished.future();
+}
+
+void ShapeManager::cancelShapeRequest(const ShapeInfo& info) {
+    if (info.getType() == SHAPE_TYPE_NONE) {
+        return;
+    }
+    // once claimed, the build is managed like any other shape, and there is nothing left to cancel
+    auto pendingItr = _pendingShapes.find(info.getHash().getHash64());
+    if (pendingItr != _pendingShapes.end() && pendingItr->second.numRequests > 0) {
+        --pendingItr->second.numRequests;
+    }
+}
+
 // private helper method
 bool ShapeManager::releaseShapeByKey(const HashKey& key) {
     ShapeReference* shapeRef = _shapeMap.find(key);
@@ -87,6 +168,23 @@ bool ShapeManager::releaseShape(const btCollisionShape* shape) {
 }
 
 void ShapeManager::collectGarbage() {
+    // finished builds that nobody is waiting to claim anymore are collected too
+    // (the ones still requested are about to be claimed, and collecting them would only get them rebuilt)
+    auto pendingItr = _pendingShapes.begin();
+    while (pendingItr != _pendingShapes.end()) {
+        const PendingShape& pendingShape = pendingItr->second;
+        if (pendingShape.numRequests > 0 || !pendingShape.future.isFinished()) {
+            ++pendingItr;
+            continue;
+        }
+        const btCollisionShape* shape = pendingShape.future.result();
+        if (shape) {
+            addShape(pendingShape.key, shape, 0);
+            _pendingGarbage.push_back(pendingShape.key);
+        }
+        pendingItr = _pendingShapes.erase(pendingItr);
+    }
+
     int numShapes = _pendingGarbage.size();
     for (int i = 0; i < numShapes; ++i) {
         HashKey& key = _pendingGarbage[i];
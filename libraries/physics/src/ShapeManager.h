@@ -12,13 +12,20 @@
 #ifndef hifi_ShapeManager_h
 #define hifi_ShapeManager_h
 
+#include <memory>
+#include <unordered_map>
+
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
+#include <QFuture>
+
 #include <ShapeInfo.h>
 
 #include "HashKey.h"
 
+class ShapeCache;
+
 // The ShapeManager handles the ref-counting on shared shapes:
 //
 // Each object added to the physics simulation gets a corresponding btRigidBody.
@@ -40,16 +47,32 @@
 // doesn't delete it right away.  Instead it puts the shape's key on a list delete
 // later.  When that list grows big enough the ShapeManager will remove any matching
 // entries that still have zero ref-count.
+//
+// Shapes can also be requested ahead of time, in which case the ShapeFactory builds them
+// on the worker pool and getShape() only blocks if the build hasn't finished yet.  With a
+// ShapeCache the built hulls and BVHs are also kept on disk for later sessions.
 
 class ShapeManager {
 public:
+    using ShapeFuture = QFuture<const btCollisionShape*>;
 
     ShapeManager();
     ~ShapeManager();
 
+    /// creates and initializes the on-disk cache of built shapes
+    void initializeShapeCache();
+
     /// \return pointer to shape
     const btCollisionShape* getShape(const ShapeInfo& info);
 
+    /// starts building the shape on the worker pool, unless it is already built or being built
+    /// \return future that finishes when the shape is built, after which getShape(info) returns it without blocking
+    /// The build is kept for getShape(info) until every request for it is claimed or cancelled.
+    ShapeFuture requestShape(const ShapeInfo& info);
+
+    /// gives up on a requestShape(info) that won't be followed by getShape(info)
+    void cancelShapeRequest(const ShapeInfo& info);
+
     /// \return true if shape was found and released
     bool releaseShape(const btCollisionShape* shape);
 
@@ -64,6 +87,10 @@ public:
 
 private:
     bool releaseShapeByKey(const HashKey& key);
+    void addShape(const HashKey& key, const btCollisionShape* shape, int refCount);
+
+    // builds the shape (or reads it from the cache) on the calling thread
+    static const btCollisionShape* createShape(const ShapeInfo& info, const std::shared_ptr<ShapeCache>& shapeCache);
 
     class ShapeReference {
     public:
@@ -76,6 +103,17 @@ private:
     // btHashMap is required because it supports memory alignment of the btCollisionShapes
     btHashMap<HashKey, ShapeReference> _shapeMap;
     btAlignedObjectArray<HashKey> _pendingGarbage;
+
+    class PendingShape {
+    public:
+        HashKey key;
+        ShapeFuture future;
+        int numRequests; // not yet claimed or cancelled
+    };
+
+    // shapes being built on the worker pool, by 64-bit hash
+    std::unordered_map<uint64_t, PendingShape> _pendingShapes;
+    std::shared_ptr<ShapeCache> _shapeCache;
 };
 
 #endif // hifi_ShapeManager_h
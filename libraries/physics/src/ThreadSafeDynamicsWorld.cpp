@@ -17,7 +17,15 @@
 
 #include "ThreadSafeDynamicsWorld.h"
 
+#include <algorithm>
+
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <BulletCollision/CollisionDispatch/btSimulationIslandManager.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 #include <LinearMath/btQuickprof.h>
+#include <SharedUtil.h>
 
 #include "Profile.h"
 
@@ -27,6 +35,38 @@ ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btConstraintSolver* constraintSolver,
         btCollisionConfiguration* collisionConfiguration)
     :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration) {
+    setNumSolverThreads(1);
+}
+
+ThreadSafeDynamicsWorld::SolverTask::SolverTask() :
+    solver(new btSequentialImpulseConstraintSolver()) {
+}
+
+ThreadSafeDynamicsWorld::SolverTask::~SolverTask() {
+    delete solver;
+}
+
+void ThreadSafeDynamicsWorld::SolverTask::clear() {
+    bodies.resize(0);
+    manifolds.resize(0);
+    constraints.resize(0);
+}
+
+void ThreadSafeDynamicsWorld::setNumSolverThreads(int numThreads) {
+    int maxThreads = std::max(QThread::idealThreadCount(), 1);
+    numThreads = std::min(std::max(numThreads, 1), maxThreads);
+    while ((int)_solverTasks.size() < numThreads) {
+        _solverTasks.emplace_back(new SolverTask());
+    }
+    _solverTasks.resize(numThreads);
+}
+
+std::vector<quint64> ThreadSafeDynamicsWorld::getSolverThreadTimes() const {
+    std::vector<quint64> times;
+    for (auto& task : _solverTasks) {
+        times.push_back(task->solveTime);
+    }
+    return times;
 }
 
 int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps,
@@ -34,6 +74,9 @@ int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep
     DETAILED_PROFILE_RANGE(simulation_physics, "stepWithCB");
     BT_PROFILE("stepSimulationWithSubstepCallback");
     int subSteps = 0;
+    for (auto& task : _solverTasks) {
+        task->solveTime = 0;
+    }
     if (maxSubSteps) {
         //fixed timestep with interpolation
         m_fixedTimeStep = fixedTimeStep;
@@ -92,6 +135,178 @@ int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep
     return subSteps;
 }
 
+void ThreadSafeDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo) {
+    if (_solverTasks.size() < 2) {
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        return;
+    }
+
+    DETAILED_PROFILE_RANGE(simulation_physics, "solveConstraints");
+    BT_PROFILE("solveConstraints");
+    {
+        // this also updates the activation state of the islands, as btSimulationIslandManager::buildAndProcessIslands() would
+        BT_PROFILE("buildIslands");
+        m_islandManager->buildIslands(getDispatcher(), this);
+    }
+    {
+        BT_PROFILE("partitionIslands");
+        partitionIslands();
+    }
+
+    // NOTE: Bullet's profiler is not thread-safe, so the solver threads time themselves
+    BT_PROFILE("solveIslands");
+    btDispatcher* dispatcher = getDispatcher();
+    std::vector<SolverTask*> tasks;
+    for (auto& task : _solverTasks) {
+        if (task->bodies.size() > 0) {
+            tasks.push_back(task.get());
+        }
+    }
+    QtConcurrent::blockingMap(tasks, [&](SolverTask* task) {
+        quint64 start = usecTimestampNow();
+        task->solver->solveGroup(&task->bodies[0], task->bodies.size(),
+            task->manifolds.size() > 0 ? &task->manifolds[0] : nullptr, task->manifolds.size(),
+            task->constraints.size() > 0 ? &task->constraints[0] : nullptr, task->constraints.size(),
+            solverInfo, nullptr, dispatcher);
+        task->solveTime += usecTimestampNow() - start;
+    });
+}
+
+int ThreadSafeDynamicsWorld::findIslandGroup(int islandId) {
+    while (_islandGroups[islandId] != islandId) {
+        _islandGroups[islandId] = _islandGroups[_islandGroups[islandId]];
+        islandId = _islandGroups[islandId];
+    }
+    return islandId;
+}
+
+// islands are disjoint, except for the kinematic bodies they touch (which Bullet never merges into an island),
+// and the solver temporarily writes into every body it solves, so islands that share one are solved together
+void ThreadSafeDynamicsWorld::partitionIslands() {
+    for (auto& task : _solverTasks) {
+        task->clear();
+    }
+
+    // the union-find elements are the non-static bodies, sorted by island id, which is also an element index
+    btUnionFind& unionFind = m_islandManager->getUnionFind();
+    int numElements = unionFind.getNumElements();
+    _islandGroups.resize(numElements);
+    _islandCosts.assign(numElements, 0);
+    _islandTasks.assign(numElements, -1);
+    _kinematicIslands.clear();
+    for (int i = 0; i < numElements; ++i) {
+        _islandGroups[i] = i;
+    }
+
+    // an island is awake if any of its bodies is
+    for (int i = 0; i < numElements; ++i) {
+        const btElement& element = unionFind.getElement(i);
+        if (m_collisionObjects[element.m_sz]->isActive()) {
+            _islandCosts[element.m_id] = 1;
+        }
+    }
+    auto isAwake = [&](int islandId) {
+        return islandId >= 0 && _islandCosts[islandId] > 0;
+    };
+    auto shareKinematic = [&](const btCollisionObject* object, int islandId) {
+        if (object->isKinematicObject()) {
+            auto itr = _kinematicIslands.find(object);
+            if (itr == _kinematicIslands.end()) {
+                _kinematicIslands[object] = islandId;
+            } else {
+                _islandGroups[findIslandGroup(islandId)] = findIslandGroup(itr->second);
+            }
+        }
+    };
+
+    // contacts belong to the island of their non-static body, as they do in btSimulationIslandManager
+    btDispatcher* dispatcher = getDispatcher();
+    int numManifolds = dispatcher->getNumManifolds();
+    for (int i = 0; i < numManifolds; ++i) {
+        btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+        const btCollisionObject* objectA = manifold->getBody0();
+        const btCollisionObject* objectB = manifold->getBody1();
+        int islandId = objectA->getIslandTag() >= 0 ? objectA->getIslandTag() : objectB->getIslandTag();
+        if (isAwake(islandId) && dispatcher->needsResponse(objectA, objectB)) {
+            _islandCosts[islandId] += manifold->getNumContacts();
+            shareKinematic(objectA, islandId);
+            shareKinematic(objectB, islandId);
+        }
+    }
+
+    int numConstraints = m_constraints.size();
+    for (int i = 0; i < numConstraints; ++i) {
+        btTypedConstraint* constraint = m_constraints[i];
+        const btRigidBody& bodyA = constraint->getRigidBodyA();
+        const btRigidBody& bodyB = constraint->getRigidBodyB();
+        int islandId = bodyA.getIslandTag() >= 0 ? bodyA.getIslandTag() : bodyB.getIslandTag();
+        if (constraint->isEnabled() && isAwake(islandId)) {
+            // constraints are expensive compared to contacts
+            const int CONSTRAINT_COST = 4;
+            _islandCosts[islandId] += CONSTRAINT_COST;
+            shareKinematic(&bodyA, islandId);
+            shareKinematic(&bodyB, islandId);
+        }
+    }
+
+    // sum the cost of each group into its root island
+    for (int islandId = 0; islandId < numElements; ++islandId) {
+        if (isAwake(islandId)) {
+            int group = findIslandGroup(islandId);
+            if (group != islandId) {
+                _islandCosts[group] += _islandCosts[islandId];
+            }
+        }
+    }
+    _groupCosts.clear();
+    for (int islandId = 0; islandId < numElements; ++islandId) {
+        if (isAwake(islandId) && findIslandGroup(islandId) == islandId) {
+            _groupCosts.push_back({ _islandCosts[islandId], islandId });
+        }
+    }
+
+    // greedily assign the most expensive groups to the least loaded tasks
+    std::sort(_groupCosts.begin(), _groupCosts.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first > b.first;
+    });
+    _taskLoads.assign(_solverTasks.size(), 0);
+    for (auto& groupCost : _groupCosts) {
+        int task = (int)std::distance(_taskLoads.begin(), std::min_element(_taskLoads.begin(), _taskLoads.end()));
+        _taskLoads[task] += groupCost.first;
+        _islandTasks[groupCost.second] = task;
+    }
+    auto taskFor = [&](int islandId) {
+        return isAwake(islandId) ? _islandTasks[findIslandGroup(islandId)] : -1;
+    };
+
+    // fill the tasks, keeping the order in which btDiscreteDynamicsWorld would solve them
+    for (int i = 0; i < numElements; ++i) {
+        const btElement& element = unionFind.getElement(i);
+        int task = taskFor(element.m_id);
+        if (task >= 0) {
+            _solverTasks[task]->bodies.push_back(m_collisionObjects[element.m_sz]);
+        }
+    }
+    for (int i = 0; i < numManifolds; ++i) {
+        btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+        const btCollisionObject* objectA = manifold->getBody0();
+        const btCollisionObject* objectB = manifold->getBody1();
+        int task = taskFor(objectA->getIslandTag() >= 0 ? objectA->getIslandTag() : objectB->getIslandTag());
+        if (task >= 0 && dispatcher->needsResponse(objectA, objectB)) {
+            _solverTasks[task]->manifolds.push_back(manifold);
+        }
+    }
+    for (int i = 0; i < numConstraints; ++i) {
+        btTypedConstraint* constraint = m_constraints[i];
+        const btRigidBody& bodyA = constraint->getRigidBodyA();
+        const btRigidBody& bodyB = constraint->getRigidBodyB();
+        int task = taskFor(bodyA.getIslandTag() >= 0 ? bodyA.getIslandTag() : bodyB.getIslandTag());
+        if (task >= 0 && constraint->isEnabled()) {
+            _solverTasks[task]->constraints.push_back(constraint);
+        }
+    }
+}
+
 // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
 void ThreadSafeDynamicsWorld::synchronizeMotionState(btRigidBody* body) {
     btAssert(body);
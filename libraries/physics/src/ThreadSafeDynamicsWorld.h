@@ -24,6 +24,11 @@
 #include "ObjectMotionState.h"
 
 #include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class btSequentialImpulseConstraintSolver;
 
 using SubStepCallback = std::function<void()>;
 
@@ -54,7 +59,36 @@ public:
 
     void addChangedMotionState(ObjectMotionState* motionState) { _changedMotionStates.push_back(motionState); }
 
+    // solve the simulation islands of each substep on this many threads
+    // (one solves them all on the simulation thread, exactly as btDiscreteDynamicsWorld does)
+    void setNumSolverThreads(int numThreads);
+    int getNumSolverThreads() const { return (int)_solverTasks.size(); }
+
+    // usecs spent solving by each solver thread over the last step
+    std::vector<quint64> getSolverThreadTimes() const;
+
+protected:
+    virtual void solveConstraints(btContactSolverInfo& solverInfo) override;
+
 private:
+    // a share of the islands to solve on one thread, with its own solver
+    class SolverTask {
+    public:
+        SolverTask();
+        ~SolverTask();
+        void clear();
+
+        btSequentialImpulseConstraintSolver* solver;
+        btAlignedObjectArray<btCollisionObject*> bodies;
+        btAlignedObjectArray<btPersistentManifold*> manifolds;
+        btAlignedObjectArray<btTypedConstraint*> constraints;
+        quint64 solveTime { 0 };
+    };
+
+    // split the awake islands across the solver tasks
+    void partitionIslands();
+    int findIslandGroup(int islandId);
+
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
 
@@ -63,6 +97,16 @@ private:
     SetOfMotionStates _activeStates;
     SetOfMotionStates _lastActiveStates;
     int _numSubsteps { 0 };
+
+    std::vector<std::unique_ptr<SolverTask>> _solverTasks;
+
+    // partitioning scratch, indexed by island id, kept to avoid reallocating every substep
+    std::vector<int> _islandGroups; // islands that share a kinematic body are solved together
+    std::vector<int> _islandCosts;
+    std::vector<int> _islandTasks;
+    std::vector<std::pair<int, int>> _groupCosts;
+    std::vector<int64_t> _taskLoads;
+    std::unordered_map<const btCollisionObject*, int> _kinematicIslands;
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
@@ -32,4 +32,7 @@ public:
     virtual Decoder* createDecoder(int sampleRate, int numChannels) = 0;
     virtual void releaseEncoder(Encoder* encoder) = 0;
     virtual void releaseDecoder(Decoder* decoder) = 0;
+
+    // true if each frame is encoded on its own, so the output of any encoder can be sent to any decoder
+    virtual bool hasStatelessEncoder() const { return false; }
 };
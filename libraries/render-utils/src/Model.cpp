@@ -14,6 +14,7 @@
 #include <QMetaType>
 #include <QRunnable>
 #include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/norm.hpp>
@@ -386,8 +387,9 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
         int subMeshIndex = 0;
         const FBXGeometry& geometry = getFBXGeometry();
 
-        if (!_triangleSetsValid) {
-            calculateTriangleSets(geometry);
+        if (!_triangleSetsValid && !calculateTriangleSets(geometry)) {
+            // the triangle sets are still being built, and the box alone isn't a surface, so miss until they are done
+            return false;
         }
 
         glm::mat4 meshToModelMatrix = glm::scale(_scale) * glm::translate(_offset);
@@ -489,8 +491,9 @@ bool Model::findParabolaIntersectionAgainstSubMeshes(const glm::vec3& origin, co
         int subMeshIndex = 0;
         const FBXGeometry& geometry = getFBXGeometry();
 
-        if (!_triangleSetsValid) {
-            calculateTriangleSets(geometry);
+        if (!_triangleSetsValid && !calculateTriangleSets(geometry)) {
+            // the triangle sets are still being built, and the box alone isn't a surface, so miss until they are done
+            return false;
         }
 
         glm::mat4 meshToModelMatrix = glm::scale(_scale) * glm::translate(_offset);
@@ -583,8 +586,9 @@ bool Model::convexHullContains(glm::vec3 point) {
     if (modelFrameBox.contains(modelFramePoint)){
         QMutexLocker locker(&_mutex);
 
-        if (!_triangleSetsValid) {
-            calculateTriangleSets(getFBXGeometry());
+        if (!_triangleSetsValid && !calculateTriangleSets(getFBXGeometry())) {
+            // the triangle sets are still being built, and the box alone isn't the hull, so don't contain until they are done
+            return false;
         }
 
         // If we are inside the models box, then consider the submeshes...
@@ -751,20 +755,45 @@ scriptable::ScriptableModelBase Model::getScriptableModel() {
     return result;
 }
 
-void Model::calculateTriangleSets(const FBXGeometry& geometry) {
+bool Model::calculateTriangleSets(const FBXGeometry& geometry) {
     PROFILE_RANGE(render, __FUNCTION__);
 
-    int numberOfMeshes = geometry.meshes.size();
+    // adopt the sets built when the geometry loaded, if they are for this geometry
+    if (_pendingTriangleSetsGeometry) {
+        bool isPendingGeometry = &geometry == &_pendingTriangleSetsGeometry->getFBXGeometry();
+        if (isPendingGeometry && !_pendingTriangleSets.isFinished()) {
+            // never block the caller (usually a pick) on the build
+            return false;
+        }
+
+        auto pendingTriangleSets = _pendingTriangleSets;
+        _pendingTriangleSets = QFuture<std::shared_ptr<TriangleSets>>();
+        _pendingTriangleSetsGeometry.reset();
+        if (isPendingGeometry) {
+            // the sets are never copied, since each octree refers to the triangles of its own set
+            _modelSpaceMeshTriangleSets.swap(*pendingTriangleSets.result());
+            _triangleSetsValid = true;
+            return true;
+        }
+    }
 
     _triangleSetsValid = true;
     _modelSpaceMeshTriangleSets.clear();
-    _modelSpaceMeshTriangleSets.resize(numberOfMeshes);
+    buildTriangleSets(geometry, _modelSpaceMeshTriangleSets);
+    return true;
+}
+
+void Model::buildTriangleSets(const FBXGeometry& geometry, TriangleSets& triangleSets) {
+    PROFILE_RANGE(render, __FUNCTION__);
+
+    int numberOfMeshes = geometry.meshes.size();
+    triangleSets.resize(numberOfMeshes);
 
     for (int i = 0; i < numberOfMeshes; i++) {
         const FBXMesh& mesh = geometry.meshes.at(i);
 
         const int numberOfParts = mesh.parts.size();
-        auto& meshTriangleSets = _modelSpaceMeshTriangleSets[i];
+        auto& meshTriangleSets = triangleSets[i];
         meshTriangleSets.resize(numberOfParts);
 
         for (int j = 0; j < numberOfParts; j++) {
@@ -825,6 +854,8 @@ void Model::calculateTriangleSets(const FBXGeometry& geometry) {
                     partTriangleSet.insert(tri);
                 }
             }
+
+            partTriangleSet.buildBVH();
         }
     }
 }
@@ -1121,6 +1152,7 @@ void Model::setTextures(const QVariantMap& textures) {
         _pendingTextures.clear();
         _needsFixupInScene = true;
         _renderGeometry->setTextures(textures);
+        _renderGeometry->setTextureImportance(this, _loadingPriority);
     } else {
         _pendingTextures = textures;
     }
@@ -1151,6 +1183,11 @@ void Model::setURL(const QUrl& url) {
     _visualGeometryRequestFailed = false;
     _needsFixupInScene = true;
     invalidCalculatedMeshBoxes();
+    {
+        QMutexLocker locker(&_mutex);
+        _pendingTriangleSets = QFuture<std::shared_ptr<TriangleSets>>();
+        _pendingTriangleSetsGeometry.reset();
+    }
     deleteGeometry();
 
     auto resource = DependencyManager::get<ModelCache>()->getGeometryResource(url);
@@ -1161,11 +1198,34 @@ void Model::setURL(const QUrl& url) {
     onInvalidate();
 }
 
+void Model::setLoadingPriority(float priority) {
+    _loadingPriority = priority;
+
+    // the loading priority is how much of the view the model covers, which is also what decides how soon its
+    // textures get their higher mips
+    if (isLoaded()) {
+        _renderGeometry->setTextureImportance(this, priority);
+    }
+}
+
 void Model::loadURLFinished(bool success) {
     if (!success) {
         _visualGeometryRequestFailed = true;
-    } else if (!_pendingTextures.empty()) {
-        setTextures(_pendingTextures);
+    } else {
+        if (!_pendingTextures.empty()) {
+            setTextures(_pendingTextures);
+        }
+        _renderGeometry->setTextureImportance(this, _loadingPriority);
+
+        // build the picking structures off the main thread, so that the first pick doesn't have to
+        QMutexLocker locker(&_mutex);
+        Geometry::Pointer geometry = _renderGeometry;
+        _pendingTriangleSetsGeometry = geometry;
+        _pendingTriangleSets = QtConcurrent::run([geometry] {
+            auto triangleSets = std::make_shared<TriangleSets>();
+            buildTriangleSets(geometry->getFBXGeometry(), *triangleSets);
+            return triangleSets;
+        });
     }
     emit setURLFinished(success);
 }
@@ -13,6 +13,7 @@
 #define hifi_Model_h
 
 #include <QBitArray>
+#include <QFuture>
 #include <QObject>
 #include <QUrl>
 #include <QMutex>
@@ -262,7 +263,7 @@ public:
     // returns 'true' if needs fullUpdate after geometry change
     virtual bool updateGeometry();
 
-    void setLoadingPriority(float priority) { _loadingPriority = priority; }
+    void setLoadingPriority(float priority);
 
     size_t getRenderInfoVertexCount() const { return _renderInfoVertexCount; }
     size_t getRenderInfoTextureSize();
@@ -424,9 +425,17 @@ protected:
     mutable QMutex _mutex{ QMutex::Recursive };
 
     bool _overrideModelTransform { false };
+    using TriangleSets = std::vector<std::vector<TriangleSet>>;
     bool _triangleSetsValid { false };
-    void calculateTriangleSets(const FBXGeometry& geometry);
-    std::vector<std::vector<TriangleSet>> _modelSpaceMeshTriangleSets; // model space triangles for all sub meshes
+    // returns false, without waiting, while the sets for the loaded geometry are still being built
+    bool calculateTriangleSets(const FBXGeometry& geometry);
+    static void buildTriangleSets(const FBXGeometry& geometry, TriangleSets& triangleSets);
+    TriangleSets _modelSpaceMeshTriangleSets; // model space triangles for all sub meshes
+
+    // the triangle sets (and their BVHs) of the loaded geometry, built on a worker thread when it finishes loading,
+    // and adopted by the first pick after they are done; earlier precise picks miss
+    QFuture<std::shared_ptr<TriangleSets>> _pendingTriangleSets;
+    Geometry::Pointer _pendingTriangleSetsGeometry;
 
     virtual void createRenderItemSet();
 
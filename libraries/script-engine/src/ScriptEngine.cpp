@@ -680,6 +680,8 @@ void ScriptEngine::init() {
     qScriptRegisterMetaType(this, AvatarEntityMapToScriptValue, AvatarEntityMapFromScriptValue);
     qScriptRegisterSequenceMetaType<QVector<QUuid>>(this);
     qScriptRegisterSequenceMetaType<QVector<EntityItemID>>(this);
+    qScriptRegisterSequenceMetaType<QVector<PickRay>>(this);
+    qScriptRegisterSequenceMetaType<QVector<RayToEntityIntersectionResult>>(this);
 
     qScriptRegisterSequenceMetaType<QVector<glm::vec2> >(this);
     qScriptRegisterSequenceMetaType<QVector<glm::quat> >(this);
@@ -0,0 +1,37 @@
+//
+//  PickPackets.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_PickPackets_h
+#define hifi_PickPackets_h
+
+#include <algorithm>
+
+#include "shared/ParallelFor.h"
+
+// batched picks are tested in packets of this many, each of which walks the tree once
+const int PICK_PACKET_SIZE = 8;
+
+// packets are only spread across threads when each thread gets at least this many
+const size_t MIN_PACKETS_PER_PICK_TASK = 4;
+
+// calls function(begin, end) over packets of [0, numPicks), spreading the packets across threads
+template <typename F>
+void forEachPickPacket(size_t numPicks, F function) {
+    size_t numPackets = (numPicks + PICK_PACKET_SIZE - 1) / PICK_PACKET_SIZE;
+    parallelFor(numPackets, MIN_PACKETS_PER_PICK_TASK, [&](size_t beginPacket, size_t endPacket) {
+        for (size_t packet = beginPacket; packet < endPacket; ++packet) {
+            size_t begin = packet * PICK_PACKET_SIZE;
+            function(begin, std::min(begin + PICK_PACKET_SIZE, numPicks));
+        }
+    });
+}
+
+#endif // hifi_PickPackets_h
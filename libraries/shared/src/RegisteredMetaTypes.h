@@ -180,6 +180,7 @@ public:
     }
 };
 Q_DECLARE_METATYPE(PickRay)
+Q_DECLARE_METATYPE(QVector<PickRay>)
 QScriptValue pickRayToScriptValue(QScriptEngine* engine, const PickRay& pickRay);
 void pickRayFromScriptValue(const QScriptValue& object, PickRay& pickRay);
 
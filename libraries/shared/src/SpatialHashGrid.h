@@ -0,0 +1,180 @@
+//
+//  SpatialHashGrid.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+#ifndef hifi_SpatialHashGrid_h
+#define hifi_SpatialHashGrid_h
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*   SpatialHashGrid is a uniform grid of point items, meant to be rebuilt once per frame and then
+     queried read-only (and concurrently) by many viewers.  To use:
+
+    SpatialHashGrid<int> grid(cellSize);
+    grid.clear();
+    for (thing in things) {
+        grid.insert(thing.position, thing.index);
+    }
+    grid.build();
+
+    grid.queryRadius(center, radius, [&](const int& index, const glm::vec3& position) { ... });
+*/
+
+template <typename T>
+class SpatialHashGrid {
+public:
+    struct Entry {
+        uint64_t key;
+        glm::vec3 position;
+        T item;
+    };
+
+    struct Cell {
+        uint64_t key;
+        glm::ivec3 coordinates;
+        uint32_t begin; // into entries
+        uint32_t end;
+    };
+
+    SpatialHashGrid(float cellSize = 1.0f) { setCellSize(cellSize); }
+
+    // the grid must be rebuilt after changing the cell size
+    void setCellSize(float cellSize) {
+        _cellSize = std::max(cellSize, MIN_CELL_SIZE);
+        _inverseCellSize = 1.0f / _cellSize;
+    }
+    float getCellSize() const { return _cellSize; }
+
+    void clear() {
+        _entries.clear();
+        _cells.clear();
+        _cellIndices.clear();
+    }
+
+    void insert(const glm::vec3& position, const T& item) {
+        _entries.push_back({ keyFor(cellFor(position)), position, item });
+    }
+
+    // sort the inserted items into cells, must be called before querying
+    void build() {
+        std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) {
+            return a.key < b.key;
+        });
+
+        _cells.clear();
+        _cellIndices.clear();
+        for (uint32_t i = 0; i < (uint32_t)_entries.size(); ++i) {
+            uint64_t key = _entries[i].key;
+            if (_cells.empty() || _cells.back().key != key) {
+                _cellIndices[key] = (uint32_t)_cells.size();
+                _cells.push_back({ key, cellFor(_entries[i].position), i, i });
+            }
+            _cells.back().end = i + 1;
+        }
+    }
+
+    size_t getNumItems() const { return _entries.size(); }
+    size_t getNumCells() const { return _cells.size(); }
+    const std::vector<Entry>& getEntries() const { return _entries; }
+    const std::vector<Cell>& getCells() const { return _cells; }
+
+    glm::ivec3 cellFor(const glm::vec3& position) const {
+        glm::vec3 cell = glm::floor(position * _inverseCellSize);
+        return glm::ivec3(glm::clamp(cell, glm::vec3((float)-MAX_COORDINATE), glm::vec3((float)MAX_COORDINATE)));
+    }
+
+    // distance from a point to the nearest point of a cell
+    float distanceToCell(const glm::vec3& point, const glm::ivec3& cell) const {
+        glm::vec3 minimum = glm::vec3(cell) * _cellSize;
+        glm::vec3 maximum = minimum + glm::vec3(_cellSize);
+        glm::vec3 nearest = glm::clamp(point, minimum, maximum);
+        return glm::distance(point, nearest);
+    }
+
+    // calls functor(const Cell& cell) for every occupied cell that intersects the sphere
+    template <typename Functor>
+    void queryCells(const glm::vec3& center, float radius, Functor functor) const {
+        if (_cells.empty()) {
+            return;
+        }
+
+        glm::ivec3 minimum = cellFor(center - glm::vec3(radius));
+        glm::ivec3 maximum = cellFor(center + glm::vec3(radius));
+        glm::vec3 extent = glm::vec3(maximum - minimum) + glm::vec3(1.0f);
+        float numQueryCells = extent.x * extent.y * extent.z;
+
+        if (numQueryCells > (float)_cells.size()) {
+            // the query covers more cells than are occupied, so scan the occupied cells
+            for (const Cell& cell : _cells) {
+                if (glm::all(glm::greaterThanEqual(cell.coordinates, minimum)) &&
+                    glm::all(glm::lessThanEqual(cell.coordinates, maximum)) &&
+                    distanceToCell(center, cell.coordinates) <= radius) {
+                    functor(cell);
+                }
+            }
+        } else {
+            // otherwise look up each cell in the query
+            for (int x = minimum.x; x <= maximum.x; ++x) {
+                for (int y = minimum.y; y <= maximum.y; ++y) {
+                    for (int z = minimum.z; z <= maximum.z; ++z) {
+                        glm::ivec3 coordinates(x, y, z);
+                        auto itr = _cellIndices.find(keyFor(coordinates));
+                        if (itr != _cellIndices.end() && distanceToCell(center, coordinates) <= radius) {
+                            functor(_cells[itr->second]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // calls functor(const T& item, const glm::vec3& position) for every item within radius of center
+    template <typename Functor>
+    void queryRadius(const glm::vec3& center, float radius, Functor functor) const {
+        float radiusSquared = radius * radius;
+        queryCells(center, radius, [&](const Cell& cell) {
+            for (uint32_t i = cell.begin; i < cell.end; ++i) {
+                const Entry& entry = _entries[i];
+                glm::vec3 offset = entry.position - center;
+                if (glm::dot(offset, offset) <= radiusSquared) {
+                    functor(entry.item, entry.position);
+                }
+            }
+        });
+    }
+
+private:
+    // 21 bits per axis
+    static const int MAX_COORDINATE = (1 << 20) - 1;
+    static constexpr float MIN_CELL_SIZE = 0.001f;
+
+    static uint64_t keyFor(const glm::ivec3& cell) {
+        const uint64_t MASK = (1 << 21) - 1;
+        return (((uint64_t)(cell.x + MAX_COORDINATE + 1) & MASK) << 42) |
+            (((uint64_t)(cell.y + MAX_COORDINATE + 1) & MASK) << 21) |
+            ((uint64_t)(cell.z + MAX_COORDINATE + 1) & MASK);
+    }
+
+    float _cellSize;
+    float _inverseCellSize;
+
+    std::vector<Entry> _entries; // sorted by cell key after build()
+    std::vector<Cell> _cells; // sorted by cell key
+    std::unordered_map<uint64_t, uint32_t> _cellIndices; // into _cells
+};
+
+template <typename T>
+constexpr float SpatialHashGrid<T>::MIN_CELL_SIZE;
+
+#endif // hifi_SpatialHashGrid_h
@@ -11,10 +11,54 @@
 
 #include "TriangleSet.h"
 
+#include <assert.h>
+#include <algorithm>
+
 #include "GLMHelpers.h"
+#include "PickPackets.h"
+#include "RegisteredMetaTypes.h"
+
+// cell bounds are padded by this fraction of their size for the packet tests, so that rounding can't cull a ray
+// that grazes a triangle lying on the bounds
+static const float PACKET_BOUNDS_EPSILON = 1.0e-4f;
+
+// a packet of rays, SoA so that each test runs across all the lanes at once
+struct TriangleSet::RayPacket {
+    float originX[PICK_PACKET_SIZE];
+    float originY[PICK_PACKET_SIZE];
+    float originZ[PICK_PACKET_SIZE];
+    float directionX[PICK_PACKET_SIZE];
+    float directionY[PICK_PACKET_SIZE];
+    float directionZ[PICK_PACKET_SIZE];
+    float inverseDirectionX[PICK_PACKET_SIZE];
+    float inverseDirectionY[PICK_PACKET_SIZE];
+    float inverseDirectionZ[PICK_PACKET_SIZE];
+    float distance[PICK_PACKET_SIZE];
+    int triangle[PICK_PACKET_SIZE]; // index of the nearest triangle so far, or -1
+};
+
+// a packet of parabolas, which are tested one lane at a time but share the walk of the octree
+struct TriangleSet::ParabolaPacket {
+    glm::vec3 origin[PICK_PACKET_SIZE];
+    glm::vec3 velocity[PICK_PACKET_SIZE];
+    glm::vec3 acceleration[PICK_PACKET_SIZE];
+    float parabolicDistance[PICK_PACKET_SIZE];
+    int triangle[PICK_PACKET_SIZE];
+};
+
+// the reciprocal of a direction component, kept finite so the slab tests never see 0 * inf
+static inline float safeInverse(float value) {
+    const float MIN_MAGNITUDE = FLT_MIN;
+    if (std::abs(value) < MIN_MAGNITUDE) {
+        value = std::signbit(value) ? -MIN_MAGNITUDE : MIN_MAGNITUDE;
+    }
+    return 1.0f / value;
+}
 
 void TriangleSet::insert(const Triangle& t) {
     _isBalanced = false;
+    _hasBVH = false;
+    _bvhNodes.clear();
 
     _triangles.push_back(t);
     _bounds += t.v0;
@@ -26,6 +70,8 @@ void TriangleSet::clear() {
     _triangles.clear();
     _bounds.clear();
     _isBalanced = false;
+    _hasBVH = false;
+    _bvhNodes.clear();
 
     _triangleOctree.clear();
 }
@@ -36,6 +82,15 @@ bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3&
     // reset our distance to be the max possible, lower level tests will store best distance here
     distance = std::numeric_limits<float>::max();
 
+    if (_hasBVH) {
+        if (!precision) {
+            glm::vec3 normal;
+            return _bounds.findRayIntersection(origin, direction, distance, face, normal);
+        }
+        face = UNKNOWN_FACE;
+        return findRayIntersectionInBVH(origin, direction, distance, triangle, allowBackface);
+    }
+
     if (!_isBalanced) {
         balanceOctree();
     }
@@ -56,6 +111,15 @@ bool TriangleSet::findParabolaIntersection(const glm::vec3& origin, const glm::v
     // reset our distance to be the max possible, lower level tests will store best distance here
     parabolicDistance = FLT_MAX;
 
+    if (_hasBVH) {
+        if (!precision) {
+            glm::vec3 normal;
+            return _bounds.findParabolaIntersection(origin, velocity, acceleration, parabolicDistance, face, normal);
+        }
+        face = UNKNOWN_FACE;
+        return findParabolaIntersectionInBVH(origin, velocity, acceleration, parabolicDistance, triangle, allowBackface);
+    }
+
     if (!_isBalanced) {
         balanceOctree();
     }
@@ -71,6 +135,94 @@ bool TriangleSet::findParabolaIntersection(const glm::vec3& origin, const glm::v
     return result;
 }
 
+void TriangleSet::findRayIntersections(const std::vector<PickRay>& rays, std::vector<Intersection>& intersections,
+        bool allowBackface) {
+    if (!_hasBVH && !_isBalanced) {
+        balanceOctree();
+    }
+
+    intersections.assign(rays.size(), Intersection());
+    forEachPickPacket(rays.size(), [&](size_t begin, size_t end) {
+        RayPacket packet;
+        uint32_t activeLanes = 0;
+        for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+            // unused lanes repeat the first ray, and are never active
+            const PickRay& ray = rays[begin + lane < end ? begin + lane : begin];
+            packet.originX[lane] = ray.origin.x;
+            packet.originY[lane] = ray.origin.y;
+            packet.originZ[lane] = ray.origin.z;
+            packet.directionX[lane] = ray.direction.x;
+            packet.directionY[lane] = ray.direction.y;
+            packet.directionZ[lane] = ray.direction.z;
+            packet.inverseDirectionX[lane] = safeInverse(ray.direction.x);
+            packet.inverseDirectionY[lane] = safeInverse(ray.direction.y);
+            packet.inverseDirectionZ[lane] = safeInverse(ray.direction.z);
+            packet.distance[lane] = FLT_MAX;
+            packet.triangle[lane] = -1;
+            if (begin + lane < end && ray) {
+                activeLanes |= 1 << lane;
+            }
+        }
+
+        if (_hasBVH) {
+            findRayIntersectionsInBVH(packet, activeLanes, allowBackface);
+        } else {
+            _triangleOctree.findRayIntersections(packet, activeLanes, allowBackface);
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            int lane = (int)(i - begin);
+            if (packet.triangle[lane] != -1) {
+                Intersection& intersection = intersections[i];
+                intersection.intersects = true;
+                intersection.distance = packet.distance[lane];
+                intersection.triangle = _triangles[packet.triangle[lane]];
+            }
+        }
+    });
+}
+
+void TriangleSet::findParabolaIntersections(const std::vector<PickParabola>& parabolas, std::vector<Intersection>& intersections,
+        bool allowBackface) {
+    if (!_hasBVH && !_isBalanced) {
+        balanceOctree();
+    }
+
+    intersections.assign(parabolas.size(), Intersection());
+    forEachPickPacket(parabolas.size(), [&](size_t begin, size_t end) {
+        ParabolaPacket packet;
+        uint32_t activeLanes = 0;
+        for (size_t i = begin; i < end; ++i) {
+            int lane = (int)(i - begin);
+            const PickParabola& parabola = parabolas[i];
+            packet.origin[lane] = parabola.origin;
+            packet.velocity[lane] = parabola.velocity;
+            packet.acceleration[lane] = parabola.acceleration;
+            packet.parabolicDistance[lane] = FLT_MAX;
+            packet.triangle[lane] = -1;
+            if (parabola) {
+                activeLanes |= 1 << lane;
+            }
+        }
+
+        if (_hasBVH) {
+            findParabolaIntersectionsInBVH(packet, activeLanes, allowBackface);
+        } else {
+            _triangleOctree.findParabolaIntersections(packet, activeLanes, allowBackface);
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            int lane = (int)(i - begin);
+            if (packet.triangle[lane] != -1) {
+                Intersection& intersection = intersections[i];
+                intersection.intersects = true;
+                intersection.distance = packet.parabolicDistance[lane];
+                intersection.triangle = _triangles[packet.triangle[lane]];
+            }
+        }
+    });
+}
+
 bool TriangleSet::convexHullContains(const glm::vec3& point) const {
     if (!_bounds.contains(point)) {
         return false;
@@ -374,4 +526,576 @@ bool TriangleSet::TriangleOctreeCell::findParabolaIntersection(const glm::vec3&
         triangle = bestLocalTriangle;
     }
     return intersects;
-}
\ No newline at end of file
+}
+void TriangleSet::TriangleOctreeCell::findRayIntersections(RayPacket& packet, uint32_t activeLanes, bool allowBackface) const {
+    if (_population < 1) {
+        return; // no triangles below here, so we can't intersect
+    }
+
+    // drop the lanes that miss our bounds, or that have already hit something closer than them
+    glm::vec3 padding = PACKET_BOUNDS_EPSILON * (_bounds.getScale() + glm::vec3(1.0f));
+    activeLanes = findRayPacketBoxHits(packet, _bounds.getMinimumPoint() - padding, _bounds.getMaximumPoint() + padding,
+        activeLanes);
+    if (!activeLanes) {
+        return;
+    }
+
+    if (_depth < MAX_DEPTH) {
+        for (auto& child : _children) {
+            child.second.findRayIntersections(packet, activeLanes, allowBackface);
+        }
+    }
+
+    for (const auto& triangleIndex : _triangleIndices) {
+        findRayPacketTriangleIntersections(packet, _allTriangles[triangleIndex], (int)triangleIndex, activeLanes,
+            allowBackface);
+    }
+}
+
+void TriangleSet::TriangleOctreeCell::findParabolaIntersections(ParabolaPacket& packet, uint32_t activeLanes,
+                                                                bool allowBackface) const {
+    if (_population < 1) {
+        return; // no triangles below here, so we can't intersect
+    }
+
+    for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+        if (!(activeLanes & (1 << lane))) {
+            continue;
+        }
+        float boxDistance = FLT_MAX;
+        BoxFace face;
+        glm::vec3 normal;
+        if (!_bounds.findParabolaIntersection(packet.origin[lane], packet.velocity[lane], packet.acceleration[lane],
+                boxDistance, face, normal) ||
+                (!_bounds.contains(packet.origin[lane]) && boxDistance > packet.parabolicDistance[lane])) {
+            activeLanes &= ~(1 << lane);
+        }
+    }
+    if (!activeLanes) {
+        return;
+    }
+
+    if (_depth < MAX_DEPTH) {
+        for (auto& child : _children) {
+            child.second.findParabolaIntersections(packet, activeLanes, allowBackface);
+        }
+    }
+
+    for (const auto& triangleIndex : _triangleIndices) {
+        const Triangle& triangle = _allTriangles[triangleIndex];
+        for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+            float parabolicDistance;
+            if ((activeLanes & (1 << lane)) &&
+                    findParabolaTriangleIntersection(packet.origin[lane], packet.velocity[lane], packet.acceleration[lane],
+                        triangle, parabolicDistance, allowBackface) &&
+                    parabolicDistance < packet.parabolicDistance[lane]) {
+                packet.parabolicDistance[lane] = parabolicDistance;
+                packet.triangle[lane] = (int)triangleIndex;
+            }
+        }
+    }
+}
+
+uint32_t TriangleSet::findRayPacketBoxHits(const RayPacket& packet, const glm::vec3& minimum, const glm::vec3& maximum,
+        uint32_t activeLanes) {
+    // slab test every lane, keeping the lanes that enter the box before their nearest hit so far
+    uint32_t hitLanes = 0;
+    for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+        float x0 = (minimum.x - packet.originX[lane]) * packet.inverseDirectionX[lane];
+        float x1 = (maximum.x - packet.originX[lane]) * packet.inverseDirectionX[lane];
+        float y0 = (minimum.y - packet.originY[lane]) * packet.inverseDirectionY[lane];
+        float y1 = (maximum.y - packet.originY[lane]) * packet.inverseDirectionY[lane];
+        float z0 = (minimum.z - packet.originZ[lane]) * packet.inverseDirectionZ[lane];
+        float z1 = (maximum.z - packet.originZ[lane]) * packet.inverseDirectionZ[lane];
+        float entry = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::max(std::min(z0, z1), 0.0f));
+        float exit = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::max(z0, z1));
+        bool hits = entry <= exit && entry <= packet.distance[lane];
+        hitLanes |= (uint32_t)hits << lane;
+    }
+    return activeLanes & hitLanes;
+}
+
+void TriangleSet::findRayPacketTriangleIntersections(RayPacket& packet, const Triangle& triangle, int triangleIndex,
+        uint32_t activeLanes, bool allowBackface) {
+    // the same test as findRayTriangleIntersection(), with the edge tests folded into per triangle edge normals
+    glm::vec3 firstSide = triangle.v0 - triangle.v1;
+    glm::vec3 secondSide = triangle.v2 - triangle.v1;
+    glm::vec3 normal = glm::cross(secondSide, firstSide);
+    glm::vec3 firstEdgeNormal = glm::cross(firstSide, normal);
+    glm::vec3 secondEdgeNormal = glm::cross(normal, secondSide);
+    glm::vec3 thirdEdgeNormal = glm::cross(triangle.v2 - triangle.v0, normal);
+    float planeDistance = glm::dot(normal, triangle.v1);
+    float firstEdgeDistance = glm::dot(firstEdgeNormal, triangle.v1);
+    float secondEdgeDistance = glm::dot(secondEdgeNormal, triangle.v1);
+    float thirdEdgeDistance = glm::dot(thirdEdgeNormal, triangle.v0);
+
+    for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+        float dividend = planeDistance -
+            (packet.originX[lane] * normal.x + packet.originY[lane] * normal.y + packet.originZ[lane] * normal.z);
+        float divisor = packet.directionX[lane] * normal.x + packet.directionY[lane] * normal.y +
+            packet.directionZ[lane] * normal.z;
+        float t = dividend / divisor;
+        float pointX = packet.originX[lane] + packet.directionX[lane] * t;
+        float pointY = packet.originY[lane] + packet.directionY[lane] * t;
+        float pointZ = packet.originZ[lane] + packet.directionZ[lane] * t;
+        bool hits = (activeLanes & (1 << lane)) && (allowBackface || dividend <= 0.0f) && divisor < 0.0f &&
+            t < packet.distance[lane] &&
+            pointX * firstEdgeNormal.x + pointY * firstEdgeNormal.y + pointZ * firstEdgeNormal.z > firstEdgeDistance &&
+            pointX * secondEdgeNormal.x + pointY * secondEdgeNormal.y + pointZ * secondEdgeNormal.z > secondEdgeDistance &&
+            pointX * thirdEdgeNormal.x + pointY * thirdEdgeNormal.y + pointZ * thirdEdgeNormal.z > thirdEdgeDistance;
+        packet.distance[lane] = hits ? t : packet.distance[lane];
+        packet.triangle[lane] = hits ? triangleIndex : packet.triangle[lane];
+    }
+}
+
+// leaves hold at most this many triangles
+static const uint32_t BVH_MAX_LEAF_SIZE = 4;
+
+static const int BVH_NUM_SAH_BINS = 16;
+
+// past this depth nodes are split at the median, which bounds the depth (and so the traversal stacks) for any mesh
+static const int BVH_MAX_SAH_DEPTH = 32;
+
+// enough for (BVH_MAX_SAH_DEPTH + the median levels of 2^32 triangles) * (BVH_WIDTH - 1) pending children
+static const int BVH_STACK_SIZE = 256;
+
+// the bounds and centroids of the triangles, indexed through the triangle order being built
+struct TriangleSet::BVHBuild {
+    std::vector<uint32_t> order;
+    std::vector<glm::vec3> minimums;
+    std::vector<glm::vec3> maximums;
+    std::vector<glm::vec3> centroids;
+
+    void getBounds(uint32_t begin, uint32_t end, glm::vec3& minimum, glm::vec3& maximum) const {
+        minimum = glm::vec3(FLT_MAX);
+        maximum = glm::vec3(-FLT_MAX);
+        for (uint32_t i = begin; i < end; ++i) {
+            minimum = glm::min(minimum, minimums[order[i]]);
+            maximum = glm::max(maximum, maximums[order[i]]);
+        }
+    }
+
+    // splits [begin, end) in two, returning the first index of the second half
+    uint32_t split(uint32_t begin, uint32_t end, int depth);
+};
+
+static inline float halfSurfaceArea(const glm::vec3& minimum, const glm::vec3& maximum) {
+    glm::vec3 extent = glm::max(maximum - minimum, glm::vec3(0.0f));
+    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+}
+
+uint32_t TriangleSet::BVHBuild::split(uint32_t begin, uint32_t end, int depth) {
+    glm::vec3 centroidMinimum(FLT_MAX);
+    glm::vec3 centroidMaximum(-FLT_MAX);
+    for (uint32_t i = begin; i < end; ++i) {
+        centroidMinimum = glm::min(centroidMinimum, centroids[order[i]]);
+        centroidMaximum = glm::max(centroidMaximum, centroids[order[i]]);
+    }
+    glm::vec3 centroidExtent = centroidMaximum - centroidMinimum;
+
+    if (depth < BVH_MAX_SAH_DEPTH) {
+        // bin the centroids along each axis, and pick the boundary between bins with the lowest surface area cost
+        int bestAxis = -1;
+        int bestBin = 0;
+        float bestCost = FLT_MAX;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (centroidExtent[axis] <= 0.0f) {
+                continue;
+            }
+            float binScale = BVH_NUM_SAH_BINS / centroidExtent[axis];
+            uint32_t counts[BVH_NUM_SAH_BINS] = { 0 };
+            glm::vec3 binMinimums[BVH_NUM_SAH_BINS];
+            glm::vec3 binMaximums[BVH_NUM_SAH_BINS];
+            std::fill(binMinimums, binMinimums + BVH_NUM_SAH_BINS, glm::vec3(FLT_MAX));
+            std::fill(binMaximums, binMaximums + BVH_NUM_SAH_BINS, glm::vec3(-FLT_MAX));
+            for (uint32_t i = begin; i < end; ++i) {
+                uint32_t index = order[i];
+                int bin = std::min((int)((centroids[index][axis] - centroidMinimum[axis]) * binScale), BVH_NUM_SAH_BINS - 1);
+                ++counts[bin];
+                binMinimums[bin] = glm::min(binMinimums[bin], minimums[index]);
+                binMaximums[bin] = glm::max(binMaximums[bin], maximums[index]);
+            }
+
+            // sweep from the right for the costs of the right halves, then from the left
+            float rightCosts[BVH_NUM_SAH_BINS];
+            glm::vec3 minimum(FLT_MAX);
+            glm::vec3 maximum(-FLT_MAX);
+            uint32_t count = 0;
+            for (int bin = BVH_NUM_SAH_BINS - 1; bin > 0; --bin) {
+                minimum = glm::min(minimum, binMinimums[bin]);
+                maximum = glm::max(maximum, binMaximums[bin]);
+                count += counts[bin];
+                rightCosts[bin] = count * halfSurfaceArea(minimum, maximum);
+            }
+            minimum = glm::vec3(FLT_MAX);
+            maximum = glm::vec3(-FLT_MAX);
+            count = 0;
+            for (int bin = 0; bin < BVH_NUM_SAH_BINS - 1; ++bin) {
+                minimum = glm::min(minimum, binMinimums[bin]);
+                maximum = glm::max(maximum, binMaximums[bin]);
+                count += counts[bin];
+                if (count == 0 || count == end - begin) {
+                    continue;
+                }
+                float cost = count * halfSurfaceArea(minimum, maximum) + rightCosts[bin + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = bin;
+                }
+            }
+        }
+
+        if (bestAxis != -1) {
+            float binScale = BVH_NUM_SAH_BINS / centroidExtent[bestAxis];
+            auto middle = std::partition(order.begin() + begin, order.begin() + end, [&](uint32_t index) {
+                int bin = std::min((int)((centroids[index][bestAxis] - centroidMinimum[bestAxis]) * binScale),
+                    BVH_NUM_SAH_BINS - 1);
+                return bin <= bestBin;
+            });
+            uint32_t mid = (uint32_t)(middle - order.begin());
+            if (mid != begin && mid != end) {
+                return mid;
+            }
+        }
+    }
+
+    // split at the median of the longest axis of the centroids
+    int axis = 0;
+    if (centroidExtent.y > centroidExtent[axis]) {
+        axis = 1;
+    }
+    if (centroidExtent.z > centroidExtent[axis]) {
+        axis = 2;
+    }
+    uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](uint32_t a, uint32_t b) {
+        return centroids[a][axis] < centroids[b][axis];
+    });
+    return mid;
+}
+
+TriangleSet::BVHNode::BVHNode() {
+    for (int child = 0; child < BVH_WIDTH; ++child) {
+        // empty children have inverted bounds, so that no ray can hit them
+        minX[child] = minY[child] = minZ[child] = FLT_MAX;
+        maxX[child] = maxY[child] = maxZ[child] = -FLT_MAX;
+        children[child] = -1;
+        numTriangles[child] = 0;
+    }
+}
+
+void TriangleSet::buildBVH() {
+    _bvhNodes.clear();
+    _hasBVH = false;
+    if (_triangles.empty()) {
+        return;
+    }
+
+    BVHBuild build;
+    uint32_t numTriangles = (uint32_t)_triangles.size();
+    build.order.resize(numTriangles);
+    build.minimums.resize(numTriangles);
+    build.maximums.resize(numTriangles);
+    build.centroids.resize(numTriangles);
+    for (uint32_t i = 0; i < numTriangles; ++i) {
+        const Triangle& triangle = _triangles[i];
+        build.order[i] = i;
+        build.minimums[i] = glm::min(glm::min(triangle.v0, triangle.v1), triangle.v2);
+        build.maximums[i] = glm::max(glm::max(triangle.v0, triangle.v1), triangle.v2);
+        build.centroids[i] = 0.5f * (build.minimums[i] + build.maximums[i]);
+    }
+
+    buildBVHNode(build, 0, numTriangles, 0);
+
+    // lay the triangles out in leaf order, so that each leaf is a contiguous range
+    std::vector<Triangle> triangles;
+    triangles.reserve(numTriangles);
+    for (uint32_t i = 0; i < numTriangles; ++i) {
+        triangles.push_back(_triangles[build.order[i]]);
+    }
+    _triangles.swap(triangles);
+
+    // the octree indexes the old order
+    _triangleOctree.clear();
+    _isBalanced = false;
+    _hasBVH = true;
+}
+
+int32_t TriangleSet::buildBVHNode(BVHBuild& build, uint32_t begin, uint32_t end, int depth) {
+    // the children of a node are its range split in two, and then each half split in two again
+    uint32_t ranges[BVH_WIDTH][2] = { { begin, end } };
+    int numRanges = 1;
+    for (int level = 0; level < 2; ++level) {
+        int numSplitRanges = numRanges;
+        for (int i = 0; i < numSplitRanges; ++i) {
+            uint32_t rangeBegin = ranges[i][0];
+            uint32_t rangeEnd = ranges[i][1];
+            if (rangeEnd - rangeBegin <= BVH_MAX_LEAF_SIZE) {
+                continue;
+            }
+            uint32_t mid = build.split(rangeBegin, rangeEnd, depth);
+            ranges[i][1] = mid;
+            ranges[numRanges][0] = mid;
+            ranges[numRanges][1] = rangeEnd;
+            ++numRanges;
+        }
+    }
+
+    // the nodes vector grows while building the children, so the node is only filled in afterwards
+    int32_t nodeIndex = (int32_t)_bvhNodes.size();
+    _bvhNodes.emplace_back();
+    BVHNode node;
+    for (int child = 0; child < numRanges; ++child) {
+        uint32_t rangeBegin = ranges[child][0];
+        uint32_t rangeEnd = ranges[child][1];
+
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        build.getBounds(rangeBegin, rangeEnd, minimum, maximum);
+        glm::vec3 padding = PACKET_BOUNDS_EPSILON * (maximum - minimum + glm::vec3(1.0f));
+        minimum -= padding;
+        maximum += padding;
+        node.minX[child] = minimum.x;
+        node.minY[child] = minimum.y;
+        node.minZ[child] = minimum.z;
+        node.maxX[child] = maximum.x;
+        node.maxY[child] = maximum.y;
+        node.maxZ[child] = maximum.z;
+
+        if (rangeEnd - rangeBegin <= BVH_MAX_LEAF_SIZE) {
+            node.children[child] = (int32_t)rangeBegin;
+            node.numTriangles[child] = (uint8_t)(rangeEnd - rangeBegin);
+        } else {
+            node.children[child] = buildBVHNode(build, rangeBegin, rangeEnd, depth + 1);
+        }
+    }
+    _bvhNodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+static inline AABox getBVHChildBounds(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) {
+    glm::vec3 minimum(minX, minY, minZ);
+    return AABox(minimum, glm::vec3(maxX, maxY, maxZ) - minimum);
+}
+
+bool TriangleSet::findRayIntersectionInBVH(const glm::vec3& origin, const glm::vec3& direction,
+        float& distance, Triangle& triangle, bool allowBackface) const {
+    glm::vec3 inverseDirection(safeInverse(direction.x), safeInverse(direction.y), safeInverse(direction.z));
+
+    struct StackEntry {
+        int32_t node;
+        float distance; // to the bounds of the node
+    };
+    StackEntry stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, 0.0f };
+
+    bool intersects = false;
+    float bestDistance = FLT_MAX;
+    while (stackSize > 0) {
+        StackEntry entry = stack[--stackSize];
+        if (entry.distance > bestDistance) {
+            continue;
+        }
+        const BVHNode& node = _bvhNodes[entry.node];
+
+        float childDistances[BVH_WIDTH];
+        for (int child = 0; child < BVH_WIDTH; ++child) {
+            float x0 = (node.minX[child] - origin.x) * inverseDirection.x;
+            float x1 = (node.maxX[child] - origin.x) * inverseDirection.x;
+            float y0 = (node.minY[child] - origin.y) * inverseDirection.y;
+            float y1 = (node.maxY[child] - origin.y) * inverseDirection.y;
+            float z0 = (node.minZ[child] - origin.z) * inverseDirection.z;
+            float z1 = (node.maxZ[child] - origin.z) * inverseDirection.z;
+            float childEntry = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::max(std::min(z0, z1), 0.0f));
+            float childExit = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::max(z0, z1));
+            bool hits = node.children[child] != -1 && childEntry <= childExit;
+            childDistances[child] = hits ? childEntry : FLT_MAX;
+        }
+
+        // order the children near to far
+        int order[BVH_WIDTH] = { 0, 1, 2, 3 };
+        for (int i = 1; i < BVH_WIDTH; ++i) {
+            for (int j = i; j > 0 && childDistances[order[j]] < childDistances[order[j - 1]]; --j) {
+                std::swap(order[j], order[j - 1]);
+            }
+        }
+
+        // test the leaves right away, near to far, so that the best distance culls as much as it can...
+        for (int i = 0; i < BVH_WIDTH; ++i) {
+            int child = order[i];
+            if (childDistances[child] == FLT_MAX || childDistances[child] > bestDistance) {
+                break;
+            }
+            for (int t = 0; t < node.numTriangles[child]; ++t) {
+                const Triangle& thisTriangle = _triangles[node.children[child] + t];
+                float thisTriangleDistance;
+                if (findRayTriangleIntersection(origin, direction, thisTriangle, thisTriangleDistance, allowBackface) &&
+                        thisTriangleDistance < bestDistance) {
+                    bestDistance = thisTriangleDistance;
+                    triangle = thisTriangle;
+                    intersects = true;
+                }
+            }
+        }
+
+        // ...then push the nodes far to near, so that the nearest is visited next
+        for (int i = BVH_WIDTH - 1; i >= 0; --i) {
+            int child = order[i];
+            if (node.numTriangles[child] == 0 && childDistances[child] != FLT_MAX &&
+                    childDistances[child] <= bestDistance) {
+                assert(stackSize < BVH_STACK_SIZE);
+                stack[stackSize++] = { node.children[child], childDistances[child] };
+            }
+        }
+    }
+
+    if (intersects) {
+        distance = bestDistance;
+    }
+    return intersects;
+}
+
+bool TriangleSet::findParabolaIntersectionInBVH(const glm::vec3& origin, const glm::vec3& velocity,
+        const glm::vec3& acceleration, float& parabolicDistance, Triangle& triangle, bool allowBackface) const {
+    int32_t stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    bool intersects = false;
+    float bestDistance = FLT_MAX;
+    while (stackSize > 0) {
+        const BVHNode& node = _bvhNodes[stack[--stackSize]];
+        for (int child = 0; child < BVH_WIDTH; ++child) {
+            if (node.children[child] == -1) {
+                continue;
+            }
+            AABox bounds = getBVHChildBounds(node.minX[child], node.minY[child], node.minZ[child],
+                node.maxX[child], node.maxY[child], node.maxZ[child]);
+            float boxDistance = FLT_MAX;
+            BoxFace face;
+            glm::vec3 normal;
+            if (!bounds.findParabolaIntersection(origin, velocity, acceleration, boxDistance, face, normal) ||
+                    (!bounds.contains(origin) && boxDistance > bestDistance)) {
+                continue;
+            }
+
+            if (node.numTriangles[child] == 0) {
+                assert(stackSize < BVH_STACK_SIZE);
+                stack[stackSize++] = node.children[child];
+                continue;
+            }
+            for (int t = 0; t < node.numTriangles[child]; ++t) {
+                const Triangle& thisTriangle = _triangles[node.children[child] + t];
+                float thisTriangleDistance;
+                if (findParabolaTriangleIntersection(origin, velocity, acceleration, thisTriangle, thisTriangleDistance,
+                        allowBackface) && thisTriangleDistance < bestDistance) {
+                    bestDistance = thisTriangleDistance;
+                    triangle = thisTriangle;
+                    intersects = true;
+                }
+            }
+        }
+    }
+
+    if (intersects) {
+        parabolicDistance = bestDistance;
+    }
+    return intersects;
+}
+
+void TriangleSet::findRayIntersectionsInBVH(RayPacket& packet, uint32_t activeLanes, bool allowBackface) const {
+    struct StackEntry {
+        int32_t node;
+        uint32_t activeLanes; // that hit the bounds of the node
+    };
+    StackEntry stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, activeLanes };
+
+    while (stackSize > 0) {
+        StackEntry entry = stack[--stackSize];
+        const BVHNode& node = _bvhNodes[entry.node];
+        for (int child = 0; child < BVH_WIDTH; ++child) {
+            if (node.children[child] == -1) {
+                continue;
+            }
+            uint32_t childLanes = findRayPacketBoxHits(packet,
+                glm::vec3(node.minX[child], node.minY[child], node.minZ[child]),
+                glm::vec3(node.maxX[child], node.maxY[child], node.maxZ[child]), entry.activeLanes);
+            if (!childLanes) {
+                continue;
+            }
+
+            if (node.numTriangles[child] == 0) {
+                assert(stackSize < BVH_STACK_SIZE);
+                stack[stackSize++] = { node.children[child], childLanes };
+                continue;
+            }
+            for (int t = 0; t < node.numTriangles[child]; ++t) {
+                int triangleIndex = node.children[child] + t;
+                findRayPacketTriangleIntersections(packet, _triangles[triangleIndex], triangleIndex, childLanes,
+                    allowBackface);
+            }
+        }
+    }
+}
+
+void TriangleSet::findParabolaIntersectionsInBVH(ParabolaPacket& packet, uint32_t activeLanes, bool allowBackface) const {
+    struct StackEntry {
+        int32_t node;
+        uint32_t activeLanes;
+    };
+    StackEntry stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, activeLanes };
+
+    while (stackSize > 0) {
+        StackEntry entry = stack[--stackSize];
+        const BVHNode& node = _bvhNodes[entry.node];
+        for (int child = 0; child < BVH_WIDTH; ++child) {
+            if (node.children[child] == -1) {
+                continue;
+            }
+            AABox bounds = getBVHChildBounds(node.minX[child], node.minY[child], node.minZ[child],
+                node.maxX[child], node.maxY[child], node.maxZ[child]);
+            uint32_t childLanes = entry.activeLanes;
+            for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+                if (!(childLanes & (1 << lane))) {
+                    continue;
+                }
+                float boxDistance = FLT_MAX;
+                BoxFace face;
+                glm::vec3 normal;
+                if (!bounds.findParabolaIntersection(packet.origin[lane], packet.velocity[lane], packet.acceleration[lane],
+                        boxDistance, face, normal) ||
+                        (!bounds.contains(packet.origin[lane]) && boxDistance > packet.parabolicDistance[lane])) {
+                    childLanes &= ~(1 << lane);
+                }
+            }
+            if (!childLanes) {
+                continue;
+            }
+
+            if (node.numTriangles[child] == 0) {
+                assert(stackSize < BVH_STACK_SIZE);
+                stack[stackSize++] = { node.children[child], childLanes };
+                continue;
+            }
+            for (int t = 0; t < node.numTriangles[child]; ++t) {
+                const Triangle& triangle = _triangles[node.children[child] + t];
+                for (int lane = 0; lane < PICK_PACKET_SIZE; ++lane) {
+                    float parabolicDistance;
+                    if ((childLanes & (1 << lane)) &&
+                            findParabolaTriangleIntersection(packet.origin[lane], packet.velocity[lane],
+                                packet.acceleration[lane], triangle, parabolicDistance, allowBackface) &&
+                            parabolicDistance < packet.parabolicDistance[lane]) {
+                        packet.parabolicDistance[lane] = parabolicDistance;
+                        packet.triangle[lane] = node.children[child] + t;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -11,12 +11,19 @@
 
 #pragma once
 
+#include <cfloat>
 #include <vector>
 
 #include "AABox.h"
 #include "GeometryUtil.h"
 
+class PickRay;
+class PickParabola;
+
 class TriangleSet {
+    struct RayPacket;
+    struct ParabolaPacket;
+    struct BVHBuild;
 
     class TriangleOctreeCell {
     public:
@@ -35,6 +42,10 @@ class TriangleSet {
             float& parabolicDistance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
             bool allowBackface = false);
 
+        // test every active lane of a packet against this cell and its children, keeping the nearest triangle per lane
+        void findRayIntersections(RayPacket& packet, uint32_t activeLanes, bool allowBackface) const;
+        void findParabolaIntersections(ParabolaPacket& packet, uint32_t activeLanes, bool allowBackface) const;
+
         const AABox& getBounds() const { return _bounds; }
 
         void debugDump();
@@ -74,8 +85,27 @@ public:
     bool findParabolaIntersection(const glm::vec3& origin, const glm::vec3& velocity, const glm::vec3& acceleration,
         float& parabolicDistance, BoxFace& face, Triangle& triangle, bool precision, bool allowBackface = false);
 
+    // the result of one pick of a batch
+    struct Intersection {
+        bool intersects { false };
+        float distance { FLT_MAX }; // parabolic distance, for parabolas
+        Triangle triangle;
+    };
+
+    // Batched picking: each packet of picks is tested against the set in a single walk of the BVH or octree, and
+    // large batches are spread across threads.  Batched picks always test the triangles, as precision picks do.
+    void findRayIntersections(const std::vector<PickRay>& rays, std::vector<Intersection>& intersections,
+        bool allowBackface = false);
+    void findParabolaIntersections(const std::vector<PickParabola>& parabolas, std::vector<Intersection>& intersections,
+        bool allowBackface = false);
+
     void balanceOctree();
 
+    // Builds a flattened BVH (4 children per node, split by the surface area heuristic) that is then used for every
+    // query in place of the octree.  This reorders the triangles, and inserting another triangle drops the BVH.
+    void buildBVH();
+    bool hasBVH() const { return _hasBVH; }
+
     void reserve(size_t size) { _triangles.reserve(size); } // reserve space in the datastructure for size number of triangles
     size_t size() const { return _triangles.size(); }
     void clear();
@@ -87,9 +117,44 @@ public:
     const AABox& getBounds() const { return _bounds; }
 
 protected:
+    static const int BVH_WIDTH = 4;
+
+    class BVHNode {
+    public:
+        BVHNode();
+
+        // bounds of the children, SoA so that a ray is tested against all of them at once
+        float minX[BVH_WIDTH];
+        float minY[BVH_WIDTH];
+        float minZ[BVH_WIDTH];
+        float maxX[BVH_WIDTH];
+        float maxY[BVH_WIDTH];
+        float maxZ[BVH_WIDTH];
+        int32_t children[BVH_WIDTH]; // index of the child node, or of the first triangle of a leaf, or -1 when empty
+        uint8_t numTriangles[BVH_WIDTH]; // of a leaf, or 0 for a node
+    };
+
+    int32_t buildBVHNode(BVHBuild& build, uint32_t begin, uint32_t end, int depth);
+
+    // the BVH only answers precision picks, imprecise picks only test the bounds of the set, as the octree does
+    bool findRayIntersectionInBVH(const glm::vec3& origin, const glm::vec3& direction,
+        float& distance, Triangle& triangle, bool allowBackface) const;
+    bool findParabolaIntersectionInBVH(const glm::vec3& origin, const glm::vec3& velocity, const glm::vec3& acceleration,
+        float& parabolicDistance, Triangle& triangle, bool allowBackface) const;
+    void findRayIntersectionsInBVH(RayPacket& packet, uint32_t activeLanes, bool allowBackface) const;
+    void findParabolaIntersectionsInBVH(ParabolaPacket& packet, uint32_t activeLanes, bool allowBackface) const;
+
+    // packet tests shared by the octree and the BVH
+    static uint32_t findRayPacketBoxHits(const RayPacket& packet, const glm::vec3& minimum, const glm::vec3& maximum,
+        uint32_t activeLanes);
+    static void findRayPacketTriangleIntersections(RayPacket& packet, const Triangle& triangle, int triangleIndex,
+        uint32_t activeLanes, bool allowBackface);
 
     bool _isBalanced{ false };
     std::vector<Triangle> _triangles;
     TriangleOctreeCell _triangleOctree;
     AABox _bounds;
+
+    bool _hasBVH { false };
+    std::vector<BVHNode> _bvhNodes; // the root is the first node
 };
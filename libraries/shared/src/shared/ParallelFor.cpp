@@ -0,0 +1,97 @@
+//
+//  ParallelFor.cpp
+//  libraries/shared/src/shared
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+namespace {
+
+// the ranges of one parallelFor call, claimed in order by the caller and the pool threads
+struct ParallelForRanges {
+    const std::function<void(size_t, size_t)>* function;
+    size_t numItems;
+    size_t itemsPerRange;
+    size_t numRanges;
+
+    std::atomic<size_t> nextRange { 0 };
+    std::mutex mutex;
+    std::condition_variable rangesDone;
+    size_t numRangesDone { 0 };
+
+    void run() {
+        // the function is only called for a claimed range, and the caller waits for every claimed range,
+        // so threads that start late never touch it
+        size_t range;
+        while ((range = nextRange++) < numRanges) {
+            size_t begin = range * itemsPerRange;
+            (*function)(begin, std::min(begin + itemsPerRange, numItems));
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++numRangesDone == numRanges) {
+                rangesDone.notify_all();
+            }
+        }
+    }
+};
+
+class ParallelForTask : public QRunnable {
+public:
+    ParallelForTask(const std::shared_ptr<ParallelForRanges>& ranges) : _ranges(ranges) {}
+    void run() override { _ranges->run(); }
+
+private:
+    std::shared_ptr<ParallelForRanges> _ranges;
+};
+
+QThreadPool& getParallelForPool() {
+    // kept apart from the global pool, whose threads block on loads
+    static QThreadPool pool;
+    static std::once_flag once;
+    std::call_once(once, [] {
+        pool.setMaxThreadCount(std::max(QThread::idealThreadCount(), 1));
+    });
+    return pool;
+}
+
+}
+
+void parallelFor(size_t numItems, size_t minItemsPerTask, const std::function<void(size_t, size_t)>& function) {
+    auto& pool = getParallelForPool();
+    size_t numTasks = std::min(numItems / std::max(minItemsPerTask, (size_t)1), (size_t)pool.maxThreadCount());
+    if (numTasks < 2) {
+        if (numItems > 0) {
+            function(0, numItems);
+        }
+        return;
+    }
+
+    auto ranges = std::make_shared<ParallelForRanges>();
+    ranges->function = &function;
+    ranges->numItems = numItems;
+    ranges->itemsPerRange = (numItems + numTasks - 1) / numTasks;
+    ranges->numRanges = (numItems + ranges->itemsPerRange - 1) / ranges->itemsPerRange;
+
+    for (size_t task = 1; task < ranges->numRanges; ++task) {
+        pool.start(new ParallelForTask(ranges));
+    }
+    ranges->run();
+
+    std::unique_lock<std::mutex> lock(ranges->mutex);
+    ranges->rangesDone.wait(lock, [&] { return ranges->numRangesDone == ranges->numRanges; });
+}
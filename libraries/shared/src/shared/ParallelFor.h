@@ -0,0 +1,24 @@
+//
+//  ParallelFor.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Shared_ParallelFor_h
+#define hifi_Shared_ParallelFor_h
+
+#include <cstddef>
+#include <functional>
+
+// Calls function(begin, end) over ranges covering [0, numItems), spreading them across a thread pool shared by every
+// caller when there are at least minItemsPerTask items for each thread.  Returns once every range is done.
+// The calling thread works through the ranges too, and runs any that no pool thread has picked up yet, so callers
+// never wait on a busy pool, and may themselves run on a pool thread.
+void parallelFor(size_t numItems, size_t minItemsPerTask, const std::function<void(size_t, size_t)>& function);
+
+#endif // hifi_Shared_ParallelFor_h
@@ -13,6 +13,8 @@
 //
 
 #include "Space.h"
+#include <cfloat>
+#include <cmath>
 #include <cstring>
 #include <algorithm>
 
@@ -20,6 +22,19 @@
 
 using namespace workload;
 
+// proxies are reclassified in blocks of this many, laid out SoA so the region tests vectorize
+static const uint32_t CLASSIFY_BLOCK_SIZE = 64;
+
+// the accumulated view drift is rebased once past this, to keep its float precision
+static const float MAX_VIEW_DRIFT = 1000.0f;
+
+// margin to the nearest region boundary is trimmed by this, to cover the rounding of the region tests
+static const float MARGIN_EPSILON = 0.001f;
+
+// a proxy that must be reclassified next frame, and one that never needs to be (it is dead)
+static const float RECLASSIFY_NOW = -FLT_MAX;
+static const float RECLASSIFY_NEVER = FLT_MAX;
+
 Space::Space() : Collection() {
 }
 
@@ -31,6 +46,7 @@ void Space::processTransactionFrame(const Transaction& transaction) {
     if (maxID > (Index) _proxies.size()) {
         _proxies.resize(maxID + 100); // allocate the maxId and more
         _owners.resize(maxID + 100);
+        _reclassifyDrifts.resize(maxID + 100, RECLASSIFY_NEVER);
     }
     // Now we know for sure that we have enough items in the array to
     // capture anything coming from the transaction
@@ -54,6 +70,7 @@ void Space::processResets(const Transaction::Resets& transactions) {
         // Reset the item with a new payload
         item.sphere = (std::get<1>(reset));
         item.prevRegion = item.region = Region::UNKNOWN;
+        _reclassifyDrifts[proxyID] = RECLASSIFY_NOW;
 
         _owners[proxyID] = (std::get<2>(reset));
     }
@@ -72,6 +89,7 @@ void Space::processRemoves(const Transaction::Removes& transactions) {
         // Kill it
         item.prevRegion = item.region = Region::INVALID;
         _owners[removedID] = Owner();
+        _reclassifyDrifts[removedID] = RECLASSIFY_NEVER;
     }
 }
 
@@ -87,37 +105,120 @@ void Space::processUpdates(const Transaction::Updates& transactions) {
 
         // Update the item
         item.sphere = (std::get<1>(update));
+        _reclassifyDrifts[updateID] = RECLASSIFY_NOW;
     }
 }
 
 void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
+
+    // proxies that changed region last frame have now settled in it
+    for (auto proxyID : _changedProxies) {
+        auto& proxy = _proxies[proxyID];
+        proxy.prevRegion = proxy.region;
+    }
+    _changedProxies.clear();
+
+    if (_viewDrift > MAX_VIEW_DRIFT) {
+        rebaseViewDrift();
+    }
+
+    // collect the proxies that moved, or that the views may have crossed
     uint32_t numProxies = (uint32_t)_proxies.size();
-    uint32_t numViews = (uint32_t)_views.size();
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        Proxy& proxy = _proxies[i];
-        if (proxy.region < Region::INVALID) {
-            glm::vec3 proxyCenter = glm::vec3(proxy.sphere);
-            float proxyRadius = proxy.sphere.w;
-            uint8_t region = Region::UNKNOWN;
-            for (uint32_t j = 0; j < numViews; ++j) {
-                auto& view = _views[j];
-                // for each 'view' we need only increment 'k' below the current value of 'region'
-                for (uint8_t k = 0; k < region; ++k) {
-                    float touchDistance = proxyRadius + view.regions[k].w;
-                    if (distance2(proxyCenter, glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
-                        region = k;
-                        break;
-                    }
-                }
+    _candidates.clear();
+    if (_reclassifyAll) {
+        for (uint32_t i = 0; i < numProxies; ++i) {
+            if (_proxies[i].region < Region::INVALID) {
+                _candidates.push_back((int32_t)i);
             }
-            proxy.prevRegion = proxy.region;
-            proxy.region = region;
-            if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+        }
+        _reclassifyAll = false;
+    } else {
+        const float* reclassifyDrifts = _reclassifyDrifts.data();
+        float viewDrift = _viewDrift;
+        for (uint32_t i = 0; i < numProxies; ++i) {
+            if (reclassifyDrifts[i] <= viewDrift) {
+                _candidates.push_back((int32_t)i);
+            }
+        }
+    }
+
+    uint32_t numCandidates = (uint32_t)_candidates.size();
+    for (uint32_t i = 0; i < numCandidates; i += CLASSIFY_BLOCK_SIZE) {
+        categorizeCandidates(i, std::min(i + CLASSIFY_BLOCK_SIZE, numCandidates), changes);
+    }
+}
+
+void Space::categorizeCandidates(uint32_t begin, uint32_t end, std::vector<Space::Change>& changes) {
+    struct ClassifyBlock {
+        float x[CLASSIFY_BLOCK_SIZE];
+        float y[CLASSIFY_BLOCK_SIZE];
+        float z[CLASSIFY_BLOCK_SIZE];
+        float radius[CLASSIFY_BLOCK_SIZE];
+        float margin[CLASSIFY_BLOCK_SIZE];
+        uint8_t region[CLASSIFY_BLOCK_SIZE];
+    };
+    ClassifyBlock block;
+
+    uint32_t numLanes = end - begin;
+    for (uint32_t i = 0; i < numLanes; ++i) {
+        const Sphere& sphere = _proxies[_candidates[begin + i]].sphere;
+        block.x[i] = sphere.x;
+        block.y[i] = sphere.y;
+        block.z[i] = sphere.z;
+        block.radius[i] = sphere.w;
+        block.margin[i] = FLT_MAX;
+        block.region[i] = Region::UNKNOWN;
+    }
+
+    // test from the outer regions in, so that the innermost region touched by any view wins,
+    // and track the distance to the nearest region boundary of any view
+    uint32_t numViews = (uint32_t)_views.size();
+    for (int32_t k = Region::NUM_VIEW_REGIONS - 1; k >= 0; --k) {
+        for (uint32_t j = 0; j < numViews; ++j) {
+            uint32_t r = k * numViews + j;
+            float regionX = _regionXs[r];
+            float regionY = _regionYs[r];
+            float regionZ = _regionZs[r];
+            float regionRadius = _regionRadiuses[r];
+            for (uint32_t i = 0; i < numLanes; ++i) {
+                float dx = block.x[i] - regionX;
+                float dy = block.y[i] - regionY;
+                float dz = block.z[i] - regionZ;
+                float distanceSquared = dx * dx + dy * dy + dz * dz;
+                float touchDistance = block.radius[i] + regionRadius;
+                bool touches = distanceSquared < touchDistance * touchDistance;
+                block.region[i] = touches ? (uint8_t)k : block.region[i];
+                block.margin[i] = std::min(block.margin[i], std::abs(std::sqrt(distanceSquared) - touchDistance));
             }
         }
     }
+
+    for (uint32_t i = 0; i < numLanes; ++i) {
+        int32_t proxyID = _candidates[begin + i];
+        Proxy& proxy = _proxies[proxyID];
+        if (proxy.region >= Region::INVALID) {
+            // updated after it was removed
+            _reclassifyDrifts[proxyID] = RECLASSIFY_NEVER;
+            continue;
+        }
+
+        _reclassifyDrifts[proxyID] = _viewDrift + block.margin[i] - MARGIN_EPSILON;
+        proxy.prevRegion = proxy.region;
+        proxy.region = block.region[i];
+        if (proxy.region != proxy.prevRegion) {
+            changes.emplace_back(Space::Change(proxyID, proxy.region, proxy.prevRegion));
+            _changedProxies.push_back(proxyID);
+        }
+    }
+}
+
+void Space::rebaseViewDrift() {
+    // RECLASSIFY_NOW and RECLASSIFY_NEVER are unchanged by this
+    for (auto& reclassifyDrift : _reclassifyDrifts) {
+        reclassifyDrift -= _viewDrift;
+    }
+    _viewDrift = 0.0f;
 }
 
 uint32_t Space::copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const {
@@ -149,11 +250,53 @@ void Space::clear() {
     _IDAllocator.clear();
     _proxies.clear();
     _owners.clear();
+    _reclassifyDrifts.clear();
+    _candidates.clear();
+    _changedProxies.clear();
+    _viewDrift = 0.0f;
+    _reclassifyAll = true;
     _views.clear();
+    _regionXs.clear();
+    _regionYs.clear();
+    _regionZs.clear();
+    _regionRadiuses.clear();
 }
 
 void Space::setViews(const Views& views) {
+    std::unique_lock<std::mutex> lock(_proxiesMutex);
+    uint32_t numViews = (uint32_t)views.size();
+    if (numViews != (uint32_t)_views.size()) {
+        _reclassifyAll = true;
+    } else {
+        // no region boundary has moved by more than the furthest any region moved or grew
+        float drift = 0.0f;
+        for (uint32_t j = 0; j < numViews; ++j) {
+            for (uint32_t k = 0; k < Region::NUM_VIEW_REGIONS; ++k) {
+                const Sphere& prevRegion = _views[j].regions[k];
+                const Sphere& region = views[j].regions[k];
+                float regionDrift = glm::distance(glm::vec3(prevRegion), glm::vec3(region)) + std::abs(region.w - prevRegion.w);
+                drift = std::max(drift, regionDrift);
+            }
+        }
+        _viewDrift += drift;
+    }
     _views = views;
+
+    uint32_t numRegions = Region::NUM_VIEW_REGIONS * numViews;
+    _regionXs.resize(numRegions);
+    _regionYs.resize(numRegions);
+    _regionZs.resize(numRegions);
+    _regionRadiuses.resize(numRegions);
+    for (uint32_t k = 0; k < Region::NUM_VIEW_REGIONS; ++k) {
+        for (uint32_t j = 0; j < numViews; ++j) {
+            const Sphere& region = _views[j].regions[k];
+            uint32_t r = k * numViews + j;
+            _regionXs[r] = region.x;
+            _regionYs[r] = region.y;
+            _regionZs[r] = region.z;
+            _regionRadiuses[r] = region.w;
+        }
+    }
 }
 
 void Space::copyViews(std::vector<View>& copy) const {
@@ -59,11 +59,30 @@ private:
     void processRemoves(const Transaction::Removes& transactions);
     void processUpdates(const Transaction::Updates& transactions);
 
+    // reclassify the proxies in [begin, end) of _candidates, appending any changes
+    void categorizeCandidates(uint32_t begin, uint32_t end, std::vector<Change>& changes);
+    void rebaseViewDrift();
+
     // The database of proxies is protected for editing by a mutex
     mutable std::mutex _proxiesMutex;
     Proxy::Vector _proxies;
     std::vector<Owner> _owners;
 
+    // A proxy's region can only change once it moves, or once the views have moved (or resized) by more than
+    // the distance between the proxy and its nearest region boundary.  So each proxy keeps the value of
+    // _viewDrift at which it must be reclassified, and categorizeAndGetChanges() only revisits those proxies.
+    std::vector<float> _reclassifyDrifts; // per proxy, -FLT_MAX once it moved, FLT_MAX when dead
+    std::vector<int32_t> _candidates; // scratch, proxies reclassified this frame
+    std::vector<int32_t> _changedProxies; // proxies whose region changed last frame, and need prevRegion reset
+    float _viewDrift { 0.0f }; // accumulated view motion
+    bool _reclassifyAll { true };
+
+    // The view regions flattened SoA, by region then view
+    std::vector<float> _regionXs;
+    std::vector<float> _regionYs;
+    std::vector<float> _regionZs;
+    std::vector<float> _regionRadiuses;
+
     Views _views;
 };
 
@@ -42,4 +42,5 @@ function filter(properties, type, originalProperties) {
     return properties;
 }
 filter.wantsOriginalProperties = "position";
+filter.wantsToFilterProperties = "position"; // only run on edits that change the position
 filter;
\ No newline at end of file
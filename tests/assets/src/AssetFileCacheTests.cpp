@@ -0,0 +1,142 @@
+//
+//  AssetFileCacheTests.cpp
+//  tests/assets/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileCacheTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <AssetFileCache.h>
+
+QTEST_GUILESS_MAIN(AssetFileCacheTests)
+
+static const qint64 LARGE_ASSET_SIZE = AssetFileCache::MAX_IN_MEMORY_ASSET_SIZE + 1;
+static const qint64 SMALL_ASSET_SIZE = AssetFileCache::MAX_IN_MEMORY_ASSET_SIZE / 4;
+
+static QByteArray writeAsset(const QDir& dir, const QString& hash, qint64 size, char fill) {
+    QByteArray contents(size, fill);
+    QFile file(dir.filePath(hash));
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != size) {
+        return QByteArray();
+    }
+    return contents;
+}
+
+static bool isCached(const AssetFileCache& cache, const QString& hash) {
+    return cache.getStats(INT_MAX)["Hot Assets"].toObject()[hash].toObject()["5. Cached"].toBool();
+}
+
+static int getStat(const AssetFileCache& cache, const QString& name) {
+    return cache.getStats(0)[name].toInt();
+}
+
+void AssetFileCacheTests::lruEviction() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir filesDirectory(dir.path());
+    writeAsset(filesDirectory, "a", LARGE_ASSET_SIZE, 'a');
+    writeAsset(filesDirectory, "b", LARGE_ASSET_SIZE, 'b');
+    writeAsset(filesDirectory, "c", LARGE_ASSET_SIZE, 'c');
+
+    AssetFileCache cache(filesDirectory, 2 * LARGE_ASSET_SIZE);
+    auto a = cache.getAsset("a");
+    QVERIFY(a && a->isMapped());
+    cache.getAsset("b");
+    QVERIFY(cache.getAsset("a") == a);
+
+    // "b" is now the least recently used
+    cache.getAsset("c");
+    QVERIFY(isCached(cache, "a"));
+    QVERIFY(!isCached(cache, "b"));
+    QVERIFY(isCached(cache, "c"));
+    QCOMPARE(getStat(cache, "1. Cached Assets"), 2);
+
+    // an evicted mapping stays valid for as long as it is held
+    cache.getAsset("b");
+    QVERIFY(!isCached(cache, "a"));
+    QCOMPARE(a->data()[LARGE_ASSET_SIZE - 1], 'a');
+
+    // assets larger than the whole cache are handed out but never cached
+    writeAsset(filesDirectory, "huge", 3 * LARGE_ASSET_SIZE, 'h');
+    QVERIFY(cache.getAsset("huge"));
+    QVERIFY(!isCached(cache, "huge"));
+    QVERIFY(isCached(cache, "b"));
+}
+
+void AssetFileCacheTests::mappedFileLimit() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir filesDirectory(dir.path());
+
+    const int MAX_MAPPED_FILES = 4;
+    const int NUM_ASSETS = 2 * MAX_MAPPED_FILES;
+    AssetFileCache cache(filesDirectory, NUM_ASSETS * LARGE_ASSET_SIZE, MAX_MAPPED_FILES);
+    for (int i = 0; i < NUM_ASSETS; ++i) {
+        auto hash = QString::number(i);
+        writeAsset(filesDirectory, hash, LARGE_ASSET_SIZE, 'x');
+        QVERIFY(cache.getAsset(hash));
+        QVERIFY(getStat(cache, "4. Mapped Files") <= MAX_MAPPED_FILES);
+    }
+
+    // the byte limit would fit every asset, but only the most recent ones keep a file open
+    QCOMPARE(getStat(cache, "4. Mapped Files"), MAX_MAPPED_FILES);
+    for (int i = 0; i < NUM_ASSETS; ++i) {
+        QCOMPARE(isCached(cache, QString::number(i)), i >= NUM_ASSETS - MAX_MAPPED_FILES);
+    }
+}
+
+void AssetFileCacheTests::smallAssetsInMemory() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir filesDirectory(dir.path());
+
+    const int MAX_MAPPED_FILES = 2;
+    const int NUM_ASSETS = 4 * MAX_MAPPED_FILES;
+    AssetFileCache cache(filesDirectory, NUM_ASSETS * SMALL_ASSET_SIZE, MAX_MAPPED_FILES);
+    for (int i = 0; i < NUM_ASSETS; ++i) {
+        auto hash = QString::number(i);
+        auto contents = writeAsset(filesDirectory, hash, SMALL_ASSET_SIZE, 'a' + i);
+        auto asset = cache.getAsset(hash);
+        QVERIFY(asset && !asset->isMapped());
+        QCOMPARE(QByteArray(asset->data(), asset->size()), contents);
+    }
+
+    QCOMPARE(getStat(cache, "1. Cached Assets"), NUM_ASSETS);
+    QCOMPARE(getStat(cache, "4. Mapped Files"), 0);
+
+    writeAsset(filesDirectory, "empty", 0, 'e');
+    auto empty = cache.getAsset("empty");
+    QVERIFY(empty && !empty->isMapped());
+    QCOMPARE(empty->size(), (qint64)0);
+}
+
+void AssetFileCacheTests::invalidate() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir filesDirectory(dir.path());
+
+    AssetFileCache cache(filesDirectory, 4 * LARGE_ASSET_SIZE);
+    QVERIFY(!cache.getAsset("missing"));
+
+    writeAsset(filesDirectory, "a", LARGE_ASSET_SIZE, 'a');
+    auto original = cache.getAsset("a");
+    QVERIFY(original);
+    QCOMPARE(getStat(cache, "4. Mapped Files"), 1);
+
+    cache.invalidate("a");
+    QCOMPARE(getStat(cache, "1. Cached Assets"), 0);
+    QCOMPARE(getStat(cache, "4. Mapped Files"), 0);
+
+    original.reset();
+    writeAsset(filesDirectory, "a", SMALL_ASSET_SIZE, 'b');
+    auto rewritten = cache.getAsset("a");
+    QVERIFY(rewritten);
+    QCOMPARE(rewritten->size(), SMALL_ASSET_SIZE);
+    QCOMPARE(rewritten->data()[0], 'b');
+}
@@ -0,0 +1,32 @@
+//
+//  AssetFileCacheTests.h
+//  tests/assets/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileCacheTests_h
+#define hifi_AssetFileCacheTests_h
+
+#include <QtTest/QtTest>
+
+class AssetFileCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test the least recently used asset is evicted first when over the byte limit
+    void lruEviction();
+
+    // Test mapped assets are evicted when over the open file limit
+    void mappedFileLimit();
+
+    // Test small assets are copied into memory and don't count against the open file limit
+    void smallAssetsInMemory();
+
+    // Test invalidated and missing assets are reloaded from disk
+    void invalidate();
+};
+
+#endif // hifi_AssetFileCacheTests_h
@@ -0,0 +1,110 @@
+//
+//  AudioMixerSharedMixesTests.cpp
+//  tests/audio-mixer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerSharedMixesTests.h"
+
+#include <cmath>
+
+#include <AudioMixerSharedMixes.h>
+
+QTEST_MAIN(AudioMixerSharedMixesTests)
+
+static const QUuid NODE_ID { QUuid::createUuid() };
+
+static AudioMixerSharedMixes::Key makeKey(const QString& codecName = "pcm", int gainStep = 0) {
+    return { codecName, NODE_ID, QUuid(), gainStep };
+}
+
+// encodes a payload naming the frame and the listener that encoded it, and counts the encodes
+class CountingEncoder {
+public:
+    std::function<void(QByteArray&)> forListener(int listener, unsigned int frame) {
+        return [this, listener, frame](QByteArray& payload) {
+            ++numEncodes;
+            payload = QByteArray::number(frame) + ":" + QByteArray::number(listener);
+        };
+    }
+
+    int numEncodes { 0 };
+};
+
+void AudioMixerSharedMixesTests::encodeOncePerFrame() {
+    AudioMixerSharedMixes sharedMixes;
+    CountingEncoder encoder;
+    auto key = makeKey();
+
+    const int NUM_LISTENERS = 4;
+    for (unsigned int frame = 1; frame <= 3; ++frame) {
+        for (int listener = 0; listener < NUM_LISTENERS; ++listener) {
+            auto payload = sharedMixes.encode(key, frame, encoder.forListener(listener, frame));
+            QCOMPARE(payload, QByteArray::number(frame) + ":0");
+        }
+        QCOMPARE(encoder.numEncodes, (int)frame);
+        sharedMixes.prune(frame);
+    }
+    QCOMPARE(sharedMixes.getNumGroups(), 1);
+}
+
+void AudioMixerSharedMixesTests::separateGroups() {
+    AudioMixerSharedMixes sharedMixes;
+    CountingEncoder encoder;
+    const unsigned int FRAME = 1;
+
+    auto pcmPayload = sharedMixes.encode(makeKey("pcm"), FRAME, encoder.forListener(0, FRAME));
+    auto zlibPayload = sharedMixes.encode(makeKey("zlib"), FRAME, encoder.forListener(1, FRAME));
+    auto quieterPayload = sharedMixes.encode(makeKey("pcm", -1), FRAME, encoder.forListener(2, FRAME));
+    auto otherStreamKey = makeKey();
+    otherStreamKey.streamID = QUuid::createUuid();
+    auto otherStreamPayload = sharedMixes.encode(otherStreamKey, FRAME, encoder.forListener(3, FRAME));
+
+    QCOMPARE(encoder.numEncodes, 4);
+    QCOMPARE(sharedMixes.getNumGroups(), 4);
+    QCOMPARE(pcmPayload, QByteArray("1:0"));
+    QCOMPARE(zlibPayload, QByteArray("1:1"));
+    QCOMPARE(quieterPayload, QByteArray("1:2"));
+    QCOMPARE(otherStreamPayload, QByteArray("1:3"));
+}
+
+void AudioMixerSharedMixesTests::prune() {
+    AudioMixerSharedMixes sharedMixes;
+    CountingEncoder encoder;
+    auto kept = makeKey("pcm");
+    auto dropped = makeKey("zlib");
+
+    sharedMixes.encode(kept, 1, encoder.forListener(0, 1));
+    sharedMixes.encode(dropped, 1, encoder.forListener(1, 1));
+    sharedMixes.prune(1);
+    QCOMPARE(sharedMixes.getNumGroups(), 2);
+
+    sharedMixes.encode(kept, 2, encoder.forListener(0, 2));
+    sharedMixes.prune(2);
+    QCOMPARE(sharedMixes.getNumGroups(), 1);
+
+    // a group that comes back is encoded again, by whichever listener asks first
+    auto payload = sharedMixes.encode(dropped, 3, encoder.forListener(2, 3));
+    QCOMPARE(payload, QByteArray("3:2"));
+    QCOMPARE(encoder.numEncodes, 4);
+}
+
+void AudioMixerSharedMixesTests::quantizeGain() {
+    QCOMPARE(AudioMixerSharedMixes::quantizeGain(1.0f), 0);
+    QCOMPARE(AudioMixerSharedMixes::dequantizeGain(AudioMixerSharedMixes::quantizeGain(0.0f)), 0.0f);
+
+    // within a quarter of a decibel
+    const float MAX_STEP_RATIO = std::pow(10.0f, 0.25f / 20.0f);
+    for (float gain : { 0.001f, 0.1f, 0.5f, 0.9f, 1.0f, 2.0f }) {
+        float dequantized = AudioMixerSharedMixes::dequantizeGain(AudioMixerSharedMixes::quantizeGain(gain));
+        QVERIFY(dequantized / gain < MAX_STEP_RATIO);
+        QVERIFY(gain / dequantized < MAX_STEP_RATIO);
+    }
+
+    // listeners at nearly the same distance share a step
+    QCOMPARE(AudioMixerSharedMixes::quantizeGain(0.5f), AudioMixerSharedMixes::quantizeGain(0.501f));
+}
@@ -0,0 +1,30 @@
+//
+//  AudioMixerSharedMixesTests.h
+//  tests/audio-mixer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSharedMixesTests_h
+#define hifi_AudioMixerSharedMixesTests_h
+
+#include <QtTest/QtTest>
+
+class AudioMixerSharedMixesTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    // every listener of a group gets the payload encoded by the first one to ask, once per frame
+    void encodeOncePerFrame();
+    // listeners with a different codec, stream, or gain step don't share a payload
+    void separateGroups();
+    // groups not mixed in a frame are released, and start over when they come back
+    void prune();
+    // gains within a step share a mix, and dequantize to within a step of the original
+    void quantizeGain();
+};
+
+#endif // hifi_AudioMixerSharedMixesTests_h
@@ -0,0 +1,118 @@
+//
+//  AudioHRTFTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioHRTFTests.h"
+
+#include <iostream>
+
+#include <AudioHRTF.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioHRTFTests)
+
+const int HRTF_INDEX = 1;
+const int NUM_SOURCES = 9;
+const int NUM_BLOCKS = 50;
+
+static void generateNoise(int16_t* samples, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = (int16_t)((rand() % 20000) - 10000);
+    }
+}
+
+void AudioHRTFTests::testBatchMatchesRender() {
+    AudioHRTF perSource[NUM_SOURCES];
+    AudioHRTF batched[NUM_SOURCES];
+    AudioHRTFBatch batch;
+
+    float azimuth[NUM_SOURCES];
+    float distance[NUM_SOURCES];
+    for (int j = 0; j < NUM_SOURCES; j++) {
+        azimuth[j] = 6.0f * ((float)rand() / (float)RAND_MAX) - 3.0f;
+        distance[j] = 0.2f + (float)j;  // covers the near-field and distance filters
+    }
+
+    int16_t input[NUM_SOURCES][HRTF_BLOCK];
+    float expected[2 * HRTF_BLOCK];
+    float actual[2 * HRTF_BLOCK];
+
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        memset(expected, 0, sizeof(expected));
+        memset(actual, 0, sizeof(actual));
+
+        for (int j = 0; j < NUM_SOURCES; j++) {
+            // move some of the sources, so both the paired and crossfaded paths are used
+            if ((block % 10 == 0) && (j % 3 == 0)) {
+                azimuth[j] *= 0.9f;
+            }
+            generateNoise(input[j], HRTF_BLOCK);
+
+            perSource[j].render(input[j], expected, HRTF_INDEX, azimuth[j], distance[j], 0.5f, HRTF_BLOCK);
+            batch.add(batched[j], input[j], azimuth[j], distance[j], 0.5f);
+        }
+        batch.render(actual, HRTF_INDEX, HRTF_BLOCK);
+        QCOMPARE(batch.size(), 0);
+
+        // the batch sums sources in a different order, so allow for rounding
+        const float EPSILON = 1.0e-5f;
+        for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+            QVERIFY(fabsf(expected[i] - actual[i]) < EPSILON);
+        }
+    }
+}
+
+#ifdef MANUAL_TEST
+
+void AudioHRTFTests::benchmark() {
+    const int numSources[] = { 10, 40, 80, 160 };
+    const int numTests = 4;
+    const int NUM_MIXES = 1000;
+
+    int16_t input[HRTF_BLOCK];
+    generateNoise(input, HRTF_BLOCK);
+    float output[2 * HRTF_BLOCK];
+
+    std::cout << "[numSources, perSourceMixesPerSec, batchedMixesPerSec] = [" << std::endl;
+    for (int i = 0; i < numTests; ++i) {
+        int n = numSources[i];
+        std::vector<AudioHRTF> perSource(n);
+        std::vector<AudioHRTF> batched(n);
+        AudioHRTFBatch batch;
+
+        // stationary sources spread around the listener
+        auto azimuthFor = [&](int j) { return 6.0f * (float)j / (float)n - 3.0f; };
+
+        uint64_t startTime = usecTimestampNow();
+        for (int mix = 0; mix < NUM_MIXES; ++mix) {
+            memset(output, 0, sizeof(output));
+            for (int j = 0; j < n; ++j) {
+                perSource[j].render(input, output, HRTF_INDEX, azimuthFor(j), 3.0f, 0.5f, HRTF_BLOCK);
+            }
+        }
+        uint64_t perSourceUsec = usecTimestampNow() - startTime;
+
+        startTime = usecTimestampNow();
+        for (int mix = 0; mix < NUM_MIXES; ++mix) {
+            memset(output, 0, sizeof(output));
+            for (int j = 0; j < n; ++j) {
+                batch.add(batched[j], input, azimuthFor(j), 3.0f, 0.5f);
+            }
+            batch.render(output, HRTF_INDEX, HRTF_BLOCK);
+        }
+        uint64_t batchedUsec = usecTimestampNow() - startTime;
+
+        std::cout << "    " << n << ", "
+            << (NUM_MIXES * USECS_PER_SECOND / std::max(perSourceUsec, (uint64_t)1)) << ", "
+            << (NUM_MIXES * USECS_PER_SECOND / std::max(batchedUsec, (uint64_t)1)) << std::endl;
+    }
+    std::cout << "];" << std::endl;
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,332 @@
+//
+//  FBXReaderTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXReaderTests.h"
+
+#include <iostream>
+#include <memory>
+
+#include <QBuffer>
+#include <QDirIterator>
+#include <QTemporaryFile>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <FBXReader.h>
+#include <FBXWriter.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(FBXReaderTests)
+
+// a document with every property type, and arrays large enough to be written compressed
+static FBXNode createDocument() {
+    const int NUM_VALUES = 4096;
+    QVector<double> vertices;
+    QVector<qint32> indices;
+    QVector<float> weights;
+    QVector<qint64> ids;
+    for (int i = 0; i < NUM_VALUES; ++i) {
+        vertices.push_back(0.5 * i);
+        indices.push_back(i % 7 == 6 ? -(i + 1) : i);
+        weights.push_back(1.0f / (i + 1));
+        ids.push_back((qint64)i << 33);
+    }
+    // too short to be compressed
+    QVector<qint32> edges { 0, 1, 2, 3 };
+
+    FBXNode mesh;
+    mesh.name = "Geometry";
+    mesh.properties << QVariant::fromValue((qint64)1234567890123LL) << QByteArray("Geometry::Body") << QByteArray("Mesh");
+
+    FBXNode verticesNode;
+    verticesNode.name = "Vertices";
+    verticesNode.properties << QVariant::fromValue(vertices);
+    mesh.children << verticesNode;
+
+    FBXNode indicesNode;
+    indicesNode.name = "PolygonVertexIndex";
+    indicesNode.properties << QVariant::fromValue(indices);
+    mesh.children << indicesNode;
+
+    FBXNode edgesNode;
+    edgesNode.name = "Edges";
+    edgesNode.properties << QVariant::fromValue(edges);
+    mesh.children << edgesNode;
+
+    FBXNode weightsNode;
+    weightsNode.name = "Weights";
+    weightsNode.properties << QVariant::fromValue(weights) << QVariant::fromValue(ids);
+    mesh.children << weightsNode;
+
+    FBXNode scalars;
+    scalars.name = "P";
+    scalars.properties << QVariant::fromValue((qint16)-7) << QVariant::fromValue(true) << QVariant::fromValue(42) <<
+        QVariant::fromValue(1.5f) << QVariant::fromValue(-2.25);
+    mesh.children << scalars;
+
+    FBXNode objects;
+    objects.name = "Objects";
+    objects.children << mesh;
+
+    FBXNode root;
+    root.children << objects;
+    return root;
+}
+
+template <typename T>
+static bool compareVectors(const QVariant& a, const QVariant& b) {
+    return a.value<QVector<T>>() == b.value<QVector<T>>();
+}
+
+static bool compareNodes(const FBXNode& a, const FBXNode& b) {
+    if (a.name != b.name || a.properties.size() != b.properties.size() || a.children.size() != b.children.size()) {
+        qDebug() << "node mismatch" << a.name << b.name;
+        return false;
+    }
+    for (int i = 0; i < a.properties.size(); ++i) {
+        const QVariant& propertyA = a.properties.at(i);
+        const QVariant& propertyB = b.properties.at(i);
+        if (propertyA.userType() != propertyB.userType()) {
+            qDebug() << "property type mismatch" << a.name << i << propertyA.typeName() << propertyB.typeName();
+            return false;
+        }
+        bool isEqual;
+        int type = propertyA.userType();
+        if (type == qMetaTypeId<QVector<double>>()) {
+            isEqual = compareVectors<double>(propertyA, propertyB);
+        } else if (type == qMetaTypeId<QVector<float>>()) {
+            isEqual = compareVectors<float>(propertyA, propertyB);
+        } else if (type == qMetaTypeId<QVector<qint32>>()) {
+            isEqual = compareVectors<qint32>(propertyA, propertyB);
+        } else if (type == qMetaTypeId<QVector<qint64>>()) {
+            isEqual = compareVectors<qint64>(propertyA, propertyB);
+        } else {
+            isEqual = (propertyA == propertyB);
+        }
+        if (!isEqual) {
+            qDebug() << "property mismatch" << a.name << i;
+            return false;
+        }
+    }
+    for (int i = 0; i < a.children.size(); ++i) {
+        if (!compareNodes(a.children.at(i), b.children.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FBXReaderTests::parseBufferTest() {
+    FBXNode document = createDocument();
+    QByteArray encoded = FBXWriter::encodeFBX(document);
+
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::ReadOnly);
+    FBXNode parsed = FBXReader::parseFBX(&buffer);
+    QVERIFY(compareNodes(document, parsed));
+}
+
+void FBXReaderTests::parseFileTest() {
+    FBXNode document = createDocument();
+    QByteArray encoded = FBXWriter::encodeFBX(document);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(encoded), (qint64)encoded.size());
+    QVERIFY(file.seek(0));
+
+    FBXNode parsed = FBXReader::parseFBX(&file);
+    QVERIFY(compareNodes(document, parsed));
+}
+
+void FBXReaderTests::truncatedTest() {
+    QByteArray encoded = FBXWriter::encodeFBX(createDocument());
+
+    // cut off in the middle of the vertices
+    const int TRUNCATED_SIZE = 200;
+    QVERIFY(encoded.size() > TRUNCATED_SIZE);
+    encoded.truncate(TRUNCATED_SIZE);
+
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::ReadOnly);
+    bool isCorrupt = false;
+    try {
+        FBXReader::parseFBX(&buffer);
+    } catch (const QString& error) {
+        isCorrupt = true;
+    }
+    QVERIFY(isCorrupt);
+}
+
+// the tangent of each edge, as originally computed, accumulated onto its first vertex
+static void addReferenceTangent(const glm::vec3& first, const glm::vec3& second, const glm::vec3& normal,
+                                const glm::vec2& firstTexCoord, const glm::vec2& secondTexCoord, glm::vec3& tangent) {
+    glm::vec3 bitangent = glm::cross(normal, second - first);
+    if (glm::length(bitangent) < EPSILON) {
+        return;
+    }
+    glm::vec2 texCoordDelta = secondTexCoord - firstTexCoord;
+    glm::vec3 normalizedNormal = glm::normalize(normal);
+    tangent += glm::cross(glm::angleAxis(-atan2f(-texCoordDelta.t, texCoordDelta.s), normalizedNormal) *
+                          glm::normalize(bitangent), normalizedNormal);
+}
+
+static bool compareTangents(const QVector<glm::vec3>& a, const QVector<glm::vec3>& b) {
+    const float TANGENT_TOLERANCE = 1.0e-4f;
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.size(); ++i) {
+        if (glm::length(a[i] - b[i]) > TANGENT_TOLERANCE * std::max(1.0f, glm::length(b[i]))) {
+            qDebug() << "tangent mismatch" << i << a[i].x << a[i].y << a[i].z << b[i].x << b[i].y << b[i].z;
+            return false;
+        }
+    }
+    return true;
+}
+
+void FBXReaderTests::tangentsTest() {
+    // a bumpy grid, more than one block of edges
+    const int GRID_SIZE = 24;
+    FBXMesh mesh;
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            float height = 0.1f * sinf(0.7f * x) * cosf(0.3f * y);
+            mesh.vertices.push_back(glm::vec3(x, y, height));
+            mesh.normals.push_back(glm::normalize(glm::vec3(-0.07f * cosf(0.7f * x), 0.03f * sinf(0.3f * y), 1.0f)));
+            mesh.texCoords.push_back(glm::vec2(x, y * 1.5f) / (float)GRID_SIZE);
+        }
+    }
+    FBXMeshPart quads;
+    FBXMeshPart triangles;
+    for (int y = 0; y < GRID_SIZE - 1; ++y) {
+        for (int x = 0; x < GRID_SIZE - 1; ++x) {
+            int index = y * GRID_SIZE + x;
+            if ((x + y) % 2) {
+                quads.quadIndices << index << index + 1 << index + GRID_SIZE + 1 << index + GRID_SIZE;
+            } else {
+                triangles.triangleIndices << index << index + 1 << index + GRID_SIZE + 1;
+                triangles.triangleIndices << index << index + GRID_SIZE + 1 << index + GRID_SIZE;
+            }
+        }
+    }
+    mesh.parts << quads << triangles;
+
+    // a blendshape moving every third vertex
+    FBXBlendshape blendshape;
+    for (int i = 0; i < mesh.vertices.size(); i += 3) {
+        blendshape.indices.push_back(i);
+        blendshape.vertices.push_back(mesh.vertices[i] + glm::vec3(0.0f, 0.0f, 0.5f));
+        blendshape.normals.push_back(glm::normalize(mesh.normals[i] + glm::vec3(0.2f, 0.0f, 0.0f)));
+    }
+    mesh.blendshapes << blendshape;
+
+    // the expected tangents
+    QVector<glm::vec3> meshTangents(mesh.vertices.size());
+    QVector<glm::vec3> blendshapeTangents(blendshape.vertices.size());
+    QHash<int, int> blendshapeIndices;
+    for (int i = 0; i < blendshape.indices.size(); ++i) {
+        blendshapeIndices.insert(blendshape.indices[i], i);
+    }
+    auto addEdge = [&](int first, int second) {
+        addReferenceTangent(mesh.vertices[first], mesh.vertices[second], mesh.normals[first],
+                            mesh.texCoords[first], mesh.texCoords[second], meshTangents[first]);
+        if (blendshapeIndices.contains(first)) {
+            int index = blendshapeIndices.value(first);
+            glm::vec3 secondVertex = blendshapeIndices.contains(second) ?
+                blendshape.vertices[blendshapeIndices.value(second)] : mesh.vertices[second];
+            addReferenceTangent(blendshape.vertices[index], secondVertex, blendshape.normals[index],
+                                mesh.texCoords[first], mesh.texCoords[second], blendshapeTangents[index]);
+        }
+    };
+    for (int i = 0; i < quads.quadIndices.size(); i += 4) {
+        for (int j = 0; j < 4; ++j) {
+            addEdge(quads.quadIndices[i + j], quads.quadIndices[i + (j + 1) % 4]);
+        }
+    }
+    for (int i = 0; i < triangles.triangleIndices.size(); i += 3) {
+        for (int j = 0; j < 3; ++j) {
+            addEdge(triangles.triangleIndices[i + j], triangles.triangleIndices[i + (j + 1) % 3]);
+        }
+    }
+
+    mesh.createTangents(true);
+    QVERIFY(compareTangents(mesh.tangents, meshTangents));
+    QVERIFY(compareTangents(mesh.blendshapes[0].tangents, blendshapeTangents));
+}
+
+#ifdef MANUAL_TEST
+
+void FBXReaderTests::benchmark() {
+    QString corpus = QProcessEnvironment::systemEnvironment().value("HIFI_FBX_CORPUS");
+    if (corpus.isEmpty()) {
+        QSKIP("set HIFI_FBX_CORPUS to a directory of .fbx files");
+    }
+
+    const int NUM_ITERATIONS = 5;
+    const float BYTES_PER_MEGABYTE = (float)(BYTES_PER_KILOBYTE * BYTES_PER_KILOBYTE);
+    quint64 totalParseTime = 0;
+    quint64 totalReadTime = 0;
+    qint64 totalSize = 0;
+    int numFiles = 0;
+
+    std::cout << "[file, sizeKB, parseMsecs, readMsecs] = [" << std::endl;
+    QDirIterator files(corpus, { "*.fbx" }, QDir::Files, QDirIterator::Subdirectories);
+    while (files.hasNext()) {
+        QString path = files.next();
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        // parsing alone, straight from the (mapped) file
+        quint64 parseTime = 0;
+        for (int i = 0; i < NUM_ITERATIONS; ++i) {
+            file.seek(0);
+            quint64 start = usecTimestampNow();
+            FBXNode root = FBXReader::parseFBX(&file);
+            parseTime += usecTimestampNow() - start;
+        }
+
+        // parsing and extracting the geometry
+        quint64 readTime = 0;
+        for (int i = 0; i < NUM_ITERATIONS; ++i) {
+            file.seek(0);
+            quint64 start = usecTimestampNow();
+            try {
+                std::unique_ptr<FBXGeometry> geometry { readFBX(&file, QVariantHash(), path) };
+            } catch (const QString& error) {
+                std::cout << "    // " << qPrintable(path) << ": " << qPrintable(error) << std::endl;
+            }
+            readTime += usecTimestampNow() - start;
+        }
+
+        parseTime /= NUM_ITERATIONS;
+        readTime /= NUM_ITERATIONS;
+        std::cout << "    \"" << qPrintable(QFileInfo(path).fileName()) << "\", " << file.size() / BYTES_PER_KILOBYTE << ", "
+            << (float)parseTime / USECS_PER_MSEC << ", " << (float)readTime / USECS_PER_MSEC << std::endl;
+
+        totalParseTime += parseTime;
+        totalReadTime += readTime;
+        totalSize += file.size();
+        ++numFiles;
+    }
+    std::cout << "];" << std::endl;
+
+    if (numFiles > 0) {
+        std::cout << "files: " << numFiles << ", MB: " << totalSize / BYTES_PER_MEGABYTE
+            << ", parse MB/s: " << totalSize / BYTES_PER_MEGABYTE / ((float)totalParseTime / USECS_PER_SECOND)
+            << ", read MB/s: " << totalSize / BYTES_PER_MEGABYTE / ((float)totalReadTime / USECS_PER_SECOND)
+            << std::endl;
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,39 @@
+//
+//  FBXReaderTests.h
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXReaderTests_h
+#define hifi_FBXReaderTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class FBXReaderTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test a written binary document parses back to the same nodes, from a buffer and from a (mapped) file
+    void parseBufferTest();
+    void parseFileTest();
+
+    // Test a truncated document is reported as corrupt
+    void truncatedTest();
+
+    // Test the mesh and blendshape tangents match the per-edge quaternion rotation they were computed with
+    void tangentsTest();
+
+#ifdef MANUAL_TEST
+    // Time loading every .fbx file under $HIFI_FBX_CORPUS (e.g. a directory of avatars)
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_FBXReaderTests_h
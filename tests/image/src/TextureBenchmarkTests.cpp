@@ -0,0 +1,131 @@
+//
+//  TextureBenchmarkTests.cpp
+//  tests/image/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureBenchmarkTests.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QImage>
+#include <QtTest/QtTest>
+
+#include <NumericalConstants.h>
+#include <image/Image.h>
+
+QTEST_GUILESS_MAIN(TextureBenchmarkTests)
+
+Q_DECLARE_METATYPE(image::TextureUsage::Type)
+
+static const int TEXTURE_SIZE = 512;
+static const int CUBE_FACE_SIZE = 128;
+static const int BENCHMARK_RUNS = 5;
+
+// A deterministic image with enough detail that the compressor can't take shortcuts on flat blocks
+static QImage createTestImage(image::TextureUsage::Type type) {
+    int width = TEXTURE_SIZE;
+    int height = TEXTURE_SIZE;
+    if (type == image::TextureUsage::CUBE_TEXTURE) {
+        // one face per row, the vertical cross layout the cube loader recognizes
+        width = CUBE_FACE_SIZE;
+        height = CUBE_FACE_SIZE * 6;
+    }
+
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        auto line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            int noise = (x * 7919 + y * 104729) % 64;
+            line[x] = qRgba((x + noise) % 256, (y + noise) % 256, (x ^ y) % 256, 255 - (x * y) % 32);
+        }
+    }
+    return image;
+}
+
+static gpu::TexturePointer loadTexture(image::TextureUsage::Type type) {
+    std::atomic<bool> abortProcessing { false };
+    auto loader = image::TextureUsage::getTextureLoaderForType(type);
+    return loader(createTestImage(type), "benchmark", true, abortProcessing);
+}
+
+static void addTextureTypeRows() {
+    using namespace image::TextureUsage;
+    QTest::addColumn<Type>("type");
+
+    QTest::newRow("default") << DEFAULT_TEXTURE;
+    QTest::newRow("strict") << STRICT_TEXTURE;
+    QTest::newRow("albedo") << ALBEDO_TEXTURE;
+    QTest::newRow("normal") << NORMAL_TEXTURE;
+    QTest::newRow("bump") << BUMP_TEXTURE;
+    QTest::newRow("specular") << SPECULAR_TEXTURE;
+    QTest::newRow("roughness") << ROUGHNESS_TEXTURE;
+    QTest::newRow("gloss") << GLOSS_TEXTURE;
+    QTest::newRow("emissive") << EMISSIVE_TEXTURE;
+    QTest::newRow("cube") << CUBE_TEXTURE;
+    QTest::newRow("occlusion") << OCCLUSION_TEXTURE;
+    QTest::newRow("lightmap") << LIGHTMAP_TEXTURE;
+}
+
+void TextureBenchmarkTests::initTestCase() {
+    _defaultThreadCount = image::getCompressionThreadCount();
+}
+
+void TextureBenchmarkTests::testParallelMatchesSerial_data() {
+    addTextureTypeRows();
+}
+
+void TextureBenchmarkTests::testParallelMatchesSerial() {
+    QFETCH(image::TextureUsage::Type, type);
+
+    image::setCompressionThreadCount(1);
+    auto serial = loadTexture(type);
+    image::setCompressionThreadCount(_defaultThreadCount);
+    auto parallel = loadTexture(type);
+
+    QVERIFY(serial);
+    QVERIFY(parallel);
+    QCOMPARE(parallel->getNumMips(), serial->getNumMips());
+
+    for (uint16 level = 0; level < serial->getNumMips(); ++level) {
+        for (uint8 face = 0; face < serial->getNumFaces(); ++face) {
+            QVERIFY(parallel->isStoredMipFaceAvailable(level, face) == serial->isStoredMipFaceAvailable(level, face));
+            if (!serial->isStoredMipFaceAvailable(level, face)) {
+                continue;
+            }
+            auto serialMip = serial->accessStoredMipFace(level, face);
+            auto parallelMip = parallel->accessStoredMipFace(level, face);
+            QCOMPARE(parallelMip->size(), serialMip->size());
+            QVERIFY(memcmp(parallelMip->data(), serialMip->data(), serialMip->size()) == 0);
+        }
+    }
+}
+
+void TextureBenchmarkTests::benchmarkTextureTypes_data() {
+    addTextureTypeRows();
+}
+
+void TextureBenchmarkTests::benchmarkTextureTypes() {
+    QFETCH(image::TextureUsage::Type, type);
+
+    auto testImage = createTestImage(type);
+    double megapixels = (double)testImage.width() * testImage.height() / (1000.0 * 1000.0);
+
+    image::setCompressionThreadCount(_defaultThreadCount);
+
+    QElapsedTimer timer;
+    qint64 totalNSecs = 0;
+    for (int i = 0; i < BENCHMARK_RUNS; ++i) {
+        timer.start();
+        auto texture = loadTexture(type);
+        totalNSecs += timer.nsecsElapsed();
+        QVERIFY(texture);
+    }
+
+    double seconds = (double)totalNSecs / BENCHMARK_RUNS / (NSECS_PER_MSEC * MSECS_PER_SECOND);
+    qInfo() << QTest::currentDataTag() << "-" << megapixels / seconds << "megapixels/sec on"
+        << _defaultThreadCount << "threads";
+}
@@ -0,0 +1,29 @@
+//
+//  TextureBenchmarkTests.h
+//  tests/image/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureBenchmarkTests_h
+#define hifi_TextureBenchmarkTests_h
+
+#include <QtCore/QObject>
+
+class TextureBenchmarkTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testParallelMatchesSerial_data();
+    void testParallelMatchesSerial();
+    void benchmarkTextureTypes_data();
+    void benchmarkTextureTypes();
+
+private:
+    int _defaultThreadCount { 1 };
+};
+
+#endif // hifi_TextureBenchmarkTests_h
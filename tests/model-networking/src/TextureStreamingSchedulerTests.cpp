@@ -0,0 +1,207 @@
+//
+//  TextureStreamingSchedulerTests.cpp
+//  tests/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureStreamingSchedulerTests.h"
+
+#include <model-networking/TextureStreamingScheduler.h>
+
+QTEST_GUILESS_MAIN(TextureStreamingSchedulerTests)
+
+static const qint64 MIP_BYTES = 1024;
+static const uint16_t NUM_MIPS = 4;
+static const uint16_t EVICTION_MIP_LEVEL = 2;
+
+// A texture whose mips all cost the same, and whose requests finish when the test says so
+class FakeTexture : public StreamedTexture {
+public:
+    FakeTexture(TextureStreamingScheduler& scheduler, QStringList& events, const QString& name, float importance,
+                uint16_t minMipLevel, const std::string& contentHash = std::string()) :
+        _scheduler(scheduler), _events(events), _name(name), _importance(importance), _minMipLevel(minMipLevel),
+        _contentHash(contentHash) {}
+    ~FakeTexture() { _scheduler.removeTexture(this); }
+
+    float getImportance() const override { return _importance; }
+    const std::string& getContentHash() const override { return _contentHash; }
+    uint16_t getMinAvailableMipLevel() const override { return _minMipLevel; }
+    qint64 getResidentMipBytes() const override { return (NUM_MIPS - _minMipLevel) * MIP_BYTES; }
+
+    bool wantsNextMip() const override { return !_isRequesting && (isEvicted() || _minMipLevel > 0); }
+    qint64 getNextMipBytes() const override {
+        return isEvicted() ? (EVICTION_MIP_LEVEL - _mipLevelBeforeEviction) * MIP_BYTES : MIP_BYTES;
+    }
+    void startScheduledMipRequest(qint64) override {
+        _isRequesting = true;
+        _events << "request " + _name;
+    }
+
+    bool canEvictHighMips() const override { return !isEvicted() && !_isRequesting && _minMipLevel < EVICTION_MIP_LEVEL; }
+    bool isEvicted() const override { return _isEvicted; }
+    qint64 evictHighMips() override {
+        auto bytes = (EVICTION_MIP_LEVEL - _minMipLevel) * MIP_BYTES;
+        _mipLevelBeforeEviction = _minMipLevel;
+        _minMipLevel = EVICTION_MIP_LEVEL;
+        _isEvicted = true;
+        _events << "evict " + _name;
+        return bytes;
+    }
+    void restoreEvictedMips() override {
+        _minMipLevel = _mipLevelBeforeEviction;
+        _isEvicted = false;
+        _events << "restore " + _name;
+    }
+
+    bool isRequesting() const { return _isRequesting; }
+    void finishRequest() {
+        _isRequesting = false;
+        --_minMipLevel;
+        _scheduler.mipRequestFinished(MIP_BYTES, true);
+    }
+
+private:
+    TextureStreamingScheduler& _scheduler;
+    QStringList& _events;
+    QString _name;
+    float _importance;
+    uint16_t _minMipLevel;
+    std::string _contentHash;
+    uint16_t _mipLevelBeforeEviction { 0 };
+    bool _isEvicted { false };
+    bool _isRequesting { false };
+};
+using FakeTexturePointer = QSharedPointer<FakeTexture>;
+
+static void requestNextMip(TextureStreamingScheduler& scheduler, const FakeTexturePointer& texture) {
+    scheduler.requestNextMip(StreamedTextureWeakPointer(texture));
+}
+
+static int getStat(const TextureStreamingScheduler& scheduler, const QString& name) {
+    return scheduler.getStats()[name].toInt();
+}
+
+void TextureStreamingSchedulerTests::inFlightBudget() {
+    TextureStreamingScheduler scheduler;
+    scheduler.setInFlightByteBudget(MIP_BYTES);
+    QStringList events;
+
+    // keep the budget busy while the others queue up
+    auto first = FakeTexturePointer::create(scheduler, events, "first", 0.0f, NUM_MIPS - 1);
+    requestNextMip(scheduler, first);
+
+    QList<FakeTexturePointer> textures;
+    for (int i = 0; i < 4; ++i) {
+        textures << FakeTexturePointer::create(scheduler, events, QString::number(i), 0.1f * (i + 1), NUM_MIPS - 1);
+        requestNextMip(scheduler, textures.back());
+    }
+    QCOMPARE(events, QStringList({ "request first" }));
+    QCOMPARE(getStat(scheduler, "inFlightRequests"), 1);
+    QCOMPARE(getStat(scheduler, "inFlightBytes"), (int)MIP_BYTES);
+    QVERIFY(getStat(scheduler, "deferredForBandwidth") > 0);
+
+    // each finished request makes room for the most important texture still waiting
+    events.clear();
+    first->finishRequest();
+    QCOMPARE(events, QStringList({ "request 3" }));
+    for (int i = 3; i > 0; --i) {
+        events.clear();
+        textures[i]->finishRequest();
+        QCOMPARE(events, QStringList({ "request " + QString::number(i - 1) }));
+        QCOMPARE(getStat(scheduler, "inFlightRequests"), 1);
+    }
+    QCOMPARE(getStat(scheduler, "completedMips"), 4);
+}
+
+void TextureStreamingSchedulerTests::residentBudget() {
+    TextureStreamingScheduler scheduler;
+    QStringList events;
+
+    // nothing can be evicted from textures that only have their lowest mip
+    auto less = FakeTexturePointer::create(scheduler, events, "less", 0.1f, NUM_MIPS - 1);
+    auto more = FakeTexturePointer::create(scheduler, events, "more", 0.5f, NUM_MIPS - 1);
+    scheduler.addTexture(StreamedTextureWeakPointer(less));
+    scheduler.addTexture(StreamedTextureWeakPointer(more));
+    scheduler.setResidentByteBudget(3 * MIP_BYTES);
+
+    requestNextMip(scheduler, more);
+    requestNextMip(scheduler, less);
+    QCOMPARE(events, QStringList({ "request more" }));
+    QVERIFY(getStat(scheduler, "deferredForMemory") > 0);
+
+    // the mip in flight counts as resident, so landing it doesn't make room
+    events.clear();
+    more->finishRequest();
+    QVERIFY(events.isEmpty());
+    QCOMPARE(getStat(scheduler, "residentBytes"), (int)(3 * MIP_BYTES));
+
+    scheduler.setResidentByteBudget(4 * MIP_BYTES);
+    scheduler.update();
+    QCOMPARE(events, QStringList({ "request less" }));
+}
+
+void TextureStreamingSchedulerTests::evictionOrder() {
+    TextureStreamingScheduler scheduler;
+    QStringList events;
+
+    auto least = FakeTexturePointer::create(scheduler, events, "least", 0.1f, 0);
+    auto less = FakeTexturePointer::create(scheduler, events, "less", 0.2f, 0);
+    auto most = FakeTexturePointer::create(scheduler, events, "most", 0.9f, 1);
+    scheduler.addTexture(StreamedTextureWeakPointer(least));
+    scheduler.addTexture(StreamedTextureWeakPointer(less));
+    scheduler.setResidentByteBudget(least->getResidentMipBytes() + less->getResidentMipBytes() +
+        most->getResidentMipBytes());
+
+    // one mip fits in what evicting the least important texture frees
+    requestNextMip(scheduler, most);
+    QCOMPARE(events, QStringList({ "evict least", "request most" }));
+    QVERIFY(least->isEvicted());
+    QVERIFY(!less->isEvicted());
+    most->finishRequest();
+
+    // evict both for a texture that needs more room
+    events.clear();
+    auto large = FakeTexturePointer::create(scheduler, events, "large", 0.8f, 1);
+    scheduler.addTexture(StreamedTextureWeakPointer(large));
+    scheduler.setResidentByteBudget(least->getResidentMipBytes() + less->getResidentMipBytes() +
+        most->getResidentMipBytes() + large->getResidentMipBytes());
+    requestNextMip(scheduler, large);
+    QCOMPARE(events, QStringList({ "evict less", "request large" }));
+    QCOMPARE(getStat(scheduler, "evictions"), 2);
+
+    // once there is room again, the evicted textures get their mips back, most important first
+    events.clear();
+    scheduler.setResidentByteBudget(TextureStreamingScheduler::DEFAULT_RESIDENT_BYTE_BUDGET);
+    scheduler.update();
+    QCOMPARE(events, QStringList({ "restore less", "restore least" }));
+    QCOMPARE(getStat(scheduler, "restores"), 2);
+    QVERIFY(!least->isEvicted() && !less->isEvicted());
+    QCOMPARE(least->getMinAvailableMipLevel(), (uint16_t)0);
+}
+
+void TextureStreamingSchedulerTests::sharedTexturesAreNotEvicted() {
+    TextureStreamingScheduler scheduler;
+    QStringList events;
+
+    auto shared = FakeTexturePointer::create(scheduler, events, "shared", 0.1f, 0, "hash");
+    auto sharing = FakeTexturePointer::create(scheduler, events, "sharing", 0.1f, 0, "hash");
+    auto waiting = FakeTexturePointer::create(scheduler, events, "waiting", 0.9f, 1);
+    scheduler.addTexture(StreamedTextureWeakPointer(shared));
+    scheduler.addTexture(StreamedTextureWeakPointer(sharing));
+    scheduler.setResidentByteBudget(shared->getResidentMipBytes() + sharing->getResidentMipBytes() +
+        waiting->getResidentMipBytes());
+
+    requestNextMip(scheduler, waiting);
+    QVERIFY(events.isEmpty());
+    QVERIFY(getStat(scheduler, "deferredForMemory") > 0);
+
+    // once the gpu texture has a single user, it can be evicted
+    sharing.reset();
+    scheduler.setResidentByteBudget(shared->getResidentMipBytes() + waiting->getResidentMipBytes());
+    scheduler.update();
+    QCOMPARE(events, QStringList({ "evict shared", "request waiting" }));
+}
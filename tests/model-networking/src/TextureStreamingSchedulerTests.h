@@ -0,0 +1,32 @@
+//
+//  TextureStreamingSchedulerTests.h
+//  tests/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureStreamingSchedulerTests_h
+#define hifi_TextureStreamingSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class TextureStreamingSchedulerTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test the mips in flight stay within the in-flight budget, most important texture first
+    void inFlightBudget();
+
+    // Test textures wait when their mips don't fit in the resident budget and nothing can be evicted
+    void residentBudget();
+
+    // Test the least important textures are evicted first, and the most important evicted ones restored first
+    void evictionOrder();
+
+    // Test textures sharing their gpu texture are never evicted
+    void sharedTexturesAreNotEvicted();
+};
+
+#endif // hifi_TextureStreamingSchedulerTests_h
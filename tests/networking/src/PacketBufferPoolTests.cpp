@@ -0,0 +1,195 @@
+//
+//  PacketBufferPoolTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPoolTests.h"
+
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <NLPacket.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <udt/PacketBufferPool.h>
+
+QTEST_MAIN(PacketBufferPoolTests)
+
+using udt::PacketBufferPool;
+
+static int packetsFor(const char* owner) {
+    return PacketBufferPool::getStats()[owner].toObject()["packets"].toInt();
+}
+
+void PacketBufferPoolTests::recycleTest() {
+    auto buffer = PacketBufferPool::acquire();
+    QVERIFY(buffer.get() != nullptr);
+
+    int numPooled = PacketBufferPool::getNumPooledBuffers();
+    PacketBufferPool::release(std::move(buffer));
+    QCOMPARE(PacketBufferPool::getNumPooledBuffers(), numPooled + 1);
+
+    bool isRecycled = false;
+    buffer = PacketBufferPool::acquire(&isRecycled);
+    QVERIFY(isRecycled);
+    QCOMPARE(PacketBufferPool::getNumPooledBuffers(), numPooled);
+    PacketBufferPool::release(std::move(buffer));
+}
+
+void PacketBufferPoolTests::packetTest() {
+    PacketBufferPool::resetStats();
+
+    // a full-size packet draws from the pool, and comes back zeroed
+    {
+        auto packet = NLPacket::create(PacketType::Unknown);
+        QVERIFY(packet->isBufferPooled());
+        for (qint64 i = NLPacket::totalHeaderSize(PacketType::Unknown); i < packet->getDataSize(); ++i) {
+            QCOMPARE(packet->getData()[i], (char)0);
+        }
+    }
+    QCOMPARE(packetsFor("nl_packet"), 1);
+
+    // a moved buffer is only returned by the packet it moved to
+    {
+        auto packet = udt::Packet::create();
+        auto nlPacket = NLPacket::fromBase(std::move(packet));
+        QVERIFY(nlPacket->isBufferPooled());
+    }
+    QCOMPARE(packetsFor("packet"), 0);
+    QCOMPARE(packetsFor("nl_packet"), 2);
+
+    // a copy has a buffer of its own
+    {
+        auto packet = NLPacket::create(PacketType::Unknown);
+        packet->writePrimitive((uint32_t)0xdeadbeef);
+        auto copy = NLPacket::createCopy(*packet);
+        QVERIFY(copy->isBufferPooled());
+        QVERIFY(copy->getData() != packet->getData());
+        QCOMPARE(memcmp(copy->getData(), packet->getData(), packet->getDataSize()), 0);
+    }
+    QCOMPARE(packetsFor("nl_packet"), 4);
+
+    // a received buffer is only pooled if the receiver says so
+    {
+        auto packet = NLPacket::create(PacketType::Unknown);
+        auto size = packet->getDataSize();
+        auto data = std::unique_ptr<char[]>(new char[size]);
+        memcpy(data.get(), packet->getData(), size);
+        auto receivedPacket = NLPacket::fromReceivedPacket(std::move(data), size, HifiSockAddr());
+        QVERIFY(!receivedPacket->isBufferPooled());
+    }
+    QCOMPARE(packetsFor("nl_packet"), 5);
+}
+
+void PacketBufferPoolTests::concurrentTest() {
+    const int NUM_THREADS = 4;
+    const int NUM_ITERATIONS = 10000;
+    const int NUM_HELD = 4;
+
+    std::atomic<int> numCorrupted { 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            std::unique_ptr<char[]> buffers[NUM_HELD];
+            for (int i = 0; i < NUM_ITERATIONS; ++i) {
+                // no other thread may hold a buffer while this one does
+                for (auto& buffer : buffers) {
+                    buffer = PacketBufferPool::acquire();
+                    memset(buffer.get(), t, PacketBufferPool::BUFFER_SIZE);
+                }
+                std::this_thread::yield();
+                for (auto& buffer : buffers) {
+                    if (buffer[0] != (char)t || buffer[PacketBufferPool::BUFFER_SIZE - 1] != (char)t) {
+                        ++numCorrupted;
+                    }
+                    PacketBufferPool::release(std::move(buffer));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(numCorrupted.load(), 0);
+    QVERIFY(PacketBufferPool::getNumPooledBuffers() <= PacketBufferPool::MAX_POOLED_BUFFERS);
+}
+
+#ifdef MANUAL_TEST
+
+void PacketBufferPoolTests::benchmark() {
+    const int numThreads[] = { 1, 2, 4, 8 };
+    const int numTests = 4;
+    const int NUM_ITERATIONS = 1000000;
+    const int NUM_HELD = 8;
+
+    // allocations per second across all threads, for a functor allocating and freeing NUM_HELD buffers
+    auto measure = [&](int n, std::function<void()> functor) {
+        std::vector<std::thread> threads;
+        uint64_t startTime = usecTimestampNow();
+        for (int t = 0; t < n; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < NUM_ITERATIONS / NUM_HELD; ++i) {
+                    functor();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        uint64_t usecs = usecTimestampNow() - startTime;
+        return (uint64_t)n * NUM_ITERATIONS * USECS_PER_SECOND / std::max(usecs, (uint64_t)1);
+    };
+
+    std::cout << "[numThreads, heapAllocsPerSec, pooledAllocsPerSec, heapPacketsPerSec, pooledPacketsPerSec] = [" << std::endl;
+    for (int i = 0; i < numTests; ++i) {
+        int n = numThreads[i];
+
+        // before: each packet allocated (and zeroed) its own buffer
+        auto heapAllocs = measure(n, [] {
+            std::unique_ptr<char[]> buffers[NUM_HELD];
+            for (auto& buffer : buffers) {
+                buffer.reset(new char[udt::MAX_PACKET_SIZE]());
+            }
+        });
+
+        auto pooledAllocs = measure(n, [] {
+            std::unique_ptr<char[]> buffers[NUM_HELD];
+            for (auto& buffer : buffers) {
+                buffer = PacketBufferPool::acquire();
+                memset(buffer.get(), 0, udt::MAX_PACKET_SIZE);
+            }
+            for (auto& buffer : buffers) {
+                PacketBufferPool::release(std::move(buffer));
+            }
+        });
+
+        // larger than a pooled buffer, so always allocated
+        auto heapPackets = measure(n, [] {
+            std::unique_ptr<NLPacket> packets[NUM_HELD];
+            for (auto& packet : packets) {
+                packet = NLPacket::create(PacketType::MixedAudio, PacketBufferPool::BUFFER_SIZE);
+            }
+        });
+
+        auto pooledPackets = measure(n, [] {
+            std::unique_ptr<NLPacket> packets[NUM_HELD];
+            for (auto& packet : packets) {
+                packet = NLPacket::create(PacketType::MixedAudio);
+            }
+        });
+
+        std::cout << "    " << n << ", " << heapAllocs << ", " << pooledAllocs << ", "
+            << heapPackets << ", " << pooledPackets << std::endl;
+    }
+    std::cout << "];" << std::endl;
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,37 @@
+//
+//  PacketBufferPoolTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBufferPoolTests_h
+#define hifi_PacketBufferPoolTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class PacketBufferPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test a released buffer is handed out again
+    void recycleTest();
+
+    // Test packets return their buffers, including after being moved
+    void packetTest();
+
+    // Test acquiring and releasing from several threads
+    void concurrentTest();
+
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_PacketBufferPoolTests_h
@@ -0,0 +1,207 @@
+//
+//  OctreePersistTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreePersistTests.h"
+
+#include <QTemporaryDir>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <DependencyManager.h>
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <OctreeConstants.h>
+#include <OctreePersistThread.h>
+
+QTEST_MAIN(OctreePersistTests)
+
+// exposes the binary persistence steps, which otherwise only run once the domain-server has replied
+class TestPersistThread : public OctreePersistThread {
+public:
+    TestPersistThread(OctreePointer tree, const QString& filename) : OctreePersistThread(tree, filename) {}
+
+    using OctreePersistThread::writeBinarySnapshot;
+    using OctreePersistThread::appendBinaryJournal;
+    using OctreePersistThread::loadBinarySnapshot;
+};
+
+static EntityTreePointer createTree() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->setIsServer(true);
+    tree->createRootElement();
+    return tree;
+}
+
+static EntityItemID addBox(const EntityTreePointer& tree, const QString& name, const glm::vec3& position) {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setName(name);
+    properties.setPosition(position);
+
+    EntityItemID entityID(QUuid::createUuid());
+    tree->withWriteLock([&] {
+        tree->addEntity(entityID, properties);
+    });
+    return entityID;
+}
+
+static void rename(const EntityTreePointer& tree, const EntityItemID& entityID, const QString& name) {
+    EntityItemProperties properties;
+    properties.setName(name);
+    tree->withWriteLock([&] {
+        tree->updateEntity(entityID, properties);
+    });
+}
+
+// like OctreePersistThread::persist, each persist is a new data version
+static bool appendJournal(const EntityTreePointer& tree, TestPersistThread& persistThread) {
+    tree->incrementPersistDataVersion();
+    return persistThread.appendBinaryJournal();
+}
+
+static QMap<QUuid, QString> entityNames(const EntityTreePointer& tree) {
+    QMap<QUuid, QString> names;
+    QVector<EntityItemPointer> entities;
+    tree->withReadLock([&] {
+        tree->findEntities(glm::vec3(0.0f), (float)TREE_SCALE, entities);
+    });
+    for (auto& entity : entities) {
+        names[entity->getEntityItemID()] = entity->getName();
+    }
+    return names;
+}
+
+// loads the binary persist files into a new tree
+static EntityTreePointer reload(const QString& filename) {
+    EntityTreePointer tree = createTree();
+    TestPersistThread persistThread(tree, filename);
+    if (!persistThread.loadBinarySnapshot()) {
+        return EntityTreePointer();
+    }
+    return tree;
+}
+
+void OctreePersistTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer, INVALID_PORT);
+}
+
+void OctreePersistTests::snapshotRoundTrip() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filename = dir.filePath("models.json.gz");
+
+    EntityTreePointer tree = createTree();
+    QUuid persistID = QUuid::createUuid();
+    tree->setOctreeVersionInfo(persistID, 7);
+    auto first = addBox(tree, "first", glm::vec3(1.0f, 2.0f, 3.0f));
+    addBox(tree, "second", glm::vec3(-4.0f, 5.0f, -6.0f));
+    addBox(tree, "third", glm::vec3(0.0f));
+
+    TestPersistThread persistThread(tree, filename);
+    QVERIFY(persistThread.writeBinarySnapshot());
+    QVERIFY(QFile::exists(dir.filePath("models.bin")));
+    QVERIFY(QFile::exists(dir.filePath("models.journal")));
+
+    EntityTreePointer loaded = reload(filename);
+    QVERIFY(loaded);
+    QCOMPARE(entityNames(loaded), entityNames(tree));
+    QCOMPARE(loaded->getPersistID(), persistID);
+    QCOMPARE(loaded->getPersistDataVersion(), 7);
+
+    auto entity = loaded->findEntityByEntityItemID(first);
+    QVERIFY(entity);
+    QCOMPARE(entity->getType(), EntityTypes::Box);
+    QVERIFY(entity->getWorldPosition() == glm::vec3(1.0f, 2.0f, 3.0f));
+    QCOMPARE(entity->getCreated(), tree->findEntityByEntityItemID(first)->getCreated());
+}
+
+void OctreePersistTests::journalRoundTrip() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filename = dir.filePath("models.json.gz");
+
+    EntityTreePointer tree = createTree();
+    auto edited = addBox(tree, "edited", glm::vec3(1.0f));
+    auto deleted = addBox(tree, "deleted", glm::vec3(2.0f));
+    auto unchanged = addBox(tree, "unchanged", glm::vec3(3.0f));
+
+    TestPersistThread persistThread(tree, filename);
+    QVERIFY(persistThread.writeBinarySnapshot());
+
+    rename(tree, edited, "edited once");
+    auto added = addBox(tree, "added", glm::vec3(4.0f));
+    QVERIFY(appendJournal(tree, persistThread));
+
+    rename(tree, edited, "edited twice");
+    tree->withWriteLock([&] {
+        tree->deleteEntity(deleted, true);
+    });
+    QVERIFY(appendJournal(tree, persistThread));
+
+    EntityTreePointer loaded = reload(filename);
+    QVERIFY(loaded);
+    auto names = entityNames(loaded);
+    QCOMPARE(names, entityNames(tree));
+    QCOMPARE(names.size(), 3);
+    QCOMPARE(names.value(edited), QString("edited twice"));
+    QCOMPARE(names.value(unchanged), QString("unchanged"));
+    QCOMPARE(names.value(added), QString("added"));
+    QVERIFY(!names.contains(deleted));
+    QCOMPARE(loaded->getPersistDataVersion(), tree->getPersistDataVersion());
+}
+
+void OctreePersistTests::truncatedJournal() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filename = dir.filePath("models.json.gz");
+    QString journalFilename = dir.filePath("models.journal");
+
+    EntityTreePointer tree = createTree();
+    auto entityID = addBox(tree, "snapshot", glm::vec3(1.0f));
+
+    TestPersistThread persistThread(tree, filename);
+    QVERIFY(persistThread.writeBinarySnapshot());
+
+    rename(tree, entityID, "first record");
+    QVERIFY(appendJournal(tree, persistThread));
+    int firstRecordVersion = tree->getPersistDataVersion();
+    qint64 firstRecordEnd = QFileInfo(journalFilename).size();
+
+    rename(tree, entityID, "torn record");
+    QVERIFY(appendJournal(tree, persistThread));
+
+    // as if the server stopped part way through writing the last record
+    {
+        QFile journalFile(journalFilename);
+        QVERIFY(journalFile.resize(journalFile.size() - 3));
+    }
+
+    EntityTreePointer loaded = createTree();
+    {
+        TestPersistThread loadedPersistThread(loaded, filename);
+        QVERIFY(loadedPersistThread.loadBinarySnapshot());
+        QCOMPARE(entityNames(loaded).value(entityID), QString("first record"));
+        QCOMPARE(loaded->getPersistDataVersion(), firstRecordVersion);
+        QCOMPARE(QFileInfo(journalFilename).size(), firstRecordEnd);
+
+        // changes made after loading are appended after the last complete record, and load again
+        rename(loaded, entityID, "after reload");
+        QVERIFY(appendJournal(loaded, loadedPersistThread));
+    }
+
+    EntityTreePointer reloaded = reload(filename);
+    QVERIFY(reloaded);
+    QCOMPARE(entityNames(reloaded).value(entityID), QString("after reload"));
+    QCOMPARE(reloaded->getPersistDataVersion(), loaded->getPersistDataVersion());
+}
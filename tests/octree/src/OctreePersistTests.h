@@ -0,0 +1,30 @@
+//
+//  OctreePersistTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePersistTests_h
+#define hifi_OctreePersistTests_h
+
+#include <QtTest/QtTest>
+
+class OctreePersistTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // a tree loaded from a binary snapshot matches the tree that wrote it
+    void snapshotRoundTrip();
+    // edits, additions and deletions appended to the journal are applied on top of the snapshot
+    void journalRoundTrip();
+    // a torn last journal record is dropped, and the journal is truncated so that later changes still load
+    void truncatedJournal();
+};
+
+#endif // hifi_OctreePersistTests_h
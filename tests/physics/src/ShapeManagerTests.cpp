@@ -13,6 +13,10 @@
 
 #include <iostream>
 
+#include <QTemporaryDir>
+
+#include <ShapeCache.h>
+#include <ShapeFactory.h>
 #include <ShapeManager.h>
 #include <StreamUtils.h>
 #include <Extents.h>
@@ -244,3 +248,208 @@ void ShapeManagerTests::addCompoundShape() {
     QCOMPARE(shapeManager.getNumShapes(), 0);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 }
+
+// a compound of tetrahedral hulls of growing size, each with enough points to be reduced
+static void computeCompoundShapeInfo(ShapeInfo& info, int numHulls) {
+    ShapeInfo::PointCollection pointCollection;
+    Extents extents;
+    const int NUM_POINTS_PER_HULL = 2 * MAX_HULL_POINTS;
+    for (int i = 0; i < numHulls; ++i) {
+        glm::vec3 offset((float)(i - numHulls / 2), 0.0f, 0.0f);
+        float radius = (float)(i + 1);
+        ShapeInfo::PointList pointList;
+        for (int j = 0; j < NUM_POINTS_PER_HULL; ++j) {
+            // points on a sphere
+            float theta = (float)j * 2.39996f;
+            float z = 1.0f - 2.0f * ((float)j + 0.5f) / (float)NUM_POINTS_PER_HULL;
+            float r = sqrtf(1.0f - z * z);
+            glm::vec3 point = radius * glm::vec3(r * cosf(theta), r * sinf(theta), z) + offset;
+            pointList.push_back(point);
+            extents.addPoint(point);
+        }
+        pointCollection.push_back(pointList);
+    }
+    info.setParams(SHAPE_TYPE_COMPOUND, 0.5f * (extents.maximum - extents.minimum));
+    info.setPointCollection(pointCollection);
+}
+
+void ShapeManagerTests::requestCompoundShape() {
+    ShapeInfo info;
+    int numHulls = 5;
+    computeCompoundShapeInfo(info, numHulls);
+
+    // request the shape, and wait for it to be built
+    ShapeManager shapeManager;
+    ShapeManager::ShapeFuture future = shapeManager.requestShape(info);
+    future.waitForFinished();
+    QVERIFY(future.result() != nullptr);
+
+    // a second request shares the build
+    QCOMPARE(shapeManager.requestShape(info).result(), future.result());
+
+    // the built shape isn't managed until it is claimed
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+    const btCollisionShape* shape = shapeManager.getShape(info);
+    QCOMPARE(shape, future.result());
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+    QCOMPARE(shapeManager.getNumReferences(info), 1);
+    QCOMPARE(shape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    QCOMPARE(static_cast<const btCompoundShape*>(shape)->getNumChildShapes(), numHulls);
+
+    // requesting a managed shape returns it right away
+    ShapeManager::ShapeFuture otherFuture = shapeManager.requestShape(info);
+    QVERIFY(otherFuture.isFinished());
+    QCOMPARE(otherFuture.result(), shape);
+
+    // builds that are requested but not claimed yet are not collected
+    ShapeInfo otherInfo;
+    computeCompoundShapeInfo(otherInfo, numHulls + 1);
+    ShapeManager::ShapeFuture otherFuture = shapeManager.requestShape(otherInfo);
+    otherFuture.waitForFinished();
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getShape(otherInfo), otherFuture.result());
+    QCOMPARE(shapeManager.getNumShapes(), 2);
+    shapeManager.releaseShape(otherFuture.result());
+
+    // builds whose requests were all cancelled are collected
+    ShapeInfo cancelledInfo;
+    computeCompoundShapeInfo(cancelledInfo, numHulls + 2);
+    shapeManager.requestShape(cancelledInfo).waitForFinished();
+    shapeManager.cancelShapeRequest(cancelledInfo);
+    shapeManager.releaseShape(shape);
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
+
+void ShapeManagerTests::serializeCompoundShape() {
+    ShapeInfo info;
+    int numHulls = 3;
+    computeCompoundShapeInfo(info, numHulls);
+    info.setOffset(glm::vec3(0.0f, 1.0f, 0.0f));
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(shape != nullptr);
+
+    QByteArray data;
+    QVERIFY(ShapeFactory::serializeShape(shape, data));
+    const btCollisionShape* otherShape = ShapeFactory::deserializeShape(info, data);
+    QVERIFY(otherShape != nullptr);
+
+    // the hulls are read back as they were built, without being reduced again
+    QCOMPARE(otherShape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+    const btCompoundShape* otherCompound = static_cast<const btCompoundShape*>(otherShape);
+    QCOMPARE(otherCompound->getNumChildShapes(), numHulls);
+    for (int i = 0; i < numHulls; ++i) {
+        QCOMPARE(otherCompound->getChildTransform(i).getOrigin(), compound->getChildTransform(i).getOrigin());
+        const btConvexHullShape* hull = static_cast<const btConvexHullShape*>(compound->getChildShape(i));
+        const btConvexHullShape* otherHull = static_cast<const btConvexHullShape*>(otherCompound->getChildShape(i));
+        QCOMPARE(otherHull->getNumPoints(), hull->getNumPoints());
+        QCOMPARE(otherHull->getMargin(), hull->getMargin());
+        for (int j = 0; j < hull->getNumPoints(); ++j) {
+            QCOMPARE(otherHull->getUnscaledPoints()[j], hull->getUnscaledPoints()[j]);
+        }
+    }
+
+    // truncated data is rejected
+    data.chop(1);
+    QVERIFY(ShapeFactory::deserializeShape(info, data) == nullptr);
+
+    ShapeFactory::deleteShape(shape);
+    ShapeFactory::deleteShape(otherShape);
+}
+
+// a flat grid of triangles, with a bump in the middle
+static void computeStaticMeshShapeInfo(ShapeInfo& info) {
+    const int GRID_SIZE = 8;
+    ShapeInfo::PointList points;
+    Extents extents;
+    for (int i = 0; i <= GRID_SIZE; ++i) {
+        for (int j = 0; j <= GRID_SIZE; ++j) {
+            float height = (i == GRID_SIZE / 2 && j == GRID_SIZE / 2) ? 1.0f : 0.0f;
+            glm::vec3 point((float)i, height, (float)j);
+            points.push_back(point);
+            extents.addPoint(point);
+        }
+    }
+    ShapeInfo::PointCollection pointCollection;
+    pointCollection.push_back(points);
+
+    info.setParams(SHAPE_TYPE_STATIC_MESH, 0.5f * (extents.maximum - extents.minimum));
+    info.setPointCollection(pointCollection);
+    auto& triangleIndices = info.getTriangleIndices();
+    for (int i = 0; i < GRID_SIZE; ++i) {
+        for (int j = 0; j < GRID_SIZE; ++j) {
+            int32_t corner = i * (GRID_SIZE + 1) + j;
+            triangleIndices << corner << corner + 1 << corner + GRID_SIZE + 1;
+            triangleIndices << corner + 1 << corner + GRID_SIZE + 2 << corner + GRID_SIZE + 1;
+        }
+    }
+}
+
+static void compareAabbs(const btCollisionShape* shape, const btCollisionShape* otherShape) {
+    btTransform identity;
+    identity.setIdentity();
+    btVector3 minimum, maximum, otherMinimum, otherMaximum;
+    shape->getAabb(identity, minimum, maximum);
+    otherShape->getAabb(identity, otherMinimum, otherMaximum);
+    QCOMPARE(otherMinimum, minimum);
+    QCOMPARE(otherMaximum, maximum);
+}
+
+void ShapeManagerTests::cacheCompoundShape() {
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    ShapeCache shapeCache(cacheDir.path().toStdString());
+    shapeCache.initialize();
+
+    ShapeInfo info;
+    int numHulls = 3;
+    computeCompoundShapeInfo(info, numHulls);
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(shape != nullptr);
+    QVERIFY(shapeCache.readShape(info) == nullptr);
+    shapeCache.writeShape(info, shape);
+
+    const btCollisionShape* cachedShape = shapeCache.readShape(info);
+    QVERIFY(cachedShape != nullptr);
+    QCOMPARE(cachedShape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    QCOMPARE(static_cast<const btCompoundShape*>(cachedShape)->getNumChildShapes(), numHulls);
+    compareAabbs(shape, cachedShape);
+    ShapeFactory::deleteShape(cachedShape);
+
+    // the same model edited in place has the same url and extents, but must not get the old hulls
+    ShapeInfo editedInfo;
+    computeCompoundShapeInfo(editedInfo, numHulls);
+    editedInfo.getPointCollection()[0][0] *= 0.5f;
+    QVERIFY(shapeCache.readShape(editedInfo) == nullptr);
+
+    ShapeFactory::deleteShape(shape);
+}
+
+void ShapeManagerTests::cacheStaticMeshShape() {
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    ShapeCache shapeCache(cacheDir.path().toStdString());
+    shapeCache.initialize();
+
+    ShapeInfo info;
+    computeStaticMeshShapeInfo(info);
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(shape != nullptr);
+    shapeCache.writeShape(info, shape);
+
+    const btCollisionShape* cachedShape = shapeCache.readShape(info);
+    QVERIFY(cachedShape != nullptr);
+    QCOMPARE(cachedShape->getShapeType(), (int)TRIANGLE_MESH_SHAPE_PROXYTYPE);
+    compareAabbs(shape, cachedShape);
+    ShapeFactory::deleteShape(cachedShape);
+
+    // a BVH must never be read back for different triangles, even with the same points
+    ShapeInfo editedInfo;
+    computeStaticMeshShapeInfo(editedInfo);
+    auto& triangleIndices = editedInfo.getTriangleIndices();
+    std::swap(triangleIndices[1], triangleIndices[2]);
+    QVERIFY(shapeCache.readShape(editedInfo) == nullptr);
+
+    ShapeFactory::deleteShape(shape);
+}
@@ -25,6 +25,10 @@ private slots:
     void addCylinderShape();
     void addCapsuleShape();
     void addCompoundShape();
+    void requestCompoundShape();
+    void serializeCompoundShape();
+    void cacheCompoundShape();
+    void cacheStaticMeshShape();
 };
 
 #endif // hifi_ShapeManagerTests_h
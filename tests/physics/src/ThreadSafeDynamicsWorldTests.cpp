@@ -0,0 +1,142 @@
+//
+//  ThreadSafeDynamicsWorldTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ThreadSafeDynamicsWorldTests.h"
+
+#include <memory>
+#include <vector>
+
+#include <QThread>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <ThreadSafeDynamicsWorld.h>
+
+// Add additional qtest functionality (the include order is important!)
+#include "BulletTestUtils.h"
+#include <test-utils/QTestExtensions.h>
+
+QTEST_MAIN(ThreadSafeDynamicsWorldTests)
+
+// stacks of boxes on a static floor, with a kinematic slab resting across the first two stacks
+class BoxStacks {
+public:
+    static const int NUM_STACKS = 8;
+    static const int STACK_HEIGHT = 4;
+
+    BoxStacks(int numSolverThreads) :
+        _dispatcher(&_collisionConfig),
+        _world(&_dispatcher, &_broadphase, &_solver, &_collisionConfig),
+        _floorShape(btVector3(50.0f, 0.5f, 50.0f)),
+        _boxShape(btVector3(0.5f, 0.5f, 0.5f)),
+        _slabShape(btVector3(2.0f, 0.1f, 0.5f)) {
+        _world.setGravity(btVector3(0.0f, -9.8f, 0.0f));
+        _world.setNumSolverThreads(numSolverThreads);
+
+        addBody(&_floorShape, 0.0f, btVector3(0.0f, -0.5f, 0.0f));
+
+        const float STACK_SPACING = 3.0f;
+        const float BOX_SPACING = 1.01f;
+        for (int i = 0; i < NUM_STACKS; ++i) {
+            for (int j = 0; j < STACK_HEIGHT; ++j) {
+                // offset the boxes a little so that the stacks topple differently
+                btVector3 position((float)i * STACK_SPACING + 0.05f * (float)(j * i % 3), 0.5f + (float)j * BOX_SPACING, 0.0f);
+                _boxes.push_back(addBody(&_boxShape, 1.0f, position));
+            }
+        }
+
+        btVector3 slabPosition(0.5f * STACK_SPACING, (float)STACK_HEIGHT * BOX_SPACING + 0.1f, 0.0f);
+        addBody(&_slabShape, 0.0f, slabPosition, btCollisionObject::CF_KINEMATIC_OBJECT);
+    }
+
+    ~BoxStacks() {
+        for (auto& body : _bodies) {
+            _world.removeRigidBody(body.get());
+        }
+    }
+
+    void step(int numSubsteps) {
+        const float SUBSTEP = 1.0f / 60.0f;
+        for (int i = 0; i < numSubsteps; ++i) {
+            _world.stepSimulationWithSubstepCallback(SUBSTEP, 1, SUBSTEP);
+        }
+    }
+
+    ThreadSafeDynamicsWorld& getWorld() { return _world; }
+    const std::vector<btRigidBody*>& getBoxes() const { return _boxes; }
+
+private:
+    btRigidBody* addBody(btCollisionShape* shape, float mass, const btVector3& position, int flags = 0) {
+        btVector3 inertia(0.0f, 0.0f, 0.0f);
+        if (mass > 0.0f) {
+            shape->calculateLocalInertia(mass, inertia);
+        }
+        btRigidBody* body = new btRigidBody(mass, nullptr, shape, inertia);
+        body->setWorldTransform(btTransform(btQuaternion::getIdentity(), position));
+        if (flags) {
+            body->setCollisionFlags(flags);
+            body->setActivationState(DISABLE_DEACTIVATION);
+        }
+        _world.addRigidBody(body);
+        _bodies.emplace_back(body);
+        return body;
+    }
+
+    btDefaultCollisionConfiguration _collisionConfig;
+    btCollisionDispatcher _dispatcher;
+    btDbvtBroadphase _broadphase;
+    btSequentialImpulseConstraintSolver _solver;
+    ThreadSafeDynamicsWorld _world;
+    btBoxShape _floorShape;
+    btBoxShape _boxShape;
+    btBoxShape _slabShape;
+    std::vector<std::unique_ptr<btRigidBody>> _bodies;
+    std::vector<btRigidBody*> _boxes;
+};
+
+void ThreadSafeDynamicsWorldTests::testSolverThreads() {
+    BoxStacks stacks(1);
+    ThreadSafeDynamicsWorld& world = stacks.getWorld();
+    QCOMPARE(world.getNumSolverThreads(), 1);
+
+    // clamped to the number of cores
+    world.setNumSolverThreads(0);
+    QCOMPARE(world.getNumSolverThreads(), 1);
+    world.setNumSolverThreads(1000);
+    QCOMPARE(world.getNumSolverThreads(), std::max(QThread::idealThreadCount(), 1));
+
+    int numThreads = world.getNumSolverThreads();
+    stacks.step(10);
+    QCOMPARE((int)world.getSolverThreadTimes().size(), numThreads);
+}
+
+void ThreadSafeDynamicsWorldTests::testParallelIslands() {
+    const int NUM_THREADS = 4;
+    BoxStacks serialStacks(1);
+    BoxStacks parallelStacks(NUM_THREADS);
+    if (parallelStacks.getWorld().getNumSolverThreads() < 2) {
+        QSKIP("needs more than one core");
+    }
+
+    // islands are independent, so solving them apart gives the same result as solving them together
+    const int NUM_SUBSTEPS = 180;
+    serialStacks.step(NUM_SUBSTEPS);
+    parallelStacks.step(NUM_SUBSTEPS);
+
+    const auto& serialBoxes = serialStacks.getBoxes();
+    const auto& parallelBoxes = parallelStacks.getBoxes();
+    QCOMPARE(parallelBoxes.size(), serialBoxes.size());
+    const float ACCEPTABLE_ERROR = 1.0e-4f;
+    for (size_t i = 0; i < serialBoxes.size(); ++i) {
+        const btVector3& position = parallelBoxes[i]->getWorldTransform().getOrigin();
+        QCOMPARE_WITH_ABS_ERROR(position, serialBoxes[i]->getWorldTransform().getOrigin(), ACCEPTABLE_ERROR);
+        QVERIFY(position.getY() > 0.0f);
+    }
+}
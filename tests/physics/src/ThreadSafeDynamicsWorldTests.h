@@ -0,0 +1,23 @@
+//
+//  ThreadSafeDynamicsWorldTests.h
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ThreadSafeDynamicsWorldTests_h
+#define hifi_ThreadSafeDynamicsWorldTests_h
+
+#include <QtTest/QtTest>
+
+class ThreadSafeDynamicsWorldTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testSolverThreads();
+    void testParallelIslands();
+};
+
+#endif // hifi_ThreadSafeDynamicsWorldTests_h
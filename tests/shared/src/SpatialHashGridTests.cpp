@@ -0,0 +1,85 @@
+//
+//  SpatialHashGridTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatialHashGridTests.h"
+
+#include <algorithm>
+#include <random>
+
+#include <SpatialHashGrid.h>
+
+QTEST_MAIN(SpatialHashGridTests)
+
+void SpatialHashGridTests::testEmpty() {
+    SpatialHashGrid<int> grid(10.0f);
+    grid.build();
+
+    int count = 0;
+    grid.queryRadius(glm::vec3(0.0f), 100.0f, [&](const int&, const glm::vec3&) { ++count; });
+    QCOMPARE(count, 0);
+    QCOMPARE((int)grid.getNumCells(), 0);
+}
+
+void SpatialHashGridTests::testQueryRadius() {
+    const int NUM_ITEMS = 2000;
+    const float DOMAIN_SIZE = 1000.0f;
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(-DOMAIN_SIZE, DOMAIN_SIZE);
+
+    std::vector<glm::vec3> positions;
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        positions.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+    }
+
+    const float CELL_SIZE = 50.0f;
+    SpatialHashGrid<int> grid(CELL_SIZE);
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        grid.insert(positions[i], i);
+    }
+    grid.build();
+    QCOMPARE((int)grid.getNumItems(), NUM_ITEMS);
+
+    // compare small (cell lookup) and large (cell scan) queries against brute force
+    for (float radius : { 5.0f, 50.0f, 120.0f, 500.0f, 5000.0f }) {
+        for (int j = 0; j < 10; ++j) {
+            glm::vec3 center(distribution(generator), distribution(generator), distribution(generator));
+
+            std::vector<int> expected;
+            for (int i = 0; i < NUM_ITEMS; ++i) {
+                if (glm::distance(positions[i], center) <= radius) {
+                    expected.push_back(i);
+                }
+            }
+
+            std::vector<int> found;
+            grid.queryRadius(center, radius, [&](const int& item, const glm::vec3& position) {
+                QCOMPARE(position, positions[item]);
+                found.push_back(item);
+            });
+            std::sort(found.begin(), found.end());
+
+            QCOMPARE(found, expected);
+        }
+    }
+}
+
+void SpatialHashGridTests::testNegativeCoordinates() {
+    // items on either side of the origin fall in distinct cells
+    SpatialHashGrid<int> grid(1.0f);
+    grid.insert(glm::vec3(-0.5f), 0);
+    grid.insert(glm::vec3(0.5f), 1);
+    grid.build();
+    QCOMPARE((int)grid.getNumCells(), 2);
+
+    std::vector<int> found;
+    grid.queryRadius(glm::vec3(-0.5f), 0.1f, [&](const int& item, const glm::vec3&) { found.push_back(item); });
+    QCOMPARE(found, std::vector<int>({ 0 }));
+}
@@ -0,0 +1,24 @@
+//
+//  SpatialHashGridTests.h
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SpatialHashGridTests_h
+#define hifi_SpatialHashGridTests_h
+
+#include <QtTest/QtTest>
+
+class SpatialHashGridTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testEmpty();
+    void testQueryRadius();
+    void testNegativeCoordinates();
+};
+
+#endif // hifi_SpatialHashGridTests_h
@@ -0,0 +1,197 @@
+//
+//  TriangleSetTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleSetTests.h"
+
+#include <random>
+
+#include <RegisteredMetaTypes.h>
+#include <TriangleSet.h>
+
+QTEST_MAIN(TriangleSetTests)
+
+const int NUM_TRIANGLES = 2000;
+const int NUM_PICKS = 1000; // enough to spread across threads
+const float DOMAIN_SIZE = 10.0f;
+const float TRIANGLE_SIZE = 0.5f;
+const float DISTANCE_TOLERANCE = 1.0e-3f;
+
+static void buildTriangleSet(std::mt19937& generator, TriangleSet& triangleSet) {
+    std::uniform_real_distribution<float> position(-DOMAIN_SIZE, DOMAIN_SIZE);
+    std::uniform_real_distribution<float> offset(-TRIANGLE_SIZE, TRIANGLE_SIZE);
+    for (int i = 0; i < NUM_TRIANGLES; ++i) {
+        glm::vec3 center(position(generator), position(generator), position(generator));
+        Triangle triangle;
+        triangle.v0 = center + glm::vec3(offset(generator), offset(generator), offset(generator));
+        triangle.v1 = center + glm::vec3(offset(generator), offset(generator), offset(generator));
+        triangle.v2 = center + glm::vec3(offset(generator), offset(generator), offset(generator));
+        triangleSet.insert(triangle);
+    }
+}
+
+// a point outside the set's bounds, and a direction aimed somewhere inside them
+static void randomPick(std::mt19937& generator, glm::vec3& origin, glm::vec3& direction) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> position(-DOMAIN_SIZE, DOMAIN_SIZE);
+    origin = 3.0f * DOMAIN_SIZE * glm::normalize(glm::vec3(unit(generator), unit(generator), unit(generator)) + glm::vec3(0.01f));
+    glm::vec3 target(position(generator), position(generator), position(generator));
+    direction = glm::normalize(target - origin);
+}
+
+void TriangleSetTests::testBatchedRayIntersections() {
+    std::mt19937 generator(42);
+    TriangleSet triangleSet;
+    buildTriangleSet(generator, triangleSet);
+
+    std::vector<PickRay> rays;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        glm::vec3 origin, direction;
+        randomPick(generator, origin, direction);
+        rays.push_back(PickRay(origin, direction));
+    }
+    rays.push_back(PickRay()); // an invalid ray never intersects
+
+    std::vector<TriangleSet::Intersection> intersections;
+    triangleSet.findRayIntersections(rays, intersections);
+    QCOMPARE(intersections.size(), rays.size());
+
+    int numHits = 0;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        float distance;
+        BoxFace face;
+        Triangle triangle;
+        bool intersects = triangleSet.findRayIntersection(rays[i].origin, rays[i].direction, distance, face, triangle, true);
+        QCOMPARE(intersections[i].intersects, intersects);
+        if (intersects) {
+            QVERIFY(fabsf(intersections[i].distance - distance) < DISTANCE_TOLERANCE);
+            ++numHits;
+        }
+    }
+    QVERIFY(numHits > 0);
+    QVERIFY(!intersections.back().intersects);
+}
+
+void TriangleSetTests::testBatchedParabolaIntersections() {
+    std::mt19937 generator(7);
+    TriangleSet triangleSet;
+    buildTriangleSet(generator, triangleSet);
+
+    const float SPEED = 10.0f;
+    const glm::vec3 GRAVITY(0.0f, -1.0f, 0.0f);
+    std::vector<PickParabola> parabolas;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        glm::vec3 origin, direction;
+        randomPick(generator, origin, direction);
+        parabolas.push_back(PickParabola(origin, SPEED * direction, GRAVITY));
+    }
+
+    std::vector<TriangleSet::Intersection> intersections;
+    triangleSet.findParabolaIntersections(parabolas, intersections);
+    QCOMPARE(intersections.size(), parabolas.size());
+
+    int numHits = 0;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        float parabolicDistance;
+        BoxFace face;
+        Triangle triangle;
+        bool intersects = triangleSet.findParabolaIntersection(parabolas[i].origin, parabolas[i].velocity,
+            parabolas[i].acceleration, parabolicDistance, face, triangle, true);
+        QCOMPARE(intersections[i].intersects, intersects);
+        if (intersects) {
+            QVERIFY(fabsf(intersections[i].distance - parabolicDistance) < DISTANCE_TOLERANCE);
+            ++numHits;
+        }
+    }
+    QVERIFY(numHits > 0);
+}
+
+void TriangleSetTests::testBVHRayIntersections() {
+    std::mt19937 generator(42);
+    TriangleSet octreeSet;
+    TriangleSet bvhSet;
+    buildTriangleSet(generator, octreeSet);
+    generator.seed(42);
+    buildTriangleSet(generator, bvhSet);
+    bvhSet.buildBVH();
+    QVERIFY(bvhSet.hasBVH());
+    QCOMPARE(bvhSet.size(), octreeSet.size());
+
+    std::vector<PickRay> rays;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        glm::vec3 origin, direction;
+        randomPick(generator, origin, direction);
+        rays.push_back(PickRay(origin, direction));
+    }
+
+    std::vector<TriangleSet::Intersection> intersections;
+    bvhSet.findRayIntersections(rays, intersections);
+
+    int numHits = 0;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        float octreeDistance;
+        float bvhDistance;
+        BoxFace face;
+        Triangle triangle;
+        bool intersects = octreeSet.findRayIntersection(rays[i].origin, rays[i].direction, octreeDistance, face, triangle, true);
+        QCOMPARE(bvhSet.findRayIntersection(rays[i].origin, rays[i].direction, bvhDistance, face, triangle, true), intersects);
+        QCOMPARE(intersections[i].intersects, intersects);
+        if (intersects) {
+            QVERIFY(fabsf(bvhDistance - octreeDistance) < DISTANCE_TOLERANCE);
+            QVERIFY(fabsf(intersections[i].distance - octreeDistance) < DISTANCE_TOLERANCE);
+            ++numHits;
+        }
+    }
+    QVERIFY(numHits > 0);
+
+    // inserting a triangle drops the BVH
+    bvhSet.insert(Triangle());
+    QVERIFY(!bvhSet.hasBVH());
+}
+
+void TriangleSetTests::testBVHParabolaIntersections() {
+    std::mt19937 generator(7);
+    TriangleSet octreeSet;
+    TriangleSet bvhSet;
+    buildTriangleSet(generator, octreeSet);
+    generator.seed(7);
+    buildTriangleSet(generator, bvhSet);
+    bvhSet.buildBVH();
+
+    const float SPEED = 10.0f;
+    const glm::vec3 GRAVITY(0.0f, -1.0f, 0.0f);
+    std::vector<PickParabola> parabolas;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        glm::vec3 origin, direction;
+        randomPick(generator, origin, direction);
+        parabolas.push_back(PickParabola(origin, SPEED * direction, GRAVITY));
+    }
+
+    std::vector<TriangleSet::Intersection> intersections;
+    bvhSet.findParabolaIntersections(parabolas, intersections);
+
+    int numHits = 0;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        float octreeDistance;
+        float bvhDistance;
+        BoxFace face;
+        Triangle triangle;
+        bool intersects = octreeSet.findParabolaIntersection(parabolas[i].origin, parabolas[i].velocity,
+            parabolas[i].acceleration, octreeDistance, face, triangle, true);
+        QCOMPARE(bvhSet.findParabolaIntersection(parabolas[i].origin, parabolas[i].velocity, parabolas[i].acceleration,
+            bvhDistance, face, triangle, true), intersects);
+        QCOMPARE(intersections[i].intersects, intersects);
+        if (intersects) {
+            QVERIFY(fabsf(bvhDistance - octreeDistance) < DISTANCE_TOLERANCE);
+            QVERIFY(fabsf(intersections[i].distance - octreeDistance) < DISTANCE_TOLERANCE);
+            ++numHits;
+        }
+    }
+    QVERIFY(numHits > 0);
+}
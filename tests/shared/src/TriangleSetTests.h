@@ -0,0 +1,25 @@
+//
+//  TriangleSetTests.h
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TriangleSetTests_h
+#define hifi_TriangleSetTests_h
+
+#include <QtTest/QtTest>
+
+class TriangleSetTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testBatchedRayIntersections();
+    void testBatchedParabolaIntersections();
+    void testBVHRayIntersections();
+    void testBVHParabolaIntersections();
+};
+
+#endif // hifi_TriangleSetTests_h
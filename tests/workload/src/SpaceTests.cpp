@@ -123,10 +123,10 @@ glm::vec3 randomVec3() {
     return v;
 }
 
-void generateSpheres(uint32_t numProxies, std::vector<workload::Space::Sphere>& spheres) {
+void generateSpheres(uint32_t numProxies, std::vector<workload::Sphere>& spheres) {
     spheres.reserve(numProxies);
     for (uint32_t i = 0; i < numProxies; ++i) {
-        workload::Space::Sphere sphere(
+        workload::Sphere sphere(
                 WORLD_WIDTH * randomFloat(),
                 WORLD_WIDTH * randomFloat(),
                 WORLD_WIDTH * randomFloat(),
@@ -277,4 +277,86 @@ void SpaceTests::benchmark() {
     std::cout << "];" << std::endl;
 }
 
+void SpaceTests::benchmarkScaling() {
+    // a view walking through a world where a few proxies move every frame,
+    // to measure how categorizeAndGetChanges scales with the number of proxies
+    uint32_t numProxies[] = { 1000, 10000, 50000, 100000, 200000 };
+    uint32_t numTests = 5;
+    const uint32_t NUM_FRAMES = 100;
+    const uint32_t MOVING_PROXY_STRIDE = 100;
+    const float VIEW_SPEED = 1.0f;
+    std::vector<uint64_t> timeToCategorizeAll;
+    std::vector<uint64_t> timeToCategorizeFrame;
+    std::vector<uint64_t> numChangesPerFrame;
+    for (uint32_t i = 0; i < numTests; ++i) {
+        workload::Space space;
+        uint32_t n = numProxies[i];
+        std::vector<workload::Sphere> proxySpheres;
+        generateSpheres(n, proxySpheres);
+
+        workload::Transaction transaction;
+        for (uint32_t j = 0; j < n; ++j) {
+            transaction.reset(space.allocateID(), proxySpheres[j], workload::Owner());
+        }
+        space.enqueueTransaction(std::move(transaction));
+        space.enqueueFrame();
+        space.processTransactionQueue();
+
+        auto makeViews = [&](const glm::vec3& position) {
+            workload::Views views(1);
+            const float REGION_RADIUSES[workload::Region::NUM_VIEW_REGIONS] = {
+                0.05f * WORLD_WIDTH, 0.15f * WORLD_WIDTH, 0.40f * WORLD_WIDTH };
+            for (uint32_t k = 0; k < workload::Region::NUM_VIEW_REGIONS; ++k) {
+                views[0].regions[k] = workload::Sphere(position, REGION_RADIUSES[k]);
+            }
+            return views;
+        };
+
+        // measure time to categorize everything
+        glm::vec3 viewPosition(0.0f);
+        space.setViews(makeViews(viewPosition));
+        workload::Changes changes;
+        uint64_t startTime = usecTimestampNow();
+        space.categorizeAndGetChanges(changes);
+        timeToCategorizeAll.push_back(usecTimestampNow() - startTime);
+
+        // measure time per frame with a moving view and a few moving proxies
+        uint64_t usec = 0;
+        uint64_t numChanges = 0;
+        for (uint32_t frame = 0; frame < NUM_FRAMES; ++frame) {
+            viewPosition.z += VIEW_SPEED;
+            space.setViews(makeViews(viewPosition));
+
+            workload::Transaction updates;
+            for (uint32_t j = frame % MOVING_PROXY_STRIDE; j < n; j += MOVING_PROXY_STRIDE) {
+                proxySpheres[j] += glm::vec4(randomVec3(), 0.0f);
+                updates.update((int32_t)j, proxySpheres[j]);
+            }
+            space.enqueueTransaction(std::move(updates));
+            space.enqueueFrame();
+            space.processTransactionQueue();
+
+            changes.clear();
+            startTime = usecTimestampNow();
+            space.categorizeAndGetChanges(changes);
+            usec += usecTimestampNow() - startTime;
+            numChanges += changes.size();
+        }
+        timeToCategorizeFrame.push_back(usec / NUM_FRAMES);
+        numChangesPerFrame.push_back(numChanges / NUM_FRAMES);
+    }
+
+    std::cout << "[numProxies, timeToCategorizeAll] = [" << std::endl;
+    for (uint32_t i = 0; i < timeToCategorizeAll.size(); ++i) {
+        std::cout << "    " << numProxies[i] << ", " << timeToCategorizeAll[i] << std::endl;
+    }
+    std::cout << "];" << std::endl;
+
+    std::cout << "[numProxies, timeToCategorizeFrame, numChangesPerFrame] = [" << std::endl;
+    for (uint32_t i = 0; i < timeToCategorizeFrame.size(); ++i) {
+        std::cout << "    " << numProxies[i] << ", " << timeToCategorizeFrame[i] << ", " << numChangesPerFrame[i] << std::endl;
+    }
+    std::cout << "];" << std::endl;
+}
+
 #endif // MANUAL_TEST
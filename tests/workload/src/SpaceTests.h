@@ -23,6 +23,7 @@ private slots:
     void testOverlaps();
 #ifdef MANUAL_TEST
     void benchmark();
+    void benchmarkScaling();
 #endif // MANUAL_TEST
 };
 
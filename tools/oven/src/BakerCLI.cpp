@@ -12,17 +12,15 @@
 #include "BakerCLI.h"
 
 #include <QObject>
-#include <QImageReader>
 #include <QtCore/QDebug>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTextStream>
 #include <QFile>
 
-#include <unordered_map>
-
 #include "OvenCLIApplication.h"
 #include "ModelBakingLoggingCategory.h"
-#include "FBXBaker.h"
-#include "JSBaker.h"
-#include "TextureBaker.h"
+#include "BakerLibrary.h"
 
 BakerCLI::BakerCLI(OvenCLIApplication* parent) : QObject(parent) {
     
@@ -37,72 +35,54 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString&
 
     qDebug() << "Baking file type: " << type;
 
-    static const QString MODEL_EXTENSION { "fbx" };
-    static const QString SCRIPT_EXTENSION { "js" };
-
-    // check what kind of baker we should be creating
-    bool isFBX = type == MODEL_EXTENSION;
-    bool isScript = type == SCRIPT_EXTENSION;
-
-    // If the type doesn't match the above, we assume we have a texture, and the type specified is the
-    // texture usage type (albedo, cubemap, normals, etc.)
-    auto url = inputUrl.toDisplayString();
-    auto idx = url.lastIndexOf('.');
-    auto extension = idx >= 0 ? url.mid(idx + 1).toLower() : "";
-    bool isSupportedImage = QImageReader::supportedImageFormats().contains(extension.toLatin1());
-
     _outputPath = outputPath;
 
     // create our appropiate baker
-    if (isFBX) {
-        _baker = std::unique_ptr<Baker> {
-            new FBXBaker(inputUrl,
-                         []() -> QThread* { return Oven::instance().getNextWorkerThread(); },
-                         outputPath)
-        };
-        _baker->moveToThread(Oven::instance().getNextWorkerThread());
-    } else if (isScript) {
-        _baker = std::unique_ptr<Baker> { new JSBaker(inputUrl, outputPath) };
-        _baker->moveToThread(Oven::instance().getNextWorkerThread());
-    } else if (isSupportedImage) {
-        static const std::unordered_map<QString, image::TextureUsage::Type> STRING_TO_TEXTURE_USAGE_TYPE_MAP {
-            { "default", image::TextureUsage::DEFAULT_TEXTURE },
-            { "strict", image::TextureUsage::STRICT_TEXTURE },
-            { "albedo", image::TextureUsage::ALBEDO_TEXTURE },
-            { "normal", image::TextureUsage::NORMAL_TEXTURE },
-            { "bump", image::TextureUsage::BUMP_TEXTURE },
-            { "specular", image::TextureUsage::SPECULAR_TEXTURE },
-            { "metallic", image::TextureUsage::METALLIC_TEXTURE },
-            { "roughness", image::TextureUsage::ROUGHNESS_TEXTURE },
-            { "gloss", image::TextureUsage::GLOSS_TEXTURE },
-            { "emissive", image::TextureUsage::EMISSIVE_TEXTURE },
-            { "cube", image::TextureUsage::CUBE_TEXTURE },
-            { "occlusion", image::TextureUsage::OCCLUSION_TEXTURE },
-            { "scattering", image::TextureUsage::SCATTERING_TEXTURE },
-            { "lightmap", image::TextureUsage::LIGHTMAP_TEXTURE },
-        };
-
-        auto it = STRING_TO_TEXTURE_USAGE_TYPE_MAP.find(type);
-        if (it == STRING_TO_TEXTURE_USAGE_TYPE_MAP.end()) {
-            qCDebug(model_baking) << "Unknown texture usage type:" << type;
-            QCoreApplication::exit(OVEN_STATUS_CODE_FAIL);
-        }
-        _baker = std::unique_ptr<Baker> { new TextureBaker(inputUrl, it->second, outputPath) };
-        _baker->moveToThread(Oven::instance().getNextWorkerThread());
-    } else {
-        qCDebug(model_baking) << "Failed to determine baker type for file" << inputUrl;
-        QCoreApplication::exit(OVEN_STATUS_CODE_FAIL);
+    QString error;
+    _baker = createBakerForType(inputUrl, type, outputPath,
+                                []() -> QThread* { return Oven::instance().getNextWorkerThread(); }, error);
+    if (!_baker) {
+        qCDebug(model_baking) << error;
+        finishBake(OVEN_STATUS_CODE_FAIL);
         return;
     }
+    _baker->moveToThread(Oven::instance().getNextWorkerThread());
 
     // invoke the bake method on the baker thread
     QMetaObject::invokeMethod(_baker.get(), "bake");
 
     // make sure we hear about the results of this baker when it is done
     connect(_baker.get(), &Baker::finished, this, &BakerCLI::handleFinishedBaker);
+    connect(_baker.get(), &Baker::aborted, this, &BakerCLI::handleFinishedBaker);
+}
+
+void BakerCLI::serveBakeRequests() {
+    _isWorker = true;
+    readNextBakeRequest();
+}
+
+void BakerCLI::readNextBakeRequest() {
+    // requests come one per line on stdin, the next one is only sent once we have replied to this one
+    static QTextStream requests { stdin };
+    QString line = requests.readLine();
+
+    if (line.isNull()) {
+        // the asset server closed our input, we are done
+        QCoreApplication::exit(OVEN_STATUS_CODE_SUCCESS);
+        return;
+    }
+
+    auto request = QJsonDocument::fromJson(line.toUtf8()).object();
+    bakeFile(QUrl(request[OVEN_WORKER_INPUT_KEY].toString()), request[OVEN_WORKER_OUTPUT_KEY].toString(),
+             request[OVEN_WORKER_TYPE_KEY].toString());
 }
 
 void BakerCLI::handleFinishedBaker() {
+    if (sender() != _baker.get()) {
+        // an aborted baker can still emit finished, we already handled it
+        return;
+    }
+
     qCDebug(model_baking) << "Finished baking file.";
     int exitCode = OVEN_STATUS_CODE_SUCCESS;
     // Do we need this?
@@ -116,5 +96,23 @@ void BakerCLI::handleFinishedBaker() {
             errorFile.close();
         }
     }
-    QCoreApplication::exit(exitCode);
+    finishBake(exitCode);
+}
+
+void BakerCLI::finishBake(int exitCode) {
+    if (!_isWorker) {
+        QCoreApplication::exit(exitCode);
+        return;
+    }
+
+    if (_baker) {
+        // we may be inside one of its signals, let it go away on its own thread
+        _baker.release()->deleteLater();
+    }
+
+    // log output shares stdout with us, so the result is tagged for the asset server to pick out
+    QTextStream results { stdout };
+    results << OVEN_WORKER_RESULT_PREFIX << exitCode << endl;
+
+    QMetaObject::invokeMethod(this, "readNextBakeRequest", Qt::QueuedConnection);
 }
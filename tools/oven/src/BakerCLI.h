@@ -27,6 +27,13 @@ static const int OVEN_STATUS_CODE_ABORT { 2 };
 
 static const QString OVEN_ERROR_FILENAME = "errors.txt";
 
+// In worker mode the oven stays alive and bakes one JSON request per line read from stdin,
+// replying with a line holding the result prefix followed by one of the status codes above.
+static const QString OVEN_WORKER_INPUT_KEY = "input";
+static const QString OVEN_WORKER_OUTPUT_KEY = "output";
+static const QString OVEN_WORKER_TYPE_KEY = "type";
+static const QString OVEN_WORKER_RESULT_PREFIX = "OVEN_RESULT ";
+
 class BakerCLI : public QObject {
     Q_OBJECT
 
@@ -35,11 +42,16 @@ public:
 
 public slots:
     void bakeFile(QUrl inputUrl, const QString& outputPath, const QString& type = QString::null);
+    void serveBakeRequests();
 
 private slots:
     void handleFinishedBaker();  
+    void readNextBakeRequest();
 
 private:
+    void finishBake(int exitCode);
+
+    bool _isWorker { false };
     QDir _outputPath;
     std::unique_ptr<Baker> _baker;
 };
@@ -23,6 +23,7 @@ static const QString CLI_INPUT_PARAMETER = "i";
 static const QString CLI_OUTPUT_PARAMETER = "o";
 static const QString CLI_TYPE_PARAMETER = "t";
 static const QString CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER = "disable-texture-compression";
+static const QString CLI_WORKER_PARAMETER = "worker";
 
 OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
@@ -34,23 +35,27 @@ OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
         { CLI_INPUT_PARAMETER, "Path to file that you would like to bake.", "input" },
         { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" },
         { CLI_TYPE_PARAMETER, "Type of asset.", "type" },
-        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." }
+        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." },
+        { CLI_WORKER_PARAMETER, "Stay running and bake the requests read from standard input, one JSON object per line." }
     });
 
     parser.addHelpOption();
     parser.process(*this);
 
-    if (parser.isSet(CLI_INPUT_PARAMETER) && parser.isSet(CLI_OUTPUT_PARAMETER)) {
+    if (parser.isSet(CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER)) {
+        qDebug() << "Disabling texture compression";
+        TextureBaker::setCompressionEnabled(false);
+    }
+
+    if (parser.isSet(CLI_WORKER_PARAMETER)) {
+        BakerCLI* cli = new BakerCLI(this);
+        QMetaObject::invokeMethod(cli, "serveBakeRequests", Qt::QueuedConnection);
+    } else if (parser.isSet(CLI_INPUT_PARAMETER) && parser.isSet(CLI_OUTPUT_PARAMETER)) {
         BakerCLI* cli = new BakerCLI(this);
         QUrl inputUrl(QDir::fromNativeSeparators(parser.value(CLI_INPUT_PARAMETER)));
         QUrl outputUrl(QDir::fromNativeSeparators(parser.value(CLI_OUTPUT_PARAMETER)));
         QString type = parser.isSet(CLI_TYPE_PARAMETER) ? parser.value(CLI_TYPE_PARAMETER) : QString::null;
 
-        if (parser.isSet(CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER)) {
-            qDebug() << "Disabling texture compression";
-            TextureBaker::setCompressionEnabled(false);
-        }
-
         QMetaObject::invokeMethod(cli, "bakeFile", Qt::QueuedConnection, Q_ARG(QUrl, inputUrl),
                                     Q_ARG(QString, outputUrl.toString()), Q_ARG(QString, type));
     } else {
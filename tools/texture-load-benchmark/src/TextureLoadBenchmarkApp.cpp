@@ -0,0 +1,430 @@
+//
+//  TextureLoadBenchmarkApp.cpp
+//  tools/texture-load-benchmark/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureLoadBenchmarkApp.h"
+
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+
+#include <ktx/KTX.h>
+#include <gpu/Texture.h>
+#include <model-networking/KTXCache.h>
+#include <NetworkAccessManager.h>
+#include <OwningBuffer.h>
+#include <RegisteredMetaTypes.h>
+
+static const char* KTX_CACHE_DIRNAME = "ktx_cache";
+static const char* KTX_CACHE_EXT = "ktx";
+
+static const char* STAGE_NAMES[] = { "fetch", "hash", "lookup", "decode", "serialize", "validate", "write", "load" };
+
+static const qint64 NSECS_PER_MSEC = 1000 * 1000;
+static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+
+static quint64 getPeakResidentBytes() {
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return 0;
+    }
+    return pmc.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef Q_OS_MAC
+    return usage.ru_maxrss;
+#else
+    // Linux reports kilobytes
+    return (quint64)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+static double toMsecs(qint64 nsecs) {
+    return (double)nsecs / NSECS_PER_MSEC;
+}
+
+void TextureLoadBenchmarkApp::Timing::add(qint64 nsecs) {
+    ++count;
+    totalNsecs += nsecs;
+    maxNsecs = std::max(maxNsecs, nsecs);
+}
+
+TextureLoadBenchmarkApp::TextureLoadBenchmarkApp(int argc, char* argv[]) : QCoreApplication(argc, argv) {
+
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity Texture Load Benchmark\n\n"
+        "Replays a list of textures through image decoding, KTX serialization and the KTX cache.\n"
+        "Each line of the list is a file path or URL, optionally followed by a texture type "
+        "(default, albedo, normal, cube, ...). Lines starting with # are ignored.");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    parser.addPositionalArgument("list", "file listing the textures to load");
+
+    const QCommandLineOption iterationsOption("iterations", "times to replay the list (default 1)", "count", "1");
+    parser.addOption(iterationsOption);
+
+    const QCommandLineOption cacheDirOption("cache-dir",
+        "KTX cache directory to use and keep (default: an empty temporary directory)", "dir");
+    parser.addOption(cacheDirOption);
+
+    const QCommandLineOption cacheSizeOption("cache-size", "maximum KTX cache size", "megabytes");
+    parser.addOption(cacheSizeOption);
+
+    const QCommandLineOption maxPixelsOption("max-pixels", "largest number of pixels a texture is decoded at", "pixels");
+    parser.addOption(maxPixelsOption);
+
+    const QCommandLineOption compressOption("compress", "compress textures while decoding them");
+    parser.addOption(compressOption);
+
+    const QCommandLineOption threadsOption("threads", "texture compression threads", "count");
+    parser.addOption(threadsOption);
+
+    const QCommandLineOption jsonOption("json", "also write the results as JSON, - for stdout", "filename");
+    parser.addOption(jsonOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        _returnCode = 1;
+        return;
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        return;
+    }
+
+    auto positionalArguments = parser.positionalArguments();
+    if (positionalArguments.size() != 1) {
+        qCritical() << "Expected a single texture list";
+        _returnCode = 1;
+        return;
+    }
+
+    int iterations = parser.value(iterationsOption).toInt();
+    if (iterations < 1) {
+        qCritical() << "Invalid iteration count" << parser.value(iterationsOption);
+        _returnCode = 1;
+        return;
+    }
+
+    if (parser.isSet(maxPixelsOption)) {
+        _maxNumPixels = parser.value(maxPixelsOption).toInt();
+        if (_maxNumPixels <= 0) {
+            qCritical() << "Invalid max pixels" << parser.value(maxPixelsOption);
+            _returnCode = 1;
+            return;
+        }
+    }
+    _compress = parser.isSet(compressOption);
+    if (parser.isSet(threadsOption)) {
+        image::setCompressionThreadCount(parser.value(threadsOption).toInt());
+    }
+
+    if (!readEntries(positionalArguments.front())) {
+        _returnCode = 2;
+        return;
+    }
+
+    QString cacheDir;
+    if (parser.isSet(cacheDirOption)) {
+        cacheDir = QDir(parser.value(cacheDirOption)).absolutePath();
+    } else {
+        _temporaryCacheDir.reset(new QTemporaryDir());
+        if (!_temporaryCacheDir->isValid()) {
+            qCritical() << "Failed to create a temporary KTX cache directory";
+            _returnCode = 2;
+            return;
+        }
+        cacheDir = QDir(_temporaryCacheDir->path()).absoluteFilePath(KTX_CACHE_DIRNAME);
+    }
+
+    _ktxCache.reset(new KTXCache(cacheDir.toStdString(), KTX_CACHE_EXT));
+    _ktxCache->initialize();
+    if (parser.isSet(cacheSizeOption)) {
+        _ktxCache->setMaxSize(parser.value(cacheSizeOption).toULongLong() * BYTES_PER_MEGABYTE);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& entry : _entries) {
+            replay(entry);
+        }
+    }
+    _elapsedNsecs = timer.nsecsElapsed();
+
+    report(parser.value(jsonOption));
+
+    if (_failures > 0) {
+        _returnCode = 3;
+    }
+}
+
+TextureLoadBenchmarkApp::~TextureLoadBenchmarkApp() {
+}
+
+bool TextureLoadBenchmarkApp::readEntries(const QString& listFilename) {
+    QFile listFile(listFilename);
+    if (!listFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCritical() << "Failed to open texture list" << listFilename;
+        return false;
+    }
+
+    // relative paths are relative to the list, so recordings can be moved along with their textures
+    QDir listDir = QFileInfo(listFilename).absoluteDir();
+
+    QTextStream stream(&listFile);
+    while (!stream.atEnd()) {
+        auto line = stream.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        Entry entry { QUrl(), image::TextureUsage::DEFAULT_TEXTURE };
+        auto separator = line.lastIndexOf(QRegExp("\\s"));
+        if (separator >= 0) {
+            if (image::TextureUsage::getTextureUsageTypeFromName(line.mid(separator + 1).toLower(), entry.type)) {
+                line = line.left(separator).trimmed();
+            }
+        }
+
+        // a single letter scheme is a windows drive
+        QUrl url(line);
+        if (url.scheme().size() > 1) {
+            entry.url = url;
+        } else {
+            entry.url = QUrl::fromLocalFile(listDir.absoluteFilePath(line));
+        }
+        _entries.push_back(entry);
+    }
+
+    if (_entries.empty()) {
+        qCritical() << "No textures in" << listFilename;
+        return false;
+    }
+    return true;
+}
+
+bool TextureLoadBenchmarkApp::fetch(const QUrl& url, QByteArray& content) {
+    if (url.isLocalFile()) {
+        QFile file(url.toLocalFile());
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Failed to open" << url.toLocalFile();
+            return false;
+        }
+        content = file.readAll();
+        return true;
+    }
+
+    if (url.scheme() != "http" && url.scheme() != "https") {
+        qWarning() << "Unsupported scheme for" << url;
+        return false;
+    }
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+    std::unique_ptr<QNetworkReply> reply { NetworkAccessManager::getInstance().get(request) };
+    QEventLoop loop;
+    connect(reply.get(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        qWarning() << "Failed to download" << url << reply->errorString();
+        return false;
+    }
+    content = reply->readAll();
+    return true;
+}
+
+void TextureLoadBenchmarkApp::replay(const Entry& entry) {
+    auto url = entry.url.toString().toStdString();
+    QElapsedTimer timer;
+
+    QByteArray content;
+    timer.start();
+    if (!fetch(entry.url, content)) {
+        ++_failures;
+        return;
+    }
+    _timings[FETCH].add(timer.nsecsElapsed());
+    _sourceBytes += content.size();
+
+    // Hash the source the way the TextureCache does to key the KTX cache
+    std::string hash;
+    timer.restart();
+    {
+        QCryptographicHash hasher(QCryptographicHash::Md5);
+        hasher.addData(content);
+        hash = hasher.result().toHex().toStdString();
+    }
+    _timings[HASH].add(timer.nsecsElapsed());
+
+    timer.restart();
+    auto ktxFile = _ktxCache->getFile(hash);
+    _timings[LOOKUP].add(timer.nsecsElapsed());
+
+    bool invalidCachedFile = false;
+    if (ktxFile) {
+        timer.restart();
+        bool valid = ktx::KTX::validate(std::make_shared<storage::FileStorage>(ktxFile->getFilepath().c_str()));
+        _timings[VALIDATE].add(timer.nsecsElapsed());
+
+        if (valid) {
+            timer.restart();
+            auto texture = gpu::Texture::unserialize(ktxFile, url);
+            _timings[LOAD].add(timer.nsecsElapsed());
+
+            if (texture) {
+                ++_hits;
+                return;
+            }
+        }
+        qWarning() << "Invalid cached KTX" << entry.url << "under hash" << hash.c_str() << ", recreating...";
+        invalidCachedFile = true;
+        ktxFile.reset();
+    }
+    ++_misses;
+
+    timer.restart();
+    auto buffer = std::shared_ptr<QIODevice>((QIODevice*)new OwningBuffer(std::move(content)));
+    auto texture = image::processImage(std::move(buffer), url, _maxNumPixels, entry.type, _compress);
+    _timings[DECODE].add(timer.nsecsElapsed());
+    if (!texture) {
+        qWarning() << "Could not process" << entry.url;
+        ++_failures;
+        return;
+    }
+    texture->setSourceHash(hash);
+
+    timer.restart();
+    auto memKtx = gpu::Texture::serialize(*texture);
+    _timings[SERIALIZE].add(timer.nsecsElapsed());
+    if (!memKtx) {
+        qWarning() << "Unable to serialize texture to KTX" << entry.url;
+        ++_failures;
+        return;
+    }
+
+    timer.restart();
+    bool valid = ktx::KTX::validate(memKtx->getStorage());
+    _timings[VALIDATE].add(timer.nsecsElapsed());
+    if (!valid) {
+        qWarning() << "Serialized an invalid KTX for" << entry.url;
+        ++_failures;
+        return;
+    }
+
+    const char* data = reinterpret_cast<const char*>(memKtx->getStorage()->data());
+    size_t length = memKtx->getStorage()->size();
+    _ktxBytes += length;
+
+    timer.restart();
+    auto file = _ktxCache->writeFile(data, KTXCache::Metadata(hash, length), invalidCachedFile);
+    _timings[WRITE].add(timer.nsecsElapsed());
+    if (!file) {
+        qWarning() << entry.url << "file cache failed";
+        ++_failures;
+    }
+}
+
+void TextureLoadBenchmarkApp::report(const QString& jsonFilename) {
+    int lookups = _hits + _misses;
+    double hitRate = lookups > 0 ? (double)_hits / lookups : 0.0;
+    quint64 peakResidentBytes = getPeakResidentBytes();
+
+    QTextStream out(stdout);
+    out << "textures:        " << _entries.size() << endl;
+    out << "lookups:         " << lookups << " (" << _hits << " hits, " << _misses << " misses, "
+        << QString::number(hitRate * 100.0, 'f', 1) << "% hit rate)" << endl;
+    out << "failures:        " << _failures << endl;
+    out << "source:          " << QString::number((double)_sourceBytes / BYTES_PER_MEGABYTE, 'f', 2) << " MB" << endl;
+    out << "ktx written:     " << QString::number((double)_ktxBytes / BYTES_PER_MEGABYTE, 'f', 2) << " MB" << endl;
+    out << "cache:           " << QString::number((double)_ktxCache->getSizeTotalFiles() / BYTES_PER_MEGABYTE, 'f', 2)
+        << " MB in " << _ktxCache->getNumTotalFiles() << " files" << endl;
+    out << "peak resident:   " << QString::number((double)peakResidentBytes / BYTES_PER_MEGABYTE, 'f', 2) << " MB" << endl;
+    out << "elapsed:         " << QString::number(toMsecs(_elapsedNsecs), 'f', 1) << " ms" << endl;
+    out << endl;
+    out << QString("%1 %2 %3 %4 %5").arg("stage", -10).arg("count", 8).arg("total ms", 12).arg("avg ms", 10).arg("max ms", 10)
+        << endl;
+
+    QJsonObject stages;
+    for (int i = 0; i < NUM_STAGES; ++i) {
+        const auto& timing = _timings[i];
+        double average = timing.count > 0 ? toMsecs(timing.totalNsecs) / timing.count : 0.0;
+        out << QString("%1 %2 %3 %4 %5")
+            .arg(STAGE_NAMES[i], -10)
+            .arg(timing.count, 8)
+            .arg(toMsecs(timing.totalNsecs), 12, 'f', 2)
+            .arg(average, 10, 'f', 3)
+            .arg(toMsecs(timing.maxNsecs), 10, 'f', 3) << endl;
+
+        QJsonObject stage;
+        stage["count"] = timing.count;
+        stage["totalMsecs"] = toMsecs(timing.totalNsecs);
+        stage["averageMsecs"] = average;
+        stage["maxMsecs"] = toMsecs(timing.maxNsecs);
+        stages[STAGE_NAMES[i]] = stage;
+    }
+
+    if (jsonFilename.isEmpty()) {
+        return;
+    }
+
+    QJsonObject results;
+    results["textures"] = (int)_entries.size();
+    results["hits"] = _hits;
+    results["misses"] = _misses;
+    results["hitRate"] = hitRate;
+    results["failures"] = _failures;
+    results["sourceBytes"] = _sourceBytes;
+    results["ktxBytes"] = _ktxBytes;
+    results["cacheBytes"] = (qint64)_ktxCache->getSizeTotalFiles();
+    results["peakResidentBytes"] = (qint64)peakResidentBytes;
+    results["elapsedMsecs"] = toMsecs(_elapsedNsecs);
+    results["stages"] = stages;
+    auto json = QJsonDocument(results).toJson();
+
+    if (jsonFilename == "-") {
+        out << json;
+        return;
+    }
+
+    QFile jsonFile(jsonFilename);
+    if (!jsonFile.open(QIODevice::WriteOnly) || jsonFile.write(json) != json.size()) {
+        qCritical() << "Failed to write" << jsonFilename;
+        _returnCode = 2;
+    }
+}
@@ -0,0 +1,87 @@
+//
+//  TextureLoadBenchmarkApp.h
+//  tools/texture-load-benchmark/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureLoadBenchmarkApp_h
+#define hifi_TextureLoadBenchmarkApp_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QUrl>
+
+#include <image/Image.h>
+
+class QTemporaryDir;
+class KTXCache;
+
+/// Replays a recorded list of textures through the same steps the TextureCache takes to load them, without a GL
+/// context: hash the source, look it up in the KTX cache, and on a miss decode it, serialize it to KTX and write it
+/// to the cache. Prints how long each step took, the cache hit rate and the peak resident memory.
+class TextureLoadBenchmarkApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    TextureLoadBenchmarkApp(int argc, char* argv[]);
+    ~TextureLoadBenchmarkApp();
+
+    int getReturnCode() const { return _returnCode; }
+
+private:
+    struct Entry {
+        QUrl url;
+        image::TextureUsage::Type type;
+    };
+
+    struct Timing {
+        void add(qint64 nsecs);
+
+        int count { 0 };
+        qint64 totalNsecs { 0 };
+        qint64 maxNsecs { 0 };
+    };
+
+    enum Stage {
+        FETCH = 0,
+        HASH,
+        LOOKUP,
+        DECODE,
+        SERIALIZE,
+        VALIDATE,
+        WRITE,
+        LOAD,
+
+        NUM_STAGES
+    };
+
+    bool readEntries(const QString& listFilename);
+    bool fetch(const QUrl& url, QByteArray& content);
+    void replay(const Entry& entry);
+    void report(const QString& jsonFilename);
+
+    std::vector<Entry> _entries;
+    // the cache goes away before the directory it lives in
+    std::unique_ptr<QTemporaryDir> _temporaryCacheDir;
+    std::unique_ptr<KTXCache> _ktxCache;
+
+    int _maxNumPixels { ABSOLUTE_MAX_TEXTURE_NUM_PIXELS };
+    bool _compress { false };
+
+    Timing _timings[NUM_STAGES];
+    int _hits { 0 };
+    int _misses { 0 };
+    int _failures { 0 };
+    qint64 _sourceBytes { 0 };
+    qint64 _ktxBytes { 0 };
+    qint64 _elapsedNsecs { 0 };
+
+    int _returnCode { 0 };
+};
+
+#endif // hifi_TextureLoadBenchmarkApp_h
@@ -0,0 +1,24 @@
+//
+//  main.cpp
+//  tools/texture-load-benchmark/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <SettingInterface.h>
+#include <SharedUtil.h>
+
+#include "TextureLoadBenchmarkApp.h"
+
+int main(int argc, char* argv[]) {
+    setupHifiApplication("Texture Load Benchmark");
+
+    // the KTX cache keeps its version in the settings
+    Setting::init();
+
+    TextureLoadBenchmarkApp app(argc, argv);
+    return app.getReturnCode();
+}